@@ -8,6 +8,7 @@
 #include <utility>
 #include <type_traits>
 #include <limits>
+#include <cstring>
 
 template <class Type>
 class ArrayIterator
@@ -316,7 +317,7 @@ public:
         m_capacity = m_size = other.m_size;
         if (m_size != 0)
         {
-            m_data = m_alloc.Allocate(m_capacity);
+            m_data = m_alloc.Allocate<Type>(m_capacity);
             for (size_type i = 0; i != m_size; i++)
             {
                 std::construct_at(&m_data[i], std::as_const(other.m_data[i]));
@@ -397,7 +398,7 @@ public:
     /// <param name="count">容器初始大小</param>
     constexpr explicit Array(size_type count)
     {
-        m_data = m_alloc.Allocate(count);
+        m_data = m_alloc.Allocate<Type>(count);
         m_capacity = m_size = count;
         for (size_type i = 0; i != count; i++)
         {
@@ -411,7 +412,7 @@ public:
     /// <param name="value">用于填充的初始值</param>
     constexpr Array(size_type count, const Type& value)
     {
-        m_data = m_alloc.Allocate(count);
+        m_data = m_alloc.Allocate<Type>(count);
         m_capacity = m_size = count;
         for (size_type i = 0; i != count; i++)
         {
@@ -428,7 +429,7 @@ public:
     constexpr Array(InputIt first, InputIt last)
     {
         size_type count = last - first;
-        m_data = m_alloc.Allocate(count);
+        m_data = m_alloc.Allocate<Type>(count);
         m_capacity = m_size = count;
         for (size_type i = 0; i != count; i++)
         {
@@ -455,7 +456,7 @@ public:
         auto first = ilist.begin();
         auto last = ilist.end();
         size_type count = last - first;
-        m_data = m_alloc.Allocate(count);
+        m_data = m_alloc.Allocate<Type>(count);
         m_capacity = m_size = count;
         for (size_type i = 0; i != count; i++)
         {
@@ -627,9 +628,7 @@ public:
 
         // 定义常量参数
         constexpr size_type init_capacity = 16; // 默认初始容量（2的幂）
-        constexpr size_type growth_factor = 3;   // 指数增长因子(1.5 * 2 避免浮点运算)
-        constexpr size_type growth_threshold = 256; // 增长阈值
-        constexpr size_type growth_amount = 64; // 固定增长量
+        constexpr size_type growth_factor = 2;   // 每次至少增长当前容量的 1 / growth_factor
 
         size_type new_capacity = size; // 实际应当分配的容量
 
@@ -638,8 +637,8 @@ public:
         {
             new_capacity = std::max(size, init_capacity);
         }
-        // 小容量策略（当前容量 < 阈值）：使用1.5倍增长
-        else if (m_capacity < growth_threshold)
+        // 按 1.5 倍增长，逐个添加元素的均摊开销为常数
+        else
         {
             // 使用整数运算计算1.5倍增长
             new_capacity = m_capacity + (m_capacity + 1) / growth_factor;
@@ -654,17 +653,6 @@ public:
                 new_capacity = size;
             }
         }
-        // 大容量策略（当前容量 >= 阈值）：使用固定大小增长
-        else
-        {
-            // 固定大小增长容量
-            new_capacity = m_capacity + growth_amount;
-            // 确保不小于请求容量
-            if (new_capacity < size)
-            {
-                new_capacity = size;
-            }
-        }
 
         // 分配新内存
         Type* new_data = m_alloc.Allocate<Type>(new_capacity);
@@ -733,7 +721,7 @@ public:
         }
         else
         {
-            m_data = m_alloc.Allocate(m_size);
+            m_data = m_alloc.Allocate<Type>(m_size);
         }
         if (old_capacity != 0) [[likely]]
         {
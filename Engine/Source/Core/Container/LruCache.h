@@ -0,0 +1,477 @@
+#pragma once
+
+#include "Core.h"
+#include "Platform.h"
+#include "HashMap.h"
+#include "Allocator/Allocator.h"
+
+#include <mutex>
+#include <memory>
+#include <utility>
+#include <functional>
+#include <stdexcept>
+
+/// <summary>
+/// 默认的缓存代价函数：每个条目代价为 1，预算即为条目数量
+/// </summary>
+struct LruUnitCost
+{
+    template<class KeyType, class ValueType>
+    constexpr int64 operator()(const KeyType&, const ValueType&) const
+    {
+        return 1;
+    }
+};
+
+/// <summary>
+/// 分片 LRU 缓存
+/// <para>每个分片由 HashMap 与侵入式双向链表组成，Get/Put 均为 O(1)，分片之间互不加锁</para>
+/// <para>按代价函数计算的总代价淘汰最久未使用的条目，可用于限制字节预算</para>
+/// <para>被固定(Pin)的条目会暂时移出淘汰链表，直到最后一次 Unpin</para>
+/// </summary>
+/// <typeparam name="KeyType">键类型</typeparam>
+/// <typeparam name="ValueType">值类型</typeparam>
+/// <typeparam name="CostType">代价函数类型，签名为 int64(const KeyType&amp;, const ValueType&amp;)</typeparam>
+template<class KeyType, class ValueType, class CostType = LruUnitCost>
+class LruCache
+{
+public:
+    using key_type = KeyType;
+    using mapped_type = ValueType;
+    using size_type = int64;
+public:
+    /// <summary>
+    /// 构造函数
+    /// <para>每个分片独立按自己的预算淘汰，单个条目的代价不能超过其所在分片的预算(budget / 分片数，见 MaxEntryCost)，
+    /// 否则即使总预算足够也无法缓存；条目代价可能接近总预算时应减少分片数量，shardCount = 1 时单个条目可使用全部预算</para>
+    /// </summary>
+    /// <param name="budget">总代价预算，平均分配给各分片</param>
+    /// <param name="shardCount">分片数量，会向上取整为 2 的幂</param>
+    /// <param name="cost">代价函数</param>
+    /// <exception cref="std::invalid_argument">预算或分片数量不大于 0 时抛出</exception>
+    explicit LruCache(size_type budget, size_type shardCount = 16, const CostType& cost = CostType())
+        : m_cost(cost)
+    {
+        if (budget <= 0 || shardCount <= 0) [[unlikely]]
+        {
+            throw std::invalid_argument("LruCache budget and shard count must be positive");
+        }
+        size_type count = 1;
+        while (count < shardCount)
+        {
+            count <<= 1;
+        }
+        // 预算过小时减少分片，保证每个分片至少有 1 的预算
+        while (count > 1 && budget / count == 0)
+        {
+            count >>= 1;
+        }
+        m_shardMask = count - 1;
+        m_shards = std::make_unique<Shard[]>(count);
+        for (size_type i = 0; i != count; i++)
+        {
+            m_shards[i].Budget = budget / count + (i < budget % count ? 1 : 0);
+        }
+    }
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~LruCache()
+    {
+        for (size_type i = 0; i <= m_shardMask; i++)
+        {
+            _ClearShard(m_shards[i], true);
+        }
+    }
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    LruCache(const LruCache& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    LruCache& operator=(const LruCache& other) = delete;
+    /// <summary>
+    /// 禁止移动构造(其他线程可能持有缓存引用)
+    /// </summary>
+    LruCache(LruCache&& other) = delete;
+    /// <summary>
+    /// 禁止移动赋值
+    /// </summary>
+    LruCache& operator=(LruCache&& other) = delete;
+public:
+    /// <summary>
+    /// 查找键对应的值并标记为最近使用
+    /// </summary>
+    /// <param name="key">键</param>
+    /// <param name="value">接收值的拷贝</param>
+    /// <returns>不存在返回 false</returns>
+    bool Get(const KeyType& key, ValueType& value)
+    {
+        Shard& shard = _ShardOf(key);
+        std::lock_guard lock(shard.Mutex);
+
+        auto iter = shard.Index.Find(key);
+        if (iter == shard.Index.end())
+        {
+            return false;
+        }
+        Node* node = iter->second;
+        if (node->PinCount == 0)
+        {
+            _Unlink(shard, node);
+            _LinkFront(shard, node);
+        }
+        value = node->Value;
+        return true;
+    }
+    /// <summary>
+    /// 检查是否包含指定键(不改变使用顺序)
+    /// </summary>
+    /// <param name="key">键</param>
+    /// <returns>存在返回 true</returns>
+    bool Contains(const KeyType& key) const
+    {
+        Shard& shard = _ShardOf(key);
+        std::lock_guard lock(shard.Mutex);
+        return shard.Index.Contains(key);
+    }
+    /// <summary>
+    /// 插入或替换键值对，并按预算淘汰最久未使用的条目
+    /// </summary>
+    /// <param name="key">键</param>
+    /// <param name="value">值</param>
+    /// <returns>
+    /// 以下情况不缓存并返回 false：键已被固定；代价超过所在分片的预算减去分片中固定条目的代价。
+    /// 分片预算为 总预算 / 分片数(向下取整，余数分给前面的分片)，默认 16 个分片时单个条目最多使用总预算的 1/16，
+    /// 没有固定条目时代价不超过 MaxEntryCost() 的条目总能缓存
+    /// </returns>
+    bool Put(const KeyType& key, ValueType value)
+    {
+        const size_type cost = m_cost(key, value);
+        Shard& shard = _ShardOf(key);
+        std::lock_guard lock(shard.Mutex);
+
+        // 固定条目不参与淘汰，超出剩余预算的新条目插入后会立即被淘汰
+        if (cost > shard.Budget - shard.PinnedCost)
+        {
+            return false;
+        }
+
+        auto iter = shard.Index.Find(key);
+        if (iter != shard.Index.end())
+        {
+            Node* node = iter->second;
+            if (node->PinCount != 0)
+            {
+                return false;
+            }
+            shard.Cost += cost - node->Cost;
+            node->Value = std::move(value);
+            node->Cost = cost;
+            _Unlink(shard, node);
+            _LinkFront(shard, node);
+        }
+        else
+        {
+            Node* node = m_alloc.Allocate<Node>(1);
+            std::construct_at(node, key, std::move(value), cost);
+            shard.Index.Emplace(key, node);
+            shard.Cost += cost;
+            shard.Count++;
+            _LinkFront(shard, node);
+        }
+        _Evict(shard);
+        return true;
+    }
+    /// <summary>
+    /// 移除指定键
+    /// </summary>
+    /// <param name="key">键</param>
+    /// <returns>不存在或已被固定返回 false</returns>
+    bool Remove(const KeyType& key)
+    {
+        Shard& shard = _ShardOf(key);
+        std::lock_guard lock(shard.Mutex);
+
+        auto iter = shard.Index.Find(key);
+        if (iter == shard.Index.end() || iter->second->PinCount != 0)
+        {
+            return false;
+        }
+        Node* node = iter->second;
+        shard.Index.Erase(iter);
+        _Unlink(shard, node);
+        _Destroy(shard, node);
+        return true;
+    }
+    /// <summary>
+    /// 固定指定键，使其不会被淘汰、替换或移除
+    /// <para>返回的指针在对应的 Unpin 之前一直有效，读写该值需由调用方自行同步</para>
+    /// </summary>
+    /// <param name="key">键</param>
+    /// <returns>指向缓存值的指针，不存在返回 nullptr</returns>
+    ValueType* Pin(const KeyType& key)
+    {
+        Shard& shard = _ShardOf(key);
+        std::lock_guard lock(shard.Mutex);
+
+        auto iter = shard.Index.Find(key);
+        if (iter == shard.Index.end())
+        {
+            return nullptr;
+        }
+        Node* node = iter->second;
+        if (node->PinCount++ == 0)
+        {
+            // 固定期间移出淘汰链表，保证淘汰操作不必跳过固定条目
+            _Unlink(shard, node);
+            shard.PinnedCost += node->Cost;
+        }
+        return &node->Value;
+    }
+    /// <summary>
+    /// 解除一次固定，最后一次解除后条目重新成为最近使用并参与淘汰
+    /// </summary>
+    /// <param name="key">键</param>
+    /// <returns>不存在或未被固定返回 false</returns>
+    bool Unpin(const KeyType& key)
+    {
+        Shard& shard = _ShardOf(key);
+        std::lock_guard lock(shard.Mutex);
+
+        auto iter = shard.Index.Find(key);
+        if (iter == shard.Index.end() || iter->second->PinCount == 0)
+        {
+            return false;
+        }
+        Node* node = iter->second;
+        if (--node->PinCount == 0)
+        {
+            shard.PinnedCost -= node->Cost;
+            _LinkFront(shard, node);
+            // 固定期间可能因其他条目插入而超出预算
+            _Evict(shard);
+        }
+        return true;
+    }
+    /// <summary>
+    /// 移除所有未被固定的条目
+    /// </summary>
+    void Clear()
+    {
+        for (size_type i = 0; i <= m_shardMask; i++)
+        {
+            std::lock_guard lock(m_shards[i].Mutex);
+            _ClearShard(m_shards[i], false);
+        }
+    }
+    /// <summary>
+    /// 获取条目数量(并发时仅为近似值)
+    /// </summary>
+    /// <returns>条目数量</returns>
+    size_type Size() const
+    {
+        size_type count = 0;
+        for (size_type i = 0; i <= m_shardMask; i++)
+        {
+            std::lock_guard lock(m_shards[i].Mutex);
+            count += m_shards[i].Count;
+        }
+        return count;
+    }
+    /// <summary>
+    /// 获取当前总代价(并发时仅为近似值)
+    /// </summary>
+    /// <returns>总代价</returns>
+    size_type Cost() const
+    {
+        size_type cost = 0;
+        for (size_type i = 0; i <= m_shardMask; i++)
+        {
+            std::lock_guard lock(m_shards[i].Mutex);
+            cost += m_shards[i].Cost;
+        }
+        return cost;
+    }
+    /// <summary>
+    /// 获取总代价预算
+    /// </summary>
+    /// <returns>总代价预算</returns>
+    size_type Budget() const
+    {
+        size_type budget = 0;
+        for (size_type i = 0; i <= m_shardMask; i++)
+        {
+            budget += m_shards[i].Budget;
+        }
+        return budget;
+    }
+    /// <summary>
+    /// 获取没有固定条目时任意键都能缓存的最大条目代价，即最小的分片预算
+    /// </summary>
+    /// <returns>最大条目代价</returns>
+    size_type MaxEntryCost() const
+    {
+        return m_shards[m_shardMask].Budget;
+    }
+    /// <summary>
+    /// 获取分片数量
+    /// </summary>
+    /// <returns>分片数量</returns>
+    size_type ShardCount() const
+    {
+        return m_shardMask + 1;
+    }
+    /// <summary>
+    /// 检查缓存是否为空
+    /// </summary>
+    /// <returns>true表示缓存为空</returns>
+    bool IsEmpty() const
+    {
+        return Size() == 0;
+    }
+private:
+    /// <summary>
+    /// 缓存条目，同时作为侵入式链表节点
+    /// </summary>
+    struct Node
+    {
+        Node(const KeyType& key, ValueType&& value, size_type cost)
+            : Key(key)
+            , Value(std::move(value))
+            , Cost(cost)
+        {
+
+        }
+
+        KeyType Key;
+        ValueType Value;
+        size_type Cost = 0;
+        size_type PinCount = 0;
+        Node* Prev = nullptr;
+        Node* Next = nullptr;
+    };
+    /// <summary>
+    /// 缓存分片
+    /// </summary>
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) Shard
+    {
+        mutable std::mutex Mutex;
+        HashMap<KeyType, Node*> Index;
+        // 最近使用的条目
+        Node* Head = nullptr;
+        // 最久未使用的条目
+        Node* Tail = nullptr;
+        size_type Count = 0;
+        size_type Cost = 0;
+        // 被固定条目的代价(包含在 Cost 中)
+        size_type PinnedCost = 0;
+        size_type Budget = 0;
+    };
+private:
+    /// <summary>
+    /// 获取键所在的分片
+    /// </summary>
+    Shard& _ShardOf(const KeyType& key) const
+    {
+        // 混合哈希高位选择分片，避免与 HashMap 桶选择使用相同的低位
+        const uint64 hash = static_cast<uint64>(std::hash<KeyType>{}(key)) * 0x9E3779B97F4A7C15ull;
+        return m_shards[static_cast<size_type>(hash >> 32) & m_shardMask];
+    }
+    /// <summary>
+    /// 将节点链接到链表头部
+    /// </summary>
+    static void _LinkFront(Shard& shard, Node* node)
+    {
+        node->Prev = nullptr;
+        node->Next = shard.Head;
+        if (shard.Head)
+        {
+            shard.Head->Prev = node;
+        }
+        shard.Head = node;
+        if (!shard.Tail)
+        {
+            shard.Tail = node;
+        }
+    }
+    /// <summary>
+    /// 将节点从链表中断开
+    /// </summary>
+    static void _Unlink(Shard& shard, Node* node)
+    {
+        if (node->Prev)
+        {
+            node->Prev->Next = node->Next;
+        }
+        else
+        {
+            shard.Head = node->Next;
+        }
+        if (node->Next)
+        {
+            node->Next->Prev = node->Prev;
+        }
+        else
+        {
+            shard.Tail = node->Prev;
+        }
+        node->Prev = nullptr;
+        node->Next = nullptr;
+    }
+    /// <summary>
+    /// 从链表尾部淘汰条目直到满足预算
+    /// </summary>
+    void _Evict(Shard& shard)
+    {
+        while (shard.Cost > shard.Budget && shard.Tail)
+        {
+            Node* node = shard.Tail;
+            _Unlink(shard, node);
+            shard.Index.Erase(node->Key);
+            _Destroy(shard, node);
+        }
+    }
+    /// <summary>
+    /// 销毁节点并更新分片统计
+    /// </summary>
+    void _Destroy(Shard& shard, Node* node)
+    {
+        shard.Cost -= node->Cost;
+        shard.Count--;
+        std::destroy_at(node);
+        m_alloc.Deallocate(node, 1);
+    }
+    /// <summary>
+    /// 清空分片
+    /// </summary>
+    /// <param name="shard">分片</param>
+    /// <param name="all">为 true 时连同固定条目一起销毁</param>
+    void _ClearShard(Shard& shard, bool all)
+    {
+        while (Node* node = shard.Head)
+        {
+            _Unlink(shard, node);
+            shard.Index.Erase(node->Key);
+            _Destroy(shard, node);
+        }
+        if (all)
+        {
+            for (auto& pair : shard.Index)
+            {
+                _Destroy(shard, pair.second);
+            }
+            shard.Index.Clear();
+        }
+    }
+private:
+    // 分片数组
+    std::unique_ptr<Shard[]> m_shards;
+    // 分片掩码
+    size_type m_shardMask = 0;
+    // 代价函数
+    CostType m_cost;
+    // 节点分配器
+    Allocator m_alloc = Allocator();
+};
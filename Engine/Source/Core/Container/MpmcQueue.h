@@ -0,0 +1,451 @@
+#pragma once
+
+#include "Core.h"
+#include "Platform.h"
+#include "Allocator/Allocator.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+
+/// <summary>
+/// 有界无锁多生产者多消费者队列
+/// <para>每个槽位保存一个序号，生产者和消费者通过序号判断槽位状态，只在读写索引上竞争一次 CAS</para>
+/// <para>批量接口一次 CAS 认领多个连续槽位</para>
+/// </summary>
+/// <typeparam name="Type">元素类型</typeparam>
+template<class Type>
+class MpmcQueue
+{
+public:
+    using value_type = Type;
+    using size_type = int64;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+public:
+    /// <summary>
+    /// 构造函数，指定队列容量
+    /// </summary>
+    /// <param name="capacity">队列容量，会向上取整为 2 的幂</param>
+    /// <exception cref="std::invalid_argument">容量不大于 0 时抛出</exception>
+    explicit MpmcQueue(size_type capacity)
+    {
+        if (capacity <= 0) [[unlikely]]
+        {
+            throw std::invalid_argument("MpmcQueue capacity must be positive");
+        }
+        m_capacity = 1;
+        while (m_capacity < capacity)
+        {
+            m_capacity <<= 1;
+        }
+        m_mask = m_capacity - 1;
+        m_slots = m_alloc.Allocate<Slot>(m_capacity);
+        for (size_type i = 0; i != m_capacity; i++)
+        {
+            std::construct_at(&m_slots[i].Sequence, i);
+        }
+    }
+    /// <summary>
+    /// 析构函数，销毁队列中剩余的元素
+    /// </summary>
+    ~MpmcQueue()
+    {
+        const size_type tail = m_tail.load(std::memory_order_relaxed);
+        for (size_type i = m_head.load(std::memory_order_relaxed); i != tail; i++)
+        {
+            std::destroy_at(_Value(m_slots[i & m_mask]));
+        }
+        for (size_type i = 0; i != m_capacity; i++)
+        {
+            std::destroy_at(&m_slots[i].Sequence);
+        }
+        m_alloc.Deallocate(m_slots, m_capacity);
+    }
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    MpmcQueue(const MpmcQueue& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    MpmcQueue& operator=(const MpmcQueue& other) = delete;
+    /// <summary>
+    /// 禁止移动构造(其他线程可能持有队列引用)
+    /// </summary>
+    MpmcQueue(MpmcQueue&& other) = delete;
+    /// <summary>
+    /// 禁止移动赋值
+    /// </summary>
+    MpmcQueue& operator=(MpmcQueue&& other) = delete;
+public:
+    /// <summary>
+    /// 尝试在队尾添加一个元素(拷贝语义)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    /// <returns>队列已满返回 false</returns>
+    bool TryPush(const Type& value)
+    {
+        return TryEmplace(value);
+    }
+    /// <summary>
+    /// 尝试在队尾添加一个元素(移动语义)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    /// <returns>队列已满返回 false</returns>
+    bool TryPush(Type&& value)
+    {
+        return TryEmplace(std::move(value));
+    }
+    /// <summary>
+    /// 尝试在队尾就地构造一个元素
+    /// </summary>
+    /// <param name="args">构造元素的参数</param>
+    /// <returns>队列已满返回 false</returns>
+    template<class... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        size_type pos = m_tail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true)
+        {
+            slot = &m_slots[pos & m_mask];
+            const size_type seq = slot->Sequence.load(std::memory_order_acquire);
+            const size_type diff = seq - pos;
+            if (diff == 0)
+            {
+                // 槽位空闲，尝试认领
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // 槽位仍被上一轮元素占用，队列已满
+                return false;
+            }
+            else
+            {
+                // 其他生产者已认领该位置，重新读取写索引
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        std::construct_at(_Value(*slot), std::forward<Args>(args)...);
+        slot->Sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    /// <summary>
+    /// 在队尾添加一个元素，队列已满时等待(拷贝语义)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    void Push(const Type& value)
+    {
+        for (int32 spin = 0; !TryPush(value); spin++)
+        {
+            _Backoff(spin);
+        }
+    }
+    /// <summary>
+    /// 在队尾添加一个元素，队列已满时等待(移动语义)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    void Push(Type&& value)
+    {
+        for (int32 spin = 0; !TryPush(std::move(value)); spin++)
+        {
+            _Backoff(spin);
+        }
+    }
+    /// <summary>
+    /// 尝试从队头取出一个元素
+    /// </summary>
+    /// <param name="value">接收取出元素的对象</param>
+    /// <returns>队列为空返回 false</returns>
+    bool TryPop(Type& value)
+    {
+        size_type pos = m_head.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true)
+        {
+            slot = &m_slots[pos & m_mask];
+            const size_type seq = slot->Sequence.load(std::memory_order_acquire);
+            const size_type diff = seq - (pos + 1);
+            if (diff == 0)
+            {
+                // 槽位已写入，尝试认领
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // 槽位尚未写入，队列为空
+                return false;
+            }
+            else
+            {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+        Type* ptr = _Value(*slot);
+        value = std::move(*ptr);
+        std::destroy_at(ptr);
+        slot->Sequence.store(pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+    /// <summary>
+    /// 从队头取出一个元素，队列为空时等待
+    /// </summary>
+    /// <param name="value">接收取出元素的对象</param>
+    void Pop(Type& value)
+    {
+        for (int32 spin = 0; !TryPop(value); spin++)
+        {
+            _Backoff(spin);
+        }
+    }
+    /// <summary>
+    /// 尝试批量添加元素(拷贝语义)
+    /// <para>一次 CAS 认领所有连续空闲槽位</para>
+    /// </summary>
+    /// <param name="values">源元素数组</param>
+    /// <param name="count">源元素数量</param>
+    /// <returns>实际添加的元素数量，队列已满返回 0</returns>
+    size_type TryPushBatch(const Type* values, size_type count)
+    {
+        size_type pos = 0;
+        const size_type n = _ClaimWrite(pos, count);
+        for (size_type i = 0; i != n; i++)
+        {
+            Slot& slot = m_slots[(pos + i) & m_mask];
+            std::construct_at(_Value(slot), values[i]);
+            slot.Sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 尝试批量添加元素(移动语义)
+    /// <para>一次 CAS 认领所有连续空闲槽位，被添加的源元素处于已移动状态</para>
+    /// </summary>
+    /// <param name="values">源元素数组</param>
+    /// <param name="count">源元素数量</param>
+    /// <returns>实际添加的元素数量，队列已满返回 0</returns>
+    size_type TryPushBatchMove(Type* values, size_type count)
+    {
+        size_type pos = 0;
+        const size_type n = _ClaimWrite(pos, count);
+        for (size_type i = 0; i != n; i++)
+        {
+            Slot& slot = m_slots[(pos + i) & m_mask];
+            std::construct_at(_Value(slot), std::move(values[i]));
+            slot.Sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 批量添加元素，直到全部添加完成(拷贝语义)
+    /// </summary>
+    /// <param name="values">源元素数组</param>
+    /// <param name="count">源元素数量</param>
+    void PushBatch(const Type* values, size_type count)
+    {
+        size_type done = 0;
+        for (int32 spin = 0; done < count; spin++)
+        {
+            const size_type n = TryPushBatch(values + done, count - done);
+            if (n != 0)
+            {
+                done += n;
+                spin = 0;
+            }
+            else
+            {
+                _Backoff(spin);
+            }
+        }
+    }
+    /// <summary>
+    /// 尝试批量取出元素
+    /// <para>一次 CAS 认领所有连续已写入槽位</para>
+    /// </summary>
+    /// <param name="values">接收元素的数组，元素须已构造</param>
+    /// <param name="count">最多取出的元素数量</param>
+    /// <returns>实际取出的元素数量，队列为空返回 0</returns>
+    size_type TryPopBatch(Type* values, size_type count)
+    {
+        size_type pos = 0;
+        const size_type n = _ClaimRead(pos, count);
+        for (size_type i = 0; i != n; i++)
+        {
+            Slot& slot = m_slots[(pos + i) & m_mask];
+            Type* ptr = _Value(slot);
+            values[i] = std::move(*ptr);
+            std::destroy_at(ptr);
+            slot.Sequence.store(pos + i + m_capacity, std::memory_order_release);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 批量取出元素，队列为空时等待直到至少取出一个元素
+    /// </summary>
+    /// <param name="values">接收元素的数组，元素须已构造</param>
+    /// <param name="count">最多取出的元素数量</param>
+    /// <returns>实际取出的元素数量</returns>
+    size_type PopBatch(Type* values, size_type count)
+    {
+        if (count <= 0) return 0;
+
+        size_type n = 0;
+        for (int32 spin = 0; (n = TryPopBatch(values, count)) == 0; spin++)
+        {
+            _Backoff(spin);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 获取队列当前元素数量(并发时仅为近似值)
+    /// </summary>
+    /// <returns>元素数量</returns>
+    size_type Size() const
+    {
+        const size_type head = m_head.load(std::memory_order_acquire);
+        const size_type tail = m_tail.load(std::memory_order_acquire);
+        return std::clamp<size_type>(tail - head, 0, m_capacity);
+    }
+    /// <summary>
+    /// 获取队列容量
+    /// </summary>
+    /// <returns>容量</returns>
+    size_type Capacity() const
+    {
+        return m_capacity;
+    }
+    /// <summary>
+    /// 检查队列是否为空(并发时仅为近似值)
+    /// </summary>
+    /// <returns>true表示队列为空</returns>
+    bool IsEmpty() const
+    {
+        return Size() == 0;
+    }
+private:
+    /// <summary>
+    /// 队列槽位
+    /// </summary>
+    struct Slot
+    {
+        // 槽位序号：等于位置表示空闲，等于位置 + 1 表示已写入
+        std::atomic<size_type> Sequence;
+        // 元素存储
+        alignas(Type) unsigned char Storage[sizeof(Type)];
+    };
+private:
+    /// <summary>
+    /// 获取槽位中的元素指针
+    /// </summary>
+    static Type* _Value(Slot& slot)
+    {
+        return std::launder(reinterpret_cast<Type*>(slot.Storage));
+    }
+    /// <summary>
+    /// 认领最多 count 个连续空闲槽位
+    /// </summary>
+    /// <param name="pos">输出认领的起始位置</param>
+    /// <param name="count">期望认领的数量</param>
+    /// <returns>实际认领的数量</returns>
+    size_type _ClaimWrite(size_type& pos, size_type count)
+    {
+        if (count <= 0) return 0;
+
+        count = std::min(count, m_capacity);
+        pos = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            // 统计从 pos 起连续空闲的槽位
+            size_type n = 0;
+            while (n < count && m_slots[(pos + n) & m_mask].Sequence.load(std::memory_order_acquire) == pos + n)
+            {
+                n++;
+            }
+            if (n == 0)
+            {
+                const size_type seq = m_slots[pos & m_mask].Sequence.load(std::memory_order_acquire);
+                if (seq < pos)
+                {
+                    return 0;
+                }
+                pos = m_tail.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                return n;
+            }
+        }
+    }
+    /// <summary>
+    /// 认领最多 count 个连续已写入槽位
+    /// </summary>
+    /// <param name="pos">输出认领的起始位置</param>
+    /// <param name="count">期望认领的数量</param>
+    /// <returns>实际认领的数量</returns>
+    size_type _ClaimRead(size_type& pos, size_type count)
+    {
+        if (count <= 0) return 0;
+
+        count = std::min(count, m_capacity);
+        pos = m_head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            // 统计从 pos 起连续已写入的槽位
+            size_type n = 0;
+            while (n < count && m_slots[(pos + n) & m_mask].Sequence.load(std::memory_order_acquire) == pos + n + 1)
+            {
+                n++;
+            }
+            if (n == 0)
+            {
+                const size_type seq = m_slots[pos & m_mask].Sequence.load(std::memory_order_acquire);
+                if (seq < pos + 1)
+                {
+                    return 0;
+                }
+                pos = m_head.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_head.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                return n;
+            }
+        }
+    }
+    /// <summary>
+    /// 阻塞等待时的退避策略：先自旋，再让出时间片
+    /// </summary>
+    static void _Backoff(int32 spin)
+    {
+        if (spin < 64)
+        {
+            return;
+        }
+        std::this_thread::yield();
+    }
+private:
+    // 消费者竞争的读索引
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_type> m_head = 0;
+    // 生产者竞争的写索引
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_type> m_tail = 0;
+    // 只读共享数据
+    alignas(PLATFORM_CACHE_LINE_SIZE) Slot* m_slots = nullptr;
+    size_type m_capacity = 0;
+    size_type m_mask = 0;
+    Allocator m_alloc = Allocator();
+};
@@ -0,0 +1,516 @@
+#pragma once
+
+#include "Core.h"
+#include "Array.h"
+
+#include <utility>
+#include <functional>
+#include <type_traits>
+#include <stdexcept>
+
+/// <summary>
+/// 基于 Array 的 4 叉堆优先队列
+/// <para>比较函数语义与 std::priority_queue 相同：Compare(a, b) 为 true 表示 a 的优先级低于 b，默认大顶堆</para>
+/// <para>启用索引(Indexed = true)后，Push 返回句柄，可通过句柄以 O(log n) 修改优先级或移除元素</para>
+/// <para>句柄由槽位与代数组成，槽位复用时代数递增，已移除元素的旧句柄不会指向复用该槽位的新元素</para>
+/// </summary>
+/// <typeparam name="Type">元素类型</typeparam>
+/// <typeparam name="Compare">比较函数类型</typeparam>
+/// <typeparam name="Indexed">是否维护句柄到堆位置的索引</typeparam>
+template<class Type, class Compare = std::less<Type>, bool Indexed = false>
+class PriorityQueue
+{
+public:
+    using value_type = Type;
+    using size_type = int64;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using handle_type = int64;
+public:
+    /// <summary>
+    /// 无效句柄
+    /// </summary>
+    static constexpr handle_type INVALID_HANDLE = -1;
+    /// <summary>
+    /// 堆的分叉数
+    /// </summary>
+    static constexpr size_type ARITY = 4;
+private:
+    // 句柄低 32 位为槽位，其上为代数
+    static constexpr int32 SLOT_BITS = 32;
+    static constexpr handle_type SLOT_MASK = (handle_type(1) << SLOT_BITS) - 1;
+    // 代数取 31 位，保证句柄非负
+    static constexpr uint32 GENERATION_MASK = 0x7FFFFFFF;
+public:
+    /// <summary>
+    /// 默认构造函数
+    /// </summary>
+    PriorityQueue() = default;
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~PriorityQueue() = default;
+    /// <summary>
+    /// 拷贝构造函数
+    /// </summary>
+    /// <param name="other">要拷贝的容器</param>
+    PriorityQueue(const PriorityQueue& other) = default;
+    /// <summary>
+    /// 拷贝赋值运算符
+    /// </summary>
+    /// <param name="other">要拷贝的容器</param>
+    /// <returns>this</returns>
+    PriorityQueue& operator=(const PriorityQueue& other) = default;
+    /// <summary>
+    /// 移动构造函数
+    /// </summary>
+    /// <param name="other">要移动的容器</param>
+    PriorityQueue(PriorityQueue&& other) = default;
+    /// <summary>
+    /// 移动赋值运算符
+    /// </summary>
+    /// <param name="other">要移动的容器</param>
+    /// <returns>this</returns>
+    PriorityQueue& operator=(PriorityQueue&& other) = default;
+    /// <summary>
+    /// 构造函数，指定比较函数
+    /// </summary>
+    /// <param name="compare">比较函数</param>
+    explicit PriorityQueue(const Compare& compare)
+        : m_compare(compare)
+    {
+
+    }
+    /// <summary>
+    /// 构造函数，从数组以 O(n) 建堆
+    /// </summary>
+    /// <param name="values">初始元素</param>
+    /// <param name="compare">比较函数</param>
+    explicit PriorityQueue(Array<Type> values, const Compare& compare = Compare())
+        : m_heap(std::move(values))
+        , m_compare(compare)
+    {
+        if constexpr (Indexed)
+        {
+            const size_type size = m_heap.Size();
+            m_handles.Reserve(size);
+            m_positions.Reserve(size);
+            m_generations.Reserve(size);
+            for (size_type i = 0; i != size; i++)
+            {
+                m_handles.Push(i);
+                m_positions.Push(i);
+                m_generations.Push(0);
+            }
+        }
+        for (size_type i = (m_heap.Size() - 2) / ARITY; i >= 0 && m_heap.Size() > 1; i--)
+        {
+            _SiftDown(i);
+        }
+    }
+public:
+    /// <summary>
+    /// 访问优先级最高的元素
+    /// </summary>
+    /// <returns>堆顶元素的const引用</returns>
+    /// <exception cref="std::out_of_range">容器为空时抛出</exception>
+    const Type& Top() const
+    {
+        if (m_heap.IsEmpty()) [[unlikely]]
+        {
+            throw std::out_of_range("PriorityQueue is empty");
+        }
+        return m_heap[0];
+    }
+    /// <summary>
+    /// 获取堆顶元素的句柄
+    /// </summary>
+    /// <returns>堆顶句柄，容器为空返回 INVALID_HANDLE</returns>
+    handle_type TopHandle() const requires Indexed
+    {
+        return m_heap.IsEmpty() ? INVALID_HANDLE : _MakeHandle(m_handles[0]);
+    }
+    /// <summary>
+    /// 添加元素(拷贝语义)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    /// <returns>元素句柄，未启用索引时返回 INVALID_HANDLE</returns>
+    handle_type Push(const Type& value)
+    {
+        return Emplace(value);
+    }
+    /// <summary>
+    /// 添加元素(移动语义)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    /// <returns>元素句柄，未启用索引时返回 INVALID_HANDLE</returns>
+    handle_type Push(Type&& value)
+    {
+        return Emplace(std::move(value));
+    }
+    /// <summary>
+    /// 就地构造元素
+    /// </summary>
+    /// <param name="args">构造元素的参数</param>
+    /// <returns>元素句柄，未启用索引时返回 INVALID_HANDLE</returns>
+    template<class... Args>
+    handle_type Emplace(Args&&... args)
+    {
+        const size_type index = m_heap.Size();
+        m_heap.Emplace(std::forward<Args>(args)...);
+
+        handle_type handle = INVALID_HANDLE;
+        if constexpr (Indexed)
+        {
+            const size_type slot = _AcquireSlot();
+            m_handles.Push(slot);
+            m_positions[slot] = index;
+            handle = _MakeHandle(slot);
+        }
+        _SiftUp(index);
+        return handle;
+    }
+    /// <summary>
+    /// 移除优先级最高的元素
+    /// </summary>
+    void Pop()
+    {
+        if (m_heap.IsEmpty()) return;
+        _RemoveAt(0);
+    }
+    /// <summary>
+    /// 尝试取出优先级最高的元素
+    /// </summary>
+    /// <param name="value">接收取出元素的对象</param>
+    /// <returns>容器为空返回 false</returns>
+    bool TryPop(Type& value)
+    {
+        if (m_heap.IsEmpty()) return false;
+
+        value = std::move(m_heap[0]);
+        _RemoveAt(0);
+        return true;
+    }
+    /// <summary>
+    /// 访问句柄对应的元素
+    /// </summary>
+    /// <param name="handle">元素句柄</param>
+    /// <returns>元素的const引用</returns>
+    /// <exception cref="std::out_of_range">句柄无效时抛出</exception>
+    const Type& Get(handle_type handle) const requires Indexed
+    {
+        return m_heap[_PositionOf(handle)];
+    }
+    /// <summary>
+    /// 修改句柄对应元素的值并恢复堆序(可提升或降低优先级)
+    /// </summary>
+    /// <param name="handle">元素句柄</param>
+    /// <param name="value">新值</param>
+    /// <exception cref="std::out_of_range">句柄无效时抛出</exception>
+    void Update(handle_type handle, Type value) requires Indexed
+    {
+        const size_type index = _PositionOf(handle);
+        const bool raise = m_compare(m_heap[index], value);
+        m_heap[index] = std::move(value);
+        if (raise)
+        {
+            _SiftUp(index);
+        }
+        else
+        {
+            _SiftDown(index);
+        }
+    }
+    /// <summary>
+    /// 提升句柄对应元素的优先级(新值的优先级不得低于原值)
+    /// <para>对于 std::greater 构成的小顶堆，即 decrease-key</para>
+    /// </summary>
+    /// <param name="handle">元素句柄</param>
+    /// <param name="value">新值</param>
+    /// <exception cref="std::out_of_range">句柄无效时抛出</exception>
+    void Raise(handle_type handle, Type value) requires Indexed
+    {
+        const size_type index = _PositionOf(handle);
+        m_heap[index] = std::move(value);
+        _SiftUp(index);
+    }
+    /// <summary>
+    /// 移除句柄对应的元素
+    /// </summary>
+    /// <param name="handle">元素句柄</param>
+    /// <returns>句柄无效返回 false</returns>
+    bool Remove(handle_type handle) requires Indexed
+    {
+        if (!Contains(handle)) return false;
+
+        _RemoveAt(m_positions[handle & SLOT_MASK]);
+        return true;
+    }
+    /// <summary>
+    /// 检查句柄是否仍在队列中
+    /// </summary>
+    /// <param name="handle">元素句柄</param>
+    /// <returns>存在返回 true，元素已移除(即使槽位已被复用)返回 false</returns>
+    bool Contains(handle_type handle) const requires Indexed
+    {
+        if (handle < 0) return false;
+
+        const size_type slot = handle & SLOT_MASK;
+        return slot < m_positions.Size()
+            && m_positions[slot] >= 0
+            && m_generations[slot] == static_cast<uint32>(handle >> SLOT_BITS);
+    }
+    /// <summary>
+    /// 获取容器当前元素数量
+    /// </summary>
+    /// <returns>元素数量</returns>
+    size_type Size() const
+    {
+        return m_heap.Size();
+    }
+    /// <summary>
+    /// 检查容器是否为空
+    /// </summary>
+    /// <returns>true表示容器为空</returns>
+    bool IsEmpty() const
+    {
+        return m_heap.IsEmpty();
+    }
+    /// <summary>
+    /// 预留存储空间
+    /// </summary>
+    /// <param name="size">期望的最小容量</param>
+    void Reserve(size_type size)
+    {
+        m_heap.Reserve(size);
+        if constexpr (Indexed)
+        {
+            m_handles.Reserve(size);
+            m_positions.Reserve(size);
+            m_generations.Reserve(size);
+        }
+    }
+    /// <summary>
+    /// 清空容器(所有句柄失效)
+    /// </summary>
+    void Clear()
+    {
+        m_heap.Clear();
+        m_handles.Clear();
+        if constexpr (Indexed)
+        {
+            // 保留槽位与代数，释放仍在使用的槽位，使清空前的句柄失效
+            for (size_type slot = 0; slot != m_positions.Size(); slot++)
+            {
+                if (m_positions[slot] >= 0)
+                {
+                    _ReleaseSlot(slot);
+                }
+            }
+        }
+    }
+    /// <summary>
+    /// 获取按堆序存储的底层数组
+    /// </summary>
+    /// <returns>底层数组的const引用</returns>
+    const Array<Type>& Data() const
+    {
+        return m_heap;
+    }
+    /// <summary>
+    /// 交换两个容器的内容
+    /// </summary>
+    /// <param name="other">要交换的另一个容器</param>
+    void Swap(PriorityQueue& other)
+    {
+        m_heap.Swap(other.m_heap);
+        m_handles.Swap(other.m_handles);
+        m_positions.Swap(other.m_positions);
+        m_generations.Swap(other.m_generations);
+        m_freeSlots.Swap(other.m_freeSlots);
+        std::swap(m_compare, other.m_compare);
+    }
+private:
+    /// <summary>
+    /// 将 index 处的元素上浮到正确位置
+    /// </summary>
+    void _SiftUp(size_type index)
+    {
+        if (index == 0) return;
+
+        Type value = std::move(m_heap[index]);
+        size_type slot = -1;
+        if constexpr (Indexed)
+        {
+            slot = m_handles[index];
+        }
+        // 空穴法：父节点依次下移，最后一次性放入
+        while (index > 0)
+        {
+            const size_type parent = (index - 1) / ARITY;
+            if (!m_compare(m_heap[parent], value))
+            {
+                break;
+            }
+            _MoveSlot(index, parent);
+            index = parent;
+        }
+        _PlaceSlot(index, std::move(value), slot);
+    }
+    /// <summary>
+    /// 将 index 处的元素下沉到正确位置
+    /// </summary>
+    void _SiftDown(size_type index)
+    {
+        const size_type size = m_heap.Size();
+        if (index * ARITY + 1 >= size) return;
+
+        Type value = std::move(m_heap[index]);
+        size_type slot = -1;
+        if constexpr (Indexed)
+        {
+            slot = m_handles[index];
+        }
+        while (true)
+        {
+            const size_type first = index * ARITY + 1;
+            if (first >= size)
+            {
+                break;
+            }
+            // 4 个子节点在内存中连续，选出优先级最高者
+            const size_type last = std::min(first + ARITY, size);
+            size_type best = first;
+            for (size_type child = first + 1; child < last; child++)
+            {
+                if (m_compare(m_heap[best], m_heap[child]))
+                {
+                    best = child;
+                }
+            }
+            if (!m_compare(value, m_heap[best]))
+            {
+                break;
+            }
+            _MoveSlot(index, best);
+            index = best;
+        }
+        _PlaceSlot(index, std::move(value), slot);
+    }
+    /// <summary>
+    /// 移除 index 处的元素，用末尾元素填补并恢复堆序
+    /// </summary>
+    void _RemoveAt(size_type index)
+    {
+        const size_type last = m_heap.Size() - 1;
+        if constexpr (Indexed)
+        {
+            _ReleaseSlot(m_handles[index]);
+        }
+        if (index != last)
+        {
+            m_heap[index] = std::move(m_heap[last]);
+            if constexpr (Indexed)
+            {
+                m_handles[index] = m_handles[last];
+                m_positions[m_handles[index]] = index;
+            }
+        }
+        m_heap.Pop();
+        if constexpr (Indexed)
+        {
+            m_handles.Pop();
+        }
+        if (index != last)
+        {
+            // 填补元素可能需要上浮(按句柄删除时)或下沉
+            if (index > 0 && m_compare(m_heap[(index - 1) / ARITY], m_heap[index]))
+            {
+                _SiftUp(index);
+            }
+            else
+            {
+                _SiftDown(index);
+            }
+        }
+    }
+    /// <summary>
+    /// 将 from 处的元素移动到 to 处
+    /// </summary>
+    void _MoveSlot(size_type to, size_type from)
+    {
+        m_heap[to] = std::move(m_heap[from]);
+        if constexpr (Indexed)
+        {
+            m_handles[to] = m_handles[from];
+            m_positions[m_handles[to]] = to;
+        }
+    }
+    /// <summary>
+    /// 将元素放入 index 处
+    /// </summary>
+    void _PlaceSlot(size_type index, Type&& value, size_type slot)
+    {
+        m_heap[index] = std::move(value);
+        if constexpr (Indexed)
+        {
+            m_handles[index] = slot;
+            m_positions[slot] = index;
+        }
+    }
+    /// <summary>
+    /// 分配一个槽位，优先复用已释放的槽位
+    /// </summary>
+    size_type _AcquireSlot()
+    {
+        if (!m_freeSlots.IsEmpty())
+        {
+            const size_type slot = m_freeSlots.Back();
+            m_freeSlots.Pop();
+            return slot;
+        }
+        m_positions.Push(-1);
+        m_generations.Push(0);
+        return m_positions.Size() - 1;
+    }
+    /// <summary>
+    /// 释放槽位并递增代数，使指向该槽位的句柄失效
+    /// </summary>
+    void _ReleaseSlot(size_type slot)
+    {
+        m_positions[slot] = -1;
+        m_generations[slot] = (m_generations[slot] + 1) & GENERATION_MASK;
+        m_freeSlots.Push(slot);
+    }
+    /// <summary>
+    /// 由槽位与当前代数生成句柄
+    /// </summary>
+    handle_type _MakeHandle(size_type slot) const
+    {
+        return static_cast<handle_type>(m_generations[slot]) << SLOT_BITS | slot;
+    }
+    /// <summary>
+    /// 获取句柄对应的堆位置
+    /// </summary>
+    size_type _PositionOf(handle_type handle) const
+    {
+        if (!Contains(handle)) [[unlikely]]
+        {
+            throw std::out_of_range("Invalid PriorityQueue handle");
+        }
+        return m_positions[handle & SLOT_MASK];
+    }
+private:
+    // 按堆序存储的元素
+    Array<Type> m_heap;
+    // 堆位置 -> 槽位
+    Array<size_type> m_handles;
+    // 槽位 -> 堆位置，-1 表示已移除
+    Array<size_type> m_positions;
+    // 槽位 -> 代数，槽位释放时递增
+    Array<uint32> m_generations;
+    // 可复用的槽位
+    Array<size_type> m_freeSlots;
+    // 比较函数
+    Compare m_compare = Compare();
+};
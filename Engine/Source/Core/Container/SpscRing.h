@@ -0,0 +1,310 @@
+#pragma once
+
+#include "Core.h"
+#include "Platform.h"
+#include "Allocator/Allocator.h"
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+
+/// <summary>
+/// 有界无锁单生产者单消费者环形队列
+/// <para>仅允许一个线程调用 Push 系列函数，另一个线程调用 Pop 系列函数</para>
+/// <para>读写索引位于不同缓存行，并各自缓存对方索引，只有在看似满/空时才读取对方的原子变量</para>
+/// </summary>
+/// <typeparam name="Type">元素类型</typeparam>
+template<class Type>
+class SpscRing
+{
+public:
+    using value_type = Type;
+    using size_type = int64;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+public:
+    /// <summary>
+    /// 构造函数，指定队列容量
+    /// </summary>
+    /// <param name="capacity">队列容量，会向上取整为 2 的幂</param>
+    /// <exception cref="std::invalid_argument">容量不大于 0 时抛出</exception>
+    explicit SpscRing(size_type capacity)
+    {
+        if (capacity <= 0) [[unlikely]]
+        {
+            throw std::invalid_argument("SpscRing capacity must be positive");
+        }
+        m_capacity = 1;
+        while (m_capacity < capacity)
+        {
+            m_capacity <<= 1;
+        }
+        m_mask = m_capacity - 1;
+        m_data = m_alloc.Allocate<Type>(m_capacity);
+    }
+    /// <summary>
+    /// 析构函数，销毁队列中剩余的元素
+    /// </summary>
+    ~SpscRing()
+    {
+        const size_type tail = m_tail.load(std::memory_order_relaxed);
+        for (size_type i = m_head.load(std::memory_order_relaxed); i != tail; i++)
+        {
+            std::destroy_at(&m_data[i & m_mask]);
+        }
+        m_alloc.Deallocate(m_data, m_capacity);
+    }
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    SpscRing(const SpscRing& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    SpscRing& operator=(const SpscRing& other) = delete;
+    /// <summary>
+    /// 禁止移动构造(其他线程可能持有队列引用)
+    /// </summary>
+    SpscRing(SpscRing&& other) = delete;
+    /// <summary>
+    /// 禁止移动赋值
+    /// </summary>
+    SpscRing& operator=(SpscRing&& other) = delete;
+public:
+    /// <summary>
+    /// 尝试在队尾添加一个元素(拷贝语义，仅生产者调用)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    /// <returns>队列已满返回 false</returns>
+    bool TryPush(const Type& value)
+    {
+        return TryEmplace(value);
+    }
+    /// <summary>
+    /// 尝试在队尾添加一个元素(移动语义，仅生产者调用)
+    /// </summary>
+    /// <param name="value">要添加的值</param>
+    /// <returns>队列已满返回 false</returns>
+    bool TryPush(Type&& value)
+    {
+        return TryEmplace(std::move(value));
+    }
+    /// <summary>
+    /// 尝试在队尾就地构造一个元素(仅生产者调用)
+    /// </summary>
+    /// <param name="args">构造元素的参数</param>
+    /// <returns>队列已满返回 false</returns>
+    template<class... Args>
+    bool TryEmplace(Args&&... args)
+    {
+        const size_type tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_capacity)
+        {
+            // 缓存的读索引显示已满，刷新后再判断
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_capacity)
+            {
+                return false;
+            }
+        }
+        std::construct_at(&m_data[tail & m_mask], std::forward<Args>(args)...);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    /// <summary>
+    /// 批量添加元素(拷贝语义，仅生产者调用)
+    /// <para>所有元素只发布一次写索引</para>
+    /// </summary>
+    /// <param name="values">源元素数组</param>
+    /// <param name="count">源元素数量</param>
+    /// <returns>实际添加的元素数量，可能小于 count</returns>
+    size_type PushBatch(const Type* values, size_type count)
+    {
+        const size_type tail = m_tail.load(std::memory_order_relaxed);
+        const size_type n = _ReserveWrite(tail, count);
+        for (size_type i = 0; i != n; i++)
+        {
+            std::construct_at(&m_data[(tail + i) & m_mask], values[i]);
+        }
+        if (n != 0)
+        {
+            m_tail.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 批量添加元素(移动语义，仅生产者调用)
+    /// <para>所有元素只发布一次写索引，被添加的源元素处于已移动状态</para>
+    /// </summary>
+    /// <param name="values">源元素数组</param>
+    /// <param name="count">源元素数量</param>
+    /// <returns>实际添加的元素数量，可能小于 count</returns>
+    size_type PushBatchMove(Type* values, size_type count)
+    {
+        const size_type tail = m_tail.load(std::memory_order_relaxed);
+        const size_type n = _ReserveWrite(tail, count);
+        for (size_type i = 0; i != n; i++)
+        {
+            std::construct_at(&m_data[(tail + i) & m_mask], std::move(values[i]));
+        }
+        if (n != 0)
+        {
+            m_tail.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 尝试从队头取出一个元素(仅消费者调用)
+    /// </summary>
+    /// <param name="value">接收取出元素的对象</param>
+    /// <returns>队列为空返回 false</returns>
+    bool TryPop(Type& value)
+    {
+        const size_type head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            // 缓存的写索引显示为空，刷新后再判断
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+        Type& slot = m_data[head & m_mask];
+        value = std::move(slot);
+        std::destroy_at(&slot);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    /// <summary>
+    /// 批量取出元素(仅消费者调用)
+    /// <para>所有元素只发布一次读索引</para>
+    /// </summary>
+    /// <param name="values">接收元素的数组，元素须已构造</param>
+    /// <param name="count">最多取出的元素数量</param>
+    /// <returns>实际取出的元素数量</returns>
+    size_type PopBatch(Type* values, size_type count)
+    {
+        const size_type head = m_head.load(std::memory_order_relaxed);
+        const size_type n = _ReserveRead(head, count);
+        for (size_type i = 0; i != n; i++)
+        {
+            Type& slot = m_data[(head + i) & m_mask];
+            values[i] = std::move(slot);
+            std::destroy_at(&slot);
+        }
+        if (n != 0)
+        {
+            m_head.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+    /// <summary>
+    /// 访问队头元素而不取出(仅消费者调用)
+    /// </summary>
+    /// <returns>指向队头元素的指针，队列为空返回 nullptr</returns>
+    Type* Front()
+    {
+        const size_type head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return nullptr;
+            }
+        }
+        return &m_data[head & m_mask];
+    }
+    /// <summary>
+    /// 丢弃队头元素(仅消费者调用，须先通过 Front 确认非空)
+    /// </summary>
+    void Discard()
+    {
+        const size_type head = m_head.load(std::memory_order_relaxed);
+        std::destroy_at(&m_data[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+    }
+    /// <summary>
+    /// 获取队列当前元素数量(并发时仅为近似值)
+    /// </summary>
+    /// <returns>元素数量</returns>
+    size_type Size() const
+    {
+        const size_type head = m_head.load(std::memory_order_acquire);
+        const size_type tail = m_tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+    /// <summary>
+    /// 获取队列容量
+    /// </summary>
+    /// <returns>容量</returns>
+    size_type Capacity() const
+    {
+        return m_capacity;
+    }
+    /// <summary>
+    /// 检查队列是否为空(并发时仅为近似值)
+    /// </summary>
+    /// <returns>true表示队列为空</returns>
+    bool IsEmpty() const
+    {
+        return Size() == 0;
+    }
+    /// <summary>
+    /// 检查队列是否已满(并发时仅为近似值)
+    /// </summary>
+    /// <returns>true表示队列已满</returns>
+    bool IsFull() const
+    {
+        return Size() == m_capacity;
+    }
+private:
+    /// <summary>
+    /// 计算生产者本次最多可写入的元素数量
+    /// </summary>
+    size_type _ReserveWrite(size_type tail, size_type count)
+    {
+        if (count <= 0) return 0;
+
+        size_type free = m_capacity - (tail - m_cachedHead);
+        if (free < count)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            free = m_capacity - (tail - m_cachedHead);
+        }
+        return std::min(free, count);
+    }
+    /// <summary>
+    /// 计算消费者本次最多可读取的元素数量
+    /// </summary>
+    size_type _ReserveRead(size_type head, size_type count)
+    {
+        if (count <= 0) return 0;
+
+        size_type used = m_cachedTail - head;
+        if (used < count)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            used = m_cachedTail - head;
+        }
+        return std::min(used, count);
+    }
+private:
+    // 消费者独占缓存行：读索引及缓存的写索引
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_type> m_head = 0;
+    size_type m_cachedTail = 0;
+    // 生产者独占缓存行：写索引及缓存的读索引
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_type> m_tail = 0;
+    size_type m_cachedHead = 0;
+    // 只读共享数据
+    alignas(PLATFORM_CACHE_LINE_SIZE) Type* m_data = nullptr;
+    size_type m_capacity = 0;
+    size_type m_mask = 0;
+    Allocator m_alloc = Allocator();
+};
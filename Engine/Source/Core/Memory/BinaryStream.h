@@ -0,0 +1,586 @@
+#pragma once
+
+#include "Core.h"
+#include "Platform.h"
+#include "ByteArray.h"
+#include "ByteView.h"
+#include "Container/Array.h"
+
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <stdexcept>
+
+/// <summary>
+/// 字节序
+/// </summary>
+enum class Endian
+{
+    Little,
+    Big,
+#ifdef PLATFORM_BIG_ENDIAN
+    Native = Big
+#else
+    Native = Little
+#endif
+};
+
+/// <summary>
+/// 二进制写入器
+/// <para>向 ByteArray 末尾追加数据，支持指定字节序、LEB128/ZigZag 变长整数以及平凡类型数组的整块写入</para>
+/// </summary>
+class BinaryWriter
+{
+public:
+    friend class BinaryReader;
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="buffer">目标字节数组，数据追加到其末尾</param>
+    /// <param name="endian">多字节数值的字节序</param>
+    explicit BinaryWriter(ByteArray& buffer, Endian endian = Endian::Little)
+        : m_buffer(buffer)
+        , m_endian(endian)
+    {
+
+    }
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    BinaryWriter(const BinaryWriter& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    BinaryWriter& operator=(const BinaryWriter& other) = delete;
+public:
+    /// <summary>
+    /// 写入一个算术类型或枚举类型的值
+    /// </summary>
+    /// <typeparam name="Type">值类型</typeparam>
+    /// <param name="value">要写入的值</param>
+    template<class Type>
+        requires std::is_arithmetic_v<Type> || std::is_enum_v<Type>
+    void Write(Type value)
+    {
+        if constexpr (sizeof(Type) > 1)
+        {
+            if (m_endian != Endian::Native)
+            {
+                value = _ByteSwap(value);
+            }
+        }
+        WriteBytes(reinterpret_cast<const byte*>(&value), sizeof(Type));
+    }
+    /// <summary>
+    /// 写入 LEB128 编码的无符号变长整数
+    /// </summary>
+    /// <param name="value">要写入的值</param>
+    void WriteVarUInt(uint64 value)
+    {
+        byte buffer[MAX_VARINT_SIZE];
+        int64 size = 0;
+        while (value >= 0x80)
+        {
+            buffer[size++] = static_cast<byte>(value | 0x80);
+            value >>= 7;
+        }
+        buffer[size++] = static_cast<byte>(value);
+        WriteBytes(buffer, size);
+    }
+    /// <summary>
+    /// 写入 ZigZag + LEB128 编码的有符号变长整数
+    /// </summary>
+    /// <param name="value">要写入的值</param>
+    void WriteVarInt(int64 value)
+    {
+        WriteVarUInt((static_cast<uint64>(value) << 1) ^ static_cast<uint64>(value >> 63));
+    }
+    /// <summary>
+    /// 写入原始字节
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    void WriteBytes(const byte* data, int64 size)
+    {
+        m_buffer.Append(data, size);
+    }
+    /// <summary>
+    /// 写入字节数组的全部内容(不含长度前缀)
+    /// </summary>
+    /// <param name="bytes">字节数组</param>
+    void WriteBytes(const ByteArray& bytes)
+    {
+        WriteBytes(bytes.Data(), bytes.Size());
+    }
+    /// <summary>
+    /// 写入字节视图的全部内容(不含长度前缀)
+    /// </summary>
+    /// <param name="bytes">字节视图</param>
+    void WriteBytes(const ByteView& bytes)
+    {
+        WriteBytes(bytes.Data(), bytes.Size());
+    }
+    /// <summary>
+    /// 写入变长整数表示的元素数量，随后写入所有元素
+    /// <para>平凡类型且字节序与本机一致时整块复制</para>
+    /// </summary>
+    /// <typeparam name="Type">元素类型，须为算术类型、枚举类型或平凡可复制类型</typeparam>
+    /// <param name="array">要写入的数组</param>
+    template<class Type>
+        requires std::is_trivially_copyable_v<Type>
+    void WriteArray(const Array<Type>& array)
+    {
+        WriteVarUInt(static_cast<uint64>(array.Size()));
+        WriteArray(array.Data(), array.Size());
+    }
+    /// <summary>
+    /// 写入连续元素(不含数量前缀)
+    /// <para>平凡类型且字节序与本机一致时整块复制</para>
+    /// </summary>
+    /// <typeparam name="Type">元素类型</typeparam>
+    /// <param name="data">元素指针</param>
+    /// <param name="count">元素数量</param>
+    template<class Type>
+        requires std::is_trivially_copyable_v<Type>
+    void WriteArray(const Type* data, int64 count)
+    {
+        if (count <= 0) return;
+
+        if constexpr (sizeof(Type) > 1 && (std::is_arithmetic_v<Type> || std::is_enum_v<Type>))
+        {
+            if (m_endian != Endian::Native)
+            {
+                m_buffer.Reserve(m_buffer.Size() + count * static_cast<int64>(sizeof(Type)));
+                for (int64 i = 0; i != count; i++)
+                {
+                    Write(data[i]);
+                }
+                return;
+            }
+        }
+        WriteBytes(reinterpret_cast<const byte*>(data), count * static_cast<int64>(sizeof(Type)));
+    }
+    /// <summary>
+    /// 预留空间，避免连续写入时多次扩容
+    /// </summary>
+    /// <param name="size">预计还要写入的字节数</param>
+    void Reserve(int64 size)
+    {
+        m_buffer.Reserve(m_buffer.Size() + size);
+    }
+    /// <summary>
+    /// 获取目标字节数组当前大小
+    /// </summary>
+    /// <returns>字节数</returns>
+    int64 Size() const
+    {
+        return m_buffer.Size();
+    }
+    /// <summary>
+    /// 获取字节序
+    /// </summary>
+    Endian GetEndian() const
+    {
+        return m_endian;
+    }
+    /// <summary>
+    /// 设置字节序
+    /// </summary>
+    void SetEndian(Endian endian)
+    {
+        m_endian = endian;
+    }
+public:
+    /// <summary>
+    /// 变长整数的最大字节数
+    /// </summary>
+    static constexpr int64 MAX_VARINT_SIZE = 10;
+private:
+    /// <summary>
+    /// 翻转值的字节序
+    /// </summary>
+    template<class Type>
+    static Type _ByteSwap(Type value)
+    {
+        if constexpr (std::is_enum_v<Type>)
+        {
+            using Underlying = std::underlying_type_t<Type>;
+            return static_cast<Type>(std::byteswap(static_cast<Underlying>(value)));
+        }
+        else if constexpr (std::is_floating_point_v<Type>)
+        {
+            using Bits = std::conditional_t<sizeof(Type) == 4, uint32, uint64>;
+            return std::bit_cast<Type>(std::byteswap(std::bit_cast<Bits>(value)));
+        }
+        else
+        {
+            return std::byteswap(value);
+        }
+    }
+private:
+    // 目标字节数组
+    ByteArray& m_buffer;
+    // 字节序
+    Endian m_endian = Endian::Little;
+};
+
+/// <summary>
+/// 二进制读取器
+/// <para>从 ByteArray、ByteView 或原始内存中顺序读取数据，所有读取均进行边界检查</para>
+/// <para>Read 系列函数越界时抛出异常，TryRead 系列函数越界时返回 false</para>
+/// </summary>
+class BinaryReader
+{
+public:
+    /// <summary>
+    /// 构造函数，读取原始内存(调用方须保证内存在读取期间有效)
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <param name="endian">多字节数值的字节序</param>
+    BinaryReader(const byte* data, int64 size, Endian endian = Endian::Little)
+        : m_data(data)
+        , m_size(size)
+        , m_endian(endian)
+    {
+
+    }
+    /// <summary>
+    /// 构造函数，读取字节数组(调用方须保证字节数组在读取期间有效)
+    /// </summary>
+    /// <param name="buffer">字节数组</param>
+    /// <param name="endian">多字节数值的字节序</param>
+    explicit BinaryReader(const ByteArray& buffer, Endian endian = Endian::Little)
+        : BinaryReader(buffer.Data(), buffer.Size(), endian)
+    {
+
+    }
+    /// <summary>
+    /// 构造函数，读取字节视图(读取器持有视图的引用计数，ReadView 返回零拷贝子视图)
+    /// </summary>
+    /// <param name="view">字节视图</param>
+    /// <param name="endian">多字节数值的字节序</param>
+    explicit BinaryReader(ByteView view, Endian endian = Endian::Little)
+        : m_view(std::move(view))
+        , m_endian(endian)
+    {
+        m_data = m_view.Data();
+        m_size = m_view.Size();
+    }
+public:
+    /// <summary>
+    /// 读取一个算术类型或枚举类型的值
+    /// </summary>
+    /// <typeparam name="Type">值类型</typeparam>
+    /// <returns>读取的值</returns>
+    /// <exception cref="std::out_of_range">剩余数据不足时抛出</exception>
+    template<class Type>
+        requires std::is_arithmetic_v<Type> || std::is_enum_v<Type>
+    Type Read()
+    {
+        Type value;
+        if (!TryRead(value)) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        return value;
+    }
+    /// <summary>
+    /// 尝试读取一个算术类型或枚举类型的值
+    /// </summary>
+    /// <typeparam name="Type">值类型</typeparam>
+    /// <param name="value">接收读取的值</param>
+    /// <returns>剩余数据不足返回 false，读取位置不变</returns>
+    template<class Type>
+        requires std::is_arithmetic_v<Type> || std::is_enum_v<Type>
+    bool TryRead(Type& value)
+    {
+        if (Remain() < static_cast<int64>(sizeof(Type))) [[unlikely]]
+        {
+            return false;
+        }
+        std::memcpy(&value, m_data + m_pos, sizeof(Type));
+        m_pos += sizeof(Type);
+        if constexpr (sizeof(Type) > 1)
+        {
+            if (m_endian != Endian::Native)
+            {
+                value = BinaryWriter::_ByteSwap(value);
+            }
+        }
+        return true;
+    }
+    /// <summary>
+    /// 读取 LEB128 编码的无符号变长整数
+    /// </summary>
+    /// <returns>读取的值</returns>
+    /// <exception cref="std::out_of_range">数据不足或编码无效时抛出</exception>
+    uint64 ReadVarUInt()
+    {
+        uint64 value = 0;
+        if (!TryReadVarUInt(value)) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        return value;
+    }
+    /// <summary>
+    /// 尝试读取 LEB128 编码的无符号变长整数
+    /// </summary>
+    /// <param name="value">接收读取的值</param>
+    /// <returns>数据不足、编码超过 10 字节或值超出 uint64 返回 false，读取位置不变</returns>
+    bool TryReadVarUInt(uint64& value)
+    {
+        const byte* ptr = m_data + m_pos;
+        uint64 result = 0;
+        if (Remain() >= BinaryWriter::MAX_VARINT_SIZE) [[likely]]
+        {
+            // 快速路径：剩余数据足够容纳最长编码，循环中无需边界检查
+            for (int32 i = 0; i != BinaryWriter::MAX_VARINT_SIZE; i++)
+            {
+                const uint64 current = static_cast<uint64>(ptr[i]);
+                // 第 10 字节只能提供第 63 位，更大的值超出 uint64
+                if (i == BinaryWriter::MAX_VARINT_SIZE - 1 && current > 1)
+                {
+                    return false;
+                }
+                result |= (current & 0x7F) << (7 * i);
+                if (current < 0x80)
+                {
+                    value = result;
+                    m_pos += i + 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+        const int64 remain = Remain();
+        for (int64 i = 0; i < remain; i++)
+        {
+            const uint64 current = static_cast<uint64>(ptr[i]);
+            if (i == BinaryWriter::MAX_VARINT_SIZE - 1 && current > 1)
+            {
+                return false;
+            }
+            result |= (current & 0x7F) << (7 * i);
+            if (current < 0x80)
+            {
+                value = result;
+                m_pos += i + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+    /// <summary>
+    /// 读取 ZigZag + LEB128 编码的有符号变长整数
+    /// </summary>
+    /// <returns>读取的值</returns>
+    /// <exception cref="std::out_of_range">数据不足或编码无效时抛出</exception>
+    int64 ReadVarInt()
+    {
+        int64 value = 0;
+        if (!TryReadVarInt(value)) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        return value;
+    }
+    /// <summary>
+    /// 尝试读取 ZigZag + LEB128 编码的有符号变长整数
+    /// </summary>
+    /// <param name="value">接收读取的值</param>
+    /// <returns>数据不足或编码无效返回 false，读取位置不变</returns>
+    bool TryReadVarInt(int64& value)
+    {
+        uint64 raw = 0;
+        if (!TryReadVarUInt(raw))
+        {
+            return false;
+        }
+        value = static_cast<int64>(raw >> 1) ^ -static_cast<int64>(raw & 1);
+        return true;
+    }
+    /// <summary>
+    /// 读取指定数量的原始字节
+    /// </summary>
+    /// <param name="data">目标内存</param>
+    /// <param name="size">字节数</param>
+    /// <exception cref="std::out_of_range">剩余数据不足时抛出</exception>
+    void ReadBytes(byte* data, int64 size)
+    {
+        if (size < 0 || Remain() < size) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        std::memcpy(data, m_data + m_pos, size);
+        m_pos += size;
+    }
+    /// <summary>
+    /// 读取指定数量的字节到新的字节数组
+    /// </summary>
+    /// <param name="size">字节数</param>
+    /// <returns>字节数组</returns>
+    /// <exception cref="std::out_of_range">剩余数据不足时抛出</exception>
+    ByteArray ReadByteArray(int64 size)
+    {
+        if (size < 0 || Remain() < size) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        ByteArray result(m_data + m_pos, size);
+        m_pos += size;
+        return result;
+    }
+    /// <summary>
+    /// 读取指定数量的字节为视图
+    /// <para>读取器基于 ByteView 构造时返回零拷贝子视图，否则复制数据</para>
+    /// </summary>
+    /// <param name="size">字节数</param>
+    /// <returns>字节视图</returns>
+    /// <exception cref="std::out_of_range">剩余数据不足时抛出</exception>
+    ByteView ReadView(int64 size)
+    {
+        if (size < 0 || Remain() < size) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        ByteView result = m_view.IsEmpty() ? ByteView(m_data + m_pos, size) : m_view.Slice(m_pos, size);
+        m_pos += size;
+        return result;
+    }
+    /// <summary>
+    /// 读取变长整数表示的元素数量，随后读取所有元素
+    /// <para>先校验剩余数据足够再分配内存，防止恶意长度导致巨量分配</para>
+    /// </summary>
+    /// <typeparam name="Type">元素类型</typeparam>
+    /// <param name="array">接收元素的数组，原有内容被替换</param>
+    /// <exception cref="std::out_of_range">数据不足或编码无效时抛出</exception>
+    template<class Type>
+        requires std::is_trivially_copyable_v<Type>
+    void ReadArray(Array<Type>& array)
+    {
+        const int64 start = m_pos;
+        const uint64 count = ReadVarUInt();
+        if (count > static_cast<uint64>(Remain() / static_cast<int64>(sizeof(Type)))) [[unlikely]]
+        {
+            m_pos = start;
+            _ThrowOutOfRange();
+        }
+        array.Resize(static_cast<int64>(count));
+        ReadArray(array.Data(), static_cast<int64>(count));
+    }
+    /// <summary>
+    /// 读取连续元素(不含数量前缀)
+    /// </summary>
+    /// <typeparam name="Type">元素类型</typeparam>
+    /// <param name="data">目标元素指针</param>
+    /// <param name="count">元素数量</param>
+    /// <exception cref="std::out_of_range">剩余数据不足时抛出</exception>
+    template<class Type>
+        requires std::is_trivially_copyable_v<Type>
+    void ReadArray(Type* data, int64 count)
+    {
+        if (count <= 0) return;
+
+        ReadBytes(reinterpret_cast<byte*>(data), count * static_cast<int64>(sizeof(Type)));
+        if constexpr (sizeof(Type) > 1 && (std::is_arithmetic_v<Type> || std::is_enum_v<Type>))
+        {
+            if (m_endian != Endian::Native)
+            {
+                for (int64 i = 0; i != count; i++)
+                {
+                    data[i] = BinaryWriter::_ByteSwap(data[i]);
+                }
+            }
+        }
+    }
+    /// <summary>
+    /// 跳过指定数量的字节
+    /// </summary>
+    /// <param name="size">字节数</param>
+    /// <exception cref="std::out_of_range">剩余数据不足时抛出</exception>
+    void Skip(int64 size)
+    {
+        if (size < 0 || Remain() < size) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        m_pos += size;
+    }
+    /// <summary>
+    /// 设置读取位置
+    /// </summary>
+    /// <param name="pos">新的读取位置</param>
+    /// <exception cref="std::out_of_range">位置超出范围时抛出</exception>
+    void Seek(int64 pos)
+    {
+        if (pos < 0 || pos > m_size) [[unlikely]]
+        {
+            _ThrowOutOfRange();
+        }
+        m_pos = pos;
+    }
+    /// <summary>
+    /// 获取当前读取位置
+    /// </summary>
+    int64 Position() const
+    {
+        return m_pos;
+    }
+    /// <summary>
+    /// 获取数据总字节数
+    /// </summary>
+    int64 Size() const
+    {
+        return m_size;
+    }
+    /// <summary>
+    /// 获取剩余未读字节数
+    /// </summary>
+    int64 Remain() const
+    {
+        return m_size - m_pos;
+    }
+    /// <summary>
+    /// 检查是否已读取到末尾
+    /// </summary>
+    bool IsEnd() const
+    {
+        return m_pos >= m_size;
+    }
+    /// <summary>
+    /// 获取字节序
+    /// </summary>
+    Endian GetEndian() const
+    {
+        return m_endian;
+    }
+    /// <summary>
+    /// 设置字节序
+    /// </summary>
+    void SetEndian(Endian endian)
+    {
+        m_endian = endian;
+    }
+private:
+    /// <summary>
+    /// 抛出越界异常(冷路径)
+    /// </summary>
+    [[noreturn]] static void _ThrowOutOfRange()
+    {
+        throw std::out_of_range("BinaryReader read out of range");
+    }
+private:
+    // 持有的视图(基于 ByteView 构造时)
+    ByteView m_view;
+    // 数据指针
+    const byte* m_data = nullptr;
+    // 数据总字节数
+    int64 m_size = 0;
+    // 当前读取位置
+    int64 m_pos = 0;
+    // 字节序
+    Endian m_endian = Endian::Little;
+};
@@ -3,6 +3,8 @@
 #include "Core.h"
 
 #include <vector>
+#include <cstring>
+#include <algorithm>
 
 class ByteArray
 {
@@ -253,6 +255,20 @@ public:
         return *this;
     }
     /// <summary>
+    /// 在末尾追加原始数据
+    /// </summary>
+    /// <param name="data">原始数据指针</param>
+    /// <param name="size">数据大小</param>
+    /// <returns>this</returns>
+    constexpr ByteArray& Append(const byte* data, int64 size)
+    {
+        if (data && size > 0)
+        {
+            m_data.insert(m_data.end(), data, data + size);
+        }
+        return *this;
+    }
+    /// <summary>
     /// 在起始追加另一个字节数组
     /// </summary>
     /// <param name="other">要追加的字节数组</param>
@@ -0,0 +1,470 @@
+#pragma once
+
+#include "Core.h"
+#include "ByteArray.h"
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <algorithm>
+
+/// <summary>
+/// 共享字节视图
+/// <para>多个视图通过引用计数共享同一块缓冲区，拷贝和 Slice 只增加引用计数，不复制数据</para>
+/// <para>通过 MutableData 修改时执行写时复制：缓冲区被共享时先复制视图覆盖的范围</para>
+/// </summary>
+class ByteView
+{
+public:
+    /// <summary>
+    /// 默认构造函数，构造空视图
+    /// </summary>
+    ByteView() = default;
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~ByteView()
+    {
+        _Release();
+    }
+    /// <summary>
+    /// 拷贝构造函数(共享缓冲区)
+    /// </summary>
+    /// <param name="other">要拷贝的视图</param>
+    ByteView(const ByteView& other)
+        : m_block(other.m_block)
+        , m_data(other.m_data)
+        , m_size(other.m_size)
+    {
+        _Retain();
+    }
+    /// <summary>
+    /// 拷贝赋值运算符(共享缓冲区)
+    /// </summary>
+    /// <param name="other">要拷贝的视图</param>
+    /// <returns>this</returns>
+    ByteView& operator=(const ByteView& other)
+    {
+        if (this == &other) [[unlikely]]
+        {
+            return *this;
+        }
+        other._Retain();
+        _Release();
+        m_block = other.m_block;
+        m_data = other.m_data;
+        m_size = other.m_size;
+        return *this;
+    }
+    /// <summary>
+    /// 移动构造函数
+    /// </summary>
+    /// <param name="other">要移动的视图</param>
+    ByteView(ByteView&& other) noexcept
+        : m_block(std::exchange(other.m_block, nullptr))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+    {
+
+    }
+    /// <summary>
+    /// 移动赋值运算符
+    /// </summary>
+    /// <param name="other">要移动的视图</param>
+    /// <returns>this</returns>
+    ByteView& operator=(ByteView&& other) noexcept
+    {
+        if (this == &other) [[unlikely]]
+        {
+            return *this;
+        }
+        _Release();
+        m_block = std::exchange(other.m_block, nullptr);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        return *this;
+    }
+    /// <summary>
+    /// 构造函数，复制字节数组的内容
+    /// </summary>
+    /// <param name="array">字节数组</param>
+    explicit ByteView(const ByteArray& array)
+        : ByteView(ByteArray(array))
+    {
+
+    }
+    /// <summary>
+    /// 构造函数，接管字节数组的存储(不复制数据)
+    /// </summary>
+    /// <param name="array">字节数组</param>
+    explicit ByteView(ByteArray&& array)
+    {
+        if (array.IsEmpty()) return;
+
+        m_block = new Block(std::move(array));
+        m_data = m_block->Storage.Data();
+        m_size = m_block->Storage.Size();
+    }
+    /// <summary>
+    /// 构造函数，复制原始数据
+    /// </summary>
+    /// <param name="data">原始数据指针</param>
+    /// <param name="size">数据大小</param>
+    ByteView(const byte* data, int64 size)
+        : ByteView(ByteArray(data, size))
+    {
+
+    }
+public:
+    /// <summary>
+    /// 创建引用外部内存的只读视图(不复制数据)
+    /// <para>最后一个引用该内存的视图销毁时调用 release，可用于保持文件映射等外部资源的生命周期</para>
+    /// <para>外部内存视为只读，MutableData 总是先复制</para>
+    /// </summary>
+    /// <param name="data">外部内存指针</param>
+    /// <param name="size">字节数</param>
+    /// <param name="release">释放回调</param>
+    /// <returns>字节视图</returns>
+    static ByteView FromExternal(const byte* data, int64 size, std::function<void()> release)
+    {
+        if (!data || size <= 0)
+        {
+            if (release) release();
+            return ByteView();
+        }
+        Block* block = new Block(ByteArray());
+        block->Release = std::move(release);
+        return ByteView(block, data, size);
+    }
+public:
+    /// <summary>
+    /// 返回视图的一个子范围，与当前视图共享缓冲区
+    /// </summary>
+    /// <param name="offset">起始偏移，超出范围时返回空视图</param>
+    /// <param name="length">长度，-1 或超出末尾时截取到末尾</param>
+    /// <returns>子视图</returns>
+    ByteView Slice(int64 offset, int64 length = -1) const
+    {
+        if (offset < 0 || offset >= m_size)
+        {
+            return ByteView();
+        }
+        if (length < 0 || length > m_size - offset)
+        {
+            length = m_size - offset;
+        }
+        if (length == 0)
+        {
+            return ByteView();
+        }
+        _Retain();
+        return ByteView(m_block, m_data + offset, length);
+    }
+    /// <summary>
+    /// 返回视图最左侧的 count 个字节
+    /// </summary>
+    ByteView Left(int64 count) const
+    {
+        return Slice(0, std::max<int64>(count, 0));
+    }
+    /// <summary>
+    /// 返回视图最右侧的 count 个字节
+    /// </summary>
+    ByteView Right(int64 count) const
+    {
+        count = std::clamp<int64>(count, 0, m_size);
+        return Slice(m_size - count, count);
+    }
+    /// <summary>
+    /// 访问指定位置的字节
+    /// </summary>
+    /// <param name="index">索引位置</param>
+    /// <returns>指定位置的字节</returns>
+    /// <exception cref="std::out_of_range">当index超出范围时抛出</exception>
+    byte At(int64 index) const
+    {
+        if (!IsValidIndex(index)) [[unlikely]]
+        {
+            throw std::out_of_range("ByteView index out of range");
+        }
+        return m_data[index];
+    }
+    /// <summary>
+    /// 访问第一个字节
+    /// </summary>
+    byte Front() const
+    {
+        return At(0);
+    }
+    /// <summary>
+    /// 访问最后一个字节
+    /// </summary>
+    byte Back() const
+    {
+        return At(m_size - 1);
+    }
+    /// <summary>
+    /// 获取只读数据指针
+    /// </summary>
+    /// <returns>指向视图首字节的指针</returns>
+    const byte* Data() const
+    {
+        return m_data;
+    }
+    /// <summary>
+    /// 获取可写数据指针(写时复制)
+    /// <para>缓冲区被其他视图共享时，先将当前视图范围复制到独占缓冲区</para>
+    /// </summary>
+    /// <returns>指向视图首字节的可写指针</returns>
+    byte* MutableData()
+    {
+        if (!m_block) return nullptr;
+
+        if (m_block->Release || m_block->RefCount.load(std::memory_order_acquire) != 1)
+        {
+            _Detach();
+        }
+        return const_cast<byte*>(m_data);
+    }
+    /// <summary>
+    /// 获取视图的字节数
+    /// </summary>
+    /// <returns>字节数</returns>
+    int64 Size() const
+    {
+        return m_size;
+    }
+    /// <summary>
+    /// 检查视图是否为空
+    /// </summary>
+    /// <returns>空返回true，否则false</returns>
+    bool IsEmpty() const
+    {
+        return m_size == 0;
+    }
+    /// <summary>
+    /// 检查索引是否有效
+    /// </summary>
+    /// <param name="index">要检查的索引</param>
+    /// <returns>有效返回true，否则false</returns>
+    bool IsValidIndex(int64 index) const
+    {
+        return index >= 0 && index < m_size;
+    }
+    /// <summary>
+    /// 检查缓冲区是否被多个视图共享
+    /// </summary>
+    /// <returns>共享返回true，否则false</returns>
+    bool IsShared() const
+    {
+        return m_block && m_block->RefCount.load(std::memory_order_acquire) > 1;
+    }
+    /// <summary>
+    /// 检查是否包含指定字节
+    /// </summary>
+    /// <param name="value">要查找的字节</param>
+    /// <returns>存在返回true，否则false</returns>
+    bool Contains(byte value) const
+    {
+        return IndexOf(value) != -1;
+    }
+    /// <summary>
+    /// 统计指定字节的出现次数
+    /// </summary>
+    /// <param name="value">要统计的字节</param>
+    /// <returns>出现次数</returns>
+    int64 Count(byte value) const
+    {
+        return static_cast<int64>(std::count(m_data, m_data + m_size, value));
+    }
+    /// <summary>
+    /// 查找指定字节第一次出现的位置
+    /// </summary>
+    /// <param name="value">要查找的字节</param>
+    /// <param name="start">起始搜索位置</param>
+    /// <returns>索引位置，未找到返回-1</returns>
+    int64 IndexOf(byte value, int64 start = 0) const
+    {
+        if (start < 0 || start >= m_size)
+            return -1;
+
+        const void* ptr = std::memchr(m_data + start, static_cast<int>(value), m_size - start);
+        return ptr ? static_cast<const byte*>(ptr) - m_data : -1;
+    }
+    /// <summary>
+    /// 查找指定字节最后一次出现的位置
+    /// </summary>
+    /// <param name="value">要查找的字节</param>
+    /// <param name="start">起始搜索位置，-1表示从末尾开始</param>
+    /// <returns>索引位置，未找到返回-1</returns>
+    int64 LastIndexOf(byte value, int64 start = -1) const
+    {
+        if (IsEmpty())
+            return -1;
+
+        if (start < 0 || start >= m_size)
+            start = m_size - 1;
+
+        for (int64 i = start; i >= 0; --i)
+        {
+            if (m_data[i] == value)
+                return i;
+        }
+        return -1;
+    }
+    /// <summary>
+    /// 检查视图是否以指定字节序列开头
+    /// </summary>
+    bool StartWith(const ByteView& other) const
+    {
+        return other.m_size <= m_size && std::memcmp(m_data, other.m_data, other.m_size) == 0;
+    }
+    /// <summary>
+    /// 检查视图是否以指定字节序列结尾
+    /// </summary>
+    bool EndWith(const ByteView& other) const
+    {
+        return other.m_size <= m_size && std::memcmp(m_data + m_size - other.m_size, other.m_data, other.m_size) == 0;
+    }
+    /// <summary>
+    /// 复制视图内容到新的字节数组
+    /// </summary>
+    /// <returns>字节数组</returns>
+    ByteArray ToByteArray() const
+    {
+        return ByteArray(m_data, m_size);
+    }
+    /// <summary>
+    /// 释放对缓冲区的引用，变为空视图
+    /// </summary>
+    void Reset()
+    {
+        _Release();
+        m_block = nullptr;
+        m_data = nullptr;
+        m_size = 0;
+    }
+    /// <summary>
+    /// 交换两个视图
+    /// </summary>
+    /// <param name="other">要交换的视图</param>
+    void Swap(ByteView& other) noexcept
+    {
+        std::swap(m_block, other.m_block);
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+    }
+public:
+    /// <summary>
+    /// 下标运算符(只读)
+    /// </summary>
+    byte operator[](int64 index) const
+    {
+        return m_data[index];
+    }
+    /// <summary>
+    /// 相等运算符(比较内容)
+    /// </summary>
+    friend bool operator==(const ByteView& left, const ByteView& right)
+    {
+        return left.m_size == right.m_size &&
+            (left.m_data == right.m_data || std::memcmp(left.m_data, right.m_data, left.m_size) == 0);
+    }
+    /// <summary>
+    /// 不等运算符(比较内容)
+    /// </summary>
+    friend bool operator!=(const ByteView& left, const ByteView& right)
+    {
+        return !(left == right);
+    }
+public:
+    /// <summary>
+    /// 返回指向第一个字节的指针
+    /// </summary>
+    [[nodiscard]] const byte* begin() const noexcept
+    {
+        return m_data;
+    }
+    /// <summary>
+    /// 返回指向末尾的指针
+    /// </summary>
+    [[nodiscard]] const byte* end() const noexcept
+    {
+        return m_data + m_size;
+    }
+private:
+    /// <summary>
+    /// 引用计数缓冲区
+    /// </summary>
+    struct Block
+    {
+        explicit Block(ByteArray&& storage)
+            : Storage(std::move(storage))
+        {
+
+        }
+
+        ~Block()
+        {
+            if (Release)
+            {
+                Release();
+            }
+        }
+
+        std::atomic<int64> RefCount = 1;
+        // 自有存储
+        ByteArray Storage;
+        // 外部内存的释放回调，为空表示数据位于 Storage 中
+        std::function<void()> Release;
+    };
+private:
+    /// <summary>
+    /// 构造函数，引用已持有的缓冲区(调用方负责增加引用计数)
+    /// </summary>
+    ByteView(Block* block, const byte* data, int64 size)
+        : m_block(block)
+        , m_data(data)
+        , m_size(size)
+    {
+
+    }
+    /// <summary>
+    /// 增加引用计数
+    /// </summary>
+    void _Retain() const
+    {
+        if (m_block)
+        {
+            m_block->RefCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    /// <summary>
+    /// 减少引用计数，归零时释放缓冲区
+    /// </summary>
+    void _Release()
+    {
+        if (m_block && m_block->RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete m_block;
+        }
+    }
+    /// <summary>
+    /// 将视图范围复制到独占缓冲区
+    /// </summary>
+    void _Detach()
+    {
+        Block* block = new Block(ByteArray(m_data, m_size));
+        _Release();
+        m_block = block;
+        m_data = block->Storage.Data();
+    }
+private:
+    // 共享缓冲区
+    Block* m_block = nullptr;
+    // 视图首字节
+    const byte* m_data = nullptr;
+    // 视图字节数
+    int64 m_size = 0;
+};
@@ -0,0 +1,493 @@
+#include "pch.h"
+
+#include "Checksum.h"
+#include "CpuFeatures.h"
+
+#if defined(CPU_ARCH_X64)
+    #include <nmmintrin.h>
+#elif defined(CPU_ARCH_ARM64)
+    #if defined(COMPILER_MSVC)
+        #include <intrin.h>
+    #else
+        #include <arm_acle.h>
+    #endif
+#endif
+
+namespace
+{
+    // CRC32C 反射多项式
+    constexpr uint32 CRC32C_POLY = 0x82F63B78u;
+    // 硬件路径三路交错时每一路的字节数
+    constexpr int64 CRC_STRIPE = 2048;
+
+    /// <summary>
+    /// slice-by-8 查找表，首次使用时生成
+    /// </summary>
+    struct CrcTable
+    {
+        uint32 Table[8][256];
+
+        CrcTable()
+        {
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                uint32 crc = i;
+                for (int32 bit = 0; bit < 8; ++bit)
+                {
+                    crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLY : 0);
+                }
+                Table[0][i] = crc;
+            }
+            for (uint32 i = 0; i < 256; ++i)
+            {
+                for (int32 slice = 1; slice < 8; ++slice)
+                {
+                    uint32 prev = Table[slice - 1][i];
+                    Table[slice][i] = (prev >> 8) ^ Table[0][prev & 0xFF];
+                }
+            }
+        }
+    };
+
+    const CrcTable& GetCrcTable()
+    {
+        static const CrcTable table;
+        return table;
+    }
+
+    inline uint64 ReadLE64(const byte* p)
+    {
+        uint64 value;
+        std::memcpy(&value, p, sizeof(value));
+#if defined(PLATFORM_BIG_ENDIAN)
+        value = __builtin_bswap64(value);
+#endif
+        return value;
+    }
+
+    inline uint32 ReadLE32(const byte* p)
+    {
+        uint32 value;
+        std::memcpy(&value, p, sizeof(value));
+#if defined(PLATFORM_BIG_ENDIAN)
+        value = __builtin_bswap32(value);
+#endif
+        return value;
+    }
+
+    /// <summary>
+    /// slice-by-8 软件实现(state 为取反后的中间状态)
+    /// </summary>
+    uint32 CrcUpdateSoftware(uint32 state, const byte* data, int64 size)
+    {
+        const auto& table = GetCrcTable().Table;
+        while (size > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0)
+        {
+            state = (state >> 8) ^ table[0][(state ^ static_cast<uint32>(*data++)) & 0xFF];
+            --size;
+        }
+        while (size >= 8)
+        {
+            uint64 word = ReadLE64(data) ^ state;
+            state = table[7][word & 0xFF] ^
+                table[6][(word >> 8) & 0xFF] ^
+                table[5][(word >> 16) & 0xFF] ^
+                table[4][(word >> 24) & 0xFF] ^
+                table[3][(word >> 32) & 0xFF] ^
+                table[2][(word >> 40) & 0xFF] ^
+                table[1][(word >> 48) & 0xFF] ^
+                table[0][word >> 56];
+            data += 8;
+            size -= 8;
+        }
+        while (size > 0)
+        {
+            state = (state >> 8) ^ table[0][(state ^ static_cast<uint32>(*data++)) & 0xFF];
+            --size;
+        }
+        return state;
+    }
+
+#if defined(CPU_ARCH_X64) || defined(CPU_ARCH_ARM64)
+    /// <summary>
+    /// 将中间状态向后推进 CRC_STRIPE 个零字节的线性变换表
+    /// <para>三路交错计算后用于把前一路的结果移位到后一路的位置再合并</para>
+    /// </summary>
+    struct CrcShiftTable
+    {
+        uint32 Table[4][256];
+
+        CrcShiftTable()
+        {
+            // 变换是线性的，先求出每个单独位的像，再展开为按字节查表
+            const auto& table = GetCrcTable().Table;
+            uint32 columns[32];
+            for (int32 bit = 0; bit < 32; ++bit)
+            {
+                uint32 state = 1u << bit;
+                for (int64 i = 0; i < CRC_STRIPE; ++i)
+                {
+                    state = (state >> 8) ^ table[0][state & 0xFF];
+                }
+                columns[bit] = state;
+            }
+            for (int32 slice = 0; slice < 4; ++slice)
+            {
+                for (uint32 value = 0; value < 256; ++value)
+                {
+                    uint32 result = 0;
+                    for (int32 bit = 0; bit < 8; ++bit)
+                    {
+                        if (value & (1u << bit))
+                        {
+                            result ^= columns[slice * 8 + bit];
+                        }
+                    }
+                    Table[slice][value] = result;
+                }
+            }
+        }
+
+        uint32 Shift(uint32 state) const
+        {
+            return Table[0][state & 0xFF] ^ Table[1][(state >> 8) & 0xFF] ^
+                Table[2][(state >> 16) & 0xFF] ^ Table[3][state >> 24];
+        }
+    };
+
+    const CrcShiftTable& GetShiftTable()
+    {
+        static const CrcShiftTable table;
+        return table;
+    }
+#endif
+
+#if defined(CPU_ARCH_X64)
+    /// <summary>
+    /// SSE4.2 实现，长数据三路交错以隐藏 crc32 指令的延迟
+    /// </summary>
+    CPU_TARGET_SSE42 uint32 CrcUpdateHardware(uint32 state, const byte* data, int64 size)
+    {
+        while (size > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0)
+        {
+            state = _mm_crc32_u8(state, static_cast<uint8>(*data++));
+            --size;
+        }
+        if (size >= 3 * CRC_STRIPE)
+        {
+            const CrcShiftTable& shift = GetShiftTable();
+            do
+            {
+                uint64 crcA = state, crcB = 0, crcC = 0;
+                for (int64 i = 0; i < CRC_STRIPE; i += 8)
+                {
+                    crcA = _mm_crc32_u64(crcA, ReadLE64(data + i));
+                    crcB = _mm_crc32_u64(crcB, ReadLE64(data + CRC_STRIPE + i));
+                    crcC = _mm_crc32_u64(crcC, ReadLE64(data + 2 * CRC_STRIPE + i));
+                }
+                state = shift.Shift(shift.Shift(static_cast<uint32>(crcA)) ^ static_cast<uint32>(crcB)) ^ static_cast<uint32>(crcC);
+                data += 3 * CRC_STRIPE;
+                size -= 3 * CRC_STRIPE;
+            } while (size >= 3 * CRC_STRIPE);
+        }
+        uint64 crc = state;
+        while (size >= 8)
+        {
+            crc = _mm_crc32_u64(crc, ReadLE64(data));
+            data += 8;
+            size -= 8;
+        }
+        state = static_cast<uint32>(crc);
+        while (size > 0)
+        {
+            state = _mm_crc32_u8(state, static_cast<uint8>(*data++));
+            --size;
+        }
+        return state;
+    }
+#elif defined(CPU_ARCH_ARM64)
+    /// <summary>
+    /// ARMv8 CRC32 实现，长数据三路交错以隐藏 crc32c 指令的延迟
+    /// </summary>
+    CPU_TARGET_CRC uint32 CrcUpdateHardware(uint32 state, const byte* data, int64 size)
+    {
+        while (size > 0 && (reinterpret_cast<uintptr_t>(data) & 7) != 0)
+        {
+            state = __crc32cb(state, static_cast<uint8>(*data++));
+            --size;
+        }
+        if (size >= 3 * CRC_STRIPE)
+        {
+            const CrcShiftTable& shift = GetShiftTable();
+            do
+            {
+                uint32 crcA = state, crcB = 0, crcC = 0;
+                for (int64 i = 0; i < CRC_STRIPE; i += 8)
+                {
+                    crcA = __crc32cd(crcA, ReadLE64(data + i));
+                    crcB = __crc32cd(crcB, ReadLE64(data + CRC_STRIPE + i));
+                    crcC = __crc32cd(crcC, ReadLE64(data + 2 * CRC_STRIPE + i));
+                }
+                state = shift.Shift(shift.Shift(crcA) ^ crcB) ^ crcC;
+                data += 3 * CRC_STRIPE;
+                size -= 3 * CRC_STRIPE;
+            } while (size >= 3 * CRC_STRIPE);
+        }
+        while (size >= 8)
+        {
+            state = __crc32cd(state, ReadLE64(data));
+            data += 8;
+            size -= 8;
+        }
+        while (size > 0)
+        {
+            state = __crc32cb(state, static_cast<uint8>(*data++));
+            --size;
+        }
+        return state;
+    }
+#endif
+
+    using CrcUpdateFunction = uint32(*)(uint32, const byte*, int64);
+
+    /// <summary>
+    /// 按 CPU 特性选择实现
+    /// </summary>
+    CrcUpdateFunction SelectCrcUpdate()
+    {
+#if defined(CPU_ARCH_X64)
+        if (CpuFeatures::Get().SSE42)
+        {
+            return &CrcUpdateHardware;
+        }
+#elif defined(CPU_ARCH_ARM64)
+        if (CpuFeatures::Get().CRC32)
+        {
+            return &CrcUpdateHardware;
+        }
+#endif
+        return &CrcUpdateSoftware;
+    }
+
+    inline uint32 CrcUpdate(uint32 state, const byte* data, int64 size)
+    {
+        static const CrcUpdateFunction update = SelectCrcUpdate();
+        if (size <= 0)
+        {
+            return state;
+        }
+        return update(state, data, size);
+    }
+
+    // xxHash64 常量
+    constexpr uint64 PRIME64_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64 PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64 PRIME64_3 = 0x165667B19E3779F9ull;
+    constexpr uint64 PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64 PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+    inline uint64 RotateLeft(uint64 value, int32 count)
+    {
+        return (value << count) | (value >> (64 - count));
+    }
+
+    inline uint64 XxhRound(uint64 acc, uint64 input)
+    {
+        acc += input * PRIME64_2;
+        acc = RotateLeft(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    inline uint64 XxhMergeRound(uint64 acc, uint64 value)
+    {
+        acc ^= XxhRound(0, value);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+}
+
+/* Crc32C */
+uint32 Crc32C::Compute(const byte* data, int64 size)
+{
+    return ~CrcUpdate(0xFFFFFFFFu, data, size);
+}
+
+uint32 Crc32C::Compute(const ByteArray& data)
+{
+    return Compute(data.Data(), data.Size());
+}
+
+uint32 Crc32C::Compute(const ByteView& data)
+{
+    return Compute(data.Data(), data.Size());
+}
+
+uint32 Crc32C::Extend(uint32 crc, const byte* data, int64 size)
+{
+    return ~CrcUpdate(~crc, data, size);
+}
+
+Crc32C& Crc32C::Update(const byte* data, int64 size)
+{
+    m_state = CrcUpdate(m_state, data, size);
+    return *this;
+}
+
+Crc32C& Crc32C::Update(const ByteArray& data)
+{
+    return Update(data.Data(), data.Size());
+}
+
+Crc32C& Crc32C::Update(const ByteView& data)
+{
+    return Update(data.Data(), data.Size());
+}
+
+uint32 Crc32C::Finalize() const
+{
+    return ~m_state;
+}
+
+void Crc32C::Reset()
+{
+    m_state = 0xFFFFFFFFu;
+}
+
+/* XxHash64 */
+XxHash64::XxHash64(uint64 seed)
+{
+    Reset(seed);
+}
+
+uint64 XxHash64::Compute(const byte* data, int64 size, uint64 seed)
+{
+    XxHash64 hash(seed);
+    hash.Update(data, size);
+    return hash.Finalize();
+}
+
+uint64 XxHash64::Compute(const ByteArray& data, uint64 seed)
+{
+    return Compute(data.Data(), data.Size(), seed);
+}
+
+uint64 XxHash64::Compute(const ByteView& data, uint64 seed)
+{
+    return Compute(data.Data(), data.Size(), seed);
+}
+
+XxHash64& XxHash64::Update(const byte* data, int64 size)
+{
+    if (size <= 0)
+    {
+        return *this;
+    }
+    m_length += static_cast<uint64>(size);
+
+    // 先补齐上次留下的尾部
+    if (m_bufferSize > 0)
+    {
+        int64 fill = std::min<int64>(32 - m_bufferSize, size);
+        std::memcpy(m_buffer + m_bufferSize, data, static_cast<size_t>(fill));
+        m_bufferSize += static_cast<int32>(fill);
+        data += fill;
+        size -= fill;
+        if (m_bufferSize < 32)
+        {
+            return *this;
+        }
+        for (int32 i = 0; i < 4; ++i)
+        {
+            m_state[i] = XxhRound(m_state[i], ReadLE64(m_buffer + i * 8));
+        }
+        m_bufferSize = 0;
+    }
+
+    uint64 v1 = m_state[0], v2 = m_state[1], v3 = m_state[2], v4 = m_state[3];
+    while (size >= 32)
+    {
+        v1 = XxhRound(v1, ReadLE64(data));
+        v2 = XxhRound(v2, ReadLE64(data + 8));
+        v3 = XxhRound(v3, ReadLE64(data + 16));
+        v4 = XxhRound(v4, ReadLE64(data + 24));
+        data += 32;
+        size -= 32;
+    }
+    m_state[0] = v1;
+    m_state[1] = v2;
+    m_state[2] = v3;
+    m_state[3] = v4;
+
+    if (size > 0)
+    {
+        std::memcpy(m_buffer, data, static_cast<size_t>(size));
+        m_bufferSize = static_cast<int32>(size);
+    }
+    return *this;
+}
+
+XxHash64& XxHash64::Update(const ByteArray& data)
+{
+    return Update(data.Data(), data.Size());
+}
+
+XxHash64& XxHash64::Update(const ByteView& data)
+{
+    return Update(data.Data(), data.Size());
+}
+
+uint64 XxHash64::Finalize() const
+{
+    uint64 hash;
+    if (m_length >= 32)
+    {
+        hash = RotateLeft(m_state[0], 1) + RotateLeft(m_state[1], 7) + RotateLeft(m_state[2], 12) + RotateLeft(m_state[3], 18);
+        for (int32 i = 0; i < 4; ++i)
+        {
+            hash = XxhMergeRound(hash, m_state[i]);
+        }
+    }
+    else
+    {
+        hash = m_seed + PRIME64_5;
+    }
+    hash += m_length;
+
+    const byte* p = m_buffer;
+    const byte* end = m_buffer + m_bufferSize;
+    while (p + 8 <= end)
+    {
+        hash ^= XxhRound(0, ReadLE64(p));
+        hash = RotateLeft(hash, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= static_cast<uint64>(ReadLE32(p)) * PRIME64_1;
+        hash = RotateLeft(hash, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    while (p < end)
+    {
+        hash ^= static_cast<uint64>(*p) * PRIME64_5;
+        hash = RotateLeft(hash, 11) * PRIME64_1;
+        ++p;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+void XxHash64::Reset(uint64 seed)
+{
+    m_seed = seed;
+    m_state[0] = seed + PRIME64_1 + PRIME64_2;
+    m_state[1] = seed + PRIME64_2;
+    m_state[2] = seed;
+    m_state[3] = seed - PRIME64_1;
+    m_bufferSize = 0;
+    m_length = 0;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Core.h"
+#include "ByteArray.h"
+#include "ByteView.h"
+
+/// <summary>
+/// CRC32C(Castagnoli) 校验，支持增量计算
+/// <para>支持 SSE4.2 或 ARMv8 CRC32 指令时使用硬件指令，否则使用 slice-by-8 查表</para>
+/// </summary>
+class Crc32C
+{
+public:
+    /// <summary>
+    /// 默认构造函数
+    /// </summary>
+    Crc32C() = default;
+public:
+    /// <summary>
+    /// 一次性计算校验值
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <returns>校验值</returns>
+    static uint32 Compute(const byte* data, int64 size);
+    /// <summary>
+    /// 一次性计算校验值
+    /// </summary>
+    static uint32 Compute(const ByteArray& data);
+    /// <summary>
+    /// 一次性计算校验值
+    /// </summary>
+    static uint32 Compute(const ByteView& data);
+    /// <summary>
+    /// 在已有校验值的基础上继续计算(与增量计算等价)
+    /// </summary>
+    /// <param name="crc">之前数据的校验值</param>
+    /// <param name="data">后续数据指针</param>
+    /// <param name="size">后续数据字节数</param>
+    /// <returns>拼接后数据的校验值</returns>
+    static uint32 Extend(uint32 crc, const byte* data, int64 size);
+public:
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <returns>this</returns>
+    Crc32C& Update(const byte* data, int64 size);
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    Crc32C& Update(const ByteArray& data);
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    Crc32C& Update(const ByteView& data);
+    /// <summary>
+    /// 获取当前已追加数据的校验值，不影响后续追加
+    /// </summary>
+    uint32 Finalize() const;
+    /// <summary>
+    /// 重置为初始状态
+    /// </summary>
+    void Reset();
+private:
+    // 已取反的中间状态
+    uint32 m_state = 0xFFFFFFFFu;
+};
+
+/// <summary>
+/// xxHash64 非加密哈希，支持增量计算
+/// <para>速度接近内存带宽，适合数据块完整性校验与内容去重，不能用于防篡改</para>
+/// </summary>
+class XxHash64
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="seed">种子</param>
+    explicit XxHash64(uint64 seed = 0);
+public:
+    /// <summary>
+    /// 一次性计算哈希值
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <param name="seed">种子</param>
+    /// <returns>哈希值</returns>
+    static uint64 Compute(const byte* data, int64 size, uint64 seed = 0);
+    /// <summary>
+    /// 一次性计算哈希值
+    /// </summary>
+    static uint64 Compute(const ByteArray& data, uint64 seed = 0);
+    /// <summary>
+    /// 一次性计算哈希值
+    /// </summary>
+    static uint64 Compute(const ByteView& data, uint64 seed = 0);
+public:
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <returns>this</returns>
+    XxHash64& Update(const byte* data, int64 size);
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    XxHash64& Update(const ByteArray& data);
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    XxHash64& Update(const ByteView& data);
+    /// <summary>
+    /// 获取当前已追加数据的哈希值，不影响后续追加
+    /// </summary>
+    uint64 Finalize() const;
+    /// <summary>
+    /// 重置为初始状态
+    /// </summary>
+    /// <param name="seed">种子</param>
+    void Reset(uint64 seed = 0);
+private:
+    // 四路累加器
+    uint64 m_state[4];
+    // 未凑满 32 字节的尾部数据
+    byte m_buffer[32];
+    // 尾部数据字节数
+    int32 m_bufferSize;
+    // 已追加的总字节数
+    uint64 m_length;
+    // 种子
+    uint64 m_seed;
+};
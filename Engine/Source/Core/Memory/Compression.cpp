@@ -0,0 +1,1202 @@
+#include "pch.h"
+
+#include "Compression.h"
+#include "Platform.h"
+#include "Container/Array.h"
+
+#include <bit>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // 帧魔数
+    constexpr uint32 FRAME_MAGIC = 0x184D2204;
+    // 块头最高位：块未压缩
+    constexpr uint32 BLOCK_UNCOMPRESSED = 0x80000000u;
+    // 最小匹配长度
+    constexpr int64 MIN_MATCH = 4;
+    // 块末尾必须是字面量的字节数
+    constexpr int64 LAST_LITERALS = 5;
+    // 最后一个匹配的起点距块末尾的最小距离
+    constexpr int64 MF_LIMIT = 12;
+    // 匹配的最大回溯距离
+    constexpr int64 MAX_DISTANCE = 65535;
+    // 压缩块的最大膨胀倍数：每个长度扩展字节至多产生 255 字节输出
+    constexpr int64 MAX_EXPANSION = 255;
+    // 哈希表位数(4096 项，16 KB)
+    constexpr int32 HASH_LOG = 12;
+    // 跳跃搜索步长的增长速度
+    constexpr int32 SKIP_TRIGGER = 6;
+
+    // xxHash32 常量
+    constexpr uint32 PRIME32_1 = 2654435761u;
+    constexpr uint32 PRIME32_2 = 2246822519u;
+    constexpr uint32 PRIME32_3 = 3266489917u;
+    constexpr uint32 PRIME32_4 = 668265263u;
+    constexpr uint32 PRIME32_5 = 374761393u;
+
+    inline uint32 Read32(const byte* p)
+    {
+        uint32 value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64 Read64(const byte* p)
+    {
+        uint64 value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32 ReadLE32(const byte* p)
+    {
+        return static_cast<uint32>(p[0]) | (static_cast<uint32>(p[1]) << 8) |
+            (static_cast<uint32>(p[2]) << 16) | (static_cast<uint32>(p[3]) << 24);
+    }
+
+    inline uint64 ReadLE64(const byte* p)
+    {
+        return static_cast<uint64>(ReadLE32(p)) | (static_cast<uint64>(ReadLE32(p + 4)) << 32);
+    }
+
+    inline void WriteLE32(byte* p, uint32 value)
+    {
+        p[0] = static_cast<byte>(value);
+        p[1] = static_cast<byte>(value >> 8);
+        p[2] = static_cast<byte>(value >> 16);
+        p[3] = static_cast<byte>(value >> 24);
+    }
+
+    inline void AppendLE32(ByteArray& output, uint32 value)
+    {
+        byte buffer[4];
+        WriteLE32(buffer, value);
+        output.Append(buffer, 4);
+    }
+
+    inline uint32 RotateLeft(uint32 value, int32 count)
+    {
+        return (value << count) | (value >> (32 - count));
+    }
+
+    inline uint32 HashPosition(uint32 sequence)
+    {
+        return (sequence * PRIME32_1) >> (32 - HASH_LOG);
+    }
+
+    /// <summary>
+    /// 计算两处数据的公共前缀长度，不超过 limit
+    /// </summary>
+    inline int64 CountMatch(const byte* ip, const byte* match, const byte* limit)
+    {
+        const byte* start = ip;
+        while (ip + 8 <= limit)
+        {
+            uint64 diff = Read64(ip) ^ Read64(match);
+            if (diff != 0)
+            {
+#if defined(PLATFORM_LITTLE_ENDIAN)
+                return (ip - start) + (std::countr_zero(diff) >> 3);
+#else
+                return (ip - start) + (std::countl_zero(diff) >> 3);
+#endif
+            }
+            ip += 8;
+            match += 8;
+        }
+        while (ip < limit && *ip == *match)
+        {
+            ++ip;
+            ++match;
+        }
+        return ip - start;
+    }
+
+    /// <summary>
+    /// 写出长度扩展字节(每字节 255，最后一个字节为余数)
+    /// </summary>
+    inline byte* WriteLength(byte* op, int64 length)
+    {
+        while (length >= 255)
+        {
+            *op++ = static_cast<byte>(255);
+            length -= 255;
+        }
+        *op++ = static_cast<byte>(length);
+        return op;
+    }
+
+    /// <summary>
+    /// 读取长度扩展字节
+    /// </summary>
+    inline bool ReadLength(const byte*& ip, const byte* end, int64& length)
+    {
+        uint32 value;
+        do
+        {
+            if (ip >= end) [[unlikely]]
+            {
+                return false;
+            }
+            value = static_cast<uint32>(*ip++);
+            length += value;
+        } while (value == 255);
+        return true;
+    }
+
+    /// <summary>
+    /// 解压一个块，匹配可回溯到 lowLimit(用于块间字典)
+    /// </summary>
+    int64 DecodeBlock(const byte* src, int64 srcSize, byte* dst, int64 dstCapacity, const byte* lowLimit)
+    {
+        const byte* ip = src;
+        const byte* iend = src + srcSize;
+        byte* op = dst;
+        byte* oend = dst + dstCapacity;
+
+        while (true)
+        {
+            if (ip >= iend) [[unlikely]]
+            {
+                return -1;
+            }
+            uint32 token = static_cast<uint32>(*ip++);
+
+            // 字面量
+            int64 literalLength = token >> 4;
+            if (literalLength == 15 && !ReadLength(ip, iend, literalLength)) [[unlikely]]
+            {
+                return -1;
+            }
+            if (literalLength > iend - ip || literalLength > oend - op) [[unlikely]]
+            {
+                return -1;
+            }
+            std::memcpy(op, ip, static_cast<size_t>(literalLength));
+            op += literalLength;
+            ip += literalLength;
+
+            // 最后一个序列只有字面量
+            if (ip == iend)
+            {
+                break;
+            }
+
+            // 匹配
+            if (iend - ip < 2) [[unlikely]]
+            {
+                return -1;
+            }
+            int64 offset = static_cast<int64>(ip[0]) | (static_cast<int64>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > op - lowLimit) [[unlikely]]
+            {
+                return -1;
+            }
+
+            int64 matchLength = token & 15;
+            if (matchLength == 15 && !ReadLength(ip, iend, matchLength)) [[unlikely]]
+            {
+                return -1;
+            }
+            matchLength += MIN_MATCH;
+            if (matchLength > oend - op) [[unlikely]]
+            {
+                return -1;
+            }
+
+            const byte* match = op - offset;
+            byte* copyEnd = op + matchLength;
+            if (offset >= 8 && oend - copyEnd >= 8)
+            {
+                // 源与目标相距至少 8 字节，可按 8 字节整块复制，允许越过 copyEnd 写入
+                do
+                {
+                    std::memcpy(op, match, 8);
+                    op += 8;
+                    match += 8;
+                } while (op < copyEnd);
+            }
+            else
+            {
+                // 重叠复制(如 offset 为 1 的游程)，必须逐字节进行
+                while (op < copyEnd)
+                {
+                    *op++ = *match++;
+                }
+            }
+            op = copyEnd;
+        }
+        return op - dst;
+    }
+
+    /// <summary>
+    /// 获取块大小枚举对应的字节数
+    /// </summary>
+    inline int64 BlockMaxSize(Lz4BlockSize blockSize)
+    {
+        return int64(1) << (8 + 2 * static_cast<int32>(blockSize));
+    }
+
+    /// <summary>
+    /// 解析线程数参数
+    /// </summary>
+    inline int32 ResolveThreadCount(int32 threadCount, int64 taskCount)
+    {
+        if (threadCount <= 0)
+        {
+            threadCount = static_cast<int32>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        return static_cast<int32>(std::min<int64>(threadCount, taskCount));
+    }
+
+    /// <summary>
+    /// 在 threadCount 个线程(含调用线程)上执行 task(0..count-1)
+    /// <para>任务抛出异常时不再分配剩余任务，等待所有线程结束后在调用线程重新抛出第一个异常</para>
+    /// </summary>
+    template<class Task>
+    void ParallelFor(int64 count, int32 threadCount, Task&& task)
+    {
+        std::atomic<int64> next = 0;
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        auto worker = [&]() {
+            for (int64 i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                try
+                {
+                    task(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(errorMutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                    next.store(count, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (int32 i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /// <summary>
+    /// 压缩一个块并以帧块格式(块头 + 数据)追加到 output，压缩无收益时存储原始数据
+    /// </summary>
+    void AppendFrameBlock(ByteArray& output, const byte* data, int64 size)
+    {
+        int64 start = output.Size();
+        output.Resize(start + 4 + size);
+        int64 compressed = Lz4::CompressBlock(data, size, output.Data() + start + 4, size - 1);
+        if (compressed > 0)
+        {
+            WriteLE32(output.Data() + start, static_cast<uint32>(compressed));
+            output.Resize(start + 4 + compressed);
+        }
+        else
+        {
+            WriteLE32(output.Data() + start, static_cast<uint32>(size) | BLOCK_UNCOMPRESSED);
+            std::memcpy(output.Data() + start + 4, data, static_cast<size_t>(size));
+        }
+    }
+
+    /// <summary>
+    /// 帧头描述
+    /// </summary>
+    struct FrameHeader
+    {
+        int64 BlockMax = 0;
+        int64 ContentSize = -1;
+        int64 HeaderSize = 0;
+        bool Independent = true;
+        bool BlockChecksum = false;
+        bool ContentChecksum = false;
+    };
+
+    /// <summary>
+    /// 写出帧头
+    /// </summary>
+    void AppendFrameHeader(ByteArray& output, Lz4BlockSize blockSize, int64 contentSize)
+    {
+        byte header[15];
+        WriteLE32(header, FRAME_MAGIC);
+        // 版本 01，块独立，带内容校验，按需带内容大小
+        uint32 flags = 0x40 | 0x20 | 0x04 | (contentSize >= 0 ? 0x08 : 0);
+        header[4] = static_cast<byte>(flags);
+        header[5] = static_cast<byte>(static_cast<int32>(blockSize) << 4);
+        int64 size = 6;
+        if (contentSize >= 0)
+        {
+            WriteLE32(header + 6, static_cast<uint32>(contentSize));
+            WriteLE32(header + 10, static_cast<uint32>(static_cast<uint64>(contentSize) >> 32));
+            size = 14;
+        }
+        header[size] = static_cast<byte>((Lz4Checksum::Compute(header + 4, size - 4) >> 8) & 0xFF);
+        output.Append(header, size + 1);
+    }
+
+    /// <summary>
+    /// 解析帧头
+    /// </summary>
+    /// <returns>1 成功，0 数据不足，-1 格式错误</returns>
+    int32 ParseFrameHeader(const byte* data, int64 size, FrameHeader& header)
+    {
+        if (size < 7)
+        {
+            return 0;
+        }
+        if (ReadLE32(data) != FRAME_MAGIC)
+        {
+            return -1;
+        }
+        uint32 flags = static_cast<uint32>(data[4]);
+        uint32 descriptor = static_cast<uint32>(data[5]);
+        // 版本必须为 01，保留位必须为 0，不支持外部字典
+        if ((flags >> 6) != 1 || (flags & 0x03) != 0 || (descriptor & 0x8F) != 0)
+        {
+            return -1;
+        }
+        int32 blockId = static_cast<int32>(descriptor >> 4);
+        if (blockId < 4)
+        {
+            return -1;
+        }
+
+        int64 headerSize = (flags & 0x08) ? 15 : 7;
+        if (size < headerSize)
+        {
+            return 0;
+        }
+        uint8 check = static_cast<uint8>((Lz4Checksum::Compute(data + 4, headerSize - 5) >> 8) & 0xFF);
+        if (check != static_cast<uint8>(data[headerSize - 1]))
+        {
+            return -1;
+        }
+
+        header.BlockMax = BlockMaxSize(static_cast<Lz4BlockSize>(blockId));
+        header.Independent = (flags & 0x20) != 0;
+        header.BlockChecksum = (flags & 0x10) != 0;
+        header.ContentChecksum = (flags & 0x04) != 0;
+        header.ContentSize = -1;
+        if (flags & 0x08)
+        {
+            uint64 contentSize = ReadLE64(data + 6);
+            if (contentSize > static_cast<uint64>(INT64_MAX))
+            {
+                return -1;
+            }
+            header.ContentSize = static_cast<int64>(contentSize);
+        }
+        header.HeaderSize = headerSize;
+        return 1;
+    }
+}
+
+/* Lz4Checksum */
+Lz4Checksum::Lz4Checksum(uint32 seed)
+{
+    Reset(seed);
+}
+
+uint32 Lz4Checksum::Compute(const byte* data, int64 size, uint32 seed)
+{
+    Lz4Checksum checksum(seed);
+    checksum.Update(data, size);
+    return checksum.Finalize();
+}
+
+void Lz4Checksum::Update(const byte* data, int64 size)
+{
+    auto round = [](uint32 acc, uint32 input) {
+        return RotateLeft(acc + input * PRIME32_2, 13) * PRIME32_1;
+    };
+
+    m_length += size;
+
+    // 先补齐上次留下的尾部
+    if (m_bufferSize > 0)
+    {
+        int64 fill = std::min<int64>(16 - m_bufferSize, size);
+        std::memcpy(m_buffer + m_bufferSize, data, static_cast<size_t>(fill));
+        m_bufferSize += static_cast<int32>(fill);
+        data += fill;
+        size -= fill;
+        if (m_bufferSize < 16)
+        {
+            return;
+        }
+        for (int32 i = 0; i < 4; ++i)
+        {
+            m_state[i] = round(m_state[i], ReadLE32(m_buffer + i * 4));
+        }
+        m_bufferSize = 0;
+    }
+
+    uint32 v1 = m_state[0], v2 = m_state[1], v3 = m_state[2], v4 = m_state[3];
+    while (size >= 16)
+    {
+        v1 = round(v1, ReadLE32(data));
+        v2 = round(v2, ReadLE32(data + 4));
+        v3 = round(v3, ReadLE32(data + 8));
+        v4 = round(v4, ReadLE32(data + 12));
+        data += 16;
+        size -= 16;
+    }
+    m_state[0] = v1;
+    m_state[1] = v2;
+    m_state[2] = v3;
+    m_state[3] = v4;
+
+    if (size > 0)
+    {
+        std::memcpy(m_buffer, data, static_cast<size_t>(size));
+        m_bufferSize = static_cast<int32>(size);
+    }
+}
+
+uint32 Lz4Checksum::Finalize() const
+{
+    uint32 hash;
+    if (m_length >= 16)
+    {
+        hash = RotateLeft(m_state[0], 1) + RotateLeft(m_state[1], 7) + RotateLeft(m_state[2], 12) + RotateLeft(m_state[3], 18);
+    }
+    else
+    {
+        hash = m_seed + PRIME32_5;
+    }
+    hash += static_cast<uint32>(m_length);
+
+    const byte* p = m_buffer;
+    const byte* end = m_buffer + m_bufferSize;
+    while (p + 4 <= end)
+    {
+        hash = RotateLeft(hash + ReadLE32(p) * PRIME32_3, 17) * PRIME32_4;
+        p += 4;
+    }
+    while (p < end)
+    {
+        hash = RotateLeft(hash + static_cast<uint32>(*p) * PRIME32_5, 11) * PRIME32_1;
+        ++p;
+    }
+
+    hash ^= hash >> 15;
+    hash *= PRIME32_2;
+    hash ^= hash >> 13;
+    hash *= PRIME32_3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+void Lz4Checksum::Reset(uint32 seed)
+{
+    m_seed = seed;
+    m_state[0] = seed + PRIME32_1 + PRIME32_2;
+    m_state[1] = seed + PRIME32_2;
+    m_state[2] = seed;
+    m_state[3] = seed - PRIME32_1;
+    m_bufferSize = 0;
+    m_length = 0;
+}
+
+/* Lz4 */
+int64 Lz4::CompressBound(int64 size)
+{
+    if (size < 0 || size > MAX_INPUT_SIZE)
+    {
+        return 0;
+    }
+    return size + size / 255 + 16;
+}
+
+int64 Lz4::CompressBlock(const byte* src, int64 srcSize, byte* dst, int64 dstCapacity, int32 acceleration)
+{
+    if (srcSize < 0 || srcSize > MAX_INPUT_SIZE || dstCapacity <= 0) [[unlikely]]
+    {
+        return -1;
+    }
+    acceleration = std::max(acceleration, 1);
+
+    const byte* ip = src;
+    const byte* anchor = src;
+    const byte* iend = src + srcSize;
+    const byte* mflimit = iend - MF_LIMIT;
+    const byte* matchLimit = iend - LAST_LITERALS;
+    byte* op = dst;
+    byte* oend = dst + dstCapacity;
+
+    // 哈希表记录每个 4 字节序列最近出现的位置(相对 src 的偏移)
+    uint32 table[1 << HASH_LOG] = {};
+
+    if (srcSize >= MF_LIMIT + 1)
+    {
+        ++ip;
+        while (true)
+        {
+            // 查找匹配：连续失败时步长逐渐增大，快速跳过不可压缩的数据
+            const byte* match;
+            int32 searchCount = acceleration << SKIP_TRIGGER;
+            while (true)
+            {
+                uint32 hash = HashPosition(Read32(ip));
+                match = src + table[hash];
+                table[hash] = static_cast<uint32>(ip - src);
+                if (match < ip && ip - match <= MAX_DISTANCE && Read32(match) == Read32(ip))
+                {
+                    break;
+                }
+                ip += searchCount++ >> SKIP_TRIGGER;
+                if (ip > mflimit)
+                {
+                    goto LastLiterals;
+                }
+            }
+
+            // 向前扩展匹配
+            while (ip > anchor && match > src && ip[-1] == match[-1])
+            {
+                --ip;
+                --match;
+            }
+
+            int64 literalLength = ip - anchor;
+            int64 matchLength = CountMatch(ip + MIN_MATCH, match + MIN_MATCH, matchLimit);
+
+            // token + 字面量长度扩展 + 字面量 + 偏移 + 匹配长度扩展
+            if (oend - op < 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1) [[unlikely]]
+            {
+                return -1;
+            }
+
+            byte* token = op++;
+            uint32 tokenValue;
+            if (literalLength >= 15)
+            {
+                tokenValue = 15 << 4;
+                op = WriteLength(op, literalLength - 15);
+            }
+            else
+            {
+                tokenValue = static_cast<uint32>(literalLength) << 4;
+            }
+            std::memcpy(op, anchor, static_cast<size_t>(literalLength));
+            op += literalLength;
+
+            uint32 offset = static_cast<uint32>(ip - match);
+            *op++ = static_cast<byte>(offset);
+            *op++ = static_cast<byte>(offset >> 8);
+
+            if (matchLength >= 15)
+            {
+                tokenValue |= 15;
+                op = WriteLength(op, matchLength - 15);
+            }
+            else
+            {
+                tokenValue |= static_cast<uint32>(matchLength);
+            }
+            *token = static_cast<byte>(tokenValue);
+
+            ip += MIN_MATCH + matchLength;
+            anchor = ip;
+            if (ip > mflimit)
+            {
+                break;
+            }
+            // 记录匹配末尾附近的位置，提高下一次命中率
+            table[HashPosition(Read32(ip - 2))] = static_cast<uint32>(ip - 2 - src);
+        }
+    }
+
+LastLiterals:
+    int64 literalLength = iend - anchor;
+    if (oend - op < 1 + literalLength / 255 + 1 + literalLength) [[unlikely]]
+    {
+        return -1;
+    }
+    if (literalLength >= 15)
+    {
+        *op++ = static_cast<byte>(15 << 4);
+        op = WriteLength(op, literalLength - 15);
+    }
+    else
+    {
+        *op++ = static_cast<byte>(literalLength << 4);
+    }
+    std::memcpy(op, anchor, static_cast<size_t>(literalLength));
+    op += literalLength;
+    return op - dst;
+}
+
+int64 Lz4::DecompressBlock(const byte* src, int64 srcSize, byte* dst, int64 dstCapacity)
+{
+    if (src == nullptr || srcSize <= 0 || dstCapacity < 0) [[unlikely]]
+    {
+        return -1;
+    }
+    return DecodeBlock(src, srcSize, dst, dstCapacity, dst);
+}
+
+ByteArray Lz4::Compress(const byte* data, int64 size, Lz4BlockSize blockSize, int32 threadCount)
+{
+    ByteArray output;
+    int64 blockMax = BlockMaxSize(blockSize);
+    int64 blockCount = (size + blockMax - 1) / blockMax;
+    output.Reserve(15 + size + blockCount * 4 + 8);
+    AppendFrameHeader(output, blockSize, size);
+
+    threadCount = ResolveThreadCount(threadCount, blockCount);
+    if (threadCount <= 1)
+    {
+        for (int64 offset = 0; offset < size; offset += blockMax)
+        {
+            AppendFrameBlock(output, data + offset, std::min(blockMax, size - offset));
+        }
+        AppendLE32(output, 0);
+        AppendLE32(output, Lz4Checksum::Compute(data, size));
+        return output;
+    }
+
+    // 各块相互独立，分别压缩到各自的缓冲区后按顺序拼接
+    Array<ByteArray> blocks(blockCount);
+    uint32 contentChecksum = 0;
+    ParallelFor(blockCount + 1, threadCount, [&](int64 index) {
+        if (index == blockCount)
+        {
+            contentChecksum = Lz4Checksum::Compute(data, size);
+            return;
+        }
+        int64 offset = index * blockMax;
+        int64 length = std::min(blockMax, size - offset);
+        blocks[index].Reserve(4 + length);
+        AppendFrameBlock(blocks[index], data + offset, length);
+    });
+
+    for (auto& block : blocks)
+    {
+        output.Append(block.Data(), block.Size());
+    }
+    AppendLE32(output, 0);
+    AppendLE32(output, contentChecksum);
+    return output;
+}
+
+ByteArray Lz4::Compress(const ByteArray& data, Lz4BlockSize blockSize, int32 threadCount)
+{
+    return Compress(data.Data(), data.Size(), blockSize, threadCount);
+}
+
+ByteArray Lz4::Compress(const ByteView& data, Lz4BlockSize blockSize, int32 threadCount)
+{
+    return Compress(data.Data(), data.Size(), blockSize, threadCount);
+}
+
+bool Lz4::TryDecompress(const byte* data, int64 size, ByteArray& output, int32 threadCount)
+{
+    output.Clear();
+
+    FrameHeader header;
+    if (ParseFrameHeader(data, size, header) != 1)
+    {
+        return false;
+    }
+
+    // 先遍历块头，确定每个块的位置，以及由块大小推出的解压后大小上限(不信任帧头声明的大小)
+    struct BlockInfo
+    {
+        const byte* Data;
+        int64 Size;
+        bool Compressed;
+        // 解压后大小上限
+        int64 Capacity;
+    };
+    Array<BlockInfo> blocks;
+    int64 capacity = 0;
+    const byte* ip = data + header.HeaderSize;
+    const byte* iend = data + size;
+    int64 checksumSize = header.BlockChecksum ? 4 : 0;
+    while (true)
+    {
+        if (iend - ip < 4)
+        {
+            return false;
+        }
+        uint32 blockHeader = ReadLE32(ip);
+        ip += 4;
+        if (blockHeader == 0)
+        {
+            break;
+        }
+        int64 blockSize = blockHeader & ~BLOCK_UNCOMPRESSED;
+        if (blockSize > header.BlockMax || iend - ip < blockSize + checksumSize)
+        {
+            return false;
+        }
+        if (header.BlockChecksum && Lz4Checksum::Compute(ip, blockSize) != ReadLE32(ip + blockSize))
+        {
+            return false;
+        }
+        bool compressed = (blockHeader & BLOCK_UNCOMPRESSED) == 0;
+        int64 blockCapacity = compressed ? std::min(header.BlockMax, blockSize * MAX_EXPANSION) : blockSize;
+        blocks.Add(BlockInfo{ ip, blockSize, compressed, blockCapacity });
+        capacity += blockCapacity;
+        ip += blockSize + checksumSize;
+    }
+    if (header.ContentChecksum)
+    {
+        if (iend - ip < 4)
+        {
+            return false;
+        }
+        ip += 4;
+    }
+    // 声明的大小超出全部块可能解压出的上限时，帧一定是损坏的
+    if (ip != iend || header.ContentSize > capacity)
+    {
+        return false;
+    }
+
+    int64 blockCount = blocks.Size();
+    threadCount = header.Independent ? ResolveThreadCount(threadCount, blockCount) : 1;
+    int64 total = 0;
+    if (threadCount <= 1)
+    {
+        // 已知大小时一次预留，否则随解压逐块增长
+        if (header.ContentSize >= 0)
+        {
+            output.Reserve(header.ContentSize);
+        }
+        for (const auto& block : blocks)
+        {
+            output.Resize(total + block.Capacity);
+            byte* dst = output.Data() + total;
+            int64 decoded = block.Size;
+            if (block.Compressed)
+            {
+                const byte* lowLimit = header.Independent ? dst : output.Data();
+                decoded = DecodeBlock(block.Data, block.Size, dst, block.Capacity, lowLimit);
+                if (decoded < 0)
+                {
+                    output.Clear();
+                    return false;
+                }
+            }
+            else
+            {
+                std::memcpy(dst, block.Data, static_cast<size_t>(block.Size));
+            }
+            total += decoded;
+        }
+    }
+    else
+    {
+        // 每个块按大小上限解压到各自的位置，最后压紧未满的块留下的空隙
+        output.Resize(capacity);
+        Array<int64> offsets(blockCount);
+        for (int64 i = 0, offset = 0; i < blockCount; ++i)
+        {
+            offsets[i] = offset;
+            offset += blocks[i].Capacity;
+        }
+        Array<int64> decodedSizes(blockCount);
+        std::atomic<bool> failed = false;
+        // 解码与复制都不会抛出异常
+        ParallelFor(blockCount, threadCount, [&](int64 index) {
+            const BlockInfo& block = blocks[index];
+            byte* dst = output.Data() + offsets[index];
+            if (block.Compressed)
+            {
+                decodedSizes[index] = DecodeBlock(block.Data, block.Size, dst, block.Capacity, dst);
+                if (decodedSizes[index] < 0)
+                {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                std::memcpy(dst, block.Data, static_cast<size_t>(block.Size));
+                decodedSizes[index] = block.Size;
+            }
+        });
+        if (failed.load())
+        {
+            output.Clear();
+            return false;
+        }
+        for (int64 i = 0; i < blockCount; ++i)
+        {
+            const byte* src = output.Data() + offsets[i];
+            if (src != output.Data() + total)
+            {
+                std::memmove(output.Data() + total, src, static_cast<size_t>(decodedSizes[i]));
+            }
+            total += decodedSizes[i];
+        }
+    }
+    output.Resize(total);
+
+    if ((header.ContentSize >= 0 && header.ContentSize != total) ||
+        (header.ContentChecksum && Lz4Checksum::Compute(output.Data(), total) != ReadLE32(iend - 4)))
+    {
+        output.Clear();
+        return false;
+    }
+    return true;
+}
+
+ByteArray Lz4::Decompress(const byte* data, int64 size, int32 threadCount)
+{
+    ByteArray output;
+    if (!TryDecompress(data, size, output, threadCount)) [[unlikely]]
+    {
+        throw std::invalid_argument("Invalid or corrupted LZ4 frame");
+    }
+    return output;
+}
+
+ByteArray Lz4::Decompress(const ByteArray& data, int32 threadCount)
+{
+    return Decompress(data.Data(), data.Size(), threadCount);
+}
+
+ByteArray Lz4::Decompress(const ByteView& data, int32 threadCount)
+{
+    return Decompress(data.Data(), data.Size(), threadCount);
+}
+
+/* Lz4Encoder */
+Lz4Encoder::Lz4Encoder(Sink sink, Lz4BlockSize blockSize)
+    : m_sink(std::move(sink))
+    , m_blockSize(blockSize)
+{
+
+}
+
+void Lz4Encoder::Write(const byte* data, int64 size)
+{
+    if (m_finished) [[unlikely]]
+    {
+        throw std::logic_error("Lz4Encoder::Write called after Finish");
+    }
+    if (size <= 0)
+    {
+        return;
+    }
+
+    m_checksum.Update(data, size);
+    m_inputSize += size;
+
+    int64 blockMax = BlockMaxSize(m_blockSize);
+    // 先补齐上次未凑满的块
+    if (!m_pending.IsEmpty())
+    {
+        int64 fill = std::min(blockMax - m_pending.Size(), size);
+        m_pending.Append(data, fill);
+        data += fill;
+        size -= fill;
+        if (m_pending.Size() < blockMax)
+        {
+            return;
+        }
+        _FlushBlock(m_pending.Data(), m_pending.Size());
+        m_pending.Clear();
+    }
+    // 整块直接从输入压缩，不经过缓冲
+    while (size >= blockMax)
+    {
+        _FlushBlock(data, blockMax);
+        data += blockMax;
+        size -= blockMax;
+    }
+    if (size > 0)
+    {
+        m_pending.Reserve(blockMax);
+        m_pending.Append(data, size);
+    }
+}
+
+void Lz4Encoder::Write(const ByteArray& data)
+{
+    Write(data.Data(), data.Size());
+}
+
+void Lz4Encoder::Write(const ByteView& data)
+{
+    Write(data.Data(), data.Size());
+}
+
+void Lz4Encoder::Finish()
+{
+    if (m_finished)
+    {
+        return;
+    }
+    if (!m_pending.IsEmpty())
+    {
+        _FlushBlock(m_pending.Data(), m_pending.Size());
+        m_pending.Clear();
+    }
+    _WriteHeader();
+
+    m_output.Clear();
+    AppendLE32(m_output, 0);
+    AppendLE32(m_output, m_checksum.Finalize());
+    m_sink(m_output.Data(), m_output.Size());
+    m_finished = true;
+}
+
+bool Lz4Encoder::IsFinished() const
+{
+    return m_finished;
+}
+
+int64 Lz4Encoder::InputSize() const
+{
+    return m_inputSize;
+}
+
+void Lz4Encoder::_WriteHeader()
+{
+    if (m_headerWritten)
+    {
+        return;
+    }
+    // 流式压缩事先不知道内容大小，帧头不带内容大小
+    m_output.Clear();
+    AppendFrameHeader(m_output, m_blockSize, -1);
+    m_sink(m_output.Data(), m_output.Size());
+    m_headerWritten = true;
+}
+
+void Lz4Encoder::_FlushBlock(const byte* data, int64 size)
+{
+    _WriteHeader();
+    m_output.Clear();
+    AppendFrameBlock(m_output, data, size);
+    m_sink(m_output.Data(), m_output.Size());
+}
+
+/* Lz4Decoder */
+Lz4Decoder::Lz4Decoder(Sink sink)
+    : m_sink(std::move(sink))
+{
+
+}
+
+bool Lz4Decoder::Write(const byte* data, int64 size)
+{
+    if (m_state == State::Error)
+    {
+        return false;
+    }
+    if (size <= 0)
+    {
+        return true;
+    }
+    if (m_state == State::Finished)
+    {
+        m_state = State::Error;
+        return false;
+    }
+
+    m_input.Append(data, size);
+    bool success = _Process();
+    // 丢弃已消费的输入，剩余不足一个块
+    if (m_inputPos > 0)
+    {
+        m_input.Remove(0, m_inputPos);
+        m_inputPos = 0;
+    }
+    if (!success)
+    {
+        m_state = State::Error;
+    }
+    return success;
+}
+
+bool Lz4Decoder::Write(const ByteArray& data)
+{
+    return Write(data.Data(), data.Size());
+}
+
+bool Lz4Decoder::Write(const ByteView& data)
+{
+    return Write(data.Data(), data.Size());
+}
+
+bool Lz4Decoder::IsFinished() const
+{
+    return m_state == State::Finished;
+}
+
+bool Lz4Decoder::IsError() const
+{
+    return m_state == State::Error;
+}
+
+void Lz4Decoder::Reset()
+{
+    m_state = State::Header;
+    m_input.Clear();
+    m_inputPos = 0;
+    m_window.Clear();
+    m_historySize = 0;
+    m_blockHeader = 0;
+    m_outputSize = 0;
+    m_contentSize = -1;
+    m_checksum.Reset();
+}
+
+bool Lz4Decoder::_Process()
+{
+    while (true)
+    {
+        const byte* ip = m_input.Data() + m_inputPos;
+        int64 available = m_input.Size() - m_inputPos;
+
+        switch (m_state)
+        {
+        case State::Header:
+        {
+            FrameHeader header;
+            int32 result = ParseFrameHeader(ip, available, header);
+            if (result <= 0)
+            {
+                return result == 0;
+            }
+            m_blockMax = header.BlockMax;
+            m_independent = header.Independent;
+            m_blockChecksum = header.BlockChecksum;
+            m_contentChecksum = header.ContentChecksum;
+            m_contentSize = header.ContentSize;
+            m_inputPos += header.HeaderSize;
+            m_state = State::BlockSize;
+            break;
+        }
+        case State::BlockSize:
+        {
+            if (available < 4)
+            {
+                return true;
+            }
+            m_blockHeader = ReadLE32(ip);
+            m_inputPos += 4;
+            if (m_blockHeader == 0)
+            {
+                if (m_contentSize >= 0 && m_contentSize != m_outputSize)
+                {
+                    return false;
+                }
+                m_state = m_contentChecksum ? State::ContentChecksum : State::Finished;
+            }
+            else if ((m_blockHeader & ~BLOCK_UNCOMPRESSED) > static_cast<uint64>(m_blockMax))
+            {
+                return false;
+            }
+            else
+            {
+                m_state = State::BlockData;
+            }
+            break;
+        }
+        case State::BlockData:
+        {
+            int64 blockSize = m_blockHeader & ~BLOCK_UNCOMPRESSED;
+            int64 required = blockSize + (m_blockChecksum ? 4 : 0);
+            if (available < required)
+            {
+                return true;
+            }
+            if (m_blockChecksum && Lz4Checksum::Compute(ip, blockSize) != ReadLE32(ip + blockSize))
+            {
+                return false;
+            }
+
+            if (m_blockHeader & BLOCK_UNCOMPRESSED)
+            {
+                _Emit(ip, blockSize);
+            }
+            else
+            {
+                // 窗口 = 最近的输出(字典) + 本块的解压空间
+                m_window.Resize(m_historySize + m_blockMax);
+                byte* dst = m_window.Data() + m_historySize;
+                int64 decoded = DecodeBlock(ip, blockSize, dst, m_blockMax, m_window.Data());
+                if (decoded < 0)
+                {
+                    return false;
+                }
+                _Emit(dst, decoded);
+            }
+            m_inputPos += required;
+            m_state = State::BlockSize;
+            break;
+        }
+        case State::ContentChecksum:
+        {
+            if (available < 4)
+            {
+                return true;
+            }
+            if (ReadLE32(ip) != m_checksum.Finalize())
+            {
+                return false;
+            }
+            m_inputPos += 4;
+            m_state = State::Finished;
+            break;
+        }
+        case State::Finished:
+            // 帧结束后不允许再有数据
+            return available == 0;
+        default:
+            return false;
+        }
+    }
+}
+
+void Lz4Decoder::_Emit(const byte* data, int64 size)
+{
+    m_sink(data, size);
+    m_checksum.Update(data, size);
+    m_outputSize += size;
+
+    if (m_independent)
+    {
+        return;
+    }
+
+    // 保留最近 64 KB 输出作为下一个块的字典
+    int64 keep = std::min<int64>(MAX_DISTANCE, m_historySize + size);
+    ByteArray history(keep);
+    int64 fromData = std::min(keep, size);
+    int64 fromHistory = keep - fromData;
+    if (fromHistory > 0)
+    {
+        std::memcpy(history.Data(), m_window.Data() + m_historySize - fromHistory, static_cast<size_t>(fromHistory));
+    }
+    std::memcpy(history.Data() + fromHistory, data + size - fromData, static_cast<size_t>(fromData));
+    m_window = std::move(history);
+    m_historySize = keep;
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include "Core.h"
+#include "ByteArray.h"
+#include "ByteView.h"
+
+#include <functional>
+
+/// <summary>
+/// LZ4 帧的最大块大小
+/// </summary>
+enum class Lz4BlockSize
+{
+    // 64 KB
+    Max64KB = 4,
+    // 256 KB
+    Max256KB = 5,
+    // 1 MB
+    Max1MB = 6,
+    // 4 MB
+    Max4MB = 7
+};
+
+/// <summary>
+/// LZ4 帧使用的 xxHash32 校验，支持增量计算
+/// </summary>
+class Lz4Checksum
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="seed">种子</param>
+    explicit Lz4Checksum(uint32 seed = 0);
+public:
+    /// <summary>
+    /// 一次性计算校验值
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <param name="seed">种子</param>
+    /// <returns>校验值</returns>
+    static uint32 Compute(const byte* data, int64 size, uint32 seed = 0);
+public:
+    /// <summary>
+    /// 追加数据
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    void Update(const byte* data, int64 size);
+    /// <summary>
+    /// 获取当前已追加数据的校验值，不影响后续追加
+    /// </summary>
+    uint32 Finalize() const;
+    /// <summary>
+    /// 重置为初始状态
+    /// </summary>
+    void Reset(uint32 seed = 0);
+private:
+    // 四路累加器
+    uint32 m_state[4];
+    // 未凑满 16 字节的尾部数据
+    byte m_buffer[16];
+    // 尾部数据字节数
+    int32 m_bufferSize;
+    // 已追加的总字节数
+    int64 m_length;
+    // 种子
+    uint32 m_seed;
+};
+
+/// <summary>
+/// LZ4 压缩编解码器
+/// <para>块格式与帧格式均与 LZ4 官方格式兼容，帧内各块相互独立，可并行压缩和解压</para>
+/// </summary>
+class Lz4
+{
+public:
+    /// <summary>
+    /// 单个块允许的最大输入字节数
+    /// </summary>
+    static constexpr int64 MAX_INPUT_SIZE = 0x7E000000;
+public:
+    /// <summary>
+    /// 计算块压缩在最坏情况下的输出字节数
+    /// </summary>
+    /// <param name="size">输入字节数</param>
+    /// <returns>输出缓冲区所需的最小容量，输入过大时返回 0</returns>
+    static int64 CompressBound(int64 size);
+    /// <summary>
+    /// 压缩单个块(无帧头)
+    /// </summary>
+    /// <param name="src">输入数据</param>
+    /// <param name="srcSize">输入字节数</param>
+    /// <param name="dst">输出缓冲区</param>
+    /// <param name="dstCapacity">输出缓冲区容量</param>
+    /// <param name="acceleration">加速因子，越大越快但压缩率越低</param>
+    /// <returns>压缩后的字节数，输出缓冲区不足时返回 -1</returns>
+    static int64 CompressBlock(const byte* src, int64 srcSize, byte* dst, int64 dstCapacity, int32 acceleration = 1);
+    /// <summary>
+    /// 解压单个块(无帧头)，对损坏的输入是安全的
+    /// </summary>
+    /// <param name="src">压缩数据</param>
+    /// <param name="srcSize">压缩数据字节数</param>
+    /// <param name="dst">输出缓冲区</param>
+    /// <param name="dstCapacity">输出缓冲区容量</param>
+    /// <returns>解压后的字节数，数据损坏或输出缓冲区不足时返回 -1</returns>
+    static int64 DecompressBlock(const byte* src, int64 srcSize, byte* dst, int64 dstCapacity);
+    /// <summary>
+    /// 压缩为 LZ4 帧
+    /// </summary>
+    /// <param name="data">输入数据</param>
+    /// <param name="size">输入字节数</param>
+    /// <param name="blockSize">最大块大小</param>
+    /// <param name="threadCount">并行压缩的线程数，0 表示使用全部硬件线程</param>
+    /// <returns>压缩后的帧</returns>
+    static ByteArray Compress(const byte* data, int64 size, Lz4BlockSize blockSize = Lz4BlockSize::Max256KB, int32 threadCount = 1);
+    /// <summary>
+    /// 压缩为 LZ4 帧
+    /// </summary>
+    static ByteArray Compress(const ByteArray& data, Lz4BlockSize blockSize = Lz4BlockSize::Max256KB, int32 threadCount = 1);
+    /// <summary>
+    /// 压缩为 LZ4 帧
+    /// </summary>
+    static ByteArray Compress(const ByteView& data, Lz4BlockSize blockSize = Lz4BlockSize::Max256KB, int32 threadCount = 1);
+    /// <summary>
+    /// 解压 LZ4 帧
+    /// </summary>
+    /// <param name="data">帧数据</param>
+    /// <param name="size">帧字节数</param>
+    /// <param name="output">解压结果</param>
+    /// <param name="threadCount">并行解压的线程数，0 表示使用全部硬件线程；块之间存在依赖时退化为单线程</param>
+    /// <returns>帧格式错误、数据损坏或校验失败时返回 false</returns>
+    static bool TryDecompress(const byte* data, int64 size, ByteArray& output, int32 threadCount = 1);
+    /// <summary>
+    /// 解压 LZ4 帧
+    /// </summary>
+    /// <param name="data">帧数据</param>
+    /// <param name="size">帧字节数</param>
+    /// <param name="threadCount">并行解压的线程数，0 表示使用全部硬件线程</param>
+    /// <returns>解压结果</returns>
+    /// <exception cref="std::invalid_argument">帧格式错误、数据损坏或校验失败时抛出</exception>
+    static ByteArray Decompress(const byte* data, int64 size, int32 threadCount = 1);
+    /// <summary>
+    /// 解压 LZ4 帧
+    /// </summary>
+    /// <exception cref="std::invalid_argument">帧格式错误、数据损坏或校验失败时抛出</exception>
+    static ByteArray Decompress(const ByteArray& data, int32 threadCount = 1);
+    /// <summary>
+    /// 解压 LZ4 帧
+    /// </summary>
+    /// <exception cref="std::invalid_argument">帧格式错误、数据损坏或校验失败时抛出</exception>
+    static ByteArray Decompress(const ByteView& data, int32 threadCount = 1);
+};
+
+/// <summary>
+/// LZ4 流式压缩器
+/// <para>分多次写入任意大小的数据，每凑满一个块即压缩并通过输出回调交出，内存占用与块大小相当</para>
+/// <para>写入完成后必须调用 Finish 输出结束标记和内容校验</para>
+/// </summary>
+class Lz4Encoder
+{
+public:
+    /// <summary>
+    /// 输出回调，参数为一段压缩数据
+    /// </summary>
+    using Sink = std::function<void(const byte* data, int64 size)>;
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="sink">输出回调</param>
+    /// <param name="blockSize">最大块大小</param>
+    explicit Lz4Encoder(Sink sink, Lz4BlockSize blockSize = Lz4BlockSize::Max256KB);
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~Lz4Encoder() = default;
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    Lz4Encoder(const Lz4Encoder& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    Lz4Encoder& operator=(const Lz4Encoder& other) = delete;
+public:
+    /// <summary>
+    /// 写入待压缩数据
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <exception cref="std::logic_error">在 Finish 之后调用时抛出</exception>
+    void Write(const byte* data, int64 size);
+    /// <summary>
+    /// 写入待压缩数据
+    /// </summary>
+    void Write(const ByteArray& data);
+    /// <summary>
+    /// 写入待压缩数据
+    /// </summary>
+    void Write(const ByteView& data);
+    /// <summary>
+    /// 压缩剩余数据并输出结束标记和内容校验
+    /// </summary>
+    void Finish();
+    /// <summary>
+    /// 检查是否已调用 Finish
+    /// </summary>
+    bool IsFinished() const;
+    /// <summary>
+    /// 获取已写入的原始字节总数
+    /// </summary>
+    int64 InputSize() const;
+private:
+    /// <summary>
+    /// 输出帧头(仅第一次调用时)
+    /// </summary>
+    void _WriteHeader();
+    /// <summary>
+    /// 压缩并输出一个块
+    /// </summary>
+    void _FlushBlock(const byte* data, int64 size);
+private:
+    // 输出回调
+    Sink m_sink;
+    // 最大块大小
+    Lz4BlockSize m_blockSize;
+    // 未凑满一块的待压缩数据
+    ByteArray m_pending;
+    // 压缩输出缓冲区(复用)
+    ByteArray m_output;
+    // 内容校验
+    Lz4Checksum m_checksum;
+    // 已写入的原始字节数
+    int64 m_inputSize = 0;
+    // 是否已输出帧头
+    bool m_headerWritten = false;
+    // 是否已结束
+    bool m_finished = false;
+};
+
+/// <summary>
+/// LZ4 流式解压器
+/// <para>分多次送入任意切分的帧数据，每解出一个块即通过输出回调交出</para>
+/// <para>支持块之间存在依赖的帧(保留最近 64 KB 的输出作为字典)</para>
+/// </summary>
+class Lz4Decoder
+{
+public:
+    /// <summary>
+    /// 输出回调，参数为一段解压数据
+    /// </summary>
+    using Sink = std::function<void(const byte* data, int64 size)>;
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="sink">输出回调</param>
+    explicit Lz4Decoder(Sink sink);
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~Lz4Decoder() = default;
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    Lz4Decoder(const Lz4Decoder& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    Lz4Decoder& operator=(const Lz4Decoder& other) = delete;
+public:
+    /// <summary>
+    /// 送入帧数据
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    /// <returns>数据损坏、校验失败或帧结束后仍有数据时返回 false，之后的调用都返回 false</returns>
+    bool Write(const byte* data, int64 size);
+    /// <summary>
+    /// 送入帧数据
+    /// </summary>
+    bool Write(const ByteArray& data);
+    /// <summary>
+    /// 送入帧数据
+    /// </summary>
+    bool Write(const ByteView& data);
+    /// <summary>
+    /// 检查是否已完整解出一个帧
+    /// </summary>
+    bool IsFinished() const;
+    /// <summary>
+    /// 检查是否遇到错误
+    /// </summary>
+    bool IsError() const;
+    /// <summary>
+    /// 重置状态以解压新的帧
+    /// </summary>
+    void Reset();
+private:
+    /// <summary>
+    /// 解码状态
+    /// </summary>
+    enum class State
+    {
+        Header,
+        BlockSize,
+        BlockData,
+        ContentChecksum,
+        Finished,
+        Error
+    };
+private:
+    /// <summary>
+    /// 尽可能多地解析已缓冲的输入
+    /// </summary>
+    bool _Process();
+    /// <summary>
+    /// 输出一段解压数据并更新校验与字典
+    /// </summary>
+    void _Emit(const byte* data, int64 size);
+private:
+    // 输出回调
+    Sink m_sink;
+    // 当前状态
+    State m_state = State::Header;
+    // 已缓冲的输入
+    ByteArray m_input;
+    // 已缓冲输入中已消费的字节数
+    int64 m_inputPos = 0;
+    // 字典与解压窗口
+    ByteArray m_window;
+    // 窗口中字典的字节数
+    int64 m_historySize = 0;
+    // 当前块的头
+    uint32 m_blockHeader = 0;
+    // 最大块字节数
+    int64 m_blockMax = 0;
+    // 块之间是否相互独立
+    bool m_independent = true;
+    // 是否带块校验
+    bool m_blockChecksum = false;
+    // 是否带内容校验
+    bool m_contentChecksum = false;
+    // 帧头声明的内容大小，-1 表示未声明
+    int64 m_contentSize = -1;
+    // 已输出的字节数
+    int64 m_outputSize = 0;
+    // 内容校验
+    Lz4Checksum m_checksum;
+};
@@ -0,0 +1,344 @@
+#include "pch.h"
+
+#include "MappedFile.h"
+#include "Platform.h"
+
+#ifdef PLATFORM_WINDOWS
+    #include "Windows/WindowsPlatform.h"
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+struct MappedFile::Mapping
+{
+    // 映射起始地址
+    byte* Data = nullptr;
+    // 映射字节数
+    int64 Size = 0;
+    // 映射模式
+    MappedFileMode Mode = MappedFileMode::ReadOnly;
+#ifdef PLATFORM_WINDOWS
+    // 文件句柄
+    HANDLE File = INVALID_HANDLE_VALUE;
+    // 映射对象句柄
+    HANDLE Map = nullptr;
+#else
+    // 文件描述符
+    int File = -1;
+#endif
+
+    ~Mapping()
+    {
+#ifdef PLATFORM_WINDOWS
+        if (Data != nullptr)
+        {
+            UnmapViewOfFile(Data);
+        }
+        if (Map != nullptr)
+        {
+            CloseHandle(Map);
+        }
+        if (File != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(File);
+        }
+#else
+        if (Data != nullptr)
+        {
+            munmap(Data, static_cast<size_t>(Size));
+        }
+        if (File >= 0)
+        {
+            close(File);
+        }
+#endif
+    }
+};
+
+namespace
+{
+    /// <summary>
+    /// 获取系统页大小
+    /// </summary>
+    int64 GetPageSize()
+    {
+#ifdef PLATFORM_WINDOWS
+        static const int64 pageSize = [] {
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return static_cast<int64>(info.dwAllocationGranularity);
+        }();
+#else
+        static const int64 pageSize = static_cast<int64>(sysconf(_SC_PAGESIZE));
+#endif
+        return pageSize;
+    }
+}
+
+bool MappedFile::Open(const std::filesystem::path& path, MappedFileMode mode, int64 size)
+{
+    Close();
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->Mode = mode;
+    bool writable = mode == MappedFileMode::ReadWrite;
+
+#ifdef PLATFORM_WINDOWS
+    mapping->File = CreateFileW(
+        path.c_str(),
+        writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+        FILE_SHARE_READ | (writable ? 0 : FILE_SHARE_WRITE),
+        nullptr,
+        writable ? OPEN_ALWAYS : OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr);
+    if (mapping->File == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    if (writable && size >= 0)
+    {
+        LARGE_INTEGER newSize;
+        newSize.QuadPart = size;
+        if (!SetFilePointerEx(mapping->File, newSize, nullptr, FILE_BEGIN) || !SetEndOfFile(mapping->File))
+        {
+            return false;
+        }
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(mapping->File, &fileSize))
+    {
+        return false;
+    }
+    mapping->Size = static_cast<int64>(fileSize.QuadPart);
+
+    // 空文件无法创建映射对象，保持为空映射
+    if (mapping->Size > 0)
+    {
+        mapping->Map = CreateFileMappingW(mapping->File, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        if (mapping->Map == nullptr)
+        {
+            return false;
+        }
+        void* data = MapViewOfFile(mapping->Map, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr)
+        {
+            return false;
+        }
+        mapping->Data = static_cast<byte*>(data);
+    }
+#else
+    mapping->File = open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+    if (mapping->File < 0)
+    {
+        return false;
+    }
+
+    if (writable && size >= 0)
+    {
+        if (ftruncate(mapping->File, static_cast<off_t>(size)) != 0)
+        {
+            return false;
+        }
+    }
+
+    struct stat info;
+    if (fstat(mapping->File, &info) != 0)
+    {
+        return false;
+    }
+    mapping->Size = static_cast<int64>(info.st_size);
+
+    // 长度为 0 的 mmap 会失败，空文件保持为空映射
+    if (mapping->Size > 0)
+    {
+        void* data = mmap(nullptr, static_cast<size_t>(mapping->Size),
+            writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, mapping->File, 0);
+        if (data == MAP_FAILED)
+        {
+            return false;
+        }
+        mapping->Data = static_cast<byte*>(data);
+    }
+#endif
+
+    m_mapping = std::move(mapping);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    m_mapping.reset();
+}
+
+ByteView MappedFile::View() const
+{
+    return View(0, -1);
+}
+
+ByteView MappedFile::View(int64 offset, int64 length) const
+{
+    if (m_mapping == nullptr || offset < 0 || offset > m_mapping->Size) [[unlikely]]
+    {
+        return ByteView();
+    }
+    if (length < 0 || length > m_mapping->Size - offset)
+    {
+        length = m_mapping->Size - offset;
+    }
+    if (length == 0)
+    {
+        return ByteView();
+    }
+
+    // 视图捕获映射的引用计数，最后一个视图释放时才解除映射
+    std::shared_ptr<Mapping> keep = m_mapping;
+    return ByteView::FromExternal(m_mapping->Data + offset, length, [keep]() {});
+}
+
+const byte* MappedFile::Data() const
+{
+    return m_mapping != nullptr ? m_mapping->Data : nullptr;
+}
+
+byte* MappedFile::MutableData()
+{
+    if (m_mapping == nullptr || m_mapping->Mode != MappedFileMode::ReadWrite)
+    {
+        return nullptr;
+    }
+    return m_mapping->Data;
+}
+
+int64 MappedFile::Size() const
+{
+    return m_mapping != nullptr ? m_mapping->Size : 0;
+}
+
+bool MappedFile::IsOpen() const
+{
+    return m_mapping != nullptr;
+}
+
+MappedFileMode MappedFile::Mode() const
+{
+    return m_mapping != nullptr ? m_mapping->Mode : MappedFileMode::ReadOnly;
+}
+
+void MappedFile::Advise(MappedFileAccess access)
+{
+    Advise(0, Size(), access);
+}
+
+void MappedFile::Advise(int64 offset, int64 length, MappedFileAccess access)
+{
+    byte* start = nullptr;
+    int64 size = 0;
+    if (!_PageRange(offset, length, start, size))
+    {
+        return;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    // Windows 没有针对已映射视图的访问模式提示，顺序访问时以预取代替加大预读
+    if (access == MappedFileAccess::Sequential)
+    {
+        WIN32_MEMORY_RANGE_ENTRY entry;
+        entry.VirtualAddress = start;
+        entry.NumberOfBytes = static_cast<SIZE_T>(size);
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+    }
+#else
+    int advice = MADV_NORMAL;
+    switch (access)
+    {
+    case MappedFileAccess::Sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case MappedFileAccess::Random:
+        advice = MADV_RANDOM;
+        break;
+    default:
+        break;
+    }
+    madvise(start, static_cast<size_t>(size), advice);
+#endif
+}
+
+void MappedFile::Prefetch(int64 offset, int64 length)
+{
+    if (length < 0)
+    {
+        length = Size() - offset;
+    }
+
+    byte* start = nullptr;
+    int64 size = 0;
+    if (!_PageRange(offset, length, start, size))
+    {
+        return;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    WIN32_MEMORY_RANGE_ENTRY entry;
+    entry.VirtualAddress = start;
+    entry.NumberOfBytes = static_cast<SIZE_T>(size);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+#else
+    madvise(start, static_cast<size_t>(size), MADV_WILLNEED);
+#endif
+}
+
+bool MappedFile::Flush(bool wait)
+{
+    if (m_mapping == nullptr || m_mapping->Mode != MappedFileMode::ReadWrite)
+    {
+        return false;
+    }
+    if (m_mapping->Data == nullptr)
+    {
+        return true;
+    }
+
+#ifdef PLATFORM_WINDOWS
+    if (!FlushViewOfFile(m_mapping->Data, 0))
+    {
+        return false;
+    }
+    return !wait || FlushFileBuffers(m_mapping->File);
+#else
+    return msync(m_mapping->Data, static_cast<size_t>(m_mapping->Size), wait ? MS_SYNC : MS_ASYNC) == 0;
+#endif
+}
+
+bool MappedFile::_PageRange(int64 offset, int64 length, byte*& start, int64& size) const
+{
+    if (m_mapping == nullptr || m_mapping->Data == nullptr)
+    {
+        return false;
+    }
+    if (offset < 0)
+    {
+        offset = 0;
+    }
+    if (offset >= m_mapping->Size || length <= 0)
+    {
+        return false;
+    }
+    if (length > m_mapping->Size - offset)
+    {
+        length = m_mapping->Size - offset;
+    }
+
+    // 映射起始地址按页对齐，只需将偏移向下对齐到页边界
+    int64 pageSize = GetPageSize();
+    int64 alignedOffset = offset - offset % pageSize;
+    start = m_mapping->Data + alignedOffset;
+    size = length + (offset - alignedOffset);
+    return true;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Core.h"
+#include "ByteView.h"
+
+#include <memory>
+#include <filesystem>
+
+/// <summary>
+/// 文件映射模式
+/// </summary>
+enum class MappedFileMode
+{
+    // 只读映射
+    ReadOnly,
+    // 读写映射，修改写回文件
+    ReadWrite
+};
+
+/// <summary>
+/// 文件映射访问模式提示
+/// </summary>
+enum class MappedFileAccess
+{
+    // 默认预读策略
+    Normal,
+    // 顺序访问：加大预读，已访问的页可尽早回收
+    Sequential,
+    // 随机访问：关闭预读
+    Random
+};
+
+/// <summary>
+/// 内存映射文件
+/// <para>将文件映射到地址空间，通过 View 以零拷贝的 ByteView 访问内容</para>
+/// <para>View 返回的视图持有映射的引用，即使 MappedFile 已关闭，视图仍然有效</para>
+/// </summary>
+class MappedFile
+{
+public:
+    /// <summary>
+    /// 默认构造函数
+    /// </summary>
+    MappedFile() = default;
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~MappedFile() = default;
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    MappedFile(const MappedFile& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    MappedFile& operator=(const MappedFile& other) = delete;
+    /// <summary>
+    /// 移动构造函数
+    /// </summary>
+    /// <param name="other">要移动的对象</param>
+    MappedFile(MappedFile&& other) noexcept = default;
+    /// <summary>
+    /// 移动赋值运算符
+    /// </summary>
+    /// <param name="other">要移动的对象</param>
+    /// <returns>this</returns>
+    MappedFile& operator=(MappedFile&& other) noexcept = default;
+public:
+    /// <summary>
+    /// 打开并映射文件
+    /// </summary>
+    /// <param name="path">文件路径</param>
+    /// <param name="mode">映射模式</param>
+    /// <param name="size">读写模式下将文件调整为的大小，-1 表示保持原大小；只读模式下忽略</param>
+    /// <returns>打开或映射失败返回 false</returns>
+    bool Open(const std::filesystem::path& path, MappedFileMode mode = MappedFileMode::ReadOnly, int64 size = -1);
+    /// <summary>
+    /// 关闭映射(已返回的视图仍然有效)
+    /// </summary>
+    void Close();
+    /// <summary>
+    /// 获取整个文件的零拷贝只读视图
+    /// </summary>
+    /// <returns>字节视图</returns>
+    ByteView View() const;
+    /// <summary>
+    /// 获取文件指定范围的零拷贝只读视图
+    /// </summary>
+    /// <param name="offset">起始偏移</param>
+    /// <param name="length">长度，-1 表示到文件末尾</param>
+    /// <returns>字节视图，范围无效时返回空视图</returns>
+    ByteView View(int64 offset, int64 length = -1) const;
+    /// <summary>
+    /// 获取只读数据指针
+    /// </summary>
+    const byte* Data() const;
+    /// <summary>
+    /// 获取可写数据指针
+    /// </summary>
+    /// <returns>只读映射返回 nullptr</returns>
+    byte* MutableData();
+    /// <summary>
+    /// 获取映射的字节数
+    /// </summary>
+    int64 Size() const;
+    /// <summary>
+    /// 检查是否已打开映射
+    /// </summary>
+    bool IsOpen() const;
+    /// <summary>
+    /// 获取映射模式
+    /// </summary>
+    MappedFileMode Mode() const;
+    /// <summary>
+    /// 设置整个映射的访问模式提示
+    /// </summary>
+    /// <param name="access">访问模式</param>
+    void Advise(MappedFileAccess access);
+    /// <summary>
+    /// 设置指定范围的访问模式提示
+    /// </summary>
+    /// <param name="offset">起始偏移</param>
+    /// <param name="length">长度</param>
+    /// <param name="access">访问模式</param>
+    void Advise(int64 offset, int64 length, MappedFileAccess access);
+    /// <summary>
+    /// 异步预取指定范围到内存，函数立即返回，由操作系统在后台读取
+    /// </summary>
+    /// <param name="offset">起始偏移</param>
+    /// <param name="length">长度，-1 表示到文件末尾</param>
+    void Prefetch(int64 offset = 0, int64 length = -1);
+    /// <summary>
+    /// 将读写映射中的修改写回文件
+    /// </summary>
+    /// <param name="wait">为 true 时等待写回完成</param>
+    /// <returns>失败返回 false</returns>
+    bool Flush(bool wait = true);
+private:
+    /// <summary>
+    /// 平台相关的映射状态，由 MappedFile 与其返回的视图共同持有
+    /// </summary>
+    struct Mapping;
+private:
+    /// <summary>
+    /// 将范围裁剪到映射内并按页对齐
+    /// </summary>
+    bool _PageRange(int64 offset, int64 length, byte*& start, int64& size) const;
+private:
+    // 映射状态
+    std::shared_ptr<Mapping> m_mapping;
+};
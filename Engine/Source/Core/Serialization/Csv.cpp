@@ -0,0 +1,426 @@
+#include "pch.h"
+
+#include "Csv.h"
+#include "CpuFeatures.h"
+#include "String/Utf8.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(CPU_ARCH_X64)
+    #include <immintrin.h>
+#elif defined(CPU_ARCH_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+    /*
+     * 每次分类 64 个字节，得到引号、分隔符与换行符三个 64 位掩码；
+     * 引号掩码的前缀异或即为引号内的字节，转义的 "" 连续切换两次，不影响结果；最高位作为下一块的初值
+     */
+
+    constexpr int64 BLOCK_SIZE = 64;
+
+    struct BlockMasks
+    {
+        // 引号
+        uint64 Quote;
+        // 分隔符
+        uint64 Delimiter;
+        // 换行符
+        uint64 LineFeed;
+    };
+
+    using ClassifyKernel = void(*)(const uint8*, uint8, BlockMasks&);
+
+    // 前缀异或：第 i 位为输入第 0..i 位的异或，即该位置之前(含)出现过奇数个引号
+    inline uint64 PrefixXor(uint64 bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    void ClassifyScalar(const uint8* block, uint8 delimiter, BlockMasks& masks)
+    {
+        masks = {};
+        for (int32 i = 0; i < BLOCK_SIZE; i++)
+        {
+            uint64 bit = uint64(1) << i;
+            if (block[i] == '"')
+            {
+                masks.Quote |= bit;
+            }
+            else if (block[i] == delimiter)
+            {
+                masks.Delimiter |= bit;
+            }
+            else if (block[i] == '\n')
+            {
+                masks.LineFeed |= bit;
+            }
+        }
+    }
+
+#if defined(CPU_ARCH_X64)
+    CPU_TARGET_SSE42 void ClassifySse(const uint8* block, uint8 delimiter, BlockMasks& masks)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i separator = _mm_set1_epi8(static_cast<char>(delimiter));
+        const __m128i lineFeed = _mm_set1_epi8('\n');
+
+        masks = {};
+        for (int32 i = 0; i < BLOCK_SIZE; i += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            masks.Quote |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(input, quote)))) << i;
+            masks.Delimiter |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(input, separator)))) << i;
+            masks.LineFeed |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(input, lineFeed)))) << i;
+        }
+    }
+
+    CPU_TARGET_AVX2 void ClassifyAvx2(const uint8* block, uint8 delimiter, BlockMasks& masks)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i separator = _mm256_set1_epi8(static_cast<char>(delimiter));
+        const __m256i lineFeed = _mm256_set1_epi8('\n');
+
+        masks = {};
+        for (int32 i = 0; i < BLOCK_SIZE; i += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+            masks.Quote |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(input, quote)))) << i;
+            masks.Delimiter |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(input, separator)))) << i;
+            masks.LineFeed |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(input, lineFeed)))) << i;
+        }
+    }
+
+    template<class Kernel>
+    Kernel SelectKernel(Kernel sse, Kernel avx2)
+    {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.AVX2)
+        {
+            return avx2;
+        }
+        if (features.SSE42)
+        {
+            return sse;
+        }
+        return nullptr;
+    }
+#elif defined(CPU_ARCH_ARM64)
+    /* NEON 没有 movemask，将 4 个比较结果按位权相与后逐级两两相加，合并为 64 位掩码 */
+
+    inline uint64 ToMaskNeon(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3)
+    {
+        const uint8x16_t weights = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+        uint8x16_t sum0 = vpaddq_u8(vandq_u8(v0, weights), vandq_u8(v1, weights));
+        uint8x16_t sum1 = vpaddq_u8(vandq_u8(v2, weights), vandq_u8(v3, weights));
+        sum0 = vpaddq_u8(sum0, sum1);
+        sum0 = vpaddq_u8(sum0, sum0);
+        return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+    }
+
+    void ClassifyNeon(const uint8* block, uint8 delimiter, BlockMasks& masks)
+    {
+        uint8x16_t quote[4], separator[4], lineFeed[4];
+        for (int32 i = 0; i < 4; i++)
+        {
+            uint8x16_t input = vld1q_u8(block + i * 16);
+            quote[i] = vceqq_u8(input, vdupq_n_u8('"'));
+            separator[i] = vceqq_u8(input, vdupq_n_u8(delimiter));
+            lineFeed[i] = vceqq_u8(input, vdupq_n_u8('\n'));
+        }
+        masks.Quote = ToMaskNeon(quote[0], quote[1], quote[2], quote[3]);
+        masks.Delimiter = ToMaskNeon(separator[0], separator[1], separator[2], separator[3]);
+        masks.LineFeed = ToMaskNeon(lineFeed[0], lineFeed[1], lineFeed[2], lineFeed[3]);
+    }
+#endif
+
+    ClassifyKernel GetClassifyKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const ClassifyKernel kernel = SelectKernel<ClassifyKernel>(&ClassifySse, &ClassifyAvx2);
+        return kernel ? kernel : &ClassifyScalar;
+#elif defined(CPU_ARCH_ARM64)
+        return &ClassifyNeon;
+#else
+        return &ClassifyScalar;
+#endif
+    }
+}
+
+CsvDocument::CsvDocument(char delimiter)
+    : m_delimiter(delimiter)
+{
+    if (delimiter == '\0' || static_cast<uint8>(delimiter) >= 0x80 || delimiter == '"' || delimiter == '\n' || delimiter == '\r')
+    {
+        throw std::invalid_argument("Invalid CSV delimiter");
+    }
+}
+
+bool CsvDocument::Parse(const ByteView& data)
+{
+    m_view = data;
+    m_data = reinterpret_cast<const char*>(data.Data());
+    m_size = data.Size();
+    return _Parse();
+}
+
+bool CsvDocument::Parse(StringView text)
+{
+    m_view = ByteView();
+    m_data = text.Data();
+    m_size = text.Size();
+    return _Parse();
+}
+
+int64 CsvDocument::RowCount() const
+{
+    return m_rows.Size();
+}
+
+int64 CsvDocument::FieldCount(int64 row) const
+{
+    return row >= 0 && row < m_rows.Size() ? m_rows[row].Count : 0;
+}
+
+StringView CsvDocument::RawField(int64 row, int64 column) const
+{
+    if (column < 0 || column >= FieldCount(row))
+    {
+        return StringView();
+    }
+
+    int64 field = m_rows[row].First + column;
+    int64 start = field == 0 ? m_start : m_ends[field - 1] + 1;
+    int64 end = m_ends[field];
+    // 以 \r\n 结束的记录，最后一个字段不含 \r
+    if (end > start && end < m_size && m_data[end] == '\n' && m_data[end - 1] == '\r')
+    {
+        end--;
+    }
+    return StringView(m_data + start, end - start);
+}
+
+String CsvDocument::Field(int64 row, int64 column) const
+{
+    StringView raw = RawField(row, column);
+    if (raw.IsEmpty() || raw.Data()[0] != '"')
+    {
+        return String(raw);
+    }
+
+    // 去掉两侧的引号(缺少结束引号时保留其余部分)，再将 "" 还原为 "
+    const char* ptr = raw.Data() + 1;
+    const char* end = raw.Data() + raw.Size();
+    if (end - ptr > 0 && end[-1] == '"')
+    {
+        end--;
+    }
+    const char* quote = static_cast<const char*>(std::memchr(ptr, '"', static_cast<size_t>(end - ptr)));
+    if (!quote)
+    {
+        return String(ptr, end - ptr);
+    }
+
+    String result;
+    result.Reserve(end - ptr);
+    while (quote)
+    {
+        result.Append(StringView(ptr, quote + 1 - ptr));
+        ptr = quote + 1 < end && quote[1] == '"' ? quote + 2 : quote + 1;
+        quote = static_cast<const char*>(std::memchr(ptr, '"', static_cast<size_t>(end - ptr)));
+    }
+    result.Append(StringView(ptr, end - ptr));
+    return result;
+}
+
+Array<String> CsvDocument::Row(int64 row) const
+{
+    Array<String> result;
+    int64 count = FieldCount(row);
+    result.Reserve(count);
+    for (int64 column = 0; column < count; column++)
+    {
+        result.Push(Field(row, column));
+    }
+    return result;
+}
+
+int64 CsvDocument::FindColumn(StringView name) const
+{
+    int64 count = FieldCount(0);
+    for (int64 column = 0; column < count; column++)
+    {
+        StringView raw = RawField(0, column);
+        if (raw.IsEmpty() || raw.Data()[0] != '"' ? raw == name : Field(0, column).View() == name)
+        {
+            return column;
+        }
+    }
+    return -1;
+}
+
+HashMap<String, String> CsvDocument::Record(int64 row) const
+{
+    HashMap<String, String> result;
+    int64 count = std::min(FieldCount(0), FieldCount(row));
+    result.Reserve(count);
+    for (int64 column = 0; column < count; column++)
+    {
+        result.Emplace(Field(0, column), Field(row, column));
+    }
+    return result;
+}
+
+CsvError CsvDocument::Error() const
+{
+    return m_error;
+}
+
+int64 CsvDocument::ErrorOffset() const
+{
+    return m_errorOffset;
+}
+
+/* private */
+
+bool CsvDocument::_Parse()
+{
+    m_ends.Reset();
+    m_rows.Reset();
+    m_error = CsvError::None;
+    m_errorOffset = -1;
+
+    // 跳过 UTF-8 BOM
+    m_start = m_size >= 3 && std::memcmp(m_data, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+
+    bool parsed = false;
+    if (m_size > std::numeric_limits<uint32>::max())
+    {
+        _Fail(CsvError::TooLarge, 0);
+    }
+    else if (!Utf8::IsValid(m_data, m_size))
+    {
+        // 只在出错时逐个解码以定位无效序列
+        int64 pos = 0;
+        uint32 code = 0;
+        while (pos < m_size)
+        {
+            int32 length = Utf8::Decode(m_data + pos, m_size - pos, code);
+            if (length == 0)
+            {
+                break;
+            }
+            pos += length;
+        }
+        _Fail(CsvError::InvalidUtf8, pos);
+    }
+    else
+    {
+        parsed = _BuildIndex();
+    }
+
+    if (!parsed)
+    {
+        m_ends.Reset();
+        m_rows.Reset();
+        m_view = ByteView();
+    }
+    return parsed;
+}
+
+bool CsvDocument::_BuildIndex()
+{
+    ClassifyKernel classify = GetClassifyKernel();
+    uint8 delimiter = static_cast<uint8>(m_delimiter);
+    m_ends.Reserve(m_size / 8 + 16);
+
+    int64 lineStart = m_start;
+    int64 firstField = 0;
+    uint64 quoteCarry = 0;
+    alignas(BLOCK_SIZE) uint8 tail[BLOCK_SIZE];
+    for (int64 base = m_start; base < m_size; base += BLOCK_SIZE)
+    {
+        const uint8* block = reinterpret_cast<const uint8*>(m_data + base);
+        if (m_size - base < BLOCK_SIZE)
+        {
+            // 最后不足一块的部分以 0 补齐
+            std::memset(tail, 0, BLOCK_SIZE);
+            std::memcpy(tail, block, static_cast<size_t>(m_size - base));
+            block = tail;
+        }
+
+        BlockMasks masks;
+        classify(block, delimiter, masks);
+
+        uint64 quoted = PrefixXor(masks.Quote) ^ quoteCarry;
+        quoteCarry = static_cast<uint64>(static_cast<int64>(quoted) >> 63);
+        uint64 separators = (masks.Delimiter | masks.LineFeed) & ~quoted;
+        if (separators == 0)
+        {
+            continue;
+        }
+
+        // 按已扫描部分的密度预估总数，一次预留
+        int64 count = std::popcount(separators);
+        if (m_ends.Size() + count > m_ends.Capacity())
+        {
+            double density = static_cast<double>(m_ends.Size() + count) / static_cast<double>(base + BLOCK_SIZE - m_start);
+            int64 estimate = static_cast<int64>(density * static_cast<double>(m_size - m_start) * 1.125) + BLOCK_SIZE;
+            m_ends.Reserve(estimate);
+        }
+        do
+        {
+            int32 bit = std::countr_zero(separators);
+            separators &= separators - 1;
+            int64 pos = base + bit;
+            m_ends.Push(static_cast<uint32>(pos));
+            if ((masks.LineFeed >> bit) & 1)
+            {
+                _EndRow(lineStart, pos, firstField);
+                lineStart = pos + 1;
+                firstField = m_ends.Size();
+            }
+        } while (separators != 0);
+    }
+
+    if (quoteCarry != 0)
+    {
+        return _Fail(CsvError::UnclosedQuote, m_size);
+    }
+    // 最后一条记录没有换行符
+    if (lineStart < m_size)
+    {
+        m_ends.Push(static_cast<uint32>(m_size));
+        _EndRow(lineStart, m_size, firstField);
+    }
+    return true;
+}
+
+void CsvDocument::_EndRow(int64 lineStart, int64 end, int64 firstField)
+{
+    int64 count = m_ends.Size() - firstField;
+    if (count == 1 && (end == lineStart || (end == lineStart + 1 && m_data[lineStart] == '\r')))
+    {
+        return;
+    }
+    m_rows.Push(RowRange{ static_cast<uint32>(firstField), static_cast<uint32>(count) });
+}
+
+bool CsvDocument::_Fail(CsvError error, int64 offset)
+{
+    m_error = error;
+    m_errorOffset = offset;
+    return false;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "Core.h"
+#include "Container/Array.h"
+#include "Container/HashMap.h"
+#include "Memory/ByteView.h"
+#include "String/String.h"
+#include "String/StringView.h"
+
+/// <summary>
+/// CSV 解析错误
+/// </summary>
+enum class CsvError
+{
+    // 没有错误
+    None,
+    // 文档超过 4 GB
+    TooLarge,
+    // 内容不是有效的 UTF-8
+    InvalidUtf8,
+    // 引号没有结束
+    UnclosedQuote
+};
+
+/// <summary>
+/// CSV 文档(RFC 4180)
+/// <para>以 SIMD 每次分类 64 个字节，得到引号、分隔符与换行符的掩码，引号掩码的前缀异或即为引号内的字节，
+/// 排除后剩下的分隔符、换行符就是字段与记录的边界，一次扫描即可建立全部字段的位置索引</para>
+/// <para>解析时只记录字段的结束位置，RawField 直接返回原文，Field、Row、Record 在访问时才去掉引号并生成 String、Array、HashMap</para>
+/// <para>记录以 \n 或 \r\n 结束，引号内的分隔符和换行符属于字段；引号应只出现在字段开头，字段中间的引号同样切换引用状态；空行被跳过</para>
+/// <para>文档引用而不复制输入：ByteView(如 MappedFile::View 返回的映射视图，或以 ByteView(std::move(array)) 包装的 ByteArray)由文档持有引用，
+/// 文本则需调用方保证在文档使用期间有效</para>
+/// </summary>
+class CsvDocument
+{
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="delimiter">字段分隔符</param>
+    /// <exception cref="std::invalid_argument">分隔符为 0、非 ASCII 字符、引号或换行符时抛出</exception>
+    explicit CsvDocument(char delimiter = ',');
+public:
+    /// <summary>
+    /// 解析字节视图，文档持有视图的引用
+    /// </summary>
+    /// <returns>解析失败返回 false，由 Error、ErrorOffset 获取原因与位置</returns>
+    bool Parse(const ByteView& data);
+    /// <summary>
+    /// 解析文本，不复制数据
+    /// </summary>
+    /// <returns>解析失败返回 false，由 Error、ErrorOffset 获取原因与位置</returns>
+    bool Parse(StringView text);
+    /// <summary>
+    /// 获取记录数(含表头)
+    /// </summary>
+    int64 RowCount() const;
+    /// <summary>
+    /// 获取记录的字段数，行号无效时返回 0
+    /// </summary>
+    int64 FieldCount(int64 row) const;
+    /// <summary>
+    /// 获取字段的原文(含引号)，不复制数据；索引无效时返回空视图
+    /// </summary>
+    StringView RawField(int64 row, int64 column) const;
+    /// <summary>
+    /// 获取字段，去掉两侧的引号并将 "" 还原为 "；索引无效时返回空字符串
+    /// </summary>
+    String Field(int64 row, int64 column) const;
+    /// <summary>
+    /// 将记录的全部字段生成为数组，行号无效时返回空数组
+    /// </summary>
+    Array<String> Row(int64 row) const;
+    /// <summary>
+    /// 在表头(第 0 行)中查找列
+    /// </summary>
+    /// <returns>列号，没有时返回 -1</returns>
+    int64 FindColumn(StringView name) const;
+    /// <summary>
+    /// 将记录生成为以表头为键的哈希表，缺少的字段不加入，重复的列名取第一列
+    /// </summary>
+    HashMap<String, String> Record(int64 row) const;
+    /// <summary>
+    /// 获取错误
+    /// </summary>
+    CsvError Error() const;
+    /// <summary>
+    /// 获取错误在输入中的字节偏移，没有错误时为 -1
+    /// </summary>
+    int64 ErrorOffset() const;
+private:
+    /// <summary>
+    /// 一条记录的字段范围
+    /// </summary>
+    struct RowRange
+    {
+        // 第一个字段在 m_ends 中的编号
+        uint32 First;
+        // 字段数
+        uint32 Count;
+    };
+private:
+    /// <summary>
+    /// 解析已设置的输入
+    /// </summary>
+    bool _Parse();
+    /// <summary>
+    /// 建立字段与记录的索引
+    /// </summary>
+    bool _BuildIndex();
+    /// <summary>
+    /// 结束从 lineStart 开始、以 end 处的换行符或输入末尾结束的记录，空行不加入
+    /// </summary>
+    void _EndRow(int64 lineStart, int64 end, int64 firstField);
+    /// <summary>
+    /// 记录错误并返回 false
+    /// </summary>
+    bool _Fail(CsvError error, int64 offset);
+private:
+    // 持有的输入视图，解析文本时为空
+    ByteView m_view;
+    // 输入数据
+    const char* m_data = nullptr;
+    // 输入字节数
+    int64 m_size = 0;
+    // 第一个字段的字节偏移(跳过 UTF-8 BOM)
+    int64 m_start = 0;
+    // 每个字段结束处(分隔符、换行符或输入末尾)的字节偏移，下一个字段从其后一个字节开始；空行也占一项但不属于任何记录
+    Array<uint32> m_ends;
+    // 记录
+    Array<RowRange> m_rows;
+    // 字段分隔符
+    char m_delimiter = ',';
+    // 错误
+    CsvError m_error = CsvError::None;
+    // 错误的字节偏移
+    int64 m_errorOffset = -1;
+};
@@ -0,0 +1,1077 @@
+#include "pch.h"
+
+#include "Json.h"
+#include "CpuFeatures.h"
+#include "String/Utf8.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(CPU_ARCH_X64)
+    #include <immintrin.h>
+#elif defined(CPU_ARCH_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+    /*
+     * 第一阶段每次分类 64 个字节，得到引号、反斜杠、结构字符({}[]:,)、空白与控制字符五个 64 位掩码，之后全是位运算：
+     * 被转义的字符由未被转义的反斜杠确定(反斜杠很少，逐个处理并跨块进位)；
+     * 未转义引号掩码的前缀异或即为字符串内的字节(含开始引号、不含结束引号)，最高位作为下一块的初值；
+     * 结构符号为字符串外的结构字符、字符串的开始引号，以及字符串外连续的非空白、非结构字符(数字、字面量)的首字节
+     */
+
+    constexpr int64 BLOCK_SIZE = 64;
+
+    struct BlockMasks
+    {
+        // 引号
+        uint64 Quote;
+        // 反斜杠
+        uint64 Backslash;
+        // 结构字符 {}[]:,
+        uint64 Operator;
+        // 空白(空格、\t、\n、\r)
+        uint64 Space;
+        // 控制字符(小于 0x20)
+        uint64 Control;
+    };
+
+    using ClassifyKernel = void(*)(const uint8*, BlockMasks&);
+
+    inline bool IsSpace(char ch)
+    {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+    }
+
+    inline bool IsDigit(char ch)
+    {
+        return ch >= '0' && ch <= '9';
+    }
+
+    inline int32 HexValue(char ch)
+    {
+        if (ch >= '0' && ch <= '9')
+        {
+            return ch - '0';
+        }
+        ch = static_cast<char>(ch | 0x20);
+        return ch >= 'a' && ch <= 'f' ? ch - 'a' + 10 : -1;
+    }
+
+    // 解析 4 位十六进制数，无效时返回 -1
+    inline int32 ParseHex4(const char* data)
+    {
+        int32 value = 0;
+        for (int32 i = 0; i < 4; i++)
+        {
+            int32 digit = HexValue(data[i]);
+            if (digit < 0)
+            {
+                return -1;
+            }
+            value = value << 4 | digit;
+        }
+        return value;
+    }
+
+    // 按 RFC 8259 的语法检查数字：-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    bool IsValidNumber(const char* ptr, const char* end)
+    {
+        auto skipDigits = [&]()
+        {
+            const char* start = ptr;
+            while (ptr != end && IsDigit(*ptr))
+            {
+                ptr++;
+            }
+            return ptr != start;
+        };
+
+        if (ptr != end && *ptr == '-')
+        {
+            ptr++;
+        }
+        if (ptr == end || !IsDigit(*ptr))
+        {
+            return false;
+        }
+        if (*ptr == '0')
+        {
+            ptr++;
+        }
+        else
+        {
+            skipDigits();
+        }
+        if (ptr != end && *ptr == '.')
+        {
+            ptr++;
+            if (!skipDigits())
+            {
+                return false;
+            }
+        }
+        if (ptr != end && (*ptr == 'e' || *ptr == 'E'))
+        {
+            ptr++;
+            if (ptr != end && (*ptr == '+' || *ptr == '-'))
+            {
+                ptr++;
+            }
+            if (!skipDigits())
+            {
+                return false;
+            }
+        }
+        return ptr == end;
+    }
+
+    // 前缀异或：第 i 位为输入第 0..i 位的异或，即该位置之前(含)出现过奇数个引号
+    inline uint64 PrefixXor(uint64 bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // 计算被转义的字符，carry 为上一块末尾的反斜杠是否转义了本块的第一个字节，返回时更新为本块的进位
+    inline uint64 FindEscaped(uint64 backslash, uint64& carry)
+    {
+        uint64 escaped = carry;
+        carry = 0;
+        while (backslash != 0)
+        {
+            int32 bit = std::countr_zero(backslash);
+            backslash &= backslash - 1;
+            // 被转义的反斜杠不转义下一个字节
+            if ((escaped >> bit) & 1)
+            {
+                continue;
+            }
+            if (bit == BLOCK_SIZE - 1)
+            {
+                carry = 1;
+            }
+            else
+            {
+                escaped |= uint64(1) << (bit + 1);
+            }
+        }
+        return escaped;
+    }
+
+    // 检查块内被转义的字符是否构成有效的转义序列，返回第一个无效序列的偏移，全部有效时返回 -1
+    int64 CheckEscapes(const char* data, int64 size, int64 base, uint64 escaped)
+    {
+        while (escaped != 0)
+        {
+            int64 pos = base + std::countr_zero(escaped);
+            escaped &= escaped - 1;
+            switch (pos < size ? data[pos] : '\0')
+            {
+            case '"':
+            case '\\':
+            case '/':
+            case 'b':
+            case 'f':
+            case 'n':
+            case 'r':
+            case 't':
+                break;
+            case 'u':
+                if (pos + 4 >= size || ParseHex4(data + pos + 1) < 0)
+                {
+                    return pos - 1;
+                }
+                break;
+            default:
+                return pos - 1;
+            }
+        }
+        return -1;
+    }
+
+    void ClassifyScalar(const uint8* block, BlockMasks& masks)
+    {
+        masks = {};
+        for (int32 i = 0; i < BLOCK_SIZE; i++)
+        {
+            uint64 bit = uint64(1) << i;
+            switch (block[i])
+            {
+            case '"':
+                masks.Quote |= bit;
+                break;
+            case '\\':
+                masks.Backslash |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks.Operator |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                masks.Space |= bit;
+                break;
+            }
+            if (block[i] < 0x20)
+            {
+                masks.Control |= bit;
+            }
+        }
+    }
+
+#if defined(CPU_ARCH_X64)
+    /* '[' '{' 与 ']' '}' 分别只差 0x20 位，置位后各用一次比较 */
+
+    CPU_TARGET_SSE42 void ClassifySse(const uint8* block, BlockMasks& masks)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i fold = _mm_set1_epi8(0x20);
+        const __m128i open = _mm_set1_epi8('{');
+        const __m128i close = _mm_set1_epi8('}');
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i lineFeed = _mm_set1_epi8('\n');
+        const __m128i carriageReturn = _mm_set1_epi8('\r');
+        const __m128i controlMax = _mm_set1_epi8(0x1F);
+
+        masks = {};
+        for (int32 i = 0; i < BLOCK_SIZE; i += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+            __m128i folded = _mm_or_si128(input, fold);
+            __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+                                      _mm_or_si128(_mm_cmpeq_epi8(input, colon), _mm_cmpeq_epi8(input, comma)));
+            __m128i white = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(input, space), _mm_cmpeq_epi8(input, tab)),
+                                         _mm_or_si128(_mm_cmpeq_epi8(input, lineFeed), _mm_cmpeq_epi8(input, carriageReturn)));
+            __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(input, controlMax), input);
+            masks.Quote |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(input, quote)))) << i;
+            masks.Backslash |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(input, backslash)))) << i;
+            masks.Operator |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(op))) << i;
+            masks.Space |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(white))) << i;
+            masks.Control |= static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(control))) << i;
+        }
+    }
+
+    CPU_TARGET_AVX2 void ClassifyAvx2(const uint8* block, BlockMasks& masks)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i backslash = _mm256_set1_epi8('\\');
+        const __m256i fold = _mm256_set1_epi8(0x20);
+        const __m256i open = _mm256_set1_epi8('{');
+        const __m256i close = _mm256_set1_epi8('}');
+        const __m256i colon = _mm256_set1_epi8(':');
+        const __m256i comma = _mm256_set1_epi8(',');
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i lineFeed = _mm256_set1_epi8('\n');
+        const __m256i carriageReturn = _mm256_set1_epi8('\r');
+        const __m256i controlMax = _mm256_set1_epi8(0x1F);
+
+        masks = {};
+        for (int32 i = 0; i < BLOCK_SIZE; i += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+            __m256i folded = _mm256_or_si256(input, fold);
+            __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(folded, open), _mm256_cmpeq_epi8(folded, close)),
+                                         _mm256_or_si256(_mm256_cmpeq_epi8(input, colon), _mm256_cmpeq_epi8(input, comma)));
+            __m256i white = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(input, space), _mm256_cmpeq_epi8(input, tab)),
+                                            _mm256_or_si256(_mm256_cmpeq_epi8(input, lineFeed), _mm256_cmpeq_epi8(input, carriageReturn)));
+            __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(input, controlMax), input);
+            masks.Quote |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(input, quote)))) << i;
+            masks.Backslash |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(input, backslash)))) << i;
+            masks.Operator |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(op))) << i;
+            masks.Space |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(white))) << i;
+            masks.Control |= static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(control))) << i;
+        }
+    }
+
+    template<class Kernel>
+    Kernel SelectKernel(Kernel sse, Kernel avx2)
+    {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.AVX2)
+        {
+            return avx2;
+        }
+        if (features.SSE42)
+        {
+            return sse;
+        }
+        return nullptr;
+    }
+#elif defined(CPU_ARCH_ARM64)
+    /* NEON 没有 movemask，将 4 个比较结果按位权相与后逐级两两相加，合并为 64 位掩码 */
+
+    inline uint64 ToMaskNeon(uint8x16_t v0, uint8x16_t v1, uint8x16_t v2, uint8x16_t v3)
+    {
+        const uint8x16_t weights = { 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80 };
+        uint8x16_t sum0 = vpaddq_u8(vandq_u8(v0, weights), vandq_u8(v1, weights));
+        uint8x16_t sum1 = vpaddq_u8(vandq_u8(v2, weights), vandq_u8(v3, weights));
+        sum0 = vpaddq_u8(sum0, sum1);
+        sum0 = vpaddq_u8(sum0, sum0);
+        return vgetq_lane_u64(vreinterpretq_u64_u8(sum0), 0);
+    }
+
+    void ClassifyNeon(const uint8* block, BlockMasks& masks)
+    {
+        uint8x16_t quote[4], backslash[4], op[4], white[4], control[4];
+        for (int32 i = 0; i < 4; i++)
+        {
+            uint8x16_t input = vld1q_u8(block + i * 16);
+            uint8x16_t folded = vorrq_u8(input, vdupq_n_u8(0x20));
+            quote[i] = vceqq_u8(input, vdupq_n_u8('"'));
+            backslash[i] = vceqq_u8(input, vdupq_n_u8('\\'));
+            op[i] = vorrq_u8(vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}'))),
+                             vorrq_u8(vceqq_u8(input, vdupq_n_u8(':')), vceqq_u8(input, vdupq_n_u8(','))));
+            white[i] = vorrq_u8(vorrq_u8(vceqq_u8(input, vdupq_n_u8(' ')), vceqq_u8(input, vdupq_n_u8('\t'))),
+                                vorrq_u8(vceqq_u8(input, vdupq_n_u8('\n')), vceqq_u8(input, vdupq_n_u8('\r'))));
+            control[i] = vcltq_u8(input, vdupq_n_u8(0x20));
+        }
+        masks.Quote = ToMaskNeon(quote[0], quote[1], quote[2], quote[3]);
+        masks.Backslash = ToMaskNeon(backslash[0], backslash[1], backslash[2], backslash[3]);
+        masks.Operator = ToMaskNeon(op[0], op[1], op[2], op[3]);
+        masks.Space = ToMaskNeon(white[0], white[1], white[2], white[3]);
+        masks.Control = ToMaskNeon(control[0], control[1], control[2], control[3]);
+    }
+#endif
+
+    ClassifyKernel GetClassifyKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const ClassifyKernel kernel = SelectKernel<ClassifyKernel>(&ClassifySse, &ClassifyAvx2);
+        return kernel ? kernel : &ClassifyScalar;
+#elif defined(CPU_ARCH_ARM64)
+        return &ClassifyNeon;
+#else
+        return &ClassifyScalar;
+#endif
+    }
+
+    // 数组与对象的最大嵌套层数，与 simdjson 的默认值相同
+    constexpr int64 MAX_DEPTH = 1024;
+
+    /// <summary>
+    /// 第二阶段中未结束的数组或对象
+    /// </summary>
+    struct Frame
+    {
+        // 开始括号的结构符号编号
+        uint32 Open;
+        // 已读到的逗号数
+        uint32 Commas;
+    };
+
+    /// <summary>
+    /// 第二阶段的语法状态
+    /// </summary>
+    enum class ParseState
+    {
+        // 期望一个值
+        Value,
+        // 期望数组的第一个元素或 ']'
+        FirstElement,
+        // 期望对象的第一个成员名或 '}'
+        FirstKey,
+        // 期望逗号之后的成员名
+        Key,
+        // 期望逗号或结束括号
+        AfterValue
+    };
+}
+
+struct JsonDocument::Index
+{
+    // 持有的输入视图，解析文本时为空
+    ByteView View;
+    // 输入数据
+    const char* Data = nullptr;
+    // 输入字节数
+    int64 Size = 0;
+    // 结构符号的字节偏移，末尾追加输入字节数作为哨兵
+    Array<uint32> Positions;
+    // 开始括号处为对应结束括号的编号，结束括号处为元素或成员数
+    Array<uint32> Matches;
+
+    // 获取第 token 个结构符号的首字符
+    char TokenChar(uint32 token) const
+    {
+        return Data[Positions[token]];
+    }
+
+    // 获取第 token 个结构符号处的字符串(含两侧的引号)、数字或字面量：与下一个结构符号之间只有空白
+    StringView TokenText(uint32 token) const
+    {
+        int64 start = Positions[token];
+        int64 end = Positions[token + 1];
+        while (end > start && IsSpace(Data[end - 1]))
+        {
+            end--;
+        }
+        return StringView(Data + start, end - start);
+    }
+};
+
+JsonDocument::JsonDocument() = default;
+
+JsonDocument::~JsonDocument() = default;
+
+JsonDocument::JsonDocument(JsonDocument&& other) noexcept = default;
+
+JsonDocument& JsonDocument::operator=(JsonDocument&& other) noexcept = default;
+
+bool JsonDocument::Parse(const ByteView& data)
+{
+    m_index = std::make_unique<Index>();
+    m_index->View = data;
+    m_index->Data = reinterpret_cast<const char*>(data.Data());
+    m_index->Size = data.Size();
+    return _Parse();
+}
+
+bool JsonDocument::Parse(StringView text)
+{
+    m_index = std::make_unique<Index>();
+    m_index->Data = text.Data();
+    m_index->Size = text.Size();
+    return _Parse();
+}
+
+JsonValue JsonDocument::Root() const
+{
+    return m_index ? JsonValue(m_index.get(), 0) : JsonValue();
+}
+
+JsonError JsonDocument::Error() const
+{
+    return m_error;
+}
+
+int64 JsonDocument::ErrorOffset() const
+{
+    return m_errorOffset;
+}
+
+/* private */
+
+bool JsonDocument::_Parse()
+{
+    m_error = JsonError::None;
+    m_errorOffset = -1;
+
+    bool parsed = false;
+    if (m_index->Size > std::numeric_limits<uint32>::max())
+    {
+        _Fail(JsonError::TooLarge, 0);
+    }
+    else if (!Utf8::IsValid(m_index->Data, m_index->Size))
+    {
+        // 只在出错时逐个解码以定位无效序列
+        int64 pos = 0;
+        uint32 code = 0;
+        while (pos < m_index->Size)
+        {
+            int32 length = Utf8::Decode(m_index->Data + pos, m_index->Size - pos, code);
+            if (length == 0)
+            {
+                break;
+            }
+            pos += length;
+        }
+        _Fail(JsonError::InvalidUtf8, pos);
+    }
+    else
+    {
+        parsed = _BuildIndex() && _Validate();
+    }
+
+    if (!parsed)
+    {
+        m_index.reset();
+    }
+    return parsed;
+}
+
+bool JsonDocument::_BuildIndex()
+{
+    const char* data = m_index->Data;
+    int64 size = m_index->Size;
+    Array<uint32>& positions = m_index->Positions;
+    ClassifyKernel classify = GetClassifyKernel();
+
+    // 跳过 UTF-8 BOM
+    int64 start = size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+    positions.Reserve(size / 8 + 16);
+
+    uint64 escapeCarry = 0;
+    uint64 stringCarry = 0;
+    uint64 scalarCarry = 0;
+    alignas(BLOCK_SIZE) uint8 tail[BLOCK_SIZE];
+    for (int64 base = start; base < size; base += BLOCK_SIZE)
+    {
+        const uint8* block = reinterpret_cast<const uint8*>(data + base);
+        if (size - base < BLOCK_SIZE)
+        {
+            // 最后不足一块的部分以空白补齐
+            std::memset(tail, ' ', BLOCK_SIZE);
+            std::memcpy(tail, block, static_cast<size_t>(size - base));
+            block = tail;
+        }
+
+        BlockMasks masks;
+        classify(block, masks);
+
+        uint64 escaped = 0;
+        if ((masks.Backslash | escapeCarry) != 0)
+        {
+            escaped = FindEscaped(masks.Backslash, escapeCarry);
+            int64 invalid = CheckEscapes(data, size, base, escaped);
+            if (invalid >= 0)
+            {
+                return _Fail(JsonError::InvalidString, invalid);
+            }
+        }
+
+        uint64 quotes = masks.Quote & ~escaped;
+        uint64 inString = PrefixXor(quotes) ^ stringCarry;
+        stringCarry = static_cast<uint64>(static_cast<int64>(inString) >> 63);
+        if (uint64 control = masks.Control & inString)
+        {
+            return _Fail(JsonError::InvalidString, base + std::countr_zero(control));
+        }
+
+        uint64 scalar = ~(masks.Operator | masks.Space | masks.Quote | inString);
+        uint64 scalarStarts = scalar & ~((scalar << 1) | scalarCarry);
+        scalarCarry = scalar >> 63;
+
+        uint64 structurals = (masks.Operator & ~inString) | (quotes & inString) | scalarStarts;
+        if (structurals == 0)
+        {
+            continue;
+        }
+        // 按已扫描部分的密度预估总数，一次预留
+        int64 count = std::popcount(structurals);
+        if (positions.Size() + count > positions.Capacity())
+        {
+            double density = static_cast<double>(positions.Size() + count) / static_cast<double>(base + BLOCK_SIZE - start);
+            int64 estimate = static_cast<int64>(density * static_cast<double>(size - start) * 1.125) + BLOCK_SIZE;
+            positions.Reserve(estimate);
+        }
+        do
+        {
+            positions.Push(static_cast<uint32>(base + std::countr_zero(structurals)));
+            structurals &= structurals - 1;
+        } while (structurals != 0);
+    }
+
+    if (stringCarry != 0)
+    {
+        return _Fail(JsonError::UnclosedString, size);
+    }
+    positions.Push(static_cast<uint32>(size));
+    return true;
+}
+
+bool JsonDocument::_Validate()
+{
+    const char* data = m_index->Data;
+    const uint32* positions = m_index->Positions.Data();
+    uint32 count = static_cast<uint32>(m_index->Positions.Size() - 1);
+    if (count == 0)
+    {
+        return _Fail(JsonError::Empty, m_index->Size);
+    }
+
+    m_index->Matches.Resize(count);
+    uint32* matches = m_index->Matches.Data();
+    Array<Frame> stack;
+    ParseState state = ParseState::Value;
+
+    // 开始数组或对象，嵌套过深时失败
+    auto open = [&](uint32 token, ParseState first)
+    {
+        if (stack.Size() >= MAX_DEPTH)
+        {
+            return _Fail(JsonError::TooDeep, positions[token]);
+        }
+        stack.Push(Frame{ token, 0 });
+        state = first;
+        return true;
+    };
+    // 结束栈顶的数组或对象
+    auto close = [&](uint32 token, uint32 size)
+    {
+        matches[stack.Back().Open] = token;
+        matches[token] = size;
+        stack.Pop();
+        state = ParseState::AfterValue;
+    };
+
+    for (uint32 token = 0; token < count; token++)
+    {
+        char ch = data[positions[token]];
+        switch (state)
+        {
+        case ParseState::FirstElement:
+            if (ch == ']')
+            {
+                close(token, 0);
+                break;
+            }
+            [[fallthrough]];
+        case ParseState::Value:
+            switch (ch)
+            {
+            case '{':
+                if (!open(token, ParseState::FirstKey))
+                {
+                    return false;
+                }
+                break;
+            case '[':
+                if (!open(token, ParseState::FirstElement))
+                {
+                    return false;
+                }
+                break;
+            case '"':
+                state = ParseState::AfterValue;
+                break;
+            case '}':
+            case ']':
+            case ',':
+            case ':':
+                return _Fail(JsonError::UnexpectedToken, positions[token]);
+            default:
+                if (!_ValidateScalar(token))
+                {
+                    return false;
+                }
+                state = ParseState::AfterValue;
+                break;
+            }
+            break;
+        case ParseState::FirstKey:
+            if (ch == '}')
+            {
+                close(token, 0);
+                break;
+            }
+            [[fallthrough]];
+        case ParseState::Key:
+            if (ch != '"')
+            {
+                return _Fail(JsonError::UnexpectedToken, positions[token]);
+            }
+            if (token + 1 == count)
+            {
+                return _Fail(JsonError::UnexpectedEnd, positions[count]);
+            }
+            if (data[positions[token + 1]] != ':')
+            {
+                return _Fail(JsonError::UnexpectedToken, positions[token + 1]);
+            }
+            token++;
+            state = ParseState::Value;
+            break;
+        case ParseState::AfterValue:
+        {
+            if (stack.IsEmpty())
+            {
+                return _Fail(JsonError::TrailingContent, positions[token]);
+            }
+            Frame& frame = stack.Back();
+            bool object = data[positions[frame.Open]] == '{';
+            if (ch == ',')
+            {
+                frame.Commas++;
+                state = object ? ParseState::Key : ParseState::Value;
+            }
+            else if (ch == (object ? '}' : ']'))
+            {
+                close(token, frame.Commas + 1);
+            }
+            else
+            {
+                return _Fail(JsonError::UnexpectedToken, positions[token]);
+            }
+            break;
+        }
+        }
+    }
+
+    if (!stack.IsEmpty() || state != ParseState::AfterValue)
+    {
+        return _Fail(JsonError::UnexpectedEnd, m_index->Size);
+    }
+    return true;
+}
+
+bool JsonDocument::_ValidateScalar(uint32 token)
+{
+    StringView text = m_index->TokenText(token);
+    switch (text.Data()[0])
+    {
+    case 't':
+        return text == "true" || _Fail(JsonError::InvalidLiteral, m_index->Positions[token]);
+    case 'f':
+        return text == "false" || _Fail(JsonError::InvalidLiteral, m_index->Positions[token]);
+    case 'n':
+        return text == "null" || _Fail(JsonError::InvalidLiteral, m_index->Positions[token]);
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        return IsValidNumber(text.Data(), text.Data() + text.Size()) || _Fail(JsonError::InvalidNumber, m_index->Positions[token]);
+    default:
+        return _Fail(JsonError::InvalidLiteral, m_index->Positions[token]);
+    }
+}
+
+bool JsonDocument::_Fail(JsonError error, int64 offset)
+{
+    m_error = error;
+    m_errorOffset = offset;
+    return false;
+}
+
+JsonValue::JsonValue(const JsonDocument::Index* index, uint32 token)
+    : m_index(index)
+    , m_token(token)
+{
+
+}
+
+JsonType JsonValue::Type() const
+{
+    if (!m_index)
+    {
+        return JsonType::Null;
+    }
+
+    switch (m_index->TokenChar(m_token))
+    {
+    case '{':
+        return JsonType::Object;
+    case '[':
+        return JsonType::Array;
+    case '"':
+        return JsonType::String;
+    case 't':
+    case 'f':
+        return JsonType::Bool;
+    case 'n':
+        return JsonType::Null;
+    default:
+        return JsonType::Number;
+    }
+}
+
+bool JsonValue::IsNull() const
+{
+    return Type() == JsonType::Null;
+}
+
+bool JsonValue::IsBool() const
+{
+    return Type() == JsonType::Bool;
+}
+
+bool JsonValue::IsNumber() const
+{
+    return Type() == JsonType::Number;
+}
+
+bool JsonValue::IsString() const
+{
+    return Type() == JsonType::String;
+}
+
+bool JsonValue::IsArray() const
+{
+    return Type() == JsonType::Array;
+}
+
+bool JsonValue::IsObject() const
+{
+    return Type() == JsonType::Object;
+}
+
+bool JsonValue::AsBool() const
+{
+    if (!IsBool())
+    {
+        throw std::logic_error("JSON value is not a bool");
+    }
+    return m_index->TokenChar(m_token) == 't';
+}
+
+int64 JsonValue::AsInt64() const
+{
+    StringView text = _NumberText();
+    int64 value = 0;
+    if (text.TryParse(value))
+    {
+        return value;
+    }
+
+    // 带小数、指数或超出范围的整数
+    double real = 0.0;
+    if (!text.TryParse(real) || !(real >= -0x1p63 && real < 0x1p63))
+    {
+        throw std::out_of_range("JSON number is out of range of int64");
+    }
+    return static_cast<int64>(real);
+}
+
+double JsonValue::AsDouble() const
+{
+    double value = 0.0;
+    if (!_NumberText().TryParse(value))
+    {
+        throw std::out_of_range("JSON number is out of range of double");
+    }
+    return value;
+}
+
+String JsonValue::AsString() const
+{
+    if (!IsString())
+    {
+        throw std::logic_error("JSON value is not a string");
+    }
+
+    StringView raw = RawText();
+    const char* ptr = raw.Data();
+    const char* end = ptr + raw.Size();
+    const char* escape = static_cast<const char*>(std::memchr(ptr, '\\', static_cast<size_t>(raw.Size())));
+    if (!escape)
+    {
+        return String(raw);
+    }
+
+    // 解码后不会比原文长：\uXXXX 最多 3 个字节，代理对 \uXXXX\uXXXX 为 4 个字节
+    Array<char> buffer;
+    buffer.Resize(raw.Size());
+    char* out = buffer.Data();
+    while (escape)
+    {
+        std::memcpy(out, ptr, static_cast<size_t>(escape - ptr));
+        out += escape - ptr;
+        ptr = escape + 2;
+        switch (escape[1])
+        {
+        case 'b':
+            *out++ = '\b';
+            break;
+        case 'f':
+            *out++ = '\f';
+            break;
+        case 'n':
+            *out++ = '\n';
+            break;
+        case 'r':
+            *out++ = '\r';
+            break;
+        case 't':
+            *out++ = '\t';
+            break;
+        case 'u':
+        {
+            uint32 code = static_cast<uint32>(ParseHex4(ptr));
+            ptr += 4;
+            if (code >= 0xD800 && code <= 0xDBFF && end - ptr >= 6 && ptr[0] == '\\' && ptr[1] == 'u')
+            {
+                uint32 low = static_cast<uint32>(ParseHex4(ptr + 2));
+                if (low >= 0xDC00 && low <= 0xDFFF)
+                {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    ptr += 6;
+                }
+            }
+            if (code >= 0xD800 && code <= 0xDFFF)
+            {
+                code = 0xFFFD;
+            }
+            out += Utf8::Encode(code, out);
+            break;
+        }
+        default:
+            // \" \\ \/
+            *out++ = escape[1];
+            break;
+        }
+        escape = static_cast<const char*>(std::memchr(ptr, '\\', static_cast<size_t>(end - ptr)));
+    }
+    std::memcpy(out, ptr, static_cast<size_t>(end - ptr));
+    out += end - ptr;
+    return String(buffer.Data(), out - buffer.Data());
+}
+
+StringView JsonValue::RawText() const
+{
+    if (!m_index)
+    {
+        return StringView();
+    }
+
+    switch (m_index->TokenChar(m_token))
+    {
+    case '{':
+    case '[':
+    {
+        int64 start = m_index->Positions[m_token];
+        int64 end = m_index->Positions[m_index->Matches[m_token]] + 1;
+        return StringView(m_index->Data + start, end - start);
+    }
+    case '"':
+    {
+        StringView text = m_index->TokenText(m_token);
+        return text.Slice(1, text.Size() - 2);
+    }
+    default:
+        return m_index->TokenText(m_token);
+    }
+}
+
+int64 JsonValue::Size() const
+{
+    JsonType type = Type();
+    if (type != JsonType::Array && type != JsonType::Object)
+    {
+        return 0;
+    }
+    return m_index->Matches[m_index->Matches[m_token]];
+}
+
+bool JsonValue::Contains(StringView key) const
+{
+    JsonValue value;
+    return TryGet(key, value);
+}
+
+bool JsonValue::TryGet(StringView key, JsonValue& value) const
+{
+    if (!IsObject())
+    {
+        return false;
+    }
+
+    bool found = false;
+    ForEachMember([&](JsonValue name, JsonValue member)
+    {
+        if (_KeyEquals(name.m_token, key))
+        {
+            value = member;
+            found = true;
+        }
+        return !found;
+    });
+    return found;
+}
+
+Array<JsonValue> JsonValue::ToArray() const
+{
+    Array<JsonValue> result;
+    result.Reserve(Size());
+    ForEachElement([&](JsonValue element)
+    {
+        result.Push(element);
+        return true;
+    });
+    return result;
+}
+
+HashMap<String, JsonValue> JsonValue::ToMap() const
+{
+    HashMap<String, JsonValue> result;
+    result.Reserve(Size());
+    ForEachMember([&](JsonValue key, JsonValue value)
+    {
+        result[key.AsString()] = value;
+        return true;
+    });
+    return result;
+}
+
+JsonValue JsonValue::operator[](int64 index) const
+{
+    _Close(JsonType::Array);
+    if (index < 0 || index >= Size())
+    {
+        throw std::out_of_range("JSON array index out of range");
+    }
+
+    uint32 token = m_token + 1;
+    for (; index > 0; index--)
+    {
+        token = _Next(token) + 1;
+    }
+    return JsonValue(m_index, token);
+}
+
+JsonValue JsonValue::operator[](StringView key) const
+{
+    _Close(JsonType::Object);
+    JsonValue value;
+    if (!TryGet(key, value))
+    {
+        throw std::out_of_range("JSON object has no such member");
+    }
+    return value;
+}
+
+/* private */
+
+uint32 JsonValue::_Close(JsonType type) const
+{
+    if (Type() != type)
+    {
+        throw std::logic_error(type == JsonType::Array ? "JSON value is not an array" : "JSON value is not an object");
+    }
+    return m_index->Matches[m_token];
+}
+
+uint32 JsonValue::_Next(uint32 token) const
+{
+    char ch = m_index->TokenChar(token);
+    return (ch == '{' || ch == '[' ? m_index->Matches[token] : token) + 1;
+}
+
+bool JsonValue::_KeyEquals(uint32 token, StringView key) const
+{
+    StringView text = m_index->TokenText(token);
+    StringView raw = text.Slice(1, text.Size() - 2);
+    if (!std::memchr(raw.Data(), '\\', static_cast<size_t>(raw.Size())))
+    {
+        return raw == key;
+    }
+    return JsonValue(m_index, token).AsString().View() == key;
+}
+
+StringView JsonValue::_NumberText() const
+{
+    if (!IsNumber())
+    {
+        throw std::logic_error("JSON value is not a number");
+    }
+    return m_index->TokenText(m_token);
+}
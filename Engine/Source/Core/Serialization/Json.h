@@ -0,0 +1,321 @@
+#pragma once
+
+#include "Core.h"
+#include "Container/Array.h"
+#include "Container/HashMap.h"
+#include "Memory/ByteView.h"
+#include "String/String.h"
+#include "String/StringView.h"
+
+#include <memory>
+
+class JsonValue;
+
+/// <summary>
+/// JSON 值类型
+/// </summary>
+enum class JsonType
+{
+    // null，默认构造的值也是 null
+    Null,
+    // true 或 false
+    Bool,
+    // 数字
+    Number,
+    // 字符串
+    String,
+    // 数组
+    Array,
+    // 对象
+    Object
+};
+
+/// <summary>
+/// JSON 解析错误
+/// </summary>
+enum class JsonError
+{
+    // 没有错误
+    None,
+    // 文档为空或只有空白
+    Empty,
+    // 文档超过 4 GB
+    TooLarge,
+    // 内容不是有效的 UTF-8
+    InvalidUtf8,
+    // 字符串没有结束引号
+    UnclosedString,
+    // 字符串中有控制字符或无效的转义序列
+    InvalidString,
+    // 数字格式无效
+    InvalidNumber,
+    // 不是 true、false 或 null 的字面量
+    InvalidLiteral,
+    // 不符合语法的符号(如缺少逗号、冒号或多余的逗号)
+    UnexpectedToken,
+    // 数组或对象没有结束
+    UnexpectedEnd,
+    // 数组与对象嵌套超过 1024 层
+    TooDeep,
+    // 根值之后还有其他内容
+    TrailingContent
+};
+
+/// <summary>
+/// JSON 文档(RFC 8259)，两阶段解析(Langdale & Lemire, "Parsing Gigabytes of JSON per Second")
+/// <para>第一阶段以 SIMD 每次分类 64 个字节，用位运算排除字符串内的字节，得到全部结构符号({}[]:, 字符串和标量的起点)的位置索引；
+/// 第二阶段按索引检查语法并记录每个数组、对象的结束位置，不解码任何值</para>
+/// <para>之后通过 JsonValue 访问时直接跳过不需要的子树，字符串、数字只在访问时解码，数组和对象只在调用 ToArray、ToMap 时生成 Array、HashMap</para>
+/// <para>文档引用而不复制输入：ByteView(如 MappedFile::View 返回的映射视图，或以 ByteView(std::move(array)) 包装的 ByteArray)由文档持有引用，
+/// 文本则需调用方保证在文档使用期间有效</para>
+/// </summary>
+class JsonDocument
+{
+    friend class JsonValue;
+public:
+    /// <summary>
+    /// 默认构造函数
+    /// </summary>
+    JsonDocument();
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~JsonDocument();
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    JsonDocument(const JsonDocument& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    JsonDocument& operator=(const JsonDocument& other) = delete;
+    /// <summary>
+    /// 移动构造函数，已获取的 JsonValue 仍然有效
+    /// </summary>
+    JsonDocument(JsonDocument&& other) noexcept;
+    /// <summary>
+    /// 移动赋值运算符，已获取的 JsonValue 仍然有效
+    /// </summary>
+    JsonDocument& operator=(JsonDocument&& other) noexcept;
+public:
+    /// <summary>
+    /// 解析字节视图，文档持有视图的引用
+    /// </summary>
+    /// <returns>解析失败返回 false，由 Error、ErrorOffset 获取原因与位置</returns>
+    bool Parse(const ByteView& data);
+    /// <summary>
+    /// 解析文本，不复制数据
+    /// </summary>
+    /// <returns>解析失败返回 false，由 Error、ErrorOffset 获取原因与位置</returns>
+    bool Parse(StringView text);
+    /// <summary>
+    /// 获取根值，解析失败时为 null
+    /// </summary>
+    JsonValue Root() const;
+    /// <summary>
+    /// 获取错误
+    /// </summary>
+    JsonError Error() const;
+    /// <summary>
+    /// 获取错误在输入中的字节偏移，没有错误时为 -1
+    /// </summary>
+    int64 ErrorOffset() const;
+private:
+    /// <summary>
+    /// 解析结果(结构符号索引)，单独分配以便移动文档后 JsonValue 仍然有效
+    /// </summary>
+    struct Index;
+private:
+    /// <summary>
+    /// 解析已设置的输入
+    /// </summary>
+    bool _Parse();
+    /// <summary>
+    /// 第一阶段：建立结构符号索引，同时检查字符串
+    /// </summary>
+    bool _BuildIndex();
+    /// <summary>
+    /// 第二阶段：检查语法并匹配括号
+    /// </summary>
+    bool _Validate();
+    /// <summary>
+    /// 检查数字或字面量
+    /// </summary>
+    bool _ValidateScalar(uint32 token);
+    /// <summary>
+    /// 记录错误并返回 false
+    /// </summary>
+    bool _Fail(JsonError error, int64 offset);
+private:
+    // 解析结果
+    std::unique_ptr<Index> m_index;
+    // 错误
+    JsonError m_error = JsonError::None;
+    // 错误的字节偏移
+    int64 m_errorOffset = -1;
+};
+
+/// <summary>
+/// JSON 值，指向 JsonDocument 中的一个值
+/// <para>只是文档内的一个位置，拷贝开销很小；字符串、数字在访问时才解码，数组和对象在调用 ToArray、ToMap 时才生成容器</para>
+/// <para>在所属文档销毁或重新解析之前有效</para>
+/// </summary>
+class JsonValue
+{
+    friend class JsonDocument;
+public:
+    /// <summary>
+    /// 默认构造函数，构造 null 值
+    /// </summary>
+    JsonValue() = default;
+public:
+    /// <summary>
+    /// 获取类型
+    /// </summary>
+    JsonType Type() const;
+    /// <summary>
+    /// 判断是否为 null
+    /// </summary>
+    bool IsNull() const;
+    /// <summary>
+    /// 判断是否为布尔值
+    /// </summary>
+    bool IsBool() const;
+    /// <summary>
+    /// 判断是否为数字
+    /// </summary>
+    bool IsNumber() const;
+    /// <summary>
+    /// 判断是否为字符串
+    /// </summary>
+    bool IsString() const;
+    /// <summary>
+    /// 判断是否为数组
+    /// </summary>
+    bool IsArray() const;
+    /// <summary>
+    /// 判断是否为对象
+    /// </summary>
+    bool IsObject() const;
+    /// <summary>
+    /// 获取布尔值
+    /// </summary>
+    /// <exception cref="std::logic_error">不是布尔值时抛出</exception>
+    bool AsBool() const;
+    /// <summary>
+    /// 获取整数，带小数或指数的数字截断为整数
+    /// </summary>
+    /// <exception cref="std::logic_error">不是数字时抛出</exception>
+    /// <exception cref="std::out_of_range">超出 int64 范围时抛出</exception>
+    int64 AsInt64() const;
+    /// <summary>
+    /// 获取浮点数
+    /// </summary>
+    /// <exception cref="std::logic_error">不是数字时抛出</exception>
+    /// <exception cref="std::out_of_range">超出 double 范围时抛出</exception>
+    double AsDouble() const;
+    /// <summary>
+    /// 获取字符串，解码转义序列(不成对的 \u 代理项解码为 U+FFFD)
+    /// </summary>
+    /// <exception cref="std::logic_error">不是字符串时抛出</exception>
+    String AsString() const;
+    /// <summary>
+    /// 获取值在文档中的原文，不复制数据；字符串不含两侧的引号且不解码转义序列，数组和对象包含全部内容
+    /// </summary>
+    StringView RawText() const;
+    /// <summary>
+    /// 获取数组的元素数或对象的成员数，其他类型返回 0
+    /// </summary>
+    int64 Size() const;
+    /// <summary>
+    /// 判断对象是否有指定的成员，不是对象时返回 false
+    /// </summary>
+    bool Contains(StringView key) const;
+    /// <summary>
+    /// 查找对象的成员，重复的成员取第一个
+    /// </summary>
+    /// <param name="key">成员名</param>
+    /// <param name="value">成员的值</param>
+    /// <returns>不是对象或没有该成员时返回 false</returns>
+    bool TryGet(StringView key, JsonValue& value) const;
+    /// <summary>
+    /// 将数组的元素生成为数组
+    /// </summary>
+    /// <exception cref="std::logic_error">不是数组时抛出</exception>
+    Array<JsonValue> ToArray() const;
+    /// <summary>
+    /// 将对象的成员生成为哈希表，重复的成员取最后一个
+    /// </summary>
+    /// <exception cref="std::logic_error">不是对象时抛出</exception>
+    HashMap<String, JsonValue> ToMap() const;
+    /// <summary>
+    /// 按顺序对数组的每个元素调用 callback(JsonValue)，返回 false 时停止
+    /// </summary>
+    /// <exception cref="std::logic_error">不是数组时抛出</exception>
+    template<class Callback>
+    void ForEachElement(Callback&& callback) const
+    {
+        uint32 end = _Close(JsonType::Array);
+        for (uint32 token = m_token + 1; token < end; token = _Next(token) + 1)
+        {
+            if (!callback(JsonValue(m_index, token)))
+            {
+                return;
+            }
+        }
+    }
+    /// <summary>
+    /// 按顺序对对象的每个成员调用 callback(JsonValue key, JsonValue value)，返回 false 时停止；key 为字符串值，可按需解码
+    /// </summary>
+    /// <exception cref="std::logic_error">不是对象时抛出</exception>
+    template<class Callback>
+    void ForEachMember(Callback&& callback) const
+    {
+        uint32 end = _Close(JsonType::Object);
+        for (uint32 token = m_token + 1; token < end; token = _Next(token + 2) + 1)
+        {
+            if (!callback(JsonValue(m_index, token), JsonValue(m_index, token + 2)))
+            {
+                return;
+            }
+        }
+    }
+    /// <summary>
+    /// 获取数组的元素
+    /// </summary>
+    /// <exception cref="std::logic_error">不是数组时抛出</exception>
+    /// <exception cref="std::out_of_range">索引越界时抛出</exception>
+    JsonValue operator[](int64 index) const;
+    /// <summary>
+    /// 获取对象的成员，重复的成员取第一个
+    /// </summary>
+    /// <exception cref="std::logic_error">不是对象时抛出</exception>
+    /// <exception cref="std::out_of_range">没有该成员时抛出</exception>
+    JsonValue operator[](StringView key) const;
+private:
+    /// <summary>
+    /// 构造指向文档中第 token 个结构符号的值
+    /// </summary>
+    JsonValue(const JsonDocument::Index* index, uint32 token);
+    /// <summary>
+    /// 检查类型并返回结束括号的结构符号编号
+    /// </summary>
+    uint32 _Close(JsonType type) const;
+    /// <summary>
+    /// 返回从 token 开始的值之后的结构符号编号(逗号或结束括号)
+    /// </summary>
+    uint32 _Next(uint32 token) const;
+    /// <summary>
+    /// 判断第 token 个结构符号处的字符串是否等于 key
+    /// </summary>
+    bool _KeyEquals(uint32 token, StringView key) const;
+    /// <summary>
+    /// 获取数字的原文，不是数字时抛出异常
+    /// </summary>
+    StringView _NumberText() const;
+private:
+    // 所属文档的索引，null 值为空
+    const JsonDocument::Index* m_index = nullptr;
+    // 值的首个结构符号编号
+    uint32 m_token = 0;
+};
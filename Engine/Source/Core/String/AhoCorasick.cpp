@@ -0,0 +1,223 @@
+#include "pch.h"
+
+#include "AhoCorasick.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    inline uint8 FoldByte(uint8 value, bool ignoreCase)
+    {
+        return ignoreCase && value >= 'A' && value <= 'Z' ? static_cast<uint8>(value | 0x20) : value;
+    }
+}
+
+AhoCorasick::AhoCorasick(bool ignoreCase)
+    : m_ignoreCase(ignoreCase)
+{
+    Build();
+}
+
+AhoCorasick::AhoCorasick(const Array<StringView>& patterns, bool ignoreCase)
+    : m_ignoreCase(ignoreCase)
+{
+    m_patterns.Reserve(patterns.Size());
+    for (StringView pattern : patterns)
+    {
+        Add(pattern);
+    }
+    Build();
+}
+
+int32 AhoCorasick::Add(StringView pattern)
+{
+    if (pattern.IsEmpty())
+    {
+        throw std::invalid_argument("Pattern must not be empty");
+    }
+    m_patterns.Push(String(pattern));
+    m_built = false;
+    return static_cast<int32>(m_patterns.Size() - 1);
+}
+
+void AhoCorasick::Build()
+{
+    // 只为模式中出现的字节分配列，忽略大小写时大写字母与对应的小写字母共用一列
+    m_classes.fill(0);
+    m_classCount = 1;
+    for (const String& pattern : m_patterns)
+    {
+        const uint8* data = reinterpret_cast<const uint8*>(pattern.Data());
+        for (int64 i = 0; i < pattern.Size(); i++)
+        {
+            uint8 key = FoldByte(data[i], m_ignoreCase);
+            if (m_classes[key] == 0)
+            {
+                m_classes[key] = static_cast<uint16>(m_classCount++);
+            }
+        }
+    }
+    if (m_ignoreCase)
+    {
+        for (int32 ch = 'A'; ch <= 'Z'; ch++)
+        {
+            m_classes[ch] = m_classes[ch | 0x20];
+        }
+    }
+
+    // 构建字典树，缺失的转移暂记为 -1
+    // 状态数在建完之前未知，转移表与状态表按倍数扩大，建完后截到实际的状态数
+    m_transitions.Clear();
+    m_statePatterns.Clear();
+    m_nextPatterns.Clear();
+    m_nextPatterns.Resize(PatternCount());
+    int64 stateCount = 0;
+    auto newState = [this, &stateCount]() {
+        if (stateCount == m_statePatterns.Size())
+        {
+            int64 capacity = std::max<int64>(stateCount * 2, 16);
+            m_transitions.Resize(capacity * m_classCount);
+            std::fill_n(m_transitions.Data() + stateCount * m_classCount, (capacity - stateCount) * m_classCount, -1);
+            m_statePatterns.Resize(capacity);
+            std::fill_n(m_statePatterns.Data() + stateCount, capacity - stateCount, -1);
+        }
+        return static_cast<int32>(stateCount++);
+    };
+    newState();
+
+    for (int32 index = 0; index < PatternCount(); index++)
+    {
+        const String& pattern = m_patterns[index];
+        const uint8* data = reinterpret_cast<const uint8*>(pattern.Data());
+        int64 state = 0;
+        for (int64 i = 0; i < pattern.Size(); i++)
+        {
+            int64 slot = state * m_classCount + m_classes[data[i]];
+            if (m_transitions[slot] < 0)
+            {
+                int32 next = newState();
+                m_transitions[slot] = next;
+            }
+            state = m_transitions[slot];
+        }
+
+        // 相同的模式按添加顺序链接在同一状态上
+        m_nextPatterns[index] = -1;
+        int32* link = &m_statePatterns[state];
+        while (*link >= 0)
+        {
+            link = &m_nextPatterns[*link];
+        }
+        *link = index;
+    }
+
+    // 按广度优先顺序计算失配状态，并将缺失的转移补全为失配状态的转移，得到确定性自动机
+    m_transitions.Resize(stateCount * m_classCount);
+    m_statePatterns.Resize(stateCount);
+    m_suffixes.Clear();
+    m_suffixes.Resize(stateCount);
+    m_outputs.Clear();
+    m_outputs.Resize(stateCount);
+    m_outputs[0] = -1;
+
+    Array<int32> queue;
+    queue.Reserve(stateCount);
+    for (int64 c = 0; c < m_classCount; c++)
+    {
+        int32 next = m_transitions[c];
+        if (next < 0)
+        {
+            m_transitions[c] = 0;
+        }
+        else
+        {
+            m_suffixes[next] = 0;
+            queue.Push(next);
+        }
+    }
+
+    for (int64 head = 0; head < queue.Size(); head++)
+    {
+        int64 state = queue[head];
+        int64 suffix = m_suffixes[state];
+        m_outputs[state] = m_statePatterns[state] >= 0 ? static_cast<int32>(state) : m_outputs[suffix];
+        for (int64 c = 0; c < m_classCount; c++)
+        {
+            int32& next = m_transitions[state * m_classCount + c];
+            int32 fallback = m_transitions[suffix * m_classCount + c];
+            if (next < 0)
+            {
+                next = fallback;
+            }
+            else
+            {
+                m_suffixes[next] = fallback;
+                queue.Push(next);
+            }
+        }
+    }
+    m_built = true;
+}
+
+int32 AhoCorasick::PatternCount() const
+{
+    return static_cast<int32>(m_patterns.Size());
+}
+
+StringView AhoCorasick::Pattern(int32 index) const
+{
+    if (index < 0 || index >= PatternCount())
+    {
+        throw std::out_of_range("Pattern index out of range");
+    }
+    return m_patterns[index].View();
+}
+
+bool AhoCorasick::IsMatch(StringView text) const
+{
+    bool found = false;
+    Scan(text, [&found](const Match&) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool AhoCorasick::Search(StringView text, Match& match, int64 start) const
+{
+    if (start < 0 || start > text.Size())
+    {
+        return false;
+    }
+
+    bool found = false;
+    Scan(StringView(text.Data() + start, text.Size() - start), [&](const Match& current) {
+        match = current;
+        match.Offset += start;
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+int64 AhoCorasick::FindAll(StringView text, Array<Match>& matches) const
+{
+    int64 count = 0;
+    Scan(text, [&](const Match& match) {
+        matches.Push(match);
+        count++;
+        return true;
+    });
+    return count;
+}
+
+/* private */
+
+void AhoCorasick::_CheckBuilt() const
+{
+    if (!m_built)
+    {
+        throw std::logic_error("AhoCorasick::Build must be called after adding patterns");
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Core.h"
+#include "Container/Array.h"
+#include "String/String.h"
+#include "String/StringView.h"
+
+#include <array>
+
+/// <summary>
+/// 多模式匹配(Aho-Corasick 自动机)
+/// <para>所有模式构建为一个确定性自动机，一次遍历文本即可找出全部模式的全部出现位置，每个字节只需一次查表，耗时与模式数量无关</para>
+/// <para>只在模式中出现过的字节各占一列转移表，其余字节共用一列，几十个关键字的自动机通常只有几十 KB</para>
+/// <para>先 Add 全部模式再 Build，之后的查找都是只读的，可被多个线程同时使用</para>
+/// </summary>
+class AhoCorasick
+{
+public:
+    /// <summary>
+    /// 一次匹配
+    /// </summary>
+    struct Match
+    {
+        // 模式编号(Add 的返回值)
+        int32 Pattern;
+        // 在文本中的字节偏移
+        int64 Offset;
+        // 字节数
+        int64 Size;
+    };
+public:
+    /// <summary>
+    /// 构造空的匹配器
+    /// </summary>
+    /// <param name="ignoreCase">是否忽略 ASCII 字母的大小写</param>
+    explicit AhoCorasick(bool ignoreCase = false);
+    /// <summary>
+    /// 以一组模式构造并立即构建
+    /// </summary>
+    /// <param name="patterns">模式，编号依次为 0, 1, 2...</param>
+    /// <param name="ignoreCase">是否忽略 ASCII 字母的大小写</param>
+    explicit AhoCorasick(const Array<StringView>& patterns, bool ignoreCase = false);
+public:
+    /// <summary>
+    /// 添加模式，添加后需重新 Build
+    /// </summary>
+    /// <param name="pattern">非空模式，相同的模式各自报告</param>
+    /// <returns>模式编号</returns>
+    /// <exception cref="std::invalid_argument">模式为空时抛出</exception>
+    int32 Add(StringView pattern);
+    /// <summary>
+    /// 构建自动机
+    /// </summary>
+    void Build();
+    /// <summary>
+    /// 获取模式数量
+    /// </summary>
+    int32 PatternCount() const;
+    /// <summary>
+    /// 获取模式
+    /// </summary>
+    StringView Pattern(int32 index) const;
+    /// <summary>
+    /// 判断文本中是否出现任一模式
+    /// </summary>
+    bool IsMatch(StringView text) const;
+    /// <summary>
+    /// 查找从 start 开始最先结束的匹配(同一位置结束时取最长的模式)
+    /// </summary>
+    /// <param name="text">文本</param>
+    /// <param name="match">匹配结果</param>
+    /// <param name="start">起始字节偏移</param>
+    /// <returns>是否找到</returns>
+    bool Search(StringView text, Match& match, int64 start = 0) const;
+    /// <summary>
+    /// 查找全部匹配(含相互重叠的)，按结束位置顺序追加到数组中
+    /// </summary>
+    /// <returns>匹配数量</returns>
+    int64 FindAll(StringView text, Array<Match>& matches) const;
+    /// <summary>
+    /// 遍历全部匹配，按结束位置顺序对每个匹配调用 callback(const Match&)，返回 false 时停止
+    /// </summary>
+    /// <exception cref="std::logic_error">添加模式后未调用 Build 时抛出</exception>
+    template<class Callback>
+    void Scan(StringView text, Callback&& callback) const
+    {
+        _CheckBuilt();
+        const uint8* data = reinterpret_cast<const uint8*>(text.Data());
+        const int32* transitions = m_transitions.Data();
+        const int32* outputs = m_outputs.Data();
+        int64 size = text.Size();
+        int64 state = 0;
+        for (int64 i = 0; i < size; i++)
+        {
+            state = transitions[state * m_classCount + m_classes[data[i]]];
+            if (outputs[state] < 0) [[likely]]
+            {
+                continue;
+            }
+            // 依次报告在此结束的模式及其作为后缀的模式
+            for (int32 output = outputs[state]; output >= 0; output = m_outputs[m_suffixes[output]])
+            {
+                for (int32 pattern = m_statePatterns[output]; pattern >= 0; pattern = m_nextPatterns[pattern])
+                {
+                    int64 patternSize = m_patterns[pattern].Size();
+                    if (!callback(Match{ pattern, i + 1 - patternSize, patternSize }))
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+private:
+    /// <summary>
+    /// 未构建时抛出异常
+    /// </summary>
+    void _CheckBuilt() const;
+private:
+    // 模式
+    Array<String> m_patterns;
+    // 字节到转移表列号的映射，模式中未出现的字节为 0
+    std::array<uint16, 256> m_classes{};
+    // 转移表列数
+    int64 m_classCount = 1;
+    // 转移表，第 state * m_classCount + class 项为下一状态
+    Array<int32> m_transitions;
+    // 每个状态上第一个有模式结束的状态(自身或后缀状态)，没有时为 -1
+    Array<int32> m_outputs;
+    // 每个状态的失配状态(最长的真后缀状态)
+    Array<int32> m_suffixes;
+    // 每个状态上结束的第一个模式，没有时为 -1
+    Array<int32> m_statePatterns;
+    // 在同一状态结束的下一个模式(相同的模式)，没有时为 -1
+    Array<int32> m_nextPatterns;
+    // 是否忽略大小写
+    bool m_ignoreCase = false;
+    // 是否已构建
+    bool m_built = false;
+};
@@ -0,0 +1,740 @@
+#include "pch.h"
+
+#include "Base64.h"
+#include "CpuFeatures.h"
+
+#include <array>
+
+#if defined(CPU_ARCH_X64)
+    #include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr char STANDARD_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    constexpr char URL_SAFE_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+    constexpr char LOWER_HEX_DIGITS[] = "0123456789abcdef";
+    constexpr char UPPER_HEX_DIGITS[] = "0123456789ABCDEF";
+
+    using DecodeTable = std::array<int8, 256>;
+
+    /// <summary>
+    /// 编译期生成 Base64 反查表，非法字符为 -1
+    /// </summary>
+    constexpr DecodeTable MakeBase64DecodeTable(const char* alphabet)
+    {
+        DecodeTable table{};
+        for (auto& value : table)
+        {
+            value = -1;
+        }
+        for (int32 i = 0; i < 64; ++i)
+        {
+            table[static_cast<uint8>(alphabet[i])] = static_cast<int8>(i);
+        }
+        return table;
+    }
+
+    /// <summary>
+    /// 编译期生成十六进制反查表，非法字符为 -1
+    /// </summary>
+    constexpr DecodeTable MakeHexDecodeTable()
+    {
+        DecodeTable table{};
+        for (auto& value : table)
+        {
+            value = -1;
+        }
+        for (int32 i = 0; i < 10; ++i)
+        {
+            table['0' + i] = static_cast<int8>(i);
+        }
+        for (int32 i = 0; i < 6; ++i)
+        {
+            table['a' + i] = static_cast<int8>(10 + i);
+            table['A' + i] = static_cast<int8>(10 + i);
+        }
+        return table;
+    }
+
+    constexpr DecodeTable STANDARD_DECODE_TABLE = MakeBase64DecodeTable(STANDARD_ALPHABET);
+    constexpr DecodeTable URL_SAFE_DECODE_TABLE = MakeBase64DecodeTable(URL_SAFE_ALPHABET);
+    constexpr DecodeTable HEX_DECODE_TABLE = MakeHexDecodeTable();
+
+    inline const char* GetAlphabet(Base64Alphabet alphabet)
+    {
+        return alphabet == Base64Alphabet::UrlSafe ? URL_SAFE_ALPHABET : STANDARD_ALPHABET;
+    }
+
+    inline const DecodeTable& GetDecodeTable(Base64Alphabet alphabet)
+    {
+        return alphabet == Base64Alphabet::UrlSafe ? URL_SAFE_DECODE_TABLE : STANDARD_DECODE_TABLE;
+    }
+
+    // 向量内核返回已处理的输入字节数，剩余部分由标量代码完成
+    using Base64EncodeKernel = int64(*)(const uint8*, int64, char*, Base64Alphabet);
+    using Base64DecodeKernel = int64(*)(const char*, int64, uint8*, Base64Alphabet);
+    using HexEncodeKernel = int64(*)(const uint8*, int64, char*, bool);
+    using HexDecodeKernel = int64(*)(const char*, int64, uint8*);
+
+#if defined(CPU_ARCH_X64)
+    /*
+     * Base64 编码：每 3 字节拆成 4 个 6 位索引(pshufb 重排 + 乘法移位)，
+     * 再按索引区间查偏移表加到索引上得到字符
+     */
+
+    CPU_TARGET_SSE42 inline __m128i Base64ShiftTable128(Base64Alphabet alphabet)
+    {
+        char c62 = GetAlphabet(alphabet)[62];
+        char c63 = GetAlphabet(alphabet)[63];
+        return _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+    }
+
+    CPU_TARGET_SSE42 inline __m128i Base64EncodeLanes128(__m128i input, __m128i shiftTable)
+    {
+        input = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003F03F0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t1, t3);
+
+        // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+        return _mm_add_epi8(_mm_shuffle_epi8(shiftTable, reduced), indices);
+    }
+
+    CPU_TARGET_SSE42 int64 Base64EncodeSse(const uint8* src, int64 size, char* dst, Base64Alphabet alphabet)
+    {
+        __m128i shiftTable = Base64ShiftTable128(alphabet);
+        int64 consumed = 0;
+        // 每次读 16 字节、使用其中 12 字节
+        while (size - consumed >= 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + consumed));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), Base64EncodeLanes128(input, shiftTable));
+            consumed += 12;
+            dst += 16;
+        }
+        return consumed;
+    }
+
+    CPU_TARGET_AVX2 int64 Base64EncodeAvx2(const uint8* src, int64 size, char* dst, Base64Alphabet alphabet)
+    {
+        char c62 = GetAlphabet(alphabet)[62];
+        char c63 = GetAlphabet(alphabet)[63];
+        __m256i shiftTable = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, static_cast<char>(c62 - 62), static_cast<char>(c63 - 63), 'A', 0, 0);
+        __m256i shuffle = _mm256_setr_epi8(
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+        int64 consumed = 0;
+        // 两个 128 位通道各处理 12 字节，第二个通道从第 12 字节开始读 16 字节
+        while (size - consumed >= 28)
+        {
+            const uint8* p = src + consumed;
+            __m256i input = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12)), 1);
+            input = _mm256_shuffle_epi8(input, shuffle);
+            __m256i t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0FC0FC00));
+            __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+            __m256i t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003F03F0));
+            __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+            __m256i indices = _mm256_or_si256(t1, t3);
+
+            __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+            reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+            __m256i result = _mm256_add_epi8(_mm256_shuffle_epi8(shiftTable, reduced), indices);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), result);
+            consumed += 24;
+            dst += 32;
+        }
+        return consumed + Base64EncodeSse(src + consumed, size - consumed, dst, alphabet);
+    }
+
+    /*
+     * Base64 解码：按字符区间求出 6 位值并校验，再用乘加指令把 4 个 6 位值拼成 3 字节
+     */
+
+    CPU_TARGET_SSE42 inline bool Base64DecodeLanes128(__m128i input, char c62, char c63, __m128i& result)
+    {
+        __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), input));
+        __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), input));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), input));
+        __m128i is62 = _mm_cmpeq_epi8(input, _mm_set1_epi8(c62));
+        __m128i is63 = _mm_cmpeq_epi8(input, _mm_set1_epi8(c63));
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+        if (_mm_movemask_epi8(valid) != 0xFFFF)
+        {
+            return false;
+        }
+
+        __m128i delta = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+            _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                _mm_or_si128(_mm_and_si128(is62, _mm_set1_epi8(static_cast<char>(62 - c62))), _mm_and_si128(is63, _mm_set1_epi8(static_cast<char>(63 - c63))))));
+        __m128i values = _mm_add_epi8(input, delta);
+
+        __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        result = _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        return true;
+    }
+
+    CPU_TARGET_SSE42 int64 Base64DecodeSse(const char* src, int64 length, uint8* dst, Base64Alphabet alphabet)
+    {
+        char c62 = GetAlphabet(alphabet)[62];
+        char c63 = GetAlphabet(alphabet)[63];
+        int64 consumed = 0;
+        // 每次写 16 字节、其中 12 字节有效，留足余量保证不越过输出缓冲区，也不会碰到末尾的 '='
+        while (length - consumed >= 24)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + consumed));
+            __m128i result;
+            if (!Base64DecodeLanes128(input, c62, c63, result))
+            {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+            consumed += 16;
+            dst += 12;
+        }
+        return consumed;
+    }
+
+    CPU_TARGET_AVX2 int64 Base64DecodeAvx2(const char* src, int64 length, uint8* dst, Base64Alphabet alphabet)
+    {
+        char c62 = GetAlphabet(alphabet)[62];
+        char c63 = GetAlphabet(alphabet)[63];
+        int64 consumed = 0;
+        while (length - consumed >= 48)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + consumed));
+            __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('A' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), input));
+            __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), input));
+            __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), input));
+            __m256i is62 = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(c62));
+            __m256i is63 = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(c63));
+            __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(is62, is63)));
+            if (_mm256_movemask_epi8(valid) != -1)
+            {
+                break;
+            }
+
+            __m256i delta = _mm256_or_si256(
+                _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')), _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+                _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                    _mm256_or_si256(_mm256_and_si256(is62, _mm256_set1_epi8(static_cast<char>(62 - c62))), _mm256_and_si256(is63, _mm256_set1_epi8(static_cast<char>(63 - c63))))));
+            __m256i values = _mm256_add_epi8(input, delta);
+
+            __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            __m256i packed = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+            packed = _mm256_shuffle_epi8(packed, _mm256_setr_epi8(
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+            // 两个通道各有 12 字节有效，拼接成连续的 24 字节
+            packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), packed);
+            consumed += 32;
+            dst += 24;
+        }
+        return consumed + Base64DecodeSse(src + consumed, length - consumed, dst, alphabet);
+    }
+
+    /*
+     * 十六进制：高低半字节查表后交错；解码时校验区间并用乘加合并相邻两个半字节
+     */
+
+    CPU_TARGET_SSE42 int64 HexEncodeSse(const uint8* src, int64 size, char* dst, bool upper)
+    {
+        __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper ? UPPER_HEX_DIGITS : LOWER_HEX_DIGITS));
+        __m128i mask = _mm_set1_epi8(0x0F);
+        int64 consumed = 0;
+        while (size - consumed >= 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + consumed));
+            __m128i high = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(input, 4), mask));
+            __m128i low = _mm_shuffle_epi8(table, _mm_and_si128(input, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi8(high, low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(high, low));
+            consumed += 16;
+            dst += 32;
+        }
+        return consumed;
+    }
+
+    CPU_TARGET_AVX2 int64 HexEncodeAvx2(const uint8* src, int64 size, char* dst, bool upper)
+    {
+        __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(upper ? UPPER_HEX_DIGITS : LOWER_HEX_DIGITS)));
+        __m256i mask = _mm256_set1_epi8(0x0F);
+        int64 consumed = 0;
+        while (size - consumed >= 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + consumed));
+            __m256i high = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(input, 4), mask));
+            __m256i low = _mm256_shuffle_epi8(table, _mm256_and_si256(input, mask));
+            __m256i first = _mm256_unpacklo_epi8(high, low);
+            __m256i second = _mm256_unpackhi_epi8(high, low);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(first, second, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(first, second, 0x31));
+            consumed += 32;
+            dst += 64;
+        }
+        return consumed + HexEncodeSse(src + consumed, size - consumed, dst, upper);
+    }
+
+    CPU_TARGET_SSE42 inline bool HexNibbles128(__m128i input, __m128i& values)
+    {
+        __m128i folded = _mm_or_si128(input, _mm_set1_epi8(0x20));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(input, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), input));
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('f' + 1), folded));
+        if (_mm_movemask_epi8(_mm_or_si128(digit, alpha)) != 0xFFFF)
+        {
+            return false;
+        }
+        values = _mm_or_si128(
+            _mm_and_si128(digit, _mm_sub_epi8(input, _mm_set1_epi8('0'))),
+            _mm_and_si128(alpha, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+        return true;
+    }
+
+    CPU_TARGET_SSE42 int64 HexDecodeSse(const char* src, int64 length, uint8* dst)
+    {
+        __m128i weights = _mm_set1_epi16(0x0110);
+        int64 consumed = 0;
+        while (length - consumed >= 32)
+        {
+            __m128i first, second;
+            if (!HexNibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + consumed)), first) ||
+                !HexNibbles128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + consumed + 16)), second))
+            {
+                break;
+            }
+            __m128i result = _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(second, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+            consumed += 32;
+            dst += 16;
+        }
+        return consumed;
+    }
+
+    CPU_TARGET_AVX2 inline bool HexNibbles256(__m256i input, __m256i& values)
+    {
+        __m256i folded = _mm256_or_si256(input, _mm256_set1_epi8(0x20));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), input));
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), folded));
+        if (_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != -1)
+        {
+            return false;
+        }
+        values = _mm256_or_si256(
+            _mm256_and_si256(digit, _mm256_sub_epi8(input, _mm256_set1_epi8('0'))),
+            _mm256_and_si256(alpha, _mm256_sub_epi8(folded, _mm256_set1_epi8('a' - 10))));
+        return true;
+    }
+
+    CPU_TARGET_AVX2 int64 HexDecodeAvx2(const char* src, int64 length, uint8* dst)
+    {
+        __m256i weights = _mm256_set1_epi16(0x0110);
+        int64 consumed = 0;
+        while (length - consumed >= 64)
+        {
+            __m256i first, second;
+            if (!HexNibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + consumed)), first) ||
+                !HexNibbles256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + consumed + 32)), second))
+            {
+                break;
+            }
+            __m256i result = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights), _mm256_maddubs_epi16(second, weights));
+            // packus 按通道交错，恢复字节顺序
+            result = _mm256_permute4x64_epi64(result, 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), result);
+            consumed += 64;
+            dst += 32;
+        }
+        return consumed + HexDecodeSse(src + consumed, length - consumed, dst);
+    }
+#endif
+
+    template<class Kernel>
+    Kernel SelectKernel(Kernel sse, Kernel avx2)
+    {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.AVX2)
+        {
+            return avx2;
+        }
+        if (features.SSE42)
+        {
+            return sse;
+        }
+        return nullptr;
+    }
+
+    Base64EncodeKernel GetBase64EncodeKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const Base64EncodeKernel kernel = SelectKernel<Base64EncodeKernel>(&Base64EncodeSse, &Base64EncodeAvx2);
+        return kernel;
+#else
+        return nullptr;
+#endif
+    }
+
+    Base64DecodeKernel GetBase64DecodeKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const Base64DecodeKernel kernel = SelectKernel<Base64DecodeKernel>(&Base64DecodeSse, &Base64DecodeAvx2);
+        return kernel;
+#else
+        return nullptr;
+#endif
+    }
+
+    HexEncodeKernel GetHexEncodeKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const HexEncodeKernel kernel = SelectKernel<HexEncodeKernel>(&HexEncodeSse, &HexEncodeAvx2);
+        return kernel;
+#else
+        return nullptr;
+#endif
+    }
+
+    HexDecodeKernel GetHexDecodeKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const HexDecodeKernel kernel = SelectKernel<HexDecodeKernel>(&HexDecodeSse, &HexDecodeAvx2);
+        return kernel;
+#else
+        return nullptr;
+#endif
+    }
+}
+
+/* Base64 */
+int64 Base64::EncodedSize(int64 size, bool padding)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+    if (padding)
+    {
+        return (size + 2) / 3 * 4;
+    }
+    return size / 3 * 4 + (size % 3 == 0 ? 0 : size % 3 + 1);
+}
+
+int64 Base64::DecodedSize(const char* text, int64 length)
+{
+    if (length <= 0)
+    {
+        return 0;
+    }
+    // 只有长度为 4 的倍数时末尾才允许 '='
+    if (length % 4 == 0 && text[length - 1] == '=')
+    {
+        --length;
+        if (text[length - 1] == '=')
+        {
+            --length;
+        }
+    }
+    switch (length % 4)
+    {
+    case 1:
+        return -1;
+    case 2:
+        return length / 4 * 3 + 1;
+    case 3:
+        return length / 4 * 3 + 2;
+    default:
+        return length / 4 * 3;
+    }
+}
+
+int64 Base64::Encode(const byte* data, int64 size, char* output, Base64Alphabet alphabet, bool padding)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+
+    const uint8* src = reinterpret_cast<const uint8*>(data);
+    char* dst = output;
+
+    int64 consumed = 0;
+    if (Base64EncodeKernel kernel = GetBase64EncodeKernel())
+    {
+        consumed = kernel(src, size, dst, alphabet);
+        dst += consumed / 3 * 4;
+    }
+
+    const char* table = GetAlphabet(alphabet);
+    int64 i = consumed;
+    for (; i + 3 <= size; i += 3)
+    {
+        uint32 value = (static_cast<uint32>(src[i]) << 16) | (static_cast<uint32>(src[i + 1]) << 8) | src[i + 2];
+        dst[0] = table[(value >> 18) & 0x3F];
+        dst[1] = table[(value >> 12) & 0x3F];
+        dst[2] = table[(value >> 6) & 0x3F];
+        dst[3] = table[value & 0x3F];
+        dst += 4;
+    }
+
+    int64 remain = size - i;
+    if (remain > 0)
+    {
+        uint32 value = static_cast<uint32>(src[i]) << 16;
+        if (remain == 2)
+        {
+            value |= static_cast<uint32>(src[i + 1]) << 8;
+        }
+        *dst++ = table[(value >> 18) & 0x3F];
+        *dst++ = table[(value >> 12) & 0x3F];
+        if (remain == 2)
+        {
+            *dst++ = table[(value >> 6) & 0x3F];
+        }
+        if (padding)
+        {
+            *dst++ = '=';
+            if (remain == 1)
+            {
+                *dst++ = '=';
+            }
+        }
+    }
+    return dst - output;
+}
+
+String Base64::Encode(const byte* data, int64 size, Base64Alphabet alphabet, bool padding)
+{
+    String result;
+    int64 length = EncodedSize(size, padding);
+    Encode(data, size, result._Allocate(length), alphabet, padding);
+    // 编码结果都是 ASCII
+    result._SetCount(length, true);
+    return result;
+}
+
+String Base64::Encode(const ByteArray& data, Base64Alphabet alphabet, bool padding)
+{
+    return Encode(data.Data(), data.Size(), alphabet, padding);
+}
+
+String Base64::Encode(const ByteView& data, Base64Alphabet alphabet, bool padding)
+{
+    return Encode(data.Data(), data.Size(), alphabet, padding);
+}
+
+void Base64::EncodeAppend(const byte* data, int64 size, ByteArray& output, Base64Alphabet alphabet, bool padding)
+{
+    int64 start = output.Size();
+    output.Resize(start + EncodedSize(size, padding));
+    Encode(data, size, reinterpret_cast<char*>(output.Data() + start), alphabet, padding);
+}
+
+int64 Base64::Decode(const char* text, int64 length, byte* output, Base64Alphabet alphabet)
+{
+    int64 decodedSize = DecodedSize(text, length);
+    if (decodedSize < 0)
+    {
+        return -1;
+    }
+    // 去掉末尾的 '='
+    length = decodedSize / 3 * 4 + (decodedSize % 3 == 0 ? 0 : decodedSize % 3 + 1);
+
+    uint8* dst = reinterpret_cast<uint8*>(output);
+    int64 consumed = 0;
+    if (Base64DecodeKernel kernel = GetBase64DecodeKernel())
+    {
+        consumed = kernel(text, length, dst, alphabet);
+        dst += consumed / 4 * 3;
+    }
+
+    const DecodeTable& table = GetDecodeTable(alphabet);
+    const uint8* src = reinterpret_cast<const uint8*>(text);
+    int64 i = consumed;
+    for (; i + 4 <= length; i += 4)
+    {
+        int32 a = table[src[i]];
+        int32 b = table[src[i + 1]];
+        int32 c = table[src[i + 2]];
+        int32 d = table[src[i + 3]];
+        if ((a | b | c | d) < 0)
+        {
+            return -1;
+        }
+        uint32 value = (static_cast<uint32>(a) << 18) | (static_cast<uint32>(b) << 12) | (static_cast<uint32>(c) << 6) | static_cast<uint32>(d);
+        dst[0] = static_cast<uint8>(value >> 16);
+        dst[1] = static_cast<uint8>(value >> 8);
+        dst[2] = static_cast<uint8>(value);
+        dst += 3;
+    }
+
+    int64 remain = length - i;
+    if (remain >= 2)
+    {
+        int32 a = table[src[i]];
+        int32 b = table[src[i + 1]];
+        int32 c = remain == 3 ? table[src[i + 2]] : 0;
+        if ((a | b | c) < 0)
+        {
+            return -1;
+        }
+        uint32 value = (static_cast<uint32>(a) << 18) | (static_cast<uint32>(b) << 12) | (static_cast<uint32>(c) << 6);
+        *dst++ = static_cast<uint8>(value >> 16);
+        if (remain == 3)
+        {
+            *dst++ = static_cast<uint8>(value >> 8);
+        }
+    }
+    return decodedSize;
+}
+
+bool Base64::TryDecode(const String& text, ByteArray& output, Base64Alphabet alphabet)
+{
+    const char* data = text.Data();
+    int64 length = text.Size();
+    int64 size = DecodedSize(data, length);
+    if (size < 0)
+    {
+        output.Clear();
+        return false;
+    }
+    output.Resize(size);
+    if (Decode(data, length, output.Data(), alphabet) < 0)
+    {
+        output.Clear();
+        return false;
+    }
+    return true;
+}
+
+ByteArray Base64::Decode(const String& text, Base64Alphabet alphabet)
+{
+    ByteArray output;
+    if (!TryDecode(text, output, alphabet)) [[unlikely]]
+    {
+        throw std::invalid_argument("Invalid Base64 string");
+    }
+    return output;
+}
+
+/* Hex */
+int64 Hex::Encode(const byte* data, int64 size, char* output, bool upper)
+{
+    if (size <= 0)
+    {
+        return 0;
+    }
+
+    const uint8* src = reinterpret_cast<const uint8*>(data);
+    int64 consumed = 0;
+    if (HexEncodeKernel kernel = GetHexEncodeKernel())
+    {
+        consumed = kernel(src, size, output, upper);
+    }
+
+    const char* digits = upper ? UPPER_HEX_DIGITS : LOWER_HEX_DIGITS;
+    for (int64 i = consumed; i < size; ++i)
+    {
+        output[i * 2] = digits[src[i] >> 4];
+        output[i * 2 + 1] = digits[src[i] & 0x0F];
+    }
+    return size * 2;
+}
+
+String Hex::Encode(const byte* data, int64 size, bool upper)
+{
+    String result;
+    int64 length = EncodedSize(std::max<int64>(size, 0));
+    Encode(data, size, result._Allocate(length), upper);
+    result._SetCount(length, true);
+    return result;
+}
+
+String Hex::Encode(const ByteArray& data, bool upper)
+{
+    return Encode(data.Data(), data.Size(), upper);
+}
+
+String Hex::Encode(const ByteView& data, bool upper)
+{
+    return Encode(data.Data(), data.Size(), upper);
+}
+
+void Hex::EncodeAppend(const byte* data, int64 size, ByteArray& output, bool upper)
+{
+    int64 start = output.Size();
+    output.Resize(start + EncodedSize(std::max<int64>(size, 0)));
+    Encode(data, size, reinterpret_cast<char*>(output.Data() + start), upper);
+}
+
+int64 Hex::Decode(const char* text, int64 length, byte* output)
+{
+    int64 size = DecodedSize(length);
+    if (size <= 0)
+    {
+        return size;
+    }
+
+    uint8* dst = reinterpret_cast<uint8*>(output);
+    int64 consumed = 0;
+    if (HexDecodeKernel kernel = GetHexDecodeKernel())
+    {
+        consumed = kernel(text, length, dst);
+    }
+
+    const uint8* src = reinterpret_cast<const uint8*>(text);
+    for (int64 i = consumed; i < length; i += 2)
+    {
+        int32 high = HEX_DECODE_TABLE[src[i]];
+        int32 low = HEX_DECODE_TABLE[src[i + 1]];
+        if ((high | low) < 0)
+        {
+            return -1;
+        }
+        dst[i / 2] = static_cast<uint8>((high << 4) | low);
+    }
+    return size;
+}
+
+bool Hex::TryDecode(const String& text, ByteArray& output)
+{
+    int64 length = text.Size();
+    int64 size = DecodedSize(length);
+    if (size < 0)
+    {
+        output.Clear();
+        return false;
+    }
+    output.Resize(size);
+    if (Decode(text.Data(), length, output.Data()) < 0)
+    {
+        output.Clear();
+        return false;
+    }
+    return true;
+}
+
+ByteArray Hex::Decode(const String& text)
+{
+    ByteArray output;
+    if (!TryDecode(text, output)) [[unlikely]]
+    {
+        throw std::invalid_argument("Invalid hex string");
+    }
+    return output;
+}
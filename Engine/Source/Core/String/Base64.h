@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Core.h"
+#include "String/String.h"
+#include "Memory/ByteArray.h"
+#include "Memory/ByteView.h"
+
+/// <summary>
+/// Base64 字母表
+/// </summary>
+enum class Base64Alphabet
+{
+    // 标准字母表(RFC 4648 §4)，62/63 为 '+' '/'
+    Standard,
+    // URL 与文件名安全字母表(RFC 4648 §5)，62/63 为 '-' '_'
+    UrlSafe
+};
+
+/// <summary>
+/// Base64 编解码
+/// <para>支持 AVX2/SSE4.2 时按向量批量处理，否则使用查表的标量实现</para>
+/// <para>输出大小可预先精确计算，编码结果直接写入目标缓冲区，无中间分配</para>
+/// </summary>
+class Base64
+{
+public:
+    /// <summary>
+    /// 计算编码后的字符数
+    /// </summary>
+    /// <param name="size">原始字节数</param>
+    /// <param name="padding">是否以 '=' 补齐到 4 的倍数</param>
+    /// <returns>编码后的字符数</returns>
+    static int64 EncodedSize(int64 size, bool padding = true);
+    /// <summary>
+    /// 计算解码后的字节数
+    /// </summary>
+    /// <param name="text">Base64 文本</param>
+    /// <param name="length">文本字符数</param>
+    /// <returns>解码后的字节数，长度不合法时返回 -1</returns>
+    static int64 DecodedSize(const char* text, int64 length);
+    /// <summary>
+    /// 编码到调用者提供的缓冲区
+    /// </summary>
+    /// <param name="data">原始数据</param>
+    /// <param name="size">原始字节数</param>
+    /// <param name="output">输出缓冲区，至少 EncodedSize(size, padding) 个字符，不写入结尾的 '\0'</param>
+    /// <param name="alphabet">字母表</param>
+    /// <param name="padding">是否以 '=' 补齐</param>
+    /// <returns>写入的字符数</returns>
+    static int64 Encode(const byte* data, int64 size, char* output, Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true);
+    /// <summary>
+    /// 编码为字符串
+    /// </summary>
+    static String Encode(const byte* data, int64 size, Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true);
+    /// <summary>
+    /// 编码为字符串
+    /// </summary>
+    static String Encode(const ByteArray& data, Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true);
+    /// <summary>
+    /// 编码为字符串
+    /// </summary>
+    static String Encode(const ByteView& data, Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true);
+    /// <summary>
+    /// 编码并追加到字节数组末尾
+    /// </summary>
+    /// <param name="data">原始数据</param>
+    /// <param name="size">原始字节数</param>
+    /// <param name="output">目标字节数组</param>
+    /// <param name="alphabet">字母表</param>
+    /// <param name="padding">是否以 '=' 补齐</param>
+    static void EncodeAppend(const byte* data, int64 size, ByteArray& output, Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true);
+    /// <summary>
+    /// 解码到调用者提供的缓冲区
+    /// <para>末尾的 '=' 可有可无，不接受空白或其他字符</para>
+    /// </summary>
+    /// <param name="text">Base64 文本</param>
+    /// <param name="length">文本字符数</param>
+    /// <param name="output">输出缓冲区，至少 DecodedSize(text, length) 个字节</param>
+    /// <param name="alphabet">字母表</param>
+    /// <returns>写入的字节数，输入不合法时返回 -1</returns>
+    static int64 Decode(const char* text, int64 length, byte* output, Base64Alphabet alphabet = Base64Alphabet::Standard);
+    /// <summary>
+    /// 解码字符串
+    /// </summary>
+    /// <param name="text">Base64 文本</param>
+    /// <param name="output">解码结果</param>
+    /// <param name="alphabet">字母表</param>
+    /// <returns>输入不合法时返回 false</returns>
+    static bool TryDecode(const String& text, ByteArray& output, Base64Alphabet alphabet = Base64Alphabet::Standard);
+    /// <summary>
+    /// 解码字符串
+    /// </summary>
+    /// <param name="text">Base64 文本</param>
+    /// <param name="alphabet">字母表</param>
+    /// <returns>解码结果</returns>
+    /// <exception cref="std::invalid_argument">输入不合法时抛出</exception>
+    static ByteArray Decode(const String& text, Base64Alphabet alphabet = Base64Alphabet::Standard);
+};
+
+/// <summary>
+/// 十六进制编解码
+/// <para>支持 AVX2/SSE4.2 时按向量批量处理，否则使用查表的标量实现</para>
+/// </summary>
+class Hex
+{
+public:
+    /// <summary>
+    /// 计算编码后的字符数
+    /// </summary>
+    static constexpr int64 EncodedSize(int64 size)
+    {
+        return size * 2;
+    }
+    /// <summary>
+    /// 计算解码后的字节数
+    /// </summary>
+    /// <returns>字符数为奇数时返回 -1</returns>
+    static constexpr int64 DecodedSize(int64 length)
+    {
+        return (length % 2 == 0) ? length / 2 : -1;
+    }
+    /// <summary>
+    /// 编码到调用者提供的缓冲区
+    /// </summary>
+    /// <param name="data">原始数据</param>
+    /// <param name="size">原始字节数</param>
+    /// <param name="output">输出缓冲区，至少 EncodedSize(size) 个字符</param>
+    /// <param name="upper">是否使用大写字母</param>
+    /// <returns>写入的字符数</returns>
+    static int64 Encode(const byte* data, int64 size, char* output, bool upper = false);
+    /// <summary>
+    /// 编码为字符串
+    /// </summary>
+    static String Encode(const byte* data, int64 size, bool upper = false);
+    /// <summary>
+    /// 编码为字符串
+    /// </summary>
+    static String Encode(const ByteArray& data, bool upper = false);
+    /// <summary>
+    /// 编码为字符串
+    /// </summary>
+    static String Encode(const ByteView& data, bool upper = false);
+    /// <summary>
+    /// 编码并追加到字节数组末尾
+    /// </summary>
+    static void EncodeAppend(const byte* data, int64 size, ByteArray& output, bool upper = false);
+    /// <summary>
+    /// 解码到调用者提供的缓冲区，大小写均可
+    /// </summary>
+    /// <param name="text">十六进制文本</param>
+    /// <param name="length">文本字符数</param>
+    /// <param name="output">输出缓冲区，至少 DecodedSize(length) 个字节</param>
+    /// <returns>写入的字节数，输入不合法时返回 -1</returns>
+    static int64 Decode(const char* text, int64 length, byte* output);
+    /// <summary>
+    /// 解码字符串
+    /// </summary>
+    /// <returns>输入不合法时返回 false</returns>
+    static bool TryDecode(const String& text, ByteArray& output);
+    /// <summary>
+    /// 解码字符串
+    /// </summary>
+    /// <exception cref="std::invalid_argument">输入不合法时抛出</exception>
+    static ByteArray Decode(const String& text);
+};
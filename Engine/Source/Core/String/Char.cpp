@@ -1,667 +1,640 @@
 #include "pch.h"
 #include "Char.h"
+#include "Utf8.h"
+#include "CpuFeatures.h"
+#include "Container/Array.h"
 #include <cctype>
 #include <algorithm>
 
-/* public */
+#if defined(CPU_ARCH_X64)
+    #include <immintrin.h>
+#elif defined(CPU_ARCH_ARM64)
+    #include <arm_neon.h>
+#endif
 
-Char::Char(const Char& other)
-    : m_data(other.m_data)
+namespace
 {
-}
+    /*
+     * 字符属性与大小写映射使用两级查找表：一级表以码点的高位(cp >> 6)索引二级块，二级块以低 6 位索引 CharInfo。
+     * 整块属性相同的二级块按内容合并(如全部 CJK 表意字符的块共用一个)，只有包含范围边界的块单独存储。
+     * 两级表在首次使用时由下面的范围表生成，每次查询只需两次访存
+     */
+
+    // 数字
+    constexpr uint16 PROPERTY_NUMBER = 1 << 0;
+    // 字母
+    constexpr uint16 PROPERTY_LETTER = 1 << 1;
+    // 标点符号
+    constexpr uint16 PROPERTY_PUNCTUATION = 1 << 2;
+    // 控制字符
+    constexpr uint16 PROPERTY_CONTROL = 1 << 3;
+    // CJK 字符
+    constexpr uint16 PROPERTY_CJK = 1 << 4;
+    // 表情符号
+    constexpr uint16 PROPERTY_EMOJI = 1 << 5;
+    // 空白字符
+    constexpr uint16 PROPERTY_SPACE = 1 << 6;
+    // 小写字母
+    constexpr uint16 PROPERTY_LOWER = 1 << 7;
+    // 大写字母
+    constexpr uint16 PROPERTY_UPPER = 1 << 8;
+    // 转换为小写时加上大小写差值
+    constexpr uint16 PROPERTY_TO_LOWER = 1 << 9;
+    // 转换为大写时加上大小写差值
+    constexpr uint16 PROPERTY_TO_UPPER = 1 << 10;
+    // 大小写折叠时加上大小写差值
+    constexpr uint16 PROPERTY_FOLD = 1 << 11;
+
+    // 转换为小写的码点同时参与大小写折叠
+    constexpr uint16 CASE_LOWER = PROPERTY_TO_LOWER | PROPERTY_FOLD;
+
+    /// <summary>
+    /// 属性相同的连续码点
+    /// </summary>
+    struct PropertyRange
+    {
+        // 首个码点
+        uint32 First;
+        // 最后一个码点(含)
+        uint32 Last;
+        // 属性位
+        uint16 Properties;
+        // 大小写差值，映射结果为 码点 + 差值
+        int16 CaseDelta;
+    };
+
+    constexpr PropertyRange PROPERTY_RANGES[] = {
+        // ==================== 数字 ====================
+        { 0x0030, 0x0039, PROPERTY_NUMBER, 0 },    // ASCII数字: 0-9
+        { 0x0660, 0x0669, PROPERTY_NUMBER, 0 },    // 阿拉伯-印度数字
+        { 0x06F0, 0x06F9, PROPERTY_NUMBER, 0 },    // 扩展阿拉伯-印度数字
+        { 0x0966, 0x096F, PROPERTY_NUMBER, 0 },    // 天城文数字
+        { 0x09E6, 0x09EF, PROPERTY_NUMBER, 0 },    // 孟加拉文数字
+        { 0x0A66, 0x0A6F, PROPERTY_NUMBER, 0 },    // 古木基文数字
+        { 0x0AE6, 0x0AEF, PROPERTY_NUMBER, 0 },    // 古吉拉特文数字
+        { 0x0B66, 0x0B6F, PROPERTY_NUMBER, 0 },    // 奥里亚文数字
+        { 0x0BE6, 0x0BEF, PROPERTY_NUMBER, 0 },    // 泰米尔文数字
+        { 0x0C66, 0x0C6F, PROPERTY_NUMBER, 0 },    // 泰卢固文数字
+        { 0x0CE6, 0x0CEF, PROPERTY_NUMBER, 0 },    // 卡纳达文数字
+        { 0x0D66, 0x0D6F, PROPERTY_NUMBER, 0 },    // 马拉雅拉姆文数字
+        { 0x0E50, 0x0E59, PROPERTY_NUMBER, 0 },    // 泰文数字
+        { 0x0ED0, 0x0ED9, PROPERTY_NUMBER, 0 },    // 老挝文数字
+        { 0x0F20, 0x0F29, PROPERTY_NUMBER, 0 },    // 藏文数字
+        { 0x1040, 0x1049, PROPERTY_NUMBER, 0 },    // 缅甸文数字
+        { 0x1090, 0x1099, PROPERTY_NUMBER, 0 },    // 缅甸文掸邦数字
+        { 0x17E0, 0x17E9, PROPERTY_NUMBER, 0 },    // 高棉文数字
+        { 0x1810, 0x1819, PROPERTY_NUMBER, 0 },    // 蒙古文数字
+        { 0x1946, 0x194F, PROPERTY_NUMBER, 0 },    // 林布文数字
+        { 0x19D0, 0x19D9, PROPERTY_NUMBER, 0 },    // 新傣文数字
+        { 0x1A80, 0x1A89, PROPERTY_NUMBER, 0 },    // 泰文数字（新）
+        { 0x1A90, 0x1A99, PROPERTY_NUMBER, 0 },    // 老挝文数字（新）
+        { 0x1B50, 0x1B59, PROPERTY_NUMBER, 0 },    // 巴厘文数字
+        { 0x1BB0, 0x1BB9, PROPERTY_NUMBER, 0 },    // 巽他文数字
+        { 0x1C40, 0x1C49, PROPERTY_NUMBER, 0 },    // 雷布查文数字
+        { 0x1C50, 0x1C59, PROPERTY_NUMBER, 0 },    // 奥里亚文数字（补充）
+        { 0xFF10, 0xFF19, PROPERTY_NUMBER, 0 },    // 全角数字
+        { 0x2160, 0x2188, PROPERTY_NUMBER, 0 },    // 罗马数字
+        { 0x2460, 0x2473, PROPERTY_NUMBER, 0 },    // 带圈数字 1-20
+        { 0x24F5, 0x24FE, PROPERTY_NUMBER, 0 },    // 带圈数字 21-30
+        { 0x2474, 0x2487, PROPERTY_NUMBER, 0 },    // 带括号数字
+        { 0x2488, 0x249B, PROPERTY_NUMBER, 0 },    // 带点数字
+
+        // ==================== 字母 ====================
+        { 0x0041, 0x005A, PROPERTY_LETTER, 0 },    // A-Z
+        { 0x0061, 0x007A, PROPERTY_LETTER, 0 },    // a-z
+        { 0x00C0, 0x00D6, PROPERTY_LETTER, 0 },    // Latin-1补充 À-Ö
+        { 0x00D8, 0x00F6, PROPERTY_LETTER, 0 },    // Ø-ö
+        { 0x00F8, 0x00FF, PROPERTY_LETTER, 0 },    // ø-ÿ
+        { 0x0386, 0x0386, PROPERTY_LETTER, 0 },    // 希腊字母(不含 0x0387、0x038B、0x038D)
+        { 0x0388, 0x038A, PROPERTY_LETTER, 0 },
+        { 0x038C, 0x038C, PROPERTY_LETTER, 0 },
+        { 0x038E, 0x03CE, PROPERTY_LETTER, 0 },
+        { 0x0400, 0x0481, PROPERTY_LETTER, 0 },    // 西里尔字母
+        { 0x048A, 0x052F, PROPERTY_LETTER, 0 },
+        { 0x0621, 0x064A, PROPERTY_LETTER, 0 },    // 阿拉伯字母
+        { 0x066E, 0x066F, PROPERTY_LETTER, 0 },
+        { 0x0671, 0x06D3, PROPERTY_LETTER, 0 },
+        { 0x06D5, 0x06D5, PROPERTY_LETTER, 0 },
+        { 0x05D0, 0x05EA, PROPERTY_LETTER, 0 },    // 希伯来字母
+        { 0x05EF, 0x05F2, PROPERTY_LETTER, 0 },
+        { 0xAC00, 0xD7A3, PROPERTY_LETTER, 0 },    // 韩文音节
+        { 0x1100, 0x11FF, PROPERTY_LETTER, 0 },    // 韩文字母
+        { 0x3131, 0x318E, PROPERTY_LETTER, 0 },    // 韩文兼容字母
+        { 0xFFA1, 0xFFDC, PROPERTY_LETTER, 0 },    // 半角韩文字母
+
+        // ==================== CJK(同时视为字母) ====================
+        { 0x4E00, 0x9FFF, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // CJK统一表意字符
+        { 0x3400, 0x4DBF, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // CJK扩展A
+        { 0x20000, 0x2A6DF, PROPERTY_CJK | PROPERTY_LETTER, 0 },    // CJK扩展B
+        { 0x2A700, 0x2B73F, PROPERTY_CJK | PROPERTY_LETTER, 0 },    // CJK扩展C
+        { 0x2B740, 0x2B81F, PROPERTY_CJK | PROPERTY_LETTER, 0 },    // CJK扩展D
+        { 0x2B820, 0x2CEAF, PROPERTY_CJK | PROPERTY_LETTER, 0 },    // CJK扩展E
+        { 0x2CEB0, 0x2EBEF, PROPERTY_CJK | PROPERTY_LETTER, 0 },    // CJK扩展F
+        { 0x30000, 0x3134F, PROPERTY_CJK | PROPERTY_LETTER, 0 },    // CJK扩展G
+        { 0xF900, 0xFAFF, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // CJK兼容表意字符
+        { 0x2F800, 0x2FA1F, PROPERTY_CJK | PROPERTY_LETTER, 0 },
+        { 0x2E80, 0x2EFF, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // CJK部首补充
+        { 0x2F00, 0x2FDF, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // 康熙部首
+        { 0x31C0, 0x31EF, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // CJK笔画
+        { 0x3000, 0x303F, PROPERTY_CJK | PROPERTY_LETTER, 0 },      // CJK符号和标点
+
+        // ==================== 标点 ====================
+        { 0x0021, 0x002F, PROPERTY_PUNCTUATION, 0 },    // ! " # $ % & ' ( ) * + , - . /
+        { 0x003A, 0x0040, PROPERTY_PUNCTUATION, 0 },    // : ; < = > ? @
+        { 0x005B, 0x0060, PROPERTY_PUNCTUATION, 0 },    // [ \ ] ^ _ `
+        { 0x007B, 0x007E, PROPERTY_PUNCTUATION, 0 },    // { | } ~
+        { 0x3000, 0x303F, PROPERTY_PUNCTUATION, 0 },    // CJK符号和标点
+        { 0xFF00, 0xFF0F, PROPERTY_PUNCTUATION, 0 },    // 全角ASCII变体
+        { 0xFF1A, 0xFF1F, PROPERTY_PUNCTUATION, 0 },
+        { 0xFF3B, 0xFF40, PROPERTY_PUNCTUATION, 0 },
+        { 0xFF5B, 0xFF65, PROPERTY_PUNCTUATION, 0 },
+        { 0x2000, 0x206F, PROPERTY_PUNCTUATION, 0 },    // 通用标点
+        { 0x2E00, 0x2E7F, PROPERTY_PUNCTUATION, 0 },    // 补充标点
+
+        // ==================== 控制字符 ====================
+        { 0x0000, 0x001F, PROPERTY_CONTROL, 0 },    // ASCII控制字符
+        { 0x007F, 0x007F, PROPERTY_CONTROL, 0 },
+        { 0x0080, 0x009F, PROPERTY_CONTROL, 0 },    // C1控制字符
+
+        // ==================== 表情符号 ====================
+        { 0x1F600, 0x1F64F, PROPERTY_EMOJI, 0 },    // 表情符号
+        { 0x1F300, 0x1F5FF, PROPERTY_EMOJI, 0 },    // 杂项符号和象形文字
+        { 0x1F680, 0x1F6FF, PROPERTY_EMOJI, 0 },    // 交通和地图符号
+        { 0x1F900, 0x1F9FF, PROPERTY_EMOJI, 0 },    // 补充符号和象形文字
+        { 0x2600, 0x26FF, PROPERTY_EMOJI, 0 },      // 杂项符号
+        { 0x2700, 0x27BF, PROPERTY_EMOJI, 0 },      // 装饰符号
+        { 0xFE0F, 0xFE0F, PROPERTY_EMOJI, 0 },      // 变体选择器
+        { 0x200D, 0x200D, PROPERTY_EMOJI, 0 },      // 零宽连接符
+        { 0x1F1E6, 0x1F1FF, PROPERTY_EMOJI, 0 },    // 区域指示符（国旗）
+        { 0x203C, 0x203C, PROPERTY_EMOJI, 0 },      // !!
+        { 0x2049, 0x2049, PROPERTY_EMOJI, 0 },      // !?
+        { 0x2122, 0x2122, PROPERTY_EMOJI, 0 },      // TM
+        { 0x2139, 0x2139, PROPERTY_EMOJI, 0 },      // ℹ
+        { 0x2194, 0x2195, PROPERTY_EMOJI, 0 },      // 箭头
+        { 0x21A9, 0x21AA, PROPERTY_EMOJI, 0 },      // 返回箭头
+        { 0x231A, 0x231B, PROPERTY_EMOJI, 0 },      // 手表、闹钟
+        { 0x2328, 0x2328, PROPERTY_EMOJI, 0 },      // 键盘
+        { 0x23CF, 0x23CF, PROPERTY_EMOJI, 0 },      // 喷气机
+        { 0x23E9, 0x23ED, PROPERTY_EMOJI, 0 },      // 快进、快退、快上、快下、下一曲
+        { 0x23EF, 0x23F0, PROPERTY_EMOJI, 0 },      // 播放/暂停、闹钟
+        { 0x23F3, 0x23F3, PROPERTY_EMOJI, 0 },      // 计时器
+        { 0x24C2, 0x24C2, PROPERTY_EMOJI, 0 },      // Ⓜ
+        { 0x25AA, 0x25AB, PROPERTY_EMOJI, 0 },      // ◻
+        { 0x25B6, 0x25B6, PROPERTY_EMOJI, 0 },      // ▶
+        { 0x25C0, 0x25C0, PROPERTY_EMOJI, 0 },      // ◀
+        { 0x25FB, 0x25FE, PROPERTY_EMOJI, 0 },      // ◻、◽、◾
+
+        // ==================== 空白字符 ====================
+        { 0x0009, 0x000D, PROPERTY_SPACE, 0 },    // 水平制表符、换行、垂直制表符、换页、回车
+        { 0x0020, 0x0020, PROPERTY_SPACE, 0 },    // 空格
+        { 0x00A0, 0x00A0, PROPERTY_SPACE, 0 },    // 不换行空格
+        { 0x1680, 0x1680, PROPERTY_SPACE, 0 },    // 欧甘空格
+        { 0x2000, 0x200A, PROPERTY_SPACE, 0 },    // 全身空格 ~ 发丝空格
+        { 0x2028, 0x2029, PROPERTY_SPACE, 0 },    // 行分隔符、段分隔符
+        { 0x202F, 0x202F, PROPERTY_SPACE, 0 },    // 窄不换行空格
+        { 0x205F, 0x205F, PROPERTY_SPACE, 0 },    // 中数学空格
+        { 0x3000, 0x3000, PROPERTY_SPACE, 0 },    // 表意空格
+
+        // ==================== 小写字母(转换为大写) ====================
+        { 0x0061, 0x007A, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x20 },    // ASCII小写字母
+        { 0x00E0, 0x00F6, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x20 },    // Latin-1补充小写字母
+        { 0x00F8, 0x00FE, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x20 },
+        { 0x00FF, 0x00FF, PROPERTY_LOWER, 0 },                            // ÿ 的大写不在 Latin-1 中
+        { 0x03B1, 0x03C1, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x20 },    // 希腊小写
+        { 0x03C2, 0x03C2, PROPERTY_FOLD, 0x01 },                          // 词尾 ς 折叠为 σ
+        { 0x03C3, 0x03CB, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x20 },
+        { 0x0430, 0x044F, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x20 },    // 西里尔小写
+        { 0x0451, 0x045F, PROPERTY_LOWER | PROPERTY_TO_UPPER, -0x50 },
+
+        // ==================== 大写字母(转换为小写) ====================
+        { 0x0041, 0x005A, PROPERTY_UPPER | CASE_LOWER, 0x20 },    // ASCII大写字母
+        { 0x00C0, 0x00D6, PROPERTY_UPPER | CASE_LOWER, 0x20 },    // Latin-1补充大写字母
+        { 0x00D8, 0x00DE, PROPERTY_UPPER | CASE_LOWER, 0x20 },
+        { 0x00DF, 0x00DF, PROPERTY_UPPER, 0 },                    // ß 没有单字符的大小写映射
+        { 0x0391, 0x03A1, PROPERTY_UPPER | CASE_LOWER, 0x20 },    // 希腊大写
+        { 0x03A3, 0x03AB, PROPERTY_UPPER | CASE_LOWER, 0x20 },
+        { 0x0410, 0x042F, PROPERTY_UPPER | CASE_LOWER, 0x20 },    // 西里尔大写
+        { 0x0401, 0x040F, PROPERTY_UPPER | CASE_LOWER, 0x50 },    // Ё 等转换为 ё 等
+    };
+
+    /// <summary>
+    /// 查找表的项
+    /// </summary>
+    struct CharInfo
+    {
+        // 属性位
+        uint16 Properties;
+        // 大小写差值
+        int16 CaseDelta;
+
+        constexpr bool operator==(const CharInfo& other) const = default;
+    };
+
+    // 二级块以码点的低 6 位索引(64 项，比 256 项的块更易合并，整张表约 25 KB)
+    constexpr int32 BLOCK_SHIFT = 6;
+    constexpr uint32 BLOCK_SIZE = 1u << BLOCK_SHIFT;
+    constexpr uint32 BLOCK_MASK = BLOCK_SIZE - 1;
+
+    /// <summary>
+    /// 查找表覆盖的码点上限(不含)，之后的码点没有任何属性
+    /// </summary>
+    constexpr uint32 TableLimit()
+    {
+        uint32 limit = 0;
+        for (const PropertyRange& range : PROPERTY_RANGES)
+        {
+            limit = std::max(limit, range.Last + 1);
+        }
+        return (limit + BLOCK_MASK) & ~BLOCK_MASK;
+    }
 
-Char& Char::operator=(const Char& other)
-{
-    if (this != &other)
+    constexpr uint32 TABLE_LIMIT = TableLimit();
+    constexpr uint32 INDEX_SIZE = TABLE_LIMIT >> BLOCK_SHIFT;
+
+    /// <summary>
+    /// 两级查找表，首次使用时由范围表生成(在编译期生成所需的求值步数超出编译器的默认限制)
+    /// </summary>
+    struct CharTable
     {
-        m_data = other.m_data;
-    }
-    return *this;
-}
+        // 一级表：码点高位 -> 二级块编号
+        uint16 Index[INDEX_SIZE];
+        // 二级表：第 n 块为 [n * BLOCK_SIZE, (n + 1) * BLOCK_SIZE)，码点低位 -> 属性与大小写差值
+        Array<CharInfo> Blocks;
 
-Char::Char(Char&& other) noexcept
-    : m_data(std::move(other.m_data))
-{
-}
+        CharTable()
+        {
+            // 块内是否有范围边界(需单独存储)
+            Array<bool> split(INDEX_SIZE, false);
+            // 完整覆盖该块的范围合并后的内容
+            Array<CharInfo> uniform(INDEX_SIZE, CharInfo{});
+            for (const PropertyRange& range : PROPERTY_RANGES)
+            {
+                if ((range.First & BLOCK_MASK) != 0)
+                {
+                    split[range.First >> BLOCK_SHIFT] = true;
+                }
+                if (((range.Last + 1) & BLOCK_MASK) != 0)
+                {
+                    split[range.Last >> BLOCK_SHIFT] = true;
+                }
+
+                // 只累计完整覆盖的块，首尾不完整的部分在生成二级块后逐码点写入
+                uint32 firstBlock = (range.First + BLOCK_MASK) >> BLOCK_SHIFT;
+                uint32 endBlock = (range.Last + 1) >> BLOCK_SHIFT;
+                for (uint32 block = firstBlock; block < endBlock; block++)
+                {
+                    uniform[block].Properties |= range.Properties;
+                    if (range.CaseDelta != 0)
+                    {
+                        uniform[block].CaseDelta = range.CaseDelta;
+                    }
+                }
+            }
+
+            // 包含边界的块各占一个二级块，其余块按内容合并(不同的内容只有少数几种)
+            Array<CharInfo> uniformValues;
+            Array<uint16> uniformIndices;
+            uint16 blockCount = 0;
+            for (uint32 block = 0; block < INDEX_SIZE; block++)
+            {
+                if (!split[block])
+                {
+                    int64 value = 0;
+                    while (value < uniformValues.Size() && !(uniformValues[value] == uniform[block]))
+                    {
+                        value++;
+                    }
+                    if (value < uniformValues.Size())
+                    {
+                        Index[block] = uniformIndices[value];
+                        continue;
+                    }
+                    uniformValues.Push(uniform[block]);
+                    uniformIndices.Push(blockCount);
+                }
+                Index[block] = blockCount++;
+            }
+
+            Blocks.Resize(static_cast<int64>(blockCount) * BLOCK_SIZE);
+            for (uint32 block = 0; block < INDEX_SIZE; block++)
+            {
+                std::fill_n(&Blocks[static_cast<int64>(Index[block]) * BLOCK_SIZE], BLOCK_SIZE, uniform[block]);
+            }
+
+            // 写入范围首尾不完整的块，这些块都包含边界，不与其他块共用
+            for (const PropertyRange& range : PROPERTY_RANGES)
+            {
+                uint32 headEnd = std::min(range.Last, range.First | BLOCK_MASK);
+                uint32 tailBegin = std::max(headEnd + 1, (range.Last + 1) & ~BLOCK_MASK);
+                for (uint32 code = range.First; code <= range.Last; code = (code == headEnd ? tailBegin : code + 1))
+                {
+                    if (!split[code >> BLOCK_SHIFT])
+                    {
+                        continue;
+                    }
+                    CharInfo& info = Blocks[static_cast<int64>(Index[code >> BLOCK_SHIFT]) * BLOCK_SIZE + (code & BLOCK_MASK)];
+                    info.Properties |= range.Properties;
+                    if (range.CaseDelta != 0)
+                    {
+                        info.CaseDelta = range.CaseDelta;
+                    }
+                }
+            }
+        }
+    };
 
-Char& Char::operator=(Char&& other) noexcept
-{
-    if (this != &other)
+    const CharTable& GetCharTable()
     {
-        m_data = std::move(other.m_data);
+        static const CharTable table;
+        return table;
     }
-    return *this;
-}
 
-Char::Char(char ch)
-{
-    // ASCII字符直接存储
-    if (static_cast<unsigned char>(ch) <= 0x7F)
+    constexpr int32 EncodedLength(uint32 code)
     {
-        m_data = std::string(1, ch);
+        return code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
     }
-    else
+
+    /// <summary>
+    /// 检查大小写映射不改变 UTF-8 编码长度，字符串的大小写转换据此原地等长写入
+    /// </summary>
+    constexpr bool CaseMappingPreservesLength()
     {
-        // 非ASCII char被视为扩展ASCII，转换为UTF-8
-        m_data = _EncodeUTF8(static_cast<uint32>(static_cast<unsigned char>(ch)));
+        for (const PropertyRange& range : PROPERTY_RANGES)
+        {
+            int32 length = EncodedLength(range.First);
+            if (range.CaseDelta != 0 &&
+                (EncodedLength(range.Last) != length ||
+                 EncodedLength(range.First + range.CaseDelta) != length ||
+                 EncodedLength(range.Last + range.CaseDelta) != length))
+            {
+                return false;
+            }
+        }
+        return true;
     }
-}
 
-Char::Char(const std::string& utf8Char)
-{
-    if (_IsValidUTF8(utf8Char))
+    static_assert(CaseMappingPreservesLength(), "Case mapping must not change the UTF-8 length");
+
+    inline CharInfo LookupChar(uint32 code)
     {
-        m_data = utf8Char;
+        if (code >= TABLE_LIMIT)
+        {
+            return CharInfo{};
+        }
+        const CharTable& table = GetCharTable();
+        return table.Blocks[static_cast<int64>(table.Index[code >> BLOCK_SHIFT]) * BLOCK_SIZE + (code & BLOCK_MASK)];
     }
-    else
+
+    inline bool HasProperty(uint32 code, uint16 property)
     {
-        // 无效UTF-8，构造为空字符
-        m_data.clear();
+        return (LookupChar(code).Properties & property) != 0;
     }
-}
 
-Char::Char(uint32 unicode)
-{
-    if (_IsValidCodepoint(unicode))
+    /// <summary>
+    /// 按映射方式转换码点，不需要转换时原样返回
+    /// </summary>
+    inline uint32 MapCase(uint32 code, uint16 mapping)
     {
-        m_data = _EncodeUTF8(unicode);
+        CharInfo info = LookupChar(code);
+        if ((info.Properties & mapping) != 0)
+        {
+            return static_cast<uint32>(static_cast<int32>(code) + info.CaseDelta);
+        }
+        return code;
     }
-    else
+
+    /*
+     * ASCII 字母的大小写转换：字节加上 0x80 - first 后，[first, first + 25] 恰好落在有符号的 [-128, -103]，
+     * 一次有符号比较即可得到需要翻转 0x20 位的字节；不小于 0x80 的字节不会落入该区间，原样保留。
+     * 内核遇到含非 ASCII 字节的向量块时停止，返回已处理的字节数，由标量代码逐字符查表处理
+     */
+
+    using CaseKernel = int64(*)(const uint8*, int64, uint8*, uint8);
+
+#if defined(CPU_ARCH_X64)
+    CPU_TARGET_SSE42 int64 MapASCIICaseSse(const uint8* src, int64 size, uint8* dst, uint8 first)
     {
-        // 无效码点，构造为空字符
-        m_data.clear();
+        const __m128i offset = _mm_set1_epi8(static_cast<char>(0x80 - first));
+        const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26));
+        const __m128i flip = _mm_set1_epi8(0x20);
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + pos));
+            if (_mm_movemask_epi8(input) != 0)
+            {
+                break;
+            }
+            __m128i letters = _mm_cmplt_epi8(_mm_add_epi8(input, offset), limit);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + pos), _mm_xor_si128(input, _mm_and_si128(letters, flip)));
+        }
+        return pos;
     }
-}
-
 
-uint32 Char::Unicode() const
-{
-    return _DecodeUTF8(m_data);
-}
+    CPU_TARGET_AVX2 int64 MapASCIICaseAvx2(const uint8* src, int64 size, uint8* dst, uint8 first)
+    {
+        const __m256i offset = _mm256_set1_epi8(static_cast<char>(0x80 - first));
+        const __m256i limit = _mm256_set1_epi8(static_cast<char>(-128 + 26));
+        const __m256i flip = _mm256_set1_epi8(0x20);
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + pos));
+            if (_mm256_movemask_epi8(input) != 0)
+            {
+                break;
+            }
+            __m256i letters = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(input, offset));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + pos), _mm256_xor_si256(input, _mm256_and_si256(letters, flip)));
+        }
+        return pos;
+    }
 
-int32 Char::Size() const
-{
-    return static_cast<int32>(m_data.size());
-}
+    template<class Kernel>
+    Kernel SelectKernel(Kernel sse, Kernel avx2)
+    {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.AVX2)
+        {
+            return avx2;
+        }
+        if (features.SSE42)
+        {
+            return sse;
+        }
+        return nullptr;
+    }
+#elif defined(CPU_ARCH_ARM64)
+    int64 MapASCIICaseNeon(const uint8* src, int64 size, uint8* dst, uint8 first)
+    {
+        const uint8x16_t base = vdupq_n_u8(first);
+        const uint8x16_t range = vdupq_n_u8(26);
+        const uint8x16_t flip = vdupq_n_u8(0x20);
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint8x16_t input = vld1q_u8(src + pos);
+            if (vmaxvq_u8(input) >= 0x80)
+            {
+                break;
+            }
+            uint8x16_t letters = vcltq_u8(vsubq_u8(input, base), range);
+            vst1q_u8(dst + pos, veorq_u8(input, vandq_u8(letters, flip)));
+        }
+        return pos;
+    }
+#endif
 
-bool Char::IsASCII() const
-{
-    return m_data.size() == 1 && (static_cast<unsigned char>(m_data[0]) <= 0x7F);
+    CaseKernel GetCaseKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const CaseKernel kernel = SelectKernel<CaseKernel>(&MapASCIICaseSse, &MapASCIICaseAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &MapASCIICaseNeon;
+#else
+        return nullptr;
+#endif
+    }
 }
 
-bool Char::IsValid() const
-{
-    return _IsValidUTF8(m_data);
-}
+/* public */
 
-bool Char::IsNull() const
+Char::Char(const std::string& utf8Char)
 {
-    return m_data.empty() || (m_data.size() == 1 && m_data[0] == '\0');
+    uint32 code = 0;
+    int64 size = static_cast<int64>(utf8Char.size());
+    if (size > 0 && Utf8::Decode(utf8Char.data(), size, code) == size)
+    {
+        m_code = code;
+    }
 }
 
 bool Char::IsNumber() const
 {
-    uint32 code = Unicode();
-
-    // ASCII数字: 0-9
-    if (code >= 0x0030 && code <= 0x0039)
-        return true;
-
-    // 阿拉伯数字
-    if (code >= 0x0660 && code <= 0x0669) return true;  // 阿拉伯-印度数字
-    if (code >= 0x06F0 && code <= 0x06F9) return true;  // 扩展阿拉伯-印度数字
-    if (code >= 0x0966 && code <= 0x096F) return true;  // 天城文数字
-    if (code >= 0x09E6 && code <= 0x09EF) return true;  // 孟加拉文数字
-    if (code >= 0x0A66 && code <= 0x0A6F) return true;  // 古木基文数字
-    if (code >= 0x0AE6 && code <= 0x0AEF) return true;  // 古吉拉特文数字
-    if (code >= 0x0B66 && code <= 0x0B6F) return true;  // 奥里亚文数字
-    if (code >= 0x0BE6 && code <= 0x0BEF) return true;  // 泰米尔文数字
-    if (code >= 0x0C66 && code <= 0x0C6F) return true;  // 泰卢固文数字
-    if (code >= 0x0CE6 && code <= 0x0CEF) return true;  // 卡纳达文数字
-    if (code >= 0x0D66 && code <= 0x0D6F) return true;  // 马拉雅拉姆文数字
-    if (code >= 0x0E50 && code <= 0x0E59) return true;  // 泰文数字
-    if (code >= 0x0ED0 && code <= 0x0ED9) return true;  // 老挝文数字
-    if (code >= 0x0F20 && code <= 0x0F29) return true;  // 藏文数字
-    if (code >= 0x1040 && code <= 0x1049) return true;  // 缅甸文数字
-    if (code >= 0x1090 && code <= 0x1099) return true;  // 缅甸文掸邦数字
-    if (code >= 0x17E0 && code <= 0x17E9) return true;  // 高棉文数字
-    if (code >= 0x1810 && code <= 0x1819) return true;  // 蒙古文数字
-    if (code >= 0x1946 && code <= 0x194F) return true;  // 林布文数字
-    if (code >= 0x19D0 && code <= 0x19D9) return true;  // 新傣文数字
-    if (code >= 0x1A80 && code <= 0x1A89) return true;  // 泰文数字（新）
-    if (code >= 0x1A90 && code <= 0x1A99) return true;  // 老挝文数字（新）
-    if (code >= 0x1B50 && code <= 0x1B59) return true;  // 巴厘文数字
-    if (code >= 0x1BB0 && code <= 0x1BB9) return true;  // 巽他文数字
-    if (code >= 0x1C40 && code <= 0x1C49) return true;  // 雷布查文数字
-    if (code >= 0x1C50 && code <= 0x1C59) return true;  // 奥里亚文数字（补充）
-
-    // 全角数字
-    if (code >= 0xFF10 && code <= 0xFF19) return true;  // 全角数字
-
-    // 罗马数字
-    if (code >= 0x2160 && code <= 0x2188) return true;
-
-    // 带圈数字
-    if (code >= 0x2460 && code <= 0x2473) return true;  // 1-20
-    if (code >= 0x24F5 && code <= 0x24FE) return true;  // 21-30
-
-    // 带括号数字
-    if (code >= 0x2474 && code <= 0x2487) return true;
-
-    // 带点数字
-    if (code >= 0x2488 && code <= 0x249B) return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_NUMBER);
 }
 
 bool Char::IsLetter() const
 {
-    uint32 code = Unicode();
-
-    // ASCII字母
-    if ((code >= 0x0041 && code <= 0x005A) ||  // A-Z
-        (code >= 0x0061 && code <= 0x007A))     // a-z
-        return true;
-
-    // Latin-1补充
-    if ((code >= 0x00C0 && code <= 0x00D6) ||  // À-Ö
-        (code >= 0x00D8 && code <= 0x00F6) ||  // Ø-ö
-        (code >= 0x00F8 && code <= 0x00FF))    // ø-ÿ
-        return true;
-
-    // 希腊字母
-    if ((code >= 0x0386 && code <= 0x03CE) &&
-        code != 0x0387 && code != 0x038B && code != 0x038D)
-        return true;
-
-    // 西里尔字母
-    if ((code >= 0x0400 && code <= 0x0481) ||
-        (code >= 0x048A && code <= 0x04FF) ||
-        (code >= 0x0500 && code <= 0x052F))
-        return true;
-
-    // 阿拉伯字母
-    if ((code >= 0x0621 && code <= 0x064A) ||
-        (code >= 0x066E && code <= 0x066F) ||
-        (code >= 0x0671 && code <= 0x06D3) ||
-        (code >= 0x06D5 && code <= 0x06D5))
-        return true;
-
-    // 希伯来字母
-    if ((code >= 0x05D0 && code <= 0x05EA) ||
-        (code >= 0x05EF && code <= 0x05F2))
-        return true;
-
-    // 中日韩表意字符
-    if (IsCJK())
-        return true;
-
-    // 韩文
-    if ((code >= 0xAC00 && code <= 0xD7A3) ||  // 韩文音节
-        (code >= 0x1100 && code <= 0x11FF) ||  // 韩文字母
-        (code >= 0x3131 && code <= 0x318E) ||  // 韩文兼容字母
-        (code >= 0xFFA1 && code <= 0xFFDC))    // 半角韩文字母
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_LETTER);
 }
 
 bool Char::IsPunctuation() const
 {
-    uint32 code = Unicode();
-
-    // ASCII标点
-    if ((code >= 0x0021 && code <= 0x002F) ||  // ! " # $ % & ' ( ) * + , - . /
-        (code >= 0x003A && code <= 0x0040) ||  // : ; < = > ? @
-        (code >= 0x005B && code <= 0x0060) ||  // [ \ ] ^ _ `
-        (code >= 0x007B && code <= 0x007E))    // { | } ~
-        return true;
-
-    // 全角标点
-    if ((code >= 0x3000 && code <= 0x303F) ||  // CJK符号和标点
-        (code >= 0xFF00 && code <= 0xFF0F) ||  // 全角ASCII变体
-        (code >= 0xFF1A && code <= 0xFF1F) ||
-        (code >= 0xFF3B && code <= 0xFF40) ||
-        (code >= 0xFF5B && code <= 0xFF65))
-        return true;
-
-    // 通用标点
-    if ((code >= 0x2000 && code <= 0x206F) ||  // 通用标点
-        (code >= 0x2E00 && code <= 0x2E7F))    // 补充标点
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_PUNCTUATION);
 }
 
 bool Char::IsControl() const
 {
-    uint32 code = Unicode();
-
-    // ASCII控制字符
-    if (code < 0x0020 || code == 0x007F)
-        return true;
-
-    // C1控制字符
-    if (code >= 0x0080 && code <= 0x009F)
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_CONTROL);
 }
 
 bool Char::IsCJK() const
 {
-    uint32 code = Unicode();
-
-    // CJK统一表意字符
-    if (code >= 0x4E00 && code <= 0x9FFF)
-        return true;
-
-    // CJK扩展A
-    if (code >= 0x3400 && code <= 0x4DBF)
-        return true;
-
-    // CJK扩展B
-    if (code >= 0x20000 && code <= 0x2A6DF)
-        return true;
-
-    // CJK扩展C
-    if (code >= 0x2A700 && code <= 0x2B73F)
-        return true;
-
-    // CJK扩展D
-    if (code >= 0x2B740 && code <= 0x2B81F)
-        return true;
-
-    // CJK扩展E
-    if (code >= 0x2B820 && code <= 0x2CEAF)
-        return true;
-
-    // CJK扩展F
-    if (code >= 0x2CEB0 && code <= 0x2EBEF)
-        return true;
-
-    // CJK扩展G
-    if (code >= 0x30000 && code <= 0x3134F)
-        return true;
-
-    // CJK兼容表意字符
-    if ((code >= 0xF900 && code <= 0xFAFF) ||
-        (code >= 0x2F800 && code <= 0x2FA1F))
-        return true;
-
-    // CJK部首
-    if ((code >= 0x2E80 && code <= 0x2EFF) ||  // CJK部首补充
-        (code >= 0x2F00 && code <= 0x2FDF) ||  // 康熙部首
-        (code >= 0x31C0 && code <= 0x31EF))    // CJK笔画
-        return true;
-
-    // CJK符号和标点
-    if (code >= 0x3000 && code <= 0x303F)
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_CJK);
 }
 
 bool Char::IsEmoji() const
 {
-    uint32 code = Unicode();
-
-    // 表情符号
-    if (code >= 0x1F600 && code <= 0x1F64F)  // 表情符号
-        return true;
-
-    // 杂项符号和象形文字
-    if (code >= 0x1F300 && code <= 0x1F5FF)
-        return true;
-
-    // 交通和地图符号
-    if (code >= 0x1F680 && code <= 0x1F6FF)
-        return true;
-
-    // 补充符号和象形文字
-    if (code >= 0x1F900 && code <= 0x1F9FF)
-        return true;
-
-    // 杂项符号
-    if ((code >= 0x2600 && code <= 0x26FF) ||  // 杂项符号
-        (code >= 0x2700 && code <= 0x27BF))    // 装饰符号
-        return true;
-
-    // 变体选择器
-    if (code == 0xFE0F || code == 0x200D)
-        return true;
-
-    // 区域指示符（国旗）
-    if (code >= 0x1F1E6 && code <= 0x1F1FF)
-        return true;
-
-    // 其他表情符号相关
-    if (code == 0x203C || code == 0x2049 ||    // !!、!?
-        code == 0x2122 || code == 0x2139 ||    // TM、ℹ
-        code == 0x2194 || code == 0x2195 ||    // 箭头
-        code == 0x21A9 || code == 0x21AA ||    // 返回箭头
-        code == 0x231A || code == 0x231B ||    // 手表、闹钟
-        code == 0x2328 || code == 0x23CF ||    // 键盘、喷气机
-        code == 0x23E9 || code == 0x23EA ||    // 快进、快退
-        code == 0x23EB || code == 0x23EC ||    // 快上、快下
-        code == 0x23ED || code == 0x23EF ||    // 下一曲、播放/暂停
-        code == 0x23F0 || code == 0x23F3 ||    // 闹钟、计时器
-        code == 0x24C2 || code == 0x25AA ||    // Ⓜ、◻
-        code == 0x25AB || code == 0x25B6 ||    // ◻、▶
-        code == 0x25C0 || code == 0x25FB ||    // ◀、◻
-        code == 0x25FC || code == 0x25FD ||    // ◻、◽
-        code == 0x25FE || code == 0x2600)      // ◾、☀
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_EMOJI);
 }
 
 bool Char::IsSpace() const
 {
-    uint32 code = Unicode();
-
-    // ASCII空白字符
-    if (code == 0x0020 ||  // 空格
-        code == 0x0009 ||  // 水平制表符
-        code == 0x000A ||  // 换行
-        code == 0x000D ||  // 回车
-        code == 0x000B ||  // 垂直制表符
-        code == 0x000C)    // 换页
-        return true;
-
-    // Unicode空白字符
-    if (code == 0x00A0 ||  // 不换行空格
-        code == 0x1680 ||  // 欧甘空格
-        code == 0x2000 ||  // 全身空格
-        code == 0x2001 ||  // 全身空格
-        code == 0x2002 ||  // 半身空格
-        code == 0x2003 ||  // 全身空格
-        code == 0x2004 ||  // 三分之一空格
-        code == 0x2005 ||  // 四分之一空格
-        code == 0x2006 ||  // 六分之一空格
-        code == 0x2007 ||  // 数字空格
-        code == 0x2008 ||  // 标点空格
-        code == 0x2009 ||  // 细空格
-        code == 0x200A ||  // 发丝空格
-        code == 0x2028 ||  // 行分隔符
-        code == 0x2029 ||  // 段分隔符
-        code == 0x202F ||  // 窄不换行空格
-        code == 0x205F ||  // 中数学空格
-        code == 0x3000)    // 表意空格
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_SPACE);
 }
 
 bool Char::IsPrint() const
 {
-    uint32 code = Unicode();
-
-    // 空字符和控制字符不可打印
-    if (IsNull() || IsControl())
-        return false;
-
-    // ASCII可打印字符范围
-    if (code >= 0x0020 && code <= 0x007E)
-        return true;
-
-    // 其他字符通常可打印
-    return true;
+    // 空字符和控制字符不可打印，其他字符通常可打印
+    return !IsNull() && !IsControl();
 }
 
 bool Char::IsLower() const
 {
-    uint32 code = Unicode();
-
-    // ASCII小写字母
-    if (code >= 0x0061 && code <= 0x007A)
-        return true;
-
-    // Latin-1补充小写字母
-    if ((code >= 0x00E0 && code <= 0x00F6) ||
-        (code >= 0x00F8 && code <= 0x00FF))
-        return true;
-
-    // 其他常见小写字母范围
-    if ((code >= 0x03B1 && code <= 0x03C1) ||  // 希腊小写
-        (code >= 0x03C3 && code <= 0x03CB) ||  // 希腊小写
-        (code >= 0x0430 && code <= 0x044F) ||  // 西里尔小写
-        (code >= 0x0451 && code <= 0x045F))    // 西里尔小写
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_LOWER);
 }
 
 bool Char::IsUpper() const
 {
-    uint32 code = Unicode();
-
-    // ASCII大写字母
-    if (code >= 0x0041 && code <= 0x005A)
-        return true;
-
-    // Latin-1补充大写字母
-    if ((code >= 0x00C0 && code <= 0x00D6) ||
-        (code >= 0x00D8 && code <= 0x00DF))
-        return true;
-
-    // 其他常见大写字母范围
-    if ((code >= 0x0391 && code <= 0x03A1) ||  // 希腊大写
-        (code >= 0x03A3 && code <= 0x03AB) ||  // 希腊大写
-        (code >= 0x0410 && code <= 0x042F) ||  // 西里尔大写
-        (code >= 0x0401 && code <= 0x040F))    // 西里尔大写
-        return true;
-
-    return false;
+    return HasProperty(Unicode(), PROPERTY_UPPER);
 }
 
 Char Char::ToLower() const
 {
     uint32 code = Unicode();
-
-    // ASCII大写转小写
-    if (code >= 0x0041 && code <= 0x005A)
-    {
-        return Char(code + 0x20);
-    }
-
-    // Latin-1补充大写转小写
-    if (code >= 0x00C0 && code <= 0x00D6)
-    {
-        return Char(code + 0x20);
-    }
-    if (code >= 0x00D8 && code <= 0x00DE)
-    {
-        return Char(code + 0x20);
-    }
-
-    // 希腊字母大写转小写
-    if (code >= 0x0391 && code <= 0x03A1)
-    {
-        return Char(code + 0x20);
-    }
-    if (code >= 0x03A3 && code <= 0x03AB)
-    {
-        return Char(code + 0x20);
-    }
-
-    // 西里尔字母大写转小写
-    if (code >= 0x0410 && code <= 0x042F)
-    {
-        return Char(code + 0x20);
-    }
-    if (code >= 0x0401 && code <= 0x040F)
-    {
-        // Ё例外，需要特殊处理
-        if (code == 0x0401) return Char(0x0451);
-        return Char(code + 0x50);
-    }
-
-    // 其他字符保持不变
-    return *this;
+    uint32 lower = MapCase(code, PROPERTY_TO_LOWER);
+    return lower != code ? Char(lower) : *this;
 }
 
 Char Char::ToUpper() const
 {
     uint32 code = Unicode();
-
-    // ASCII小写转大写
-    if (code >= 0x0061 && code <= 0x007A)
-    {
-        return Char(code - 0x20);
-    }
-
-    // Latin-1补充小写转大写
-    if (code >= 0x00E0 && code <= 0x00F6)
-    {
-        return Char(code - 0x20);
-    }
-    if (code >= 0x00F8 && code <= 0x00FE)
-    {
-        return Char(code - 0x20);
-    }
-
-    // 希腊字母小写转大写
-    if (code >= 0x03B1 && code <= 0x03C1)
-    {
-        return Char(code - 0x20);
-    }
-    if (code >= 0x03C3 && code <= 0x03CB)
-    {
-        return Char(code - 0x20);
-    }
-
-    // 西里尔字母小写转大写
-    if (code >= 0x0430 && code <= 0x044F)
-    {
-        return Char(code - 0x20);
-    }
-    if (code >= 0x0451 && code <= 0x045F)
-    {
-        // ё例外，需要特殊处理
-        if (code == 0x0451) return Char(0x0401);
-        return Char(code - 0x50);
-    }
-
-    // 其他字符保持不变
-    return *this;
+    uint32 upper = MapCase(code, PROPERTY_TO_UPPER);
+    return upper != code ? Char(upper) : *this;
 }
 
-/* private */
-
-bool Char::_IsValidCodepoint(uint32 cp) const
+int32 Char::Encode(char* buffer) const
 {
-    // Unicode有效范围: 0x0000-0x10FFFF, 排除代理对范围 0xD800-0xDFFF
-    return cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
-}
-
-uint32 Char::_DecodeUTF8(const std::string& str) const
-{
-    if (str.empty()) return 0;
-
-    const unsigned char* data = reinterpret_cast<const unsigned char*>(str.data());
-    size_t len = str.size();
-
-    if (len == 1)
+    if (!IsValid())
     {
-        // 单字节ASCII
-        return data[0];
+        return 0;
     }
-    else if (len == 2)
-    {
-        // 2字节UTF-8: 110xxxxx 10xxxxxx
-        return ((data[0] & 0x1F) << 6) | (data[1] & 0x3F);
-    }
-    else if (len == 3)
-    {
-        // 3字节UTF-8: 1110xxxx 10xxxxxx 10xxxxxx
-        return ((data[0] & 0x0F) << 12) |
-            ((data[1] & 0x3F) << 6) |
-            (data[2] & 0x3F);
-    }
-    else if (len == 4)
-    {
-        // 4字节UTF-8: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-        return ((data[0] & 0x07) << 18) |
-            ((data[1] & 0x3F) << 12) |
-            ((data[2] & 0x3F) << 6) |
-            (data[3] & 0x3F);
-    }
-    return 0;
+    return Utf8::Encode(m_code, buffer);
 }
 
-std::string Char::_EncodeUTF8(uint32 cp) const
-{
-    if (!_IsValidCodepoint(cp)) return "";
-
-    std::string result;
-    if (cp <= 0x7F)
-    {
-        // 1字节: 0xxxxxxx
-        result += static_cast<char>(cp);
-    }
-    else if (cp <= 0x7FF)
-    {
-        // 2字节: 110xxxxx 10xxxxxx
-        result += static_cast<char>(0xC0 | ((cp >> 6) & 0x1F));
-        result += static_cast<char>(0x80 | (cp & 0x3F));
-    }
-    else if (cp <= 0xFFFF)
-    {
-        // 3字节: 1110xxxx 10xxxxxx 10xxxxxx
-        result += static_cast<char>(0xE0 | ((cp >> 12) & 0x0F));
-        result += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
-        result += static_cast<char>(0x80 | (cp & 0x3F));
-    }
-    else
-    {
-        // 4字节: 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
-        result += static_cast<char>(0xF0 | ((cp >> 18) & 0x07));
-        result += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
-        result += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
-        result += static_cast<char>(0x80 | (cp & 0x3F));
-    }
-    return result;
-}
+/* private */
 
-bool Char::_IsValidUTF8(const std::string& str) const
+void Char::_MapCase(const char* src, char* dst, int64 size, CaseMapping mapping)
 {
-    if (str.empty()) return false;
-
-    const unsigned char* data = reinterpret_cast<const unsigned char*>(str.data());
-    size_t len = str.size();
-
-    // 单字节ASCII字符
-    if (len == 1)
-    {
-        return (data[0] <= 0x7F);
-    }
-
-    // UTF-8最大4字节
-    if (len < 2 || len > 4) return false;
-
-    // 验证首字节格式
-    if (len == 2 && (data[0] & 0xE0) != 0xC0) return false;
-    if (len == 3 && (data[0] & 0xF0) != 0xE0) return false;
-    if (len == 4 && (data[0] & 0xF8) != 0xF0) return false;
+    const uint8* input = reinterpret_cast<const uint8*>(src);
+    uint8* output = reinterpret_cast<uint8*>(dst);
+    uint8 first = mapping == CaseMapping::Upper ? 'a' : 'A';
+    uint16 property = mapping == CaseMapping::Lower ? PROPERTY_TO_LOWER :
+        mapping == CaseMapping::Upper ? PROPERTY_TO_UPPER : PROPERTY_FOLD;
+
+    CaseKernel kernel = GetCaseKernel();
+    int64 pos = 0;
+    while (pos < size)
+    {
+        // 向量内核处理连续的 ASCII 块，之后逐字符处理一个向量宽度再交回内核
+        int64 end = size;
+        if (kernel)
+        {
+            pos += kernel(input + pos, size - pos, output + pos, first);
+            end = std::min(size, pos + 32);
+        }
 
-    // 验证后续字节格式（所有后续字节必须以10开头）
-    for (size_t i = 1; i < len; ++i)
-    {
-        if ((data[i] & 0xC0) != 0x80)
+        while (pos < end)
         {
-            return false; // 不是有效的10xxxxxx格式
+            uint8 byte = input[pos];
+            if (byte < 0x80)
+            {
+                output[pos++] = static_cast<uint8>(byte - first) < 26 ? (byte ^ 0x20) : byte;
+                continue;
+            }
+
+            uint32 code = 0;
+            int32 length = Utf8::Decode(src + pos, size - pos, code);
+            if (length == 0) [[unlikely]]
+            {
+                // 无效字节原样复制
+                output[pos++] = byte;
+                continue;
+            }
+
+            // 映射不改变编码长度(编译期已检查)
+            uint32 mapped = MapCase(code, property);
+            if (mapped != code)
+            {
+                Utf8::Encode(mapped, dst + pos);
+            }
+            else
+            {
+                std::copy_n(input + pos, length, output + pos);
+            }
+            pos += length;
         }
     }
-
-    // 解码并验证码点有效性
-    uint32 code = _DecodeUTF8(str);
-    if (!_IsValidCodepoint(code)) return false;
-
-    // 验证是否使用了最小字节数（防止过长编码）
-    if (len == 2 && code < 0x0080) return false;
-    if (len == 3 && code < 0x0800) return false;
-    if (len == 4 && code < 0x10000) return false;
-
-    return true;
-}
\ No newline at end of file
+}
@@ -4,71 +4,66 @@
 
 #include <string>
 
+/// <summary>
+/// Unicode 字符，以 32 位码点表示的值类型
+/// <para>拷贝与构造都不分配内存；无效字符(如无效的 UTF-8 序列)的 Size 为 0，Unicode 返回 0</para>
+/// </summary>
 class Char
 {
 public:
     friend class String;
 public:
     /// <summary>
-    /// 默认构造函数
+    /// 默认构造函数，构造无效的空字符
     /// </summary>
-    Char() = default;
-    /// <summary>
-    /// 析构函数
-    /// </summary>
-    ~Char() = default;
-    /// <summary>
-    /// 拷贝构造函数
-    /// </summary>
-    /// <param name="other">要拷贝的对象</param>
-    Char(const Char& other);
-    /// <summary>
-    /// 拷贝赋值运算符
-    /// </summary>
-    /// <param name="other">要拷贝的对象</param>
-    /// <returns>this</returns>
-    Char& operator=(const Char& other);
-    /// <summary>
-    /// 移动构造函数
-    /// </summary>
-    /// <param name="other">要移动的对象</param>
-    Char(Char&& other);
-    /// <summary>
-    /// 移动赋值运算符
-    /// </summary>
-    /// <param name="other">要移动的对象</param>
-    /// <returns>this</returns>
-    Char& operator=(Char&& other);
+    constexpr Char() noexcept = default;
     /// <summary>
     /// 构造函数，从 Unicode 码点构造字符
     /// </summary>
-    /// <param name="unicode">Unicode 码点值，范围 0x0000 - 0x10FFFF</param>
-    explicit Char(uint32 unicode);
+    /// <param name="unicode">Unicode 码点值，范围 0x0000 - 0x10FFFF，超出范围或为代理项时构造为无效字符</param>
+    constexpr explicit Char(uint32 unicode) noexcept
+        : m_code(_IsValidCodepoint(unicode) ? unicode : INVALID_CODE)
+    {
+
+    }
     /// <summary>
     /// 构造函数，从 ASCII 字符构造
     /// </summary>
-    /// <param name="ch">ASCII 字符（0x00 - 0x7F）</param>
-    explicit Char(char ch);
+    /// <param name="ch">ASCII 字符（0x00 - 0x7F），更大的值视为 Latin-1 字符</param>
+    constexpr explicit Char(char ch) noexcept
+        : m_code(static_cast<unsigned char>(ch))
+    {
+
+    }
     /// <summary>
     /// 构造函数，从 UTF-8 编码的字符构造
     /// </summary>
-    /// <param name="utf8Char">UTF-8 编码的单个字符，长度应为 1-4 字节</param>
+    /// <param name="utf8Char">UTF-8 编码的单个字符，长度应为 1-4 字节，否则构造为无效字符</param>
     explicit Char(const std::string& utf8Char);
 public:
     /// <summary>
     /// 返回字符的 Unicode 码点值
     /// </summary>
     /// <returns>Unicode 码点值，无效字符返回 0</returns>
-    uint32 Unicode() const;
+    constexpr uint32 Unicode() const noexcept
+    {
+        return IsValid() ? m_code : 0;
+    }
     /// <summary>
-    /// 返回UTF-8字节数
+    /// 返回UTF-8字节数，无效字符为 0
     /// </summary>
-    int32 Size() const;
+    constexpr int32 Size() const noexcept
+    {
+        return !IsValid() ? 0 : m_code < 0x80 ? 1 : m_code < 0x800 ? 2 : m_code < 0x10000 ? 3 : 4;
+    }
     
     /// <summary>
     /// 是否为 ASCII 字符
     /// </summary>
-    bool IsASCII() const;
+    constexpr bool IsASCII() const noexcept
+    {
+        return m_code < 0x80;
+    }
     /// <summary>
     /// 判断字符是否为数字字符
     /// </summary>
@@ -108,12 +103,18 @@ public:
     /// 检查字符是否为有效的 UTF-8 编码字符
     /// </summary>
     /// <returns>有效返回 true，否则返回 false</returns>
-    bool IsValid() const;
+    constexpr bool IsValid() const noexcept
+    {
+        return m_code != INVALID_CODE;
+    }
     /// <summary>
     /// 判断字符是否为空字符
     /// </summary>
-    /// <returns>是空字符返回 true，否则返回 false</returns>
-    bool IsNull() const;
+    /// <returns>是空字符或无效字符返回 true，否则返回 false</returns>
+    constexpr bool IsNull() const noexcept
+    {
+        return m_code == 0 || m_code == INVALID_CODE;
+    }
     /// <summary>
     /// 判断字符是否为小写字母
     /// </summary>
@@ -134,26 +135,52 @@ public:
     /// </summary>
     /// <returns>大写形式的字符对象</returns>
     Char ToUpper() const; 
-private:
     /// <summary>
-    /// 验证UTF-8字符串是否为有效的单个字符
+    /// 将字符编码为 UTF-8
     /// </summary>
-    bool _IsValidUTF8(const std::string& str) const;
+    /// <param name="buffer">至少 4 字节的缓冲区</param>
+    /// <returns>写入的字节数，无效字符为 0</returns>
+    int32 Encode(char* buffer) const;
+public:
+    friend constexpr bool operator==(const Char& left, const Char& right) noexcept = default;
 
+    friend constexpr auto operator<=>(const Char& left, const Char& right) noexcept = default;
+private:
     /// <summary>
-    /// 验证Unicode码点的有效性
+    /// 字符串的大小写转换方式
+    /// </summary>
+    enum class CaseMapping : uint8
+    {
+        // 转换为小写
+        Lower,
+        // 转换为大写
+        Upper,
+        // 简单大小写折叠(用于不区分大小写的比较)
+        Fold
+    };
+private:
+    /// <summary>
+    /// 逐字符转换 UTF-8 字节序列的大小写，结果与输入等长
+    /// <para>连续的 ASCII 字节按向量批量转换，其余字符查表转换；无效字节原样复制</para>
     /// </summary>
-    bool _IsValidCodepoint(uint32 cp) const;
+    static void _MapCase(const char* src, char* dst, int64 size, CaseMapping mapping);
 
     /// <summary>
-    /// 从UTF-8解码Unicode码点
+    /// 验证Unicode码点的有效性
     /// </summary>
-    uint32 _DecodeUTF8(const std::string& str) const;
-
+    static constexpr bool _IsValidCodepoint(uint32 cp)
+    {
+        // Unicode有效范围: 0x0000-0x10FFFF, 排除代理对范围 0xD800-0xDFFF
+        return cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
+    }
+private:
     /// <summary>
-    /// 将Unicode码点编码为UTF-8
+    /// 无效字符的码点值
     /// </summary>
-    std::string _EncodeUTF8(uint32 cp) const;
+    static constexpr uint32 INVALID_CODE = 0xFFFFFFFF;
 private:
-    std::string m_data;
-};
\ No newline at end of file
+    // Unicode 码点，无效字符为 INVALID_CODE
+    uint32 m_code = INVALID_CODE;
+};
+
+static_assert(sizeof(Char) == 4, "Char must stay a packed 32-bit value");
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "pch.h"
+
+#include "LineReader.h"
+#include "Utf8.h"
+#include "StringSearch.h"
+#include "Platform.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+
+#ifdef PLATFORM_WINDOWS
+    #include "Windows/WindowsPlatform.h"
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+struct LineReader::File
+{
+#ifdef PLATFORM_WINDOWS
+    // 文件句柄
+    HANDLE Handle = INVALID_HANDLE_VALUE;
+#else
+    // 文件描述符
+    int Handle = -1;
+#endif
+
+    ~File()
+    {
+#ifdef PLATFORM_WINDOWS
+        if (Handle != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(Handle);
+        }
+#else
+        if (Handle >= 0)
+        {
+            close(Handle);
+        }
+#endif
+    }
+
+    /// <summary>
+    /// 读取最多 size 个字节
+    /// </summary>
+    /// <returns>读取的字节数，到达文件末尾返回 0，失败返回 -1</returns>
+    int64 Read(char* buffer, int64 size)
+    {
+#ifdef PLATFORM_WINDOWS
+        DWORD request = static_cast<DWORD>(std::min<int64>(size, std::numeric_limits<DWORD>::max()));
+        DWORD read = 0;
+        if (!ReadFile(Handle, buffer, request, &read, nullptr))
+        {
+            return -1;
+        }
+        return static_cast<int64>(read);
+#else
+        ssize_t result;
+        do
+        {
+            result = read(Handle, buffer, static_cast<size_t>(size));
+        } while (result < 0 && errno == EINTR);
+        return static_cast<int64>(result);
+#endif
+    }
+};
+
+LineReader::LineReader(bool validate)
+    : m_validate(validate)
+{
+
+}
+
+LineReader::~LineReader() = default;
+
+LineReader::LineReader(LineReader&& other) noexcept = default;
+
+LineReader& LineReader::operator=(LineReader&& other) noexcept = default;
+
+bool LineReader::Open(const std::filesystem::path& path, int64 blockSize)
+{
+    Close();
+
+    auto file = std::make_unique<File>();
+#ifdef PLATFORM_WINDOWS
+    file->Handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file->Handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+#else
+    file->Handle = open(path.c_str(), O_RDONLY);
+    if (file->Handle < 0)
+    {
+        return false;
+    }
+    #ifdef POSIX_FADV_SEQUENTIAL
+        posix_fadvise(file->Handle, 0, 0, POSIX_FADV_SEQUENTIAL);
+    #endif
+#endif
+
+    m_file = std::move(file);
+    m_blockSize = std::max<int64>(blockSize, 1);
+    m_buffer.Resize(m_blockSize);
+    m_data = m_buffer.Data();
+    m_eof = false;
+    m_open = true;
+    return true;
+}
+
+void LineReader::OpenView(const ByteView& view)
+{
+    Close();
+    m_view = view;
+    m_data = reinterpret_cast<const char*>(m_view.Data());
+    m_size = m_view.Size();
+    m_open = true;
+    _SkipBom();
+}
+
+void LineReader::OpenText(StringView text)
+{
+    Close();
+    m_data = text.Data();
+    m_size = text.Size();
+    m_open = true;
+    _SkipBom();
+}
+
+void LineReader::Close()
+{
+    m_file.reset();
+    m_buffer.Reset();
+    m_view.Reset();
+    _Reset();
+}
+
+bool LineReader::ReadLine(StringView& line)
+{
+    if (m_error != LineReaderError::None)
+    {
+        return false;
+    }
+
+    int64 end;
+    int64 next;
+    while (true)
+    {
+        // 只在上次未查找过的部分中查找换行符
+        int64 from = std::max(m_pos, m_scanned);
+        const void* found = from < m_size ? std::memchr(m_data + from, '\n', static_cast<size_t>(m_size - from)) : nullptr;
+        if (found)
+        {
+            end = static_cast<const char*>(found) - m_data;
+            next = end + 1;
+            break;
+        }
+        m_scanned = m_size;
+
+        if (m_eof)
+        {
+            if (m_pos == m_size)
+            {
+                return false;
+            }
+            end = m_size;
+            next = m_size;
+            break;
+        }
+        if (!_Refill())
+        {
+            return false;
+        }
+    }
+
+    if (!_Validate(next))
+    {
+        return false;
+    }
+
+    if (end > m_pos && next > end && m_data[end - 1] == '\r')
+    {
+        end--;
+    }
+    line = StringView(m_data + m_pos, end - m_pos);
+    m_pos = next;
+    m_lineNumber++;
+    return true;
+}
+
+int64 LineReader::LineNumber() const
+{
+    return m_lineNumber;
+}
+
+int64 LineReader::Offset() const
+{
+    return m_base + m_pos;
+}
+
+LineReaderError LineReader::Error() const
+{
+    return m_error;
+}
+
+bool LineReader::IsOpen() const
+{
+    return m_open;
+}
+
+/* private */
+
+void LineReader::_Reset()
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_pos = 0;
+    m_scanned = 0;
+    m_validated = 0;
+    m_checkLines = 0;
+    m_base = 0;
+    m_lineNumber = 0;
+    m_error = LineReaderError::None;
+    m_open = false;
+    m_eof = true;
+}
+
+bool LineReader::_Refill()
+{
+    // 丢弃已返回的行，未读完的行移到开头
+    int64 shift = m_pos;
+    int64 remain = m_size - m_pos;
+    if (shift > 0)
+    {
+        std::memmove(m_buffer.Data(), m_buffer.Data() + shift, static_cast<size_t>(remain));
+        m_base += shift;
+        m_pos = 0;
+        m_size = remain;
+        m_scanned -= shift;
+        m_validated = std::max<int64>(m_validated - shift, 0);
+        m_checkLines = std::max<int64>(m_checkLines - shift, 0);
+    }
+
+    // 保证每次至少能读入一个块
+    if (m_buffer.Size() - m_size < m_blockSize)
+    {
+        m_buffer.Resize(std::max(m_buffer.Size() * 2, m_size + m_blockSize));
+    }
+    m_data = m_buffer.Data();
+
+    int64 read = m_file->Read(m_buffer.Data() + m_size, m_buffer.Size() - m_size);
+    if (read < 0)
+    {
+        m_error = LineReaderError::ReadFailed;
+        return false;
+    }
+    if (read == 0)
+    {
+        m_eof = true;
+    }
+
+    m_size += read;
+    if (m_base == 0 && m_pos == 0)
+    {
+        // 块很小时 BOM 可能分几次读入
+        _SkipBom();
+    }
+    return true;
+}
+
+bool LineReader::_Validate(int64 next)
+{
+    if (!m_validate || next <= m_validated)
+    {
+        return true;
+    }
+
+    if (next > m_checkLines)
+    {
+        // 批量校验到已读入数据中最后一个换行符为止，换行符之后的部分可能是被块边界截断的序列
+        int64 limit = m_size;
+        if (!m_eof)
+        {
+            limit = StringSearch::FindLast(m_data + next - 1, m_size - next + 1, "\n", 1) + next;
+        }
+        if (Utf8::IsValid(m_data + m_validated, limit - m_validated))
+        {
+            m_validated = limit;
+            return true;
+        }
+        m_checkLines = limit;
+    }
+
+    // 本批中存在无效序列，逐行校验以准确定位
+    if (!Utf8::IsValid(m_data + m_pos, next - m_pos))
+    {
+        m_error = LineReaderError::InvalidUtf8;
+        return false;
+    }
+    m_validated = next;
+    return true;
+}
+
+void LineReader::_SkipBom()
+{
+    if (m_size - m_pos >= 3 && std::memcmp(m_data + m_pos, "\xEF\xBB\xBF", 3) == 0)
+    {
+        m_pos += 3;
+        m_validated = m_pos;
+    }
+}
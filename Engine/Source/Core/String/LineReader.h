@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Core.h"
+#include "Container/Array.h"
+#include "Memory/ByteView.h"
+#include "String/StringView.h"
+
+#include <memory>
+#include <filesystem>
+
+/// <summary>
+/// 行读取错误
+/// </summary>
+enum class LineReaderError
+{
+    // 没有错误
+    None,
+    // 读取文件失败
+    ReadFailed,
+    // 内容不是有效的 UTF-8
+    InvalidUtf8
+};
+
+/// <summary>
+/// 流式行读取器
+/// <para>按固定大小的块读取文件，或直接扫描内存映射等已有的数据，逐行返回不复制数据的 StringView，可处理远大于内存的文件</para>
+/// <para>跨越块边界的行先移到缓冲区开头再读入后续数据，超过缓冲区的长行使缓冲区按倍数扩大</para>
+/// <para>UTF-8 按块增量校验：每次校验到已读入数据中最后一个换行符为止(换行符不会出现在多字节序列中)，发现无效序列时再逐行校验以定位到具体的行</para>
+/// <para>行不含结尾的 \n 或 \r\n；最后一行没有换行符时也会返回，文件开头的 UTF-8 BOM 会被跳过</para>
+/// </summary>
+class LineReader
+{
+public:
+    // 默认的读取块大小
+    static constexpr int64 DEFAULT_BLOCK_SIZE = 64 * 1024;
+public:
+    /// <summary>
+    /// 构造函数
+    /// </summary>
+    /// <param name="validate">是否校验 UTF-8</param>
+    explicit LineReader(bool validate = true);
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~LineReader();
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    LineReader(const LineReader& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    LineReader& operator=(const LineReader& other) = delete;
+    /// <summary>
+    /// 移动构造函数
+    /// </summary>
+    LineReader(LineReader&& other) noexcept;
+    /// <summary>
+    /// 移动赋值运算符
+    /// </summary>
+    LineReader& operator=(LineReader&& other) noexcept;
+public:
+    /// <summary>
+    /// 打开文件，按块读取
+    /// <para>返回的行指向内部缓冲区，在下一次 ReadLine 之前有效</para>
+    /// </summary>
+    /// <param name="path">文件路径</param>
+    /// <param name="blockSize">每次读取的字节数</param>
+    /// <returns>打开失败返回 false</returns>
+    bool Open(const std::filesystem::path& path, int64 blockSize = DEFAULT_BLOCK_SIZE);
+    /// <summary>
+    /// 读取字节视图(如 MappedFile::View 返回的映射视图)，不复制数据
+    /// <para>读取器持有视图的引用，返回的行在读取器关闭前有效</para>
+    /// </summary>
+    void OpenView(const ByteView& view);
+    /// <summary>
+    /// 读取内存中的文本，不复制数据；调用方需保证文本在读取期间有效
+    /// </summary>
+    void OpenText(StringView text);
+    /// <summary>
+    /// 关闭并释放缓冲区
+    /// </summary>
+    void Close();
+    /// <summary>
+    /// 读取下一行
+    /// </summary>
+    /// <param name="line">行内容，不含换行符</param>
+    /// <returns>已读完或出错时返回 false，由 Error 区分</returns>
+    bool ReadLine(StringView& line);
+    /// <summary>
+    /// 获取已读取的行数
+    /// </summary>
+    int64 LineNumber() const;
+    /// <summary>
+    /// 获取下一行在数据中的字节偏移
+    /// </summary>
+    int64 Offset() const;
+    /// <summary>
+    /// 获取错误
+    /// </summary>
+    LineReaderError Error() const;
+    /// <summary>
+    /// 检查是否已打开
+    /// </summary>
+    bool IsOpen() const;
+private:
+    /// <summary>
+    /// 平台相关的文件句柄
+    /// </summary>
+    struct File;
+private:
+    /// <summary>
+    /// 重置读取状态
+    /// </summary>
+    void _Reset();
+    /// <summary>
+    /// 将未读完的数据移到缓冲区开头并读入下一块，必要时扩大缓冲区
+    /// </summary>
+    /// <returns>读取失败返回 false</returns>
+    bool _Refill();
+    /// <summary>
+    /// 确保 [m_pos, next) 已通过 UTF-8 校验
+    /// </summary>
+    bool _Validate(int64 next);
+    /// <summary>
+    /// 跳过开头的 UTF-8 BOM
+    /// </summary>
+    void _SkipBom();
+private:
+    // 打开的文件，读取内存或视图时为空
+    std::unique_ptr<File> m_file;
+    // 文件读取缓冲区
+    Array<char> m_buffer;
+    // 读取视图时持有的引用
+    ByteView m_view;
+    // 当前数据，文件模式下指向缓冲区
+    const char* m_data = nullptr;
+    // 当前数据的字节数
+    int64 m_size = 0;
+    // 下一行的起始位置
+    int64 m_pos = 0;
+    // 已查找过换行符的位置，之前的部分不含换行符
+    int64 m_scanned = 0;
+    // 已通过校验的位置
+    int64 m_validated = 0;
+    // 在此位置之前逐行校验(批量校验发现了无效序列)
+    int64 m_checkLines = 0;
+    // 缓冲区开头在文件中的偏移
+    int64 m_base = 0;
+    // 每次读取的字节数
+    int64 m_blockSize = DEFAULT_BLOCK_SIZE;
+    // 已读取的行数
+    int64 m_lineNumber = 0;
+    // 错误
+    LineReaderError m_error = LineReaderError::None;
+    // 是否已打开
+    bool m_open = false;
+    // 数据是否已全部读入
+    bool m_eof = true;
+    // 是否校验 UTF-8
+    bool m_validate = true;
+};
@@ -0,0 +1,281 @@
+#include "pch.h"
+
+#include "Name.h"
+#include "Memory/Checksum.h"
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    /// <summary>
+    /// 驻留条目，文本(以 '\0' 结尾)紧跟在条目之后
+    /// </summary>
+    struct NameEntry
+    {
+        uint64 Hash;
+        int64 Size;
+        uint32 Id;
+
+        const char* Data() const
+        {
+            return reinterpret_cast<const char*>(this + 1);
+        }
+    };
+    /// <summary>
+    /// 只增不减的内存块分配器，条目一经分配直到进程结束都不会释放或移动
+    /// </summary>
+    class NameArena
+    {
+    public:
+        void* Allocate(int64 bytes)
+        {
+            bytes = (bytes + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+            // 较大的文本单独分配，避免浪费当前块的剩余空间
+            if (bytes > BLOCK_SIZE / 4)
+            {
+                return ::operator new(static_cast<size_t>(bytes));
+            }
+            if (bytes > m_end - m_cursor)
+            {
+                m_cursor = static_cast<char*>(::operator new(static_cast<size_t>(BLOCK_SIZE)));
+                m_end = m_cursor + BLOCK_SIZE;
+            }
+            void* ptr = m_cursor;
+            m_cursor += bytes;
+            return ptr;
+        }
+    private:
+        static constexpr int64 BLOCK_SIZE = 64 * 1024;
+        static constexpr int64 ALIGNMENT = alignof(NameEntry);
+        // 当前块的空闲位置
+        char* m_cursor = nullptr;
+        // 当前块的末尾
+        char* m_end = nullptr;
+    };
+    /// <summary>
+    /// 开放寻址(线性探测)的槽位表，槽位只会从空变为非空
+    /// </summary>
+    struct SlotTable
+    {
+        explicit SlotTable(int64 capacity, SlotTable* previous)
+            : Mask(capacity - 1)
+            , Slots(new std::atomic<const NameEntry*>[static_cast<size_t>(capacity)]())
+            , Previous(previous)
+        {
+
+        }
+
+        int64 Mask;
+        std::unique_ptr<std::atomic<const NameEntry*>[]> Slots;
+        // 扩容前的旧表，可能仍有读者在访问，因此一直保留
+        std::unique_ptr<SlotTable> Previous;
+    };
+    /// <summary>
+    /// 全局驻留表
+    /// <para>读者只通过原子指针访问槽位表，查找不加锁；插入与扩容在互斥锁内进行，扩容后发布新表，读到旧表的读者最多错过新条目而转入加锁路径</para>
+    /// </summary>
+    class NameTable
+    {
+    public:
+        NameTable()
+        {
+            m_table.store(new SlotTable(INITIAL_CAPACITY, nullptr), std::memory_order_relaxed);
+        }
+
+        uint32 Find(StringView text) const
+        {
+            if (text.IsEmpty())
+            {
+                return 0;
+            }
+            const NameEntry* entry = _Find(m_table.load(std::memory_order_acquire), _Hash(text), text);
+            return entry ? entry->Id : 0;
+        }
+
+        uint32 Intern(StringView text)
+        {
+            if (text.IsEmpty())
+            {
+                return 0;
+            }
+
+            const uint64 hash = _Hash(text);
+            if (const NameEntry* entry = _Find(m_table.load(std::memory_order_acquire), hash, text))
+            {
+                return entry->Id;
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            SlotTable* table = m_table.load(std::memory_order_relaxed);
+            // 加锁期间其他线程可能已插入同一文本
+            if (const NameEntry* entry = _Find(table, hash, text))
+            {
+                return entry->Id;
+            }
+
+            const int64 count = m_count.load(std::memory_order_relaxed);
+            if (count + 1 >= MAX_COUNT) [[unlikely]]
+            {
+                throw std::out_of_range("Name table is full");
+            }
+            // 负载因子不超过 1/2，保证探测一定能遇到空槽
+            if ((count + 1) * 2 > table->Mask + 1)
+            {
+                table = _Grow(table);
+            }
+
+            const uint32 id = static_cast<uint32>(count + 1);
+            void* memory = m_arena.Allocate(static_cast<int64>(sizeof(NameEntry)) + text.Size() + 1);
+            NameEntry* entry = new (memory) NameEntry{ hash, text.Size(), id };
+            char* data = const_cast<char*>(entry->Data());
+            std::memcpy(data, text.Data(), static_cast<size_t>(text.Size()));
+            data[text.Size()] = '\0';
+
+            _SetEntry(id, entry);
+            _Insert(table, entry);
+            m_count.store(count + 1, std::memory_order_relaxed);
+            return id;
+        }
+
+        const NameEntry* GetEntry(uint32 id) const
+        {
+            const NameEntry* const* chunk = m_chunks[id >> CHUNK_SHIFT].load(std::memory_order_acquire);
+            return chunk[id & CHUNK_MASK];
+        }
+
+        int64 GetCount() const
+        {
+            return m_count.load(std::memory_order_relaxed);
+        }
+    private:
+        static uint64 _Hash(StringView text)
+        {
+            return XxHash64::Compute(reinterpret_cast<const byte*>(text.Data()), text.Size());
+        }
+
+        static const NameEntry* _Find(const SlotTable* table, uint64 hash, StringView text)
+        {
+            for (int64 i = static_cast<int64>(hash) & table->Mask;; i = (i + 1) & table->Mask)
+            {
+                const NameEntry* entry = table->Slots[i].load(std::memory_order_acquire);
+                if (!entry)
+                {
+                    return nullptr;
+                }
+                if (entry->Hash == hash && entry->Size == text.Size()
+                    && std::memcmp(entry->Data(), text.Data(), static_cast<size_t>(text.Size())) == 0)
+                {
+                    return entry;
+                }
+            }
+        }
+
+        static void _Insert(SlotTable* table, const NameEntry* entry)
+        {
+            int64 i = static_cast<int64>(entry->Hash) & table->Mask;
+            while (table->Slots[i].load(std::memory_order_relaxed))
+            {
+                i = (i + 1) & table->Mask;
+            }
+            // 条目内容先写完再发布，读者以 acquire 读取
+            table->Slots[i].store(entry, std::memory_order_release);
+        }
+
+        SlotTable* _Grow(SlotTable* table)
+        {
+            SlotTable* grown = new SlotTable((table->Mask + 1) * 2, table);
+            for (int64 i = 0; i <= table->Mask; ++i)
+            {
+                if (const NameEntry* entry = table->Slots[i].load(std::memory_order_relaxed))
+                {
+                    _Insert(grown, entry);
+                }
+            }
+            m_table.store(grown, std::memory_order_release);
+            return grown;
+        }
+
+        void _SetEntry(uint32 id, const NameEntry* entry)
+        {
+            std::atomic<const NameEntry**>& slot = m_chunks[id >> CHUNK_SHIFT];
+            const NameEntry** chunk = slot.load(std::memory_order_relaxed);
+            if (!chunk)
+            {
+                chunk = new const NameEntry*[CHUNK_SIZE]();
+                slot.store(chunk, std::memory_order_release);
+            }
+            chunk[id & CHUNK_MASK] = entry;
+        }
+    private:
+        static constexpr int64 INITIAL_CAPACITY = 4096;
+        static constexpr uint32 CHUNK_SHIFT = 16;
+        static constexpr uint32 CHUNK_SIZE = 1u << CHUNK_SHIFT;
+        static constexpr uint32 CHUNK_MASK = CHUNK_SIZE - 1;
+        static constexpr uint32 CHUNK_COUNT = 1u << 12;
+        static constexpr int64 MAX_COUNT = static_cast<int64>(CHUNK_SIZE) * CHUNK_COUNT;
+        // 当前槽位表
+        std::atomic<SlotTable*> m_table;
+        // 编号到条目的映射，按块分配，已分配的块不会移动
+        std::atomic<const NameEntry**> m_chunks[CHUNK_COUNT] = {};
+        // 已驻留的名称数量(也是最大编号)
+        std::atomic<int64> m_count = 0;
+        // 条目存储
+        NameArena m_arena;
+        // 插入与扩容锁
+        std::mutex m_mutex;
+    };
+
+    NameTable& GetNameTable()
+    {
+        // 不析构，保证静态对象析构期间仍可使用名称
+        static NameTable* table = new NameTable();
+        return *table;
+    }
+}
+
+Name::Name(StringView text)
+    : m_id(GetNameTable().Intern(text))
+{
+
+}
+
+Name::Name(const char* text)
+    : Name(StringView(text))
+{
+
+}
+
+Name::Name(const String& text)
+    : Name(text.View())
+{
+
+}
+
+Name Name::Find(StringView text)
+{
+    return Name(GetNameTable().Find(text));
+}
+
+int64 Name::GetCount()
+{
+    return GetNameTable().GetCount();
+}
+
+StringView Name::View() const noexcept
+{
+    if (m_id == 0)
+    {
+        return StringView();
+    }
+    const NameEntry* entry = GetNameTable().GetEntry(m_id);
+    return StringView(entry->Data(), entry->Size);
+}
+
+String Name::ToString() const
+{
+    return String(View());
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Core.h"
+#include "String/String.h"
+#include "String/StringView.h"
+
+#include <compare>
+#include <functional>
+
+/// <summary>
+/// 驻留字符串名称
+/// <para>相同文本在全局驻留表中只保存一份，Name 本身只是一个 32 位编号，比较和哈希都是整数运算</para>
+/// <para>驻留表线程安全：查找已存在的名称不加锁，只有首次插入时加锁；文本存放在只增不减的内存块中，地址在进程生命周期内保持不变</para>
+/// <para>适用于资源路径、属性名、事件标识等比较远多于创建的场合；名称大小关系按编号而不是按字典序</para>
+/// </summary>
+class Name
+{
+public:
+    /// <summary>
+    /// 默认构造函数，构造空名称(编号为 0)
+    /// </summary>
+    constexpr Name() noexcept = default;
+    /// <summary>
+    /// 驻留文本并构造名称，空文本得到空名称
+    /// </summary>
+    /// <param name="text">文本</param>
+    explicit Name(StringView text);
+    /// <summary>
+    /// 驻留 C 风格字符串并构造名称
+    /// </summary>
+    explicit Name(const char* text);
+    /// <summary>
+    /// 驻留字符串并构造名称
+    /// </summary>
+    explicit Name(const String& text);
+public:
+    /// <summary>
+    /// 查找已驻留的名称，不会插入新文本(不加锁)
+    /// </summary>
+    /// <param name="text">文本</param>
+    /// <returns>未驻留时返回空名称</returns>
+    static Name Find(StringView text);
+    /// <summary>
+    /// 获取已驻留的名称数量
+    /// </summary>
+    static int64 GetCount();
+public:
+    /// <summary>
+    /// 获取编号
+    /// </summary>
+    constexpr uint32 Id() const noexcept
+    {
+        return m_id;
+    }
+    /// <summary>
+    /// 判断是否为空名称
+    /// </summary>
+    constexpr bool IsNone() const noexcept
+    {
+        return m_id == 0;
+    }
+    /// <summary>
+    /// 获取驻留的文本(以 '\0' 结尾，在进程生命周期内有效)
+    /// </summary>
+    StringView View() const noexcept;
+    /// <summary>
+    /// 复制出驻留的文本
+    /// </summary>
+    String ToString() const;
+    /// <summary>
+    /// 获取哈希值(由编号混合得到，不读取文本)
+    /// </summary>
+    constexpr uint64 GetHash() const noexcept
+    {
+        return static_cast<uint64>(m_id) * 0x9E3779B97F4A7C15ull;
+    }
+public:
+    friend constexpr bool operator==(Name left, Name right) noexcept
+    {
+        return left.m_id == right.m_id;
+    }
+
+    friend constexpr auto operator<=>(Name left, Name right) noexcept
+    {
+        return left.m_id <=> right.m_id;
+    }
+private:
+    /// <summary>
+    /// 由编号构造
+    /// </summary>
+    constexpr explicit Name(uint32 id) noexcept
+        : m_id(id)
+    {
+
+    }
+private:
+    // 驻留表中的编号，0 表示空名称
+    uint32 m_id = 0;
+};
+
+template<>
+struct std::hash<Name>
+{
+    size_t operator()(Name name) const noexcept
+    {
+        return static_cast<size_t>(name.GetHash());
+    }
+};
@@ -0,0 +1,1684 @@
+#include "pch.h"
+
+#include "Regex.h"
+#include "StringBuilder.h"
+#include "Container/LruCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    /// <summary>
+    /// 虚拟机指令类型
+    /// </summary>
+    enum class RegexOp : uint8
+    {
+        // 匹配码点 X
+        Char,
+        // 匹配任意码点
+        Any,
+        // 匹配 '\n' 以外的任意码点
+        AnyNotNewline,
+        // 匹配字符类 X
+        Class,
+        // 分叉到 X(优先)与 Y
+        Split,
+        // 跳转到 X
+        Jump,
+        // 记录当前位置到捕获槽 X
+        Save,
+        // 零宽断言 X
+        Assert,
+        // 记录当前位置到循环寄存器 X(可选的一次重复开始)
+        Mark,
+        // 当前位置等于循环寄存器 X(本次重复没有消耗字符)时跳转到 Y，不再重复
+        Check,
+        // 匹配成功
+        Match
+    };
+    /// <summary>
+    /// 零宽断言类型
+    /// </summary>
+    enum class RegexAssert : int32
+    {
+        // 行首(^)
+        LineBegin,
+        // 行尾($)
+        LineEnd,
+        // 文本开头(\A，或非多行模式下的 ^)
+        TextBegin,
+        // 文本结尾(\z，或非多行模式下的 $)
+        TextEnd,
+        // 单词边界(\b)
+        WordBoundary,
+        // 非单词边界(\B)
+        NotWordBoundary
+    };
+    /// <summary>
+    /// 语法树节点类型
+    /// </summary>
+    enum class RegexNodeType : uint8
+    {
+        Empty,
+        Literal,
+        Any,
+        Class,
+        Assert,
+        Concat,
+        Alternate,
+        Group,
+        Repeat
+    };
+
+    struct RegexInst
+    {
+        RegexOp Op;
+        int32 X;
+        int32 Y;
+        // 所在的最内层可空重复(一次展开)，-1 表示不在其中或为消耗字符的指令
+        int32 Loop = -1;
+        // 线程列表中第一个状态的编号
+        int32 Key = 0;
+    };
+    /// <summary>
+    /// 可空重复体的一次展开：Mark 与 Check 之间的指令
+    /// </summary>
+    struct RegexLoop
+    {
+        // 循环寄存器
+        int32 Register;
+        // 外层的可空重复展开，-1 表示没有
+        int32 Parent;
+    };
+    /// <summary>
+    /// 字符类：有序且互不相交的闭区间，ASCII 部分另存位图
+    /// </summary>
+    struct RegexClass
+    {
+        Array<uint32> Ranges;
+        uint64 Ascii[2] = {};
+
+        bool Contains(uint32 c) const
+        {
+            if (c < 128)
+            {
+                return (Ascii[c >> 6] >> (c & 63)) & 1;
+            }
+            // 二分查找第一个上界不小于 c 的区间
+            int64 low = 0;
+            int64 high = Ranges.Size() / 2;
+            while (low < high)
+            {
+                int64 mid = (low + high) / 2;
+                if (Ranges[mid * 2 + 1] < c)
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            return low < Ranges.Size() / 2 && Ranges[low * 2] <= c;
+        }
+    };
+
+    struct RegexNode
+    {
+        RegexNodeType Type = RegexNodeType::Empty;
+        int32 Value = 0;
+        int32 Min = 0;
+        int32 Max = 0;
+        bool Greedy = true;
+        // 重复体可以匹配空串时使用的循环寄存器，-1 表示尚未分配
+        int32 Loop = -1;
+        Array<int32> Children;
+    };
+
+    constexpr uint32 MAX_CODEPOINT = 0x10FFFF;
+    // 无效 UTF-8 字节解码后的值，不属于任何字符类，只能被 . 匹配
+    constexpr uint32 INVALID_CODEPOINT = 0x110000;
+    // {n,m} 中允许的最大次数
+    constexpr int32 MAX_REPEAT = 1000;
+    // 线程状态的最大数量，防止可空重复嵌套过深时占用过多内存
+    constexpr int64 MAX_STATES = 1 << 17;
+    // 分组的最大嵌套层数，解析与生成指令都是递归的，防止栈溢出
+    constexpr int32 MAX_NESTING = 1000;
+    // 程序的最大指令数，防止重复展开后占用过多内存
+    constexpr int64 MAX_INSTRUCTIONS = 1 << 16;
+
+    inline uint32 DecodeAt(const unsigned char* ptr, int64 available, int32& length)
+    {
+        uint32 lead = ptr[0];
+        if (lead < 0x80)
+        {
+            length = 1;
+            return lead;
+        }
+
+        int32 size;
+        uint32 value;
+        uint32 minimum;
+        if ((lead & 0xE0) == 0xC0)
+        {
+            size = 2;
+            value = lead & 0x1F;
+            minimum = 0x80;
+        }
+        else if ((lead & 0xF0) == 0xE0)
+        {
+            size = 3;
+            value = lead & 0x0F;
+            minimum = 0x800;
+        }
+        else if ((lead & 0xF8) == 0xF0)
+        {
+            size = 4;
+            value = lead & 0x07;
+            minimum = 0x10000;
+        }
+        else
+        {
+            length = 1;
+            return INVALID_CODEPOINT;
+        }
+
+        if (size > available)
+        {
+            length = 1;
+            return INVALID_CODEPOINT;
+        }
+        for (int32 i = 1; i < size; ++i)
+        {
+            if ((ptr[i] & 0xC0) != 0x80)
+            {
+                length = 1;
+                return INVALID_CODEPOINT;
+            }
+            value = (value << 6) | (ptr[i] & 0x3F);
+        }
+        if (value < minimum || value > MAX_CODEPOINT || (value >= 0xD800 && value <= 0xDFFF))
+        {
+            length = 1;
+            return INVALID_CODEPOINT;
+        }
+        length = size;
+        return value;
+    }
+
+    inline void EncodeTo(std::string& out, uint32 c)
+    {
+        if (c < 0x80)
+        {
+            out += static_cast<char>(c);
+        }
+        else if (c < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    inline bool IsWordByte(char ch)
+    {
+        return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+    }
+
+    inline void AddRange(Array<uint32>& ranges, uint32 low, uint32 high)
+    {
+        ranges.Push(low);
+        ranges.Push(high);
+    }
+    /// <summary>
+    /// 添加 \d \w \s 对应的区间
+    /// </summary>
+    void AddPerlClass(Array<uint32>& ranges, char kind)
+    {
+        switch (kind)
+        {
+        case 'd':
+            AddRange(ranges, '0', '9');
+            break;
+        case 'w':
+            AddRange(ranges, '0', '9');
+            AddRange(ranges, 'A', 'Z');
+            AddRange(ranges, '_', '_');
+            AddRange(ranges, 'a', 'z');
+            break;
+        case 's':
+            AddRange(ranges, '\t', '\r');
+            AddRange(ranges, ' ', ' ');
+            break;
+        }
+    }
+    /// <summary>
+    /// 排序并合并相交或相邻的区间
+    /// </summary>
+    void NormalizeRanges(Array<uint32>& ranges)
+    {
+        int64 count = ranges.Size() / 2;
+        Array<std::pair<uint32, uint32>> pairs;
+        pairs.Reserve(count);
+        for (int64 i = 0; i < count; ++i)
+        {
+            pairs.Push({ ranges[i * 2], ranges[i * 2 + 1] });
+        }
+        std::sort(pairs.begin(), pairs.end());
+
+        ranges.Clear();
+        for (const auto& [low, high] : pairs)
+        {
+            if (!ranges.IsEmpty() && low <= ranges.Back() + 1)
+            {
+                ranges.Back() = std::max(ranges.Back(), high);
+            }
+            else
+            {
+                AddRange(ranges, low, high);
+            }
+        }
+    }
+    /// <summary>
+    /// 取补集(在 [0, MAX_CODEPOINT] 内)
+    /// </summary>
+    void NegateRanges(Array<uint32>& ranges)
+    {
+        NormalizeRanges(ranges);
+        Array<uint32> result;
+        uint32 next = 0;
+        for (int64 i = 0; i < ranges.Size(); i += 2)
+        {
+            if (ranges[i] > next)
+            {
+                AddRange(result, next, ranges[i] - 1);
+            }
+            next = ranges[i + 1] + 1;
+        }
+        if (next <= MAX_CODEPOINT)
+        {
+            AddRange(result, next, MAX_CODEPOINT);
+        }
+        ranges = std::move(result);
+    }
+    /// <summary>
+    /// 为区间内的 ASCII 字母补上另一种大小写
+    /// </summary>
+    void FoldRanges(Array<uint32>& ranges)
+    {
+        int64 count = ranges.Size() / 2;
+        for (int64 i = 0; i < count; ++i)
+        {
+            uint32 low = ranges[i * 2];
+            uint32 high = ranges[i * 2 + 1];
+            uint32 lowerLow = std::max<uint32>(low, 'a');
+            uint32 lowerHigh = std::min<uint32>(high, 'z');
+            if (lowerLow <= lowerHigh)
+            {
+                AddRange(ranges, lowerLow - 32, lowerHigh - 32);
+            }
+            uint32 upperLow = std::max<uint32>(low, 'A');
+            uint32 upperHigh = std::min<uint32>(high, 'Z');
+            if (upperLow <= upperHigh)
+            {
+                AddRange(ranges, upperLow + 32, upperHigh + 32);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// 编译后的正则表达式程序(不可变，可在线程间共享)
+/// </summary>
+class RegexProgram
+{
+public:
+    RegexProgram(StringView pattern, RegexFlag flags);
+public:
+    /// <summary>
+    /// 在 text 中从 start 开始查找
+    /// </summary>
+    /// <param name="full">是否要求从 start 开始匹配到文本末尾</param>
+    bool Search(StringView text, int64 start, bool full, int64* slots, int32 slotCount) const;
+public:
+    // 模式
+    String Pattern;
+    // 选项
+    RegexFlag Flags;
+    // 编译错误信息
+    String Error;
+    // 捕获组数量(含第 0 组)
+    int32 GroupCount = 1;
+    // 循环寄存器数量，存放在每个线程的捕获槽之后
+    int32 LoopCount = 0;
+private:
+    /// <summary>
+    /// 线程列表：稀疏集合保证每个状态只出现一次，顺序即优先级
+    /// <para>状态为指令加上从内向外有多少层可空重复在当前位置刚开始本次重复，这几层的 Check 结果不同，不能合并</para>
+    /// </summary>
+    struct ThreadList
+    {
+        Array<int32> Sparse;
+        Array<int32> Dense;
+        Array<int32> Pcs;
+        Array<int64> Caps;
+        int32 Size = 0;
+    };
+    /// <summary>
+    /// 每个线程复用的匹配工作区
+    /// </summary>
+    struct Scratch
+    {
+        ThreadList Lists[2];
+        // 深度优先展开空转移时的栈，Slot 不小于 0 表示恢复捕获槽
+        Array<std::pair<int32, int64>> Stack;
+        Array<int64> Caps;
+    };
+private:
+    int32 _Parse();
+    int32 _ParseAlternate();
+    int32 _ParseConcat();
+    int32 _ParseRepeat(int32 atom, bool group);
+    int32 _ParseAtom();
+    int32 _ParseClass();
+    bool _ParseEscape(uint32& c, Array<uint32>* ranges, bool inClass);
+    bool _ParseCount(int32& min, int32& max);
+    bool _Next(uint32& c);
+    bool _Peek(uint32& c) const;
+    int32 _NewNode(RegexNodeType type, int32 value = 0);
+    int32 _NewClass(Array<uint32>&& ranges, bool fold);
+    bool _Fail(const char* message);
+
+    void _Emit(int32 node);
+    void _EmitIteration(int32 node);
+    bool _CanBeEmpty(int32 node) const;
+    int32 _Add(RegexOp op, int32 x = 0, int32 y = 0);
+    void _AssignKeys();
+    int32 _KeyOf(int32 pc, int64 pos, const int64* caps, int32 slotCount) const;
+    void _Analyze(int32 root);
+
+    void _AddThread(ThreadList& list, Scratch& scratch, int32 pc, int64 pos, int64* caps, int32 slotCount, StringView text) const;
+    bool _CheckAssert(RegexAssert kind, StringView text, int64 pos) const;
+private:
+    // 指令
+    Array<RegexInst> m_insts;
+    // 可空重复的展开
+    Array<RegexLoop> m_loops;
+    // 线程状态数
+    int32 m_keyCount = 0;
+    // 字符类
+    Array<RegexClass> m_classes;
+    // 所有匹配都必须以此开头(用于跳过不可能匹配的位置)
+    std::string m_prefix;
+    // 整个模式是否为纯字面量
+    bool m_literal = false;
+    // 是否只能从文本开头匹配
+    bool m_anchored = false;
+
+    // 以下仅在编译期间使用
+    Array<RegexNode> m_nodes;
+    int64 m_pos = 0;
+    // 当前分组的嵌套层数
+    int32 m_depth = 0;
+    // 正在生成的最内层可空重复展开
+    int32 m_loop = -1;
+};
+
+RegexProgram::RegexProgram(StringView pattern, RegexFlag flags)
+    : Pattern(pattern)
+    , Flags(flags)
+{
+    int32 root = _Parse();
+    if (Error.IsEmpty())
+    {
+        _Add(RegexOp::Save, 0);
+        _Emit(root);
+        _Add(RegexOp::Save, 1);
+        _Add(RegexOp::Match);
+        if (m_insts.Size() > MAX_INSTRUCTIONS)
+        {
+            _Fail("Pattern is too large");
+        }
+        else
+        {
+            _AssignKeys();
+        }
+    }
+    if (Error.IsEmpty())
+    {
+        _Analyze(root);
+    }
+    else
+    {
+        m_insts.Clear();
+    }
+    m_nodes.Reset();
+}
+
+bool RegexProgram::_Fail(const char* message)
+{
+    if (Error.IsEmpty())
+    {
+        Error = message;
+    }
+    return false;
+}
+
+bool RegexProgram::_Peek(uint32& c) const
+{
+    if (m_pos >= Pattern.Size())
+    {
+        return false;
+    }
+    int32 length;
+    c = DecodeAt(reinterpret_cast<const unsigned char*>(Pattern.Data() + m_pos), Pattern.Size() - m_pos, length);
+    return true;
+}
+
+bool RegexProgram::_Next(uint32& c)
+{
+    if (m_pos >= Pattern.Size())
+    {
+        return false;
+    }
+    int32 length;
+    c = DecodeAt(reinterpret_cast<const unsigned char*>(Pattern.Data() + m_pos), Pattern.Size() - m_pos, length);
+    m_pos += length;
+    if (c == INVALID_CODEPOINT)
+    {
+        return _Fail("Pattern is not valid UTF-8");
+    }
+    return true;
+}
+
+int32 RegexProgram::_NewNode(RegexNodeType type, int32 value)
+{
+    RegexNode node;
+    node.Type = type;
+    node.Value = value;
+    m_nodes.Push(std::move(node));
+    return static_cast<int32>(m_nodes.Size() - 1);
+}
+
+int32 RegexProgram::_NewClass(Array<uint32>&& ranges, bool fold)
+{
+    if (fold)
+    {
+        FoldRanges(ranges);
+    }
+    NormalizeRanges(ranges);
+
+    RegexClass cls;
+    for (int64 i = 0; i < ranges.Size(); i += 2)
+    {
+        for (uint32 c = ranges[i]; c <= ranges[i + 1] && c < 128; ++c)
+        {
+            cls.Ascii[c >> 6] |= uint64(1) << (c & 63);
+        }
+    }
+    cls.Ranges = std::move(ranges);
+    m_classes.Push(std::move(cls));
+    return _NewNode(RegexNodeType::Class, static_cast<int32>(m_classes.Size() - 1));
+}
+
+int32 RegexProgram::_Parse()
+{
+    int32 root = _ParseAlternate();
+    if (Error.IsEmpty() && m_pos < Pattern.Size())
+    {
+        _Fail("Unmatched ')'");
+    }
+    return root;
+}
+
+int32 RegexProgram::_ParseAlternate()
+{
+    int32 first = _ParseConcat();
+    uint32 c;
+    if (!_Peek(c) || c != '|')
+    {
+        return first;
+    }
+
+    Array<int32> branches;
+    branches.Push(first);
+    while (Error.IsEmpty() && _Peek(c) && c == '|')
+    {
+        m_pos++;
+        branches.Push(_ParseConcat());
+    }
+    int32 node = _NewNode(RegexNodeType::Alternate);
+    m_nodes[node].Children = std::move(branches);
+    return node;
+}
+
+int32 RegexProgram::_ParseConcat()
+{
+    Array<int32> items;
+    uint32 c;
+    while (Error.IsEmpty() && _Peek(c) && c != '|' && c != ')')
+    {
+        bool group = c == '(';
+        int32 atom = _ParseAtom();
+        if (!Error.IsEmpty())
+        {
+            break;
+        }
+        items.Push(_ParseRepeat(atom, group));
+    }
+
+    if (items.Size() == 1)
+    {
+        return items[0];
+    }
+    int32 node = _NewNode(items.IsEmpty() ? RegexNodeType::Empty : RegexNodeType::Concat);
+    m_nodes[node].Children = std::move(items);
+    return node;
+}
+
+int32 RegexProgram::_ParseRepeat(int32 atom, bool group)
+{
+    uint32 c;
+    if (!Error.IsEmpty() || !_Peek(c))
+    {
+        return atom;
+    }
+
+    int32 min;
+    int32 max;
+    if (c == '*' || c == '+' || c == '?')
+    {
+        m_pos++;
+        min = c == '+' ? 1 : 0;
+        max = c == '?' ? 1 : -1;
+    }
+    else if (c == '{')
+    {
+        // 不是合法的 {n,m} 时按字面量 '{' 处理
+        int64 saved = m_pos;
+        m_pos++;
+        if (!_ParseCount(min, max))
+        {
+            m_pos = saved;
+            return atom;
+        }
+    }
+    else
+    {
+        return atom;
+    }
+
+    // 与 Python 相同，单独的断言不能重复，放在分组中可以，如 (?:\b)+
+    if (!group && (m_nodes[atom].Type == RegexNodeType::Empty || m_nodes[atom].Type == RegexNodeType::Assert))
+    {
+        _Fail("Nothing to repeat");
+        return atom;
+    }
+    if (min > MAX_REPEAT || max > MAX_REPEAT)
+    {
+        _Fail("Repeat count is too large");
+        return atom;
+    }
+    if (max >= 0 && max < min)
+    {
+        _Fail("Invalid repeat range");
+        return atom;
+    }
+
+    bool greedy = true;
+    if (_Peek(c) && c == '?')
+    {
+        m_pos++;
+        greedy = false;
+    }
+    if (_Peek(c) && (c == '*' || c == '+' || c == '?'))
+    {
+        _Fail("Nested quantifier");
+        return atom;
+    }
+
+    int32 node = _NewNode(RegexNodeType::Repeat);
+    m_nodes[node].Min = min;
+    m_nodes[node].Max = max;
+    m_nodes[node].Greedy = greedy;
+    m_nodes[node].Children.Push(atom);
+    return node;
+}
+
+bool RegexProgram::_ParseCount(int32& min, int32& max)
+{
+    auto parseNumber = [this](int32& value) -> bool
+    {
+        int64 start = m_pos;
+        int64 result = 0;
+        while (m_pos < Pattern.Size() && Pattern.Data()[m_pos] >= '0' && Pattern.Data()[m_pos] <= '9')
+        {
+            result = std::min<int64>(result * 10 + (Pattern.Data()[m_pos] - '0'), MAX_REPEAT + 1);
+            m_pos++;
+        }
+        value = static_cast<int32>(result);
+        return m_pos > start;
+    };
+
+    if (!parseNumber(min))
+    {
+        return false;
+    }
+    max = min;
+    if (m_pos < Pattern.Size() && Pattern.Data()[m_pos] == ',')
+    {
+        m_pos++;
+        if (!parseNumber(max))
+        {
+            max = -1;
+        }
+    }
+    if (m_pos >= Pattern.Size() || Pattern.Data()[m_pos] != '}')
+    {
+        return false;
+    }
+    m_pos++;
+    return true;
+}
+
+int32 RegexProgram::_ParseAtom()
+{
+    uint32 c;
+    _Next(c);
+    switch (c)
+    {
+    case '(':
+    {
+        if (m_depth >= MAX_NESTING)
+        {
+            _Fail("Pattern is too deeply nested");
+            return _NewNode(RegexNodeType::Empty);
+        }
+        int32 group = -1;
+        if (m_pos + 1 < Pattern.Size() && Pattern.Data()[m_pos] == '?')
+        {
+            if (Pattern.Data()[m_pos + 1] != ':')
+            {
+                _Fail("Unsupported group syntax");
+                return _NewNode(RegexNodeType::Empty);
+            }
+            m_pos += 2;
+        }
+        else
+        {
+            group = GroupCount++;
+        }
+
+        m_depth++;
+        int32 inner = _ParseAlternate();
+        m_depth--;
+        uint32 close;
+        if (!_Next(close) || close != ')')
+        {
+            _Fail("Missing ')'");
+            return inner;
+        }
+        if (group < 0)
+        {
+            return inner;
+        }
+        int32 node = _NewNode(RegexNodeType::Group, group);
+        m_nodes[node].Children.Push(inner);
+        return node;
+    }
+    case '[':
+        return _ParseClass();
+    case '.':
+        return _NewNode(RegexNodeType::Any);
+    case '^':
+        return _NewNode(RegexNodeType::Assert, static_cast<int32>((Flags & RegexFlag::Multiline) ? RegexAssert::LineBegin : RegexAssert::TextBegin));
+    case '$':
+        return _NewNode(RegexNodeType::Assert, static_cast<int32>((Flags & RegexFlag::Multiline) ? RegexAssert::LineEnd : RegexAssert::TextEnd));
+    case '*':
+    case '+':
+    case '?':
+        _Fail("Nothing to repeat");
+        return _NewNode(RegexNodeType::Empty);
+    case '\\':
+    {
+        if (m_pos < Pattern.Size())
+        {
+            switch (Pattern.Data()[m_pos])
+            {
+            case 'b':
+                m_pos++;
+                return _NewNode(RegexNodeType::Assert, static_cast<int32>(RegexAssert::WordBoundary));
+            case 'B':
+                m_pos++;
+                return _NewNode(RegexNodeType::Assert, static_cast<int32>(RegexAssert::NotWordBoundary));
+            case 'A':
+                m_pos++;
+                return _NewNode(RegexNodeType::Assert, static_cast<int32>(RegexAssert::TextBegin));
+            case 'z':
+                m_pos++;
+                return _NewNode(RegexNodeType::Assert, static_cast<int32>(RegexAssert::TextEnd));
+            }
+        }
+        Array<uint32> ranges;
+        uint32 value;
+        if (!_ParseEscape(value, &ranges, false))
+        {
+            return _NewNode(RegexNodeType::Empty);
+        }
+        if (!ranges.IsEmpty())
+        {
+            return _NewClass(std::move(ranges), Flags & RegexFlag::IgnoreCase);
+        }
+        c = value;
+        break;
+    }
+    default:
+        break;
+    }
+
+    // 忽略大小写时字母以字符类表示
+    if ((Flags & RegexFlag::IgnoreCase) && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')))
+    {
+        Array<uint32> ranges;
+        AddRange(ranges, c, c);
+        return _NewClass(std::move(ranges), true);
+    }
+    return _NewNode(RegexNodeType::Literal, static_cast<int32>(c));
+}
+
+int32 RegexProgram::_ParseClass()
+{
+    Array<uint32> ranges;
+    bool negate = false;
+    uint32 c;
+    if (_Peek(c) && c == '^')
+    {
+        m_pos++;
+        negate = true;
+    }
+
+    bool first = true;
+    while (true)
+    {
+        if (!_Next(c))
+        {
+            _Fail("Missing ']'");
+            return _NewNode(RegexNodeType::Empty);
+        }
+        // 开头的 ']' 按字面量处理
+        if (c == ']' && !first)
+        {
+            break;
+        }
+        first = false;
+
+        uint32 low = c;
+        if (c == '\\')
+        {
+            int64 before = ranges.Size();
+            if (!_ParseEscape(low, &ranges, true))
+            {
+                return _NewNode(RegexNodeType::Empty);
+            }
+            if (ranges.Size() != before)
+            {
+                continue;
+            }
+        }
+
+        uint32 high = low;
+        uint32 dash;
+        if (_Peek(dash) && dash == '-' && m_pos + 1 < Pattern.Size() && Pattern.Data()[m_pos + 1] != ']')
+        {
+            m_pos++;
+            _Next(high);
+            if (high == '\\')
+            {
+                Array<uint32> perl;
+                if (!_ParseEscape(high, &perl, true) || !perl.IsEmpty())
+                {
+                    _Fail("Invalid character class range");
+                    return _NewNode(RegexNodeType::Empty);
+                }
+            }
+            if (high < low)
+            {
+                _Fail("Invalid character class range");
+                return _NewNode(RegexNodeType::Empty);
+            }
+        }
+        AddRange(ranges, low, high);
+    }
+
+    if (Flags & RegexFlag::IgnoreCase)
+    {
+        FoldRanges(ranges);
+    }
+    if (negate)
+    {
+        NegateRanges(ranges);
+    }
+    // 大小写已在取反之前展开
+    return _NewClass(std::move(ranges), false);
+}
+
+bool RegexProgram::_ParseEscape(uint32& c, Array<uint32>* ranges, bool inClass)
+{
+    if (!_Next(c))
+    {
+        return _Fail("Trailing '\\'");
+    }
+
+    switch (c)
+    {
+    case 'd':
+    case 'w':
+    case 's':
+        AddPerlClass(*ranges, static_cast<char>(c));
+        return true;
+    case 'D':
+    case 'W':
+    case 'S':
+    {
+        Array<uint32> perl;
+        AddPerlClass(perl, static_cast<char>(c + 32));
+        NegateRanges(perl);
+        for (uint32 value : perl)
+        {
+            ranges->Push(value);
+        }
+        return true;
+    }
+    case 't':
+        c = '\t';
+        return true;
+    case 'n':
+        c = '\n';
+        return true;
+    case 'r':
+        c = '\r';
+        return true;
+    case 'f':
+        c = '\f';
+        return true;
+    case 'v':
+        c = '\v';
+        return true;
+    case '0':
+        c = 0;
+        return true;
+    case 'b':
+        // 字符类中的 \b 表示退格
+        if (inClass)
+        {
+            c = '\b';
+            return true;
+        }
+        break;
+    case 'x':
+    case 'u':
+    {
+        // \xHH、\uHHHH 或 \x{H...}
+        bool braced = c == 'x' && m_pos < Pattern.Size() && Pattern.Data()[m_pos] == '{';
+        int32 digits = braced ? 6 : (c == 'x' ? 2 : 4);
+        if (braced)
+        {
+            m_pos++;
+        }
+        uint32 value = 0;
+        int32 count = 0;
+        while (count < digits && m_pos < Pattern.Size())
+        {
+            char ch = Pattern.Data()[m_pos];
+            uint32 digit;
+            if (ch >= '0' && ch <= '9')
+            {
+                digit = ch - '0';
+            }
+            else if ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f')
+            {
+                digit = (ch | 0x20) - 'a' + 10;
+            }
+            else
+            {
+                break;
+            }
+            value = value * 16 + digit;
+            count++;
+            m_pos++;
+        }
+        if (braced)
+        {
+            if (m_pos >= Pattern.Size() || Pattern.Data()[m_pos] != '}' || count == 0)
+            {
+                return _Fail("Invalid hexadecimal escape");
+            }
+            m_pos++;
+        }
+        else if (count != digits)
+        {
+            return _Fail("Invalid hexadecimal escape");
+        }
+        if (value > MAX_CODEPOINT)
+        {
+            return _Fail("Invalid hexadecimal escape");
+        }
+        c = value;
+        return true;
+    }
+    default:
+        break;
+    }
+
+    // 其余字母数字(包括反向引用 \1)不支持，标点按字面量处理
+    if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+    {
+        return _Fail("Unsupported escape sequence");
+    }
+    return true;
+}
+
+int32 RegexProgram::_Add(RegexOp op, int32 x, int32 y)
+{
+    // 消耗字符的指令之后位置前进，不再区分重复是否刚开始
+    bool consuming = op == RegexOp::Char || op == RegexOp::Any || op == RegexOp::AnyNotNewline || op == RegexOp::Class || op == RegexOp::Match;
+    m_insts.Push(RegexInst{ op, x, y, consuming ? -1 : m_loop });
+    return static_cast<int32>(m_insts.Size() - 1);
+}
+
+void RegexProgram::_AssignKeys()
+{
+    // 每条指令占 1 + 所在可空重复层数个状态
+    int64 key = 0;
+    for (RegexInst& inst : m_insts)
+    {
+        inst.Key = static_cast<int32>(key);
+        key++;
+        for (int32 loop = inst.Loop; loop >= 0; loop = m_loops[loop].Parent)
+        {
+            key++;
+        }
+        if (key > MAX_STATES)
+        {
+            _Fail("Pattern is too large");
+            return;
+        }
+    }
+    m_keyCount = static_cast<int32>(key);
+}
+
+int32 RegexProgram::_KeyOf(int32 pc, int64 pos, const int64* caps, int32 slotCount) const
+{
+    // 刚开始的重复从内向外连续：外层在当前位置开始时，其中的内层也只能在当前位置开始
+    const RegexInst& inst = m_insts[pc];
+    int32 key = inst.Key;
+    for (int32 loop = inst.Loop; loop >= 0 && caps[slotCount + m_loops[loop].Register] == pos; loop = m_loops[loop].Parent)
+    {
+        key++;
+    }
+    return key;
+}
+
+void RegexProgram::_Emit(int32 index)
+{
+    if (m_insts.Size() > MAX_INSTRUCTIONS)
+    {
+        return;
+    }
+
+    // 生成指令期间 m_nodes 不再增长，可以持有节点引用
+    const RegexNode& node = m_nodes[index];
+    switch (node.Type)
+    {
+    case RegexNodeType::Empty:
+        break;
+    case RegexNodeType::Literal:
+        _Add(RegexOp::Char, node.Value);
+        break;
+    case RegexNodeType::Any:
+        _Add((Flags & RegexFlag::DotAll) ? RegexOp::Any : RegexOp::AnyNotNewline);
+        break;
+    case RegexNodeType::Class:
+        _Add(RegexOp::Class, node.Value);
+        break;
+    case RegexNodeType::Assert:
+        _Add(RegexOp::Assert, node.Value);
+        break;
+    case RegexNodeType::Concat:
+        for (int32 child : node.Children)
+        {
+            _Emit(child);
+        }
+        break;
+    case RegexNodeType::Alternate:
+    {
+        // split L1, next; L1: a; jmp end; next: split L2, ...
+        Array<int32> jumps;
+        for (int64 i = 0; i < node.Children.Size(); ++i)
+        {
+            if (i + 1 < node.Children.Size())
+            {
+                int32 split = _Add(RegexOp::Split);
+                m_insts[split].X = split + 1;
+                _Emit(node.Children[i]);
+                jumps.Push(_Add(RegexOp::Jump));
+                m_insts[split].Y = static_cast<int32>(m_insts.Size());
+            }
+            else
+            {
+                _Emit(node.Children[i]);
+            }
+        }
+        for (int32 jump : jumps)
+        {
+            m_insts[jump].X = static_cast<int32>(m_insts.Size());
+        }
+        break;
+    }
+    case RegexNodeType::Group:
+        _Add(RegexOp::Save, node.Value * 2);
+        _Emit(node.Children[0]);
+        _Add(RegexOp::Save, node.Value * 2 + 1);
+        break;
+    case RegexNodeType::Repeat:
+    {
+        int32 child = node.Children[0];
+        for (int32 i = 0; i < node.Min; ++i)
+        {
+            _Emit(child);
+        }
+        // 与 Perl/Python 相同，可选的一次重复没有消耗字符时结束重复，Check 跳转到 end，稍后回填
+        Array<int32> checks;
+        if (node.Max < 0)
+        {
+            // L: split body, end; body; jmp L
+            int32 split = _Add(RegexOp::Split);
+            _EmitIteration(index);
+            if (m_nodes[index].Loop >= 0)
+            {
+                checks.Push(static_cast<int32>(m_insts.Size() - 1));
+            }
+            _Add(RegexOp::Jump, split);
+            int32 end = static_cast<int32>(m_insts.Size());
+            m_insts[split].X = node.Greedy ? split + 1 : end;
+            m_insts[split].Y = node.Greedy ? end : split + 1;
+        }
+        else
+        {
+            // 可选部分嵌套展开：split body, end; body; split body, end; body ...
+            Array<int32> splits;
+            for (int32 i = node.Min; i < node.Max; ++i)
+            {
+                splits.Push(_Add(RegexOp::Split));
+                _EmitIteration(index);
+                if (m_nodes[index].Loop >= 0)
+                {
+                    checks.Push(static_cast<int32>(m_insts.Size() - 1));
+                }
+            }
+            int32 end = static_cast<int32>(m_insts.Size());
+            for (int32 split : splits)
+            {
+                m_insts[split].X = node.Greedy ? split + 1 : end;
+                m_insts[split].Y = node.Greedy ? end : split + 1;
+            }
+        }
+        for (int32 check : checks)
+        {
+            m_insts[check].Y = static_cast<int32>(m_insts.Size());
+        }
+        break;
+    }
+    }
+}
+
+void RegexProgram::_EmitIteration(int32 index)
+{
+    // 重复体不能匹配空串时无需检查
+    int32 child = m_nodes[index].Children[0];
+    if (!_CanBeEmpty(child))
+    {
+        _Emit(child);
+        return;
+    }
+
+    // mark k; body; check k, end
+    // 同一节点的多次展开不会同时进行，共用一个循环寄存器
+    if (m_nodes[index].Loop < 0)
+    {
+        m_nodes[index].Loop = LoopCount++;
+    }
+    int32 reg = m_nodes[index].Loop;
+    _Add(RegexOp::Mark, reg);
+    int32 parent = m_loop;
+    m_loops.Push(RegexLoop{ reg, parent });
+    m_loop = static_cast<int32>(m_loops.Size() - 1);
+    _Emit(child);
+    _Add(RegexOp::Check, reg);
+    m_loop = parent;
+}
+
+bool RegexProgram::_CanBeEmpty(int32 index) const
+{
+    const RegexNode& node = m_nodes[index];
+    switch (node.Type)
+    {
+    case RegexNodeType::Empty:
+    case RegexNodeType::Assert:
+        return true;
+    case RegexNodeType::Literal:
+    case RegexNodeType::Any:
+    case RegexNodeType::Class:
+        return false;
+    case RegexNodeType::Concat:
+        return std::all_of(node.Children.begin(), node.Children.end(), [this](int32 child) { return _CanBeEmpty(child); });
+    case RegexNodeType::Alternate:
+        return std::any_of(node.Children.begin(), node.Children.end(), [this](int32 child) { return _CanBeEmpty(child); });
+    case RegexNodeType::Group:
+        return _CanBeEmpty(node.Children[0]);
+    case RegexNodeType::Repeat:
+        return node.Min == 0 || _CanBeEmpty(node.Children[0]);
+    }
+    return true;
+}
+
+void RegexProgram::_Analyze(int32 root)
+{
+    // 取出顶层连接开头的字面量作为前缀
+    const RegexNode& node = m_nodes[root];
+    Array<int32> items;
+    if (node.Type == RegexNodeType::Concat)
+    {
+        items = node.Children;
+    }
+    else
+    {
+        items.Push(root);
+    }
+
+    int64 literals = 0;
+    for (int32 item : items)
+    {
+        if (m_nodes[item].Type != RegexNodeType::Literal)
+        {
+            break;
+        }
+        EncodeTo(m_prefix, static_cast<uint32>(m_nodes[item].Value));
+        literals++;
+    }
+    m_literal = literals == items.Size() && !m_prefix.empty();
+
+    const RegexNode& first = m_nodes[items[0]];
+    m_anchored = first.Type == RegexNodeType::Assert && first.Value == static_cast<int32>(RegexAssert::TextBegin);
+}
+
+bool RegexProgram::_CheckAssert(RegexAssert kind, StringView text, int64 pos) const
+{
+    switch (kind)
+    {
+    case RegexAssert::LineBegin:
+        return pos == 0 || text.Data()[pos - 1] == '\n';
+    case RegexAssert::LineEnd:
+        return pos == text.Size() || text.Data()[pos] == '\n';
+    case RegexAssert::TextBegin:
+        return pos == 0;
+    case RegexAssert::TextEnd:
+        return pos == text.Size();
+    case RegexAssert::WordBoundary:
+    case RegexAssert::NotWordBoundary:
+    {
+        bool before = pos > 0 && IsWordByte(text.Data()[pos - 1]);
+        bool after = pos < text.Size() && IsWordByte(text.Data()[pos]);
+        return (before != after) == (kind == RegexAssert::WordBoundary);
+    }
+    }
+    return false;
+}
+
+void RegexProgram::_AddThread(ThreadList& list, Scratch& scratch, int32 pc, int64 pos, int64* caps, int32 slotCount, StringView text) const
+{
+    // 沿空转移深度优先展开，先到达的线程优先级更高；Save、Mark 修改的槽在回溯时恢复
+    // 每个线程的槽依次为请求的捕获槽与循环寄存器
+    const int32 width = slotCount + LoopCount;
+    Array<std::pair<int32, int64>>& stack = scratch.Stack;
+    stack.Clear();
+    stack.Push({ pc, -1 });
+    while (!stack.IsEmpty())
+    {
+        auto [target, restore] = stack.Back();
+        stack.Resize(stack.Size() - 1);
+        if (target < 0)
+        {
+            // 恢复捕获槽：target 为 -1 - 槽号
+            caps[-1 - target] = restore;
+            continue;
+        }
+
+        pc = target;
+        while (true)
+        {
+            int32 key = _KeyOf(pc, pos, caps, slotCount);
+            int32 index = list.Sparse[key];
+            if (index < list.Size && list.Dense[index] == key)
+            {
+                break;
+            }
+            index = list.Size++;
+            list.Sparse[key] = index;
+            list.Dense[index] = key;
+            list.Pcs[index] = pc;
+
+            const RegexInst& inst = m_insts[pc];
+            if (inst.Op == RegexOp::Jump)
+            {
+                pc = inst.X;
+            }
+            else if (inst.Op == RegexOp::Split)
+            {
+                stack.Push({ inst.Y, -1 });
+                pc = inst.X;
+            }
+            else if (inst.Op == RegexOp::Save)
+            {
+                if (inst.X < slotCount)
+                {
+                    stack.Push({ -1 - inst.X, caps[inst.X] });
+                    caps[inst.X] = pos;
+                }
+                pc++;
+            }
+            else if (inst.Op == RegexOp::Assert)
+            {
+                if (!_CheckAssert(static_cast<RegexAssert>(inst.X), text, pos))
+                {
+                    break;
+                }
+                pc++;
+            }
+            else if (inst.Op == RegexOp::Mark)
+            {
+                int32 slot = slotCount + inst.X;
+                stack.Push({ -1 - slot, caps[slot] });
+                caps[slot] = pos;
+                pc++;
+            }
+            else if (inst.Op == RegexOp::Check)
+            {
+                pc = caps[slotCount + inst.X] == pos ? inst.Y : pc + 1;
+            }
+            else
+            {
+                // 消耗字符或匹配成功的指令，保存槽等待下一步
+                if (width > 0)
+                {
+                    std::memcpy(list.Caps.Data() + static_cast<int64>(index) * width, caps, sizeof(int64) * width);
+                }
+                break;
+            }
+        }
+    }
+}
+
+bool RegexProgram::Search(StringView text, int64 start, bool full, int64* slots, int32 slotCount) const
+{
+    if (!Error.IsEmpty() || start < 0 || start > text.Size())
+    {
+        return false;
+    }
+
+    // 纯字面量直接查找子串
+    if (m_literal && !full)
+    {
+        int64 found = text.IndexOf(StringView(m_prefix), start);
+        if (found < 0)
+        {
+            return false;
+        }
+        if (slotCount > 0)
+        {
+            slots[0] = found;
+            slots[1] = found + static_cast<int64>(m_prefix.size());
+            std::fill(slots + 2, slots + slotCount, -1);
+        }
+        return true;
+    }
+
+    thread_local Scratch scratch;
+    const int32 count = m_keyCount;
+    const int32 width = slotCount + LoopCount;
+    for (ThreadList& list : scratch.Lists)
+    {
+        if (list.Sparse.Size() < count)
+        {
+            list.Sparse.Resize(count);
+            list.Dense.Resize(count);
+            list.Pcs.Resize(count);
+        }
+        if (list.Caps.Size() < static_cast<int64>(count) * width)
+        {
+            list.Caps.Resize(static_cast<int64>(count) * width);
+        }
+        list.Size = 0;
+    }
+    if (scratch.Caps.Size() < width)
+    {
+        scratch.Caps.Resize(width);
+    }
+
+    ThreadList* current = &scratch.Lists[0];
+    ThreadList* next = &scratch.Lists[1];
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(text.Data());
+    const bool anchored = m_anchored || full;
+    bool matched = false;
+    int64 pos = start;
+    while (true)
+    {
+        // 尚未找到匹配时，在每个位置以最低优先级开始新的尝试
+        if (!matched && (pos == start || !anchored))
+        {
+            if (current->Size == 0 && !m_prefix.empty() && !anchored)
+            {
+                int64 found = text.IndexOf(StringView(m_prefix), pos);
+                if (found < 0)
+                {
+                    break;
+                }
+                pos = found;
+            }
+            std::fill(scratch.Caps.Data(), scratch.Caps.Data() + width, -1);
+            _AddThread(*current, scratch, 0, pos, scratch.Caps.Data(), slotCount, text);
+        }
+        if (current->Size == 0)
+        {
+            break;
+        }
+
+        uint32 c = INVALID_CODEPOINT;
+        int32 length = 0;
+        if (pos < text.Size())
+        {
+            c = DecodeAt(data + pos, text.Size() - pos, length);
+        }
+
+        next->Size = 0;
+        for (int32 i = 0; i < current->Size; ++i)
+        {
+            int32 pc = current->Pcs[i];
+            const RegexInst& inst = m_insts[pc];
+            bool step = false;
+            switch (inst.Op)
+            {
+            case RegexOp::Char:
+                step = length > 0 && c == static_cast<uint32>(inst.X);
+                break;
+            case RegexOp::Any:
+                step = length > 0;
+                break;
+            case RegexOp::AnyNotNewline:
+                step = length > 0 && c != '\n';
+                break;
+            case RegexOp::Class:
+                step = length > 0 && m_classes[inst.X].Contains(c);
+                break;
+            case RegexOp::Match:
+                if (full && pos != text.Size())
+                {
+                    break;
+                }
+                matched = true;
+                if (slotCount == 0)
+                {
+                    return true;
+                }
+                std::memcpy(slots, current->Caps.Data() + static_cast<int64>(i) * width, sizeof(int64) * slotCount);
+                // 优先级更低的线程不再需要
+                i = current->Size;
+                break;
+            default:
+                break;
+            }
+            if (step)
+            {
+                int64* caps = width > 0 ? current->Caps.Data() + static_cast<int64>(i) * width : nullptr;
+                _AddThread(*next, scratch, pc + 1, pos + length, caps, slotCount, text);
+            }
+        }
+
+        std::swap(current, next);
+        if (pos >= text.Size())
+        {
+            break;
+        }
+        pos += length;
+    }
+    return matched;
+}
+
+namespace
+{
+    using RegexCache = LruCache<std::string, std::shared_ptr<const RegexProgram>>;
+
+    RegexCache& GetRegexCache()
+    {
+        static RegexCache cache(256, 16);
+        return cache;
+    }
+}
+
+Regex::Regex(StringView pattern, RegexFlag flags)
+{
+    // 键为选项与模式的组合
+    std::string key;
+    key.reserve(static_cast<size_t>(pattern.Size()) + 1);
+    key += static_cast<char>('0' + static_cast<uint32>(flags));
+    key.append(pattern.Data(), static_cast<size_t>(pattern.Size()));
+
+    RegexCache& cache = GetRegexCache();
+    if (!cache.Get(key, m_program))
+    {
+        m_program = std::make_shared<const RegexProgram>(pattern, flags);
+        cache.Put(key, m_program);
+    }
+}
+
+bool Regex::IsValid() const
+{
+    return m_program && m_program->Error.IsEmpty();
+}
+
+StringView Regex::Error() const
+{
+    return m_program ? m_program->Error.View() : StringView("Empty regex");
+}
+
+StringView Regex::Pattern() const
+{
+    return m_program ? m_program->Pattern.View() : StringView();
+}
+
+int32 Regex::GroupCount() const
+{
+    return IsValid() ? m_program->GroupCount : 0;
+}
+
+bool Regex::IsMatch(StringView text) const
+{
+    return _Search(text, 0, false, nullptr, 0);
+}
+
+bool Regex::FullMatch(StringView text) const
+{
+    return _Search(text, 0, true, nullptr, 0);
+}
+
+bool Regex::Search(StringView text, RegexMatch& match, int64 start) const
+{
+    match.m_text = text;
+    match.m_slots.Resize(static_cast<int64>(GroupCount()) * 2);
+    if (!_Search(text, start, false, match.m_slots.Data(), static_cast<int32>(match.m_slots.Size())))
+    {
+        match.m_slots.Clear();
+        return false;
+    }
+    return true;
+}
+
+bool Regex::Search(StringView text, StringView& match, int64 start) const
+{
+    int64 slots[2];
+    if (!_Search(text, start, false, slots, 2))
+    {
+        return false;
+    }
+    match = StringView(text.Data() + slots[0], slots[1] - slots[0]);
+    return true;
+}
+
+int64 Regex::MatchAll(StringView text, Array<StringView>& matches) const
+{
+    int64 count = 0;
+    int64 slots[2];
+    int64 pos = 0;
+    while (pos <= text.Size() && _Search(text, pos, false, slots, 2))
+    {
+        matches.Push(StringView(text.Data() + slots[0], slots[1] - slots[0]));
+        count++;
+        if (slots[1] > slots[0])
+        {
+            pos = slots[1];
+        }
+        else if (slots[1] < text.Size())
+        {
+            // 空匹配之后前进一个字符，避免原地重复
+            int32 length;
+            DecodeAt(reinterpret_cast<const unsigned char*>(text.Data() + slots[1]), text.Size() - slots[1], length);
+            pos = slots[1] + length;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+String Regex::Replace(StringView text, StringView replacement, int64 maxCount) const
+{
+    if (!IsValid())
+    {
+        return String(text);
+    }
+
+    const int32 slotCount = GroupCount() * 2;
+    Array<int64> slots(slotCount);
+    StringBuilder builder;
+    int64 last = 0;
+    int64 pos = 0;
+    int64 replaced = 0;
+    while (pos <= text.Size() && (maxCount < 0 || replaced < maxCount) && _Search(text, pos, false, slots.Data(), slotCount))
+    {
+        builder.Append(text.Slice(last, slots[0] - last));
+        // 展开 $n 与 $$
+        int64 copied = 0;
+        for (int64 i = 0; i + 1 < replacement.Size(); ++i)
+        {
+            char ch = replacement.Data()[i + 1];
+            if (replacement.Data()[i] != '$' || !(ch == '$' || (ch >= '0' && ch <= '9')))
+            {
+                continue;
+            }
+            builder.Append(replacement.Slice(copied, i - copied));
+            if (ch == '$')
+            {
+                builder.Append('$');
+            }
+            else if (ch - '0' < GroupCount() && slots[(ch - '0') * 2] >= 0)
+            {
+                int64 begin = slots[(ch - '0') * 2];
+                builder.Append(StringView(text.Data() + begin, slots[(ch - '0') * 2 + 1] - begin));
+            }
+            i++;
+            copied = i + 1;
+        }
+        builder.Append(replacement.Slice(copied));
+        replaced++;
+        last = slots[1];
+
+        if (slots[1] > slots[0])
+        {
+            pos = slots[1];
+        }
+        else if (slots[1] < text.Size())
+        {
+            int32 length;
+            DecodeAt(reinterpret_cast<const unsigned char*>(text.Data() + slots[1]), text.Size() - slots[1], length);
+            pos = slots[1] + length;
+        }
+        else
+        {
+            break;
+        }
+    }
+    builder.Append(text.Slice(last));
+    return builder.ToString();
+}
+
+int64 Regex::Split(StringView text, Array<StringView>& parts) const
+{
+    int64 count = 0;
+    int64 slots[2];
+    int64 last = 0;
+    int64 pos = 0;
+    while (pos <= text.Size() && _Search(text, pos, false, slots, 2))
+    {
+        bool empty = slots[1] == slots[0];
+        // 开头与结尾处的空匹配不产生分段
+        if (!empty || (slots[0] > 0 && slots[0] < text.Size()))
+        {
+            parts.Push(StringView(text.Data() + last, slots[0] - last));
+            count++;
+            last = slots[1];
+        }
+
+        if (!empty)
+        {
+            pos = slots[1];
+        }
+        else if (slots[1] < text.Size())
+        {
+            int32 length;
+            DecodeAt(reinterpret_cast<const unsigned char*>(text.Data() + slots[1]), text.Size() - slots[1], length);
+            pos = slots[1] + length;
+        }
+        else
+        {
+            break;
+        }
+    }
+    parts.Push(StringView(text.Data() + last, text.Size() - last));
+    return count + 1;
+}
+
+void Regex::ClearCache()
+{
+    GetRegexCache().Clear();
+}
+
+bool Regex::_Search(StringView text, int64 start, bool anchorEnd, int64* slots, int32 slotCount) const
+{
+    return m_program && m_program->Search(text, start, anchorEnd, slots, slotCount);
+}
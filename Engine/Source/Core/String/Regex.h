@@ -0,0 +1,182 @@
+#pragma once
+
+#include "Core.h"
+#include "Container/Array.h"
+#include "String/String.h"
+#include "String/StringView.h"
+
+#include <memory>
+
+class RegexProgram;
+
+/// <summary>
+/// 正则表达式选项，可按位组合
+/// </summary>
+enum class RegexFlag : uint32
+{
+    // 无选项
+    None = 0,
+    // 忽略 ASCII 字母的大小写
+    IgnoreCase = 1 << 0,
+    // ^ 与 $ 同时匹配每一行的开头和结尾
+    Multiline = 1 << 1,
+    // . 也匹配 '\n'
+    DotAll = 1 << 2
+};
+
+constexpr RegexFlag operator|(RegexFlag left, RegexFlag right)
+{
+    return static_cast<RegexFlag>(static_cast<uint32>(left) | static_cast<uint32>(right));
+}
+
+constexpr bool operator&(RegexFlag left, RegexFlag right)
+{
+    return (static_cast<uint32>(left) & static_cast<uint32>(right)) != 0;
+}
+
+/// <summary>
+/// 一次匹配的结果，保存各捕获组的字节范围
+/// <para>引用被匹配的文本，文本必须在结果使用期间保持有效；重复用于多次匹配时不再分配内存</para>
+/// </summary>
+class RegexMatch
+{
+public:
+    friend class Regex;
+public:
+    /// <summary>
+    /// 获取捕获组数量(含表示整个匹配的第 0 组)
+    /// </summary>
+    int32 GroupCount() const
+    {
+        return static_cast<int32>(m_slots.Size() / 2);
+    }
+    /// <summary>
+    /// 获取捕获组的内容
+    /// </summary>
+    /// <param name="index">组号，0 为整个匹配</param>
+    /// <returns>组号无效或该组未参与匹配时返回空视图</returns>
+    StringView Group(int32 index = 0) const
+    {
+        int64 offset = Offset(index);
+        if (offset < 0)
+        {
+            return StringView();
+        }
+        return StringView(m_text.Data() + offset, m_slots[index * 2 + 1] - offset);
+    }
+    /// <summary>
+    /// 获取捕获组在文本中的字节偏移
+    /// </summary>
+    /// <returns>组号无效或该组未参与匹配时返回 -1</returns>
+    int64 Offset(int32 index = 0) const
+    {
+        if (index < 0 || index >= GroupCount())
+        {
+            return -1;
+        }
+        return m_slots[index * 2];
+    }
+    /// <summary>
+    /// 获取整个匹配的内容
+    /// </summary>
+    StringView Value() const
+    {
+        return Group(0);
+    }
+private:
+    // 被匹配的文本
+    StringView m_text;
+    // 各组的起止字节偏移，未参与匹配为 -1
+    Array<int64> m_slots;
+};
+
+/// <summary>
+/// 编译后的正则表达式
+/// <para>使用 Pike 虚拟机(并行模拟 NFA)匹配，耗时与 模式长度 × 文本长度 成正比，不会因回溯退化，可用于不受信任的模式</para>
+/// <para>支持：字面量与转义、.、字符类 [...] 与 \d \w \s(及其大写取反)、^ $ \A \z \b \B、分组 (...) (?:...)、|、* + ? {n} {n,} {n,m} 及其非贪婪形式；
+/// 按 UTF-8 码点匹配，匹配语义与 Perl/Python 的最左优先一致(可选的一次重复没有消耗字符时结束重复)；分组最多嵌套 1000 层。不支持反向引用与环视</para>
+/// <para>编译结果按 (模式, 选项) 缓存在进程级的 LRU 缓存中，相同模式重复构造只需一次查表；编译后的程序不可变，可被多个线程同时使用</para>
+/// <para>模式无效时不抛出异常，IsValid 返回 false，所有匹配操作都视为不匹配</para>
+/// </summary>
+class Regex
+{
+public:
+    /// <summary>
+    /// 默认构造函数，构造无效的表达式
+    /// </summary>
+    Regex() = default;
+    /// <summary>
+    /// 编译模式(优先从缓存获取)
+    /// </summary>
+    /// <param name="pattern">模式</param>
+    /// <param name="flags">选项</param>
+    explicit Regex(StringView pattern, RegexFlag flags = RegexFlag::None);
+public:
+    /// <summary>
+    /// 判断模式是否编译成功
+    /// </summary>
+    bool IsValid() const;
+    /// <summary>
+    /// 获取编译错误信息，成功时为空
+    /// </summary>
+    StringView Error() const;
+    /// <summary>
+    /// 获取模式
+    /// </summary>
+    StringView Pattern() const;
+    /// <summary>
+    /// 获取捕获组数量(含第 0 组)
+    /// </summary>
+    int32 GroupCount() const;
+    /// <summary>
+    /// 判断文本中是否存在匹配
+    /// </summary>
+    bool IsMatch(StringView text) const;
+    /// <summary>
+    /// 判断整个文本是否匹配
+    /// </summary>
+    bool FullMatch(StringView text) const;
+    /// <summary>
+    /// 从 start 开始查找第一个匹配并记录各捕获组
+    /// </summary>
+    /// <param name="text">文本</param>
+    /// <param name="match">匹配结果</param>
+    /// <param name="start">起始字节偏移(^ 与 \b 仍参照完整文本判断)</param>
+    /// <returns>是否找到</returns>
+    bool Search(StringView text, RegexMatch& match, int64 start = 0) const;
+    /// <summary>
+    /// 从 start 开始查找第一个匹配，只返回整个匹配的内容(不分配内存)
+    /// </summary>
+    bool Search(StringView text, StringView& match, int64 start = 0) const;
+    /// <summary>
+    /// 查找全部互不重叠的匹配，追加到数组中
+    /// </summary>
+    /// <returns>匹配数量</returns>
+    int64 MatchAll(StringView text, Array<StringView>& matches) const;
+    /// <summary>
+    /// 替换匹配的内容
+    /// <para>替换文本中 $0-$9 表示对应的捕获组，$$ 表示 '$'</para>
+    /// </summary>
+    /// <param name="text">文本</param>
+    /// <param name="replacement">替换文本</param>
+    /// <param name="maxCount">最多替换的次数，-1 表示全部</param>
+    /// <returns>替换后的字符串</returns>
+    String Replace(StringView text, StringView replacement, int64 maxCount = -1) const;
+    /// <summary>
+    /// 以匹配的内容为分隔符切分，追加到数组中
+    /// </summary>
+    /// <returns>段数</returns>
+    int64 Split(StringView text, Array<StringView>& parts) const;
+    /// <summary>
+    /// 清空进程级的编译缓存
+    /// </summary>
+    static void ClearCache();
+private:
+    /// <summary>
+    /// 从 start 开始查找，将前 slotCount 个捕获位置写入 slots
+    /// </summary>
+    bool _Search(StringView text, int64 start, bool anchorEnd, int64* slots, int32 slotCount) const;
+private:
+    // 编译后的程序，多个 Regex 与缓存共享
+    std::shared_ptr<const RegexProgram> m_program;
+};
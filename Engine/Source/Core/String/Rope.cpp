@@ -0,0 +1,427 @@
+#include "pch.h"
+
+#include "Rope.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace
+{
+    // 叶节点的最大字节数
+    constexpr int64 CHUNK_SIZE = 1024;
+    // 小于此字节数的叶节点在连接时并入相邻的叶节点，避免反复编辑后产生大量碎块
+    constexpr int64 MIN_CHUNK_SIZE = CHUNK_SIZE / 4;
+
+    int64 CountLines(const char* data, int64 size)
+    {
+        int64 lines = 0;
+        const char* end = data + size;
+        while (const void* found = std::memchr(data, '\n', static_cast<size_t>(end - data)))
+        {
+            lines++;
+            data = static_cast<const char*>(found) + 1;
+        }
+        return lines;
+    }
+
+    int64 CharToByte(const String& text, int64 index)
+    {
+        return index >= text.Count() ? text.Size() : text.SubView(0, index).Size();
+    }
+
+    // 不超过 CHUNK_SIZE 的块长度，尽量不切断多字节序列
+    int64 ChunkLength(const char* data, int64 size)
+    {
+        if (size <= CHUNK_SIZE)
+        {
+            return size;
+        }
+        int64 length = CHUNK_SIZE;
+        while (length > CHUNK_SIZE - 3 && (static_cast<uint8>(data[length]) & 0xC0) == 0x80)
+        {
+            length--;
+        }
+        return length;
+    }
+}
+
+Rope::Rope(StringView str)
+    : m_root(_Build(str))
+{
+
+}
+
+Rope& Rope::Append(StringView str)
+{
+    return Insert(Count(), str);
+}
+
+Rope& Rope::Insert(int64 index, StringView str)
+{
+    if (index < 0 || index > Count() || str.IsEmpty())
+    {
+        return *this;
+    }
+
+    m_root = m_root ? _Insert(m_root, index, str) : _Build(str);
+    return *this;
+}
+
+Rope& Rope::Remove(int64 index, int64 count)
+{
+    if (count <= 0 || index < 0 || index >= Count())
+    {
+        return *this;
+    }
+
+    m_root = _Remove(m_root, index, std::min(index + count, Count()));
+    return *this;
+}
+
+Rope& Rope::Replace(int64 index, int64 count, StringView str)
+{
+    if (index < 0 || count < 0 || index >= Count())
+    {
+        return *this;
+    }
+
+    Remove(index, count);
+    return Insert(index, str);
+}
+
+void Rope::Clear()
+{
+    m_root.reset();
+}
+
+Char Rope::At(int64 index) const
+{
+    if (index < 0 || index >= Count())
+    {
+        return Char();
+    }
+
+    const Node* leaf = _FindLeaf(index);
+    return leaf->Text[index];
+}
+
+String Rope::MidStr(int64 index, int64 count) const
+{
+    if (index < 0 || count <= 0 || index >= Count())
+    {
+        return String();
+    }
+
+    String result;
+    _Collect(m_root.get(), index, std::min(index + count, Count()), result);
+    return result;
+}
+
+String Rope::ToString() const
+{
+    return MidStr(0, Count());
+}
+
+String Rope::Line(int64 line) const
+{
+    int64 start = LineToIndex(line);
+    if (start < 0)
+    {
+        return String();
+    }
+
+    int64 end = line + 1 < LineCount() ? LineToIndex(line + 1) - 1 : Count();
+    return MidStr(start, end - start);
+}
+
+int64 Rope::LineToIndex(int64 line) const
+{
+    if (line < 0 || line >= LineCount())
+    {
+        return -1;
+    }
+    if (line == 0)
+    {
+        return 0;
+    }
+
+    // 查找第 line 个换行符所在的叶节点
+    const Node* node = m_root.get();
+    int64 index = 0;
+    while (!node->IsLeaf())
+    {
+        if (line <= node->Left->Lines)
+        {
+            node = node->Left.get();
+        }
+        else
+        {
+            line -= node->Left->Lines;
+            index += node->Left->Count;
+            node = node->Right.get();
+        }
+    }
+
+    const char* data = node->Text.Data();
+    const char* pos = data;
+    for (; line > 0; line--)
+    {
+        pos = static_cast<const char*>(std::memchr(pos, '\n', static_cast<size_t>(data + node->Size - pos))) + 1;
+    }
+    return index + StringView(data, pos - data).Count();
+}
+
+int64 Rope::IndexToLine(int64 index) const
+{
+    if (index < 0 || index > Count())
+    {
+        return -1;
+    }
+    if (!m_root)
+    {
+        return 0;
+    }
+
+    const Node* node = m_root.get();
+    int64 line = 0;
+    while (!node->IsLeaf())
+    {
+        if (index < node->Left->Count)
+        {
+            node = node->Left.get();
+        }
+        else
+        {
+            line += node->Left->Lines;
+            index -= node->Left->Count;
+            node = node->Right.get();
+        }
+    }
+    return line + CountLines(node->Text.Data(), CharToByte(node->Text, index));
+}
+
+int64 Rope::Size() const
+{
+    return m_root ? m_root->Size : 0;
+}
+
+int64 Rope::Count() const
+{
+    return m_root ? m_root->Count : 0;
+}
+
+int64 Rope::LineCount() const
+{
+    return (m_root ? m_root->Lines : 0) + 1;
+}
+
+bool Rope::IsEmpty() const
+{
+    return m_root == nullptr;
+}
+
+Char Rope::operator[](int64 index) const
+{
+    return At(index);
+}
+
+/* private */
+
+Rope::NodePtr Rope::_MakeLeaf(String text)
+{
+    if (text.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    auto node = std::make_shared<Node>();
+    node->Size = text.Size();
+    node->Count = text.Count();
+    node->Lines = CountLines(text.Data(), text.Size());
+    node->Text = std::move(text);
+    return node;
+}
+
+Rope::NodePtr Rope::_MakeBranch(NodePtr left, NodePtr right)
+{
+    auto node = std::make_shared<Node>();
+    node->Size = left->Size + right->Size;
+    node->Count = left->Count + right->Count;
+    node->Lines = left->Lines + right->Lines;
+    node->Height = std::max(left->Height, right->Height) + 1;
+    node->Left = std::move(left);
+    node->Right = std::move(right);
+    return node;
+}
+
+Rope::NodePtr Rope::_Build(StringView str)
+{
+    Array<NodePtr> leaves;
+    leaves.Reserve(str.Size() / CHUNK_SIZE + 1);
+    for (int64 pos = 0; pos < str.Size();)
+    {
+        int64 length = ChunkLength(str.Data() + pos, str.Size() - pos);
+        leaves.Push(_MakeLeaf(String(str.Slice(pos, length))));
+        pos += length;
+    }
+    return leaves.IsEmpty() ? nullptr : _Build(leaves, 0, leaves.Size());
+}
+
+Rope::NodePtr Rope::_Build(const Array<NodePtr>& leaves, int64 first, int64 last)
+{
+    if (last - first == 1)
+    {
+        return leaves[first];
+    }
+
+    // 两侧叶节点数最多相差 1，高度也最多相差 1
+    int64 middle = first + (last - first) / 2;
+    return _MakeBranch(_Build(leaves, first, middle), _Build(leaves, middle, last));
+}
+
+Rope::NodePtr Rope::_Balance(NodePtr left, NodePtr right)
+{
+    if (left->Height > right->Height + 1)
+    {
+        if (left->Left->Height >= left->Right->Height)
+        {
+            return _MakeBranch(left->Left, _MakeBranch(left->Right, std::move(right)));
+        }
+        const NodePtr& middle = left->Right;
+        return _MakeBranch(_MakeBranch(left->Left, middle->Left), _MakeBranch(middle->Right, std::move(right)));
+    }
+    if (right->Height > left->Height + 1)
+    {
+        if (right->Right->Height >= right->Left->Height)
+        {
+            return _MakeBranch(_MakeBranch(std::move(left), right->Left), right->Right);
+        }
+        const NodePtr& middle = right->Left;
+        return _MakeBranch(_MakeBranch(std::move(left), middle->Left), _MakeBranch(middle->Right, right->Right));
+    }
+    return _MakeBranch(std::move(left), std::move(right));
+}
+
+Rope::NodePtr Rope::_Join(NodePtr left, NodePtr right)
+{
+    if (!left)
+    {
+        return right;
+    }
+    if (!right)
+    {
+        return left;
+    }
+
+    if (left->IsLeaf() && right->IsLeaf() && left->Size + right->Size <= CHUNK_SIZE)
+    {
+        String text(left->Text);
+        text += right->Text;
+        return _MakeLeaf(std::move(text));
+    }
+
+    // 沿较高一侧的内侧路径下降到高度相近处连接，过小的叶节点一直下降到相邻的叶节点
+    if (left->Height > right->Height + 1 || (!left->IsLeaf() && right->IsLeaf() && right->Size < MIN_CHUNK_SIZE))
+    {
+        return _Balance(left->Left, _Join(left->Right, std::move(right)));
+    }
+    if (right->Height > left->Height + 1 || (!right->IsLeaf() && left->IsLeaf() && left->Size < MIN_CHUNK_SIZE))
+    {
+        return _Balance(_Join(std::move(left), right->Left), right->Right);
+    }
+    return _MakeBranch(std::move(left), std::move(right));
+}
+
+Rope::NodePtr Rope::_Insert(const NodePtr& node, int64 index, StringView str)
+{
+    if (node->IsLeaf())
+    {
+        if (node->Size + str.Size() <= CHUNK_SIZE)
+        {
+            String text(node->Text);
+            text.Insert(index, str);
+            return _MakeLeaf(std::move(text));
+        }
+
+        // 超过块大小时将整块文本重新切分
+        int64 pos = CharToByte(node->Text, index);
+        String text(node->Text.View().Left(pos));
+        text.Reserve(node->Size + str.Size());
+        text.Append(str);
+        text.Append(node->Text.View().Slice(pos));
+        return _Build(text.View());
+    }
+
+    int64 leftCount = node->Left->Count;
+    if (index <= leftCount)
+    {
+        return _Join(_Insert(node->Left, index, str), node->Right);
+    }
+    return _Join(node->Left, _Insert(node->Right, index - leftCount, str));
+}
+
+Rope::NodePtr Rope::_Remove(const NodePtr& node, int64 start, int64 end)
+{
+    if (start == 0 && end == node->Count)
+    {
+        return nullptr;
+    }
+
+    if (node->IsLeaf())
+    {
+        String text(node->Text);
+        text.RemoveMid(start, end - start);
+        return _MakeLeaf(std::move(text));
+    }
+
+    int64 leftCount = node->Left->Count;
+    NodePtr left = start < leftCount ? _Remove(node->Left, start, std::min(end, leftCount)) : node->Left;
+    NodePtr right = end > leftCount ? _Remove(node->Right, std::max(start - leftCount, int64(0)), end - leftCount) : node->Right;
+    return _Join(std::move(left), std::move(right));
+}
+
+void Rope::_Collect(const Node* node, int64 start, int64 end, String& result)
+{
+    if (node->IsLeaf())
+    {
+        // 整块追加时直接使用已知的字符数
+        if (start == 0 && end == node->Count)
+        {
+            result += node->Text;
+        }
+        else
+        {
+            result.Append(node->Text.SubView(start, end - start));
+        }
+        return;
+    }
+
+    int64 leftCount = node->Left->Count;
+    if (start < leftCount)
+    {
+        _Collect(node->Left.get(), start, std::min(end, leftCount), result);
+    }
+    if (end > leftCount)
+    {
+        _Collect(node->Right.get(), std::max(start - leftCount, int64(0)), end - leftCount, result);
+    }
+}
+
+const Rope::Node* Rope::_FindLeaf(int64& index) const
+{
+    const Node* node = m_root.get();
+    while (!node->IsLeaf())
+    {
+        if (index < node->Left->Count)
+        {
+            node = node->Left.get();
+        }
+        else
+        {
+            index -= node->Left->Count;
+            node = node->Right.get();
+        }
+    }
+    return node;
+}
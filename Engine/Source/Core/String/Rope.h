@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Core.h"
+#include "String/Char.h"
+#include "String/String.h"
+#include "String/StringView.h"
+
+#include <memory>
+
+/// <summary>
+/// 绳索字符串，用于需要频繁编辑的大段文本(控制台、脚本编辑器缓冲区)
+/// <para>文本按约 1 KB 的 UTF-8 块保存在平衡二叉树(AVL)的叶节点中，每个节点缓存子树的字节数、字符数与换行数，
+/// 按字符索引或行号定位、插入、删除都只访问根到叶的路径，耗时为 O(log n)，与 String 的 O(n) 搬移不同</para>
+/// <para>节点创建后不再修改，编辑时只复制路径上的节点；拷贝 Rope 只增加根节点的引用计数，可作为快照保存(如撤销记录)，
+/// 快照之间共享未修改的节点，且可在其他线程中读取</para>
+/// <para>索引以字符(码点)为单位，越界时的行为与 String 相同</para>
+/// </summary>
+class Rope
+{
+public:
+    /// <summary>
+    /// 默认构造函数，构造空文本
+    /// </summary>
+    Rope() = default;
+    /// <summary>
+    /// 从字符串视图构造(复制数据)
+    /// </summary>
+    explicit Rope(StringView str);
+public:
+    /// <summary>
+    /// 在末尾追加文本
+    /// </summary>
+    Rope& Append(StringView str);
+    /// <summary>
+    /// 在指定字符位置插入文本，index 为 Count() 时追加到末尾
+    /// </summary>
+    Rope& Insert(int64 index, StringView str);
+    /// <summary>
+    /// 移除从 index 位置开始的 count 个字符
+    /// </summary>
+    Rope& Remove(int64 index, int64 count);
+    /// <summary>
+    /// 将从 index 位置开始的 count 个字符替换为 str
+    /// </summary>
+    Rope& Replace(int64 index, int64 count, StringView str);
+    /// <summary>
+    /// 清空文本
+    /// </summary>
+    void Clear();
+    /// <summary>
+    /// 获取指定位置的字符，索引无效时返回空字符
+    /// </summary>
+    Char At(int64 index) const;
+    /// <summary>
+    /// 返回从 index 位置开始的 count 个字符
+    /// </summary>
+    String MidStr(int64 index, int64 count) const;
+    /// <summary>
+    /// 返回全部文本
+    /// </summary>
+    String ToString() const;
+    /// <summary>
+    /// 返回指定行的文本(不含换行符)，行号无效时返回空字符串
+    /// </summary>
+    String Line(int64 line) const;
+    /// <summary>
+    /// 获取行首的字符位置
+    /// </summary>
+    /// <param name="line">从 0 开始的行号</param>
+    /// <returns>字符位置，行号无效时返回 -1</returns>
+    int64 LineToIndex(int64 line) const;
+    /// <summary>
+    /// 获取字符位置所在的行号
+    /// </summary>
+    /// <param name="index">字符位置，可为 Count()</param>
+    /// <returns>从 0 开始的行号，位置无效时返回 -1</returns>
+    int64 IndexToLine(int64 index) const;
+    /// <summary>
+    /// 获取字节数
+    /// </summary>
+    int64 Size() const;
+    /// <summary>
+    /// 获取字符数
+    /// </summary>
+    int64 Count() const;
+    /// <summary>
+    /// 获取行数(换行符数量 + 1)
+    /// </summary>
+    int64 LineCount() const;
+    /// <summary>
+    /// 判断是否为空
+    /// </summary>
+    bool IsEmpty() const;
+    /// <summary>
+    /// 按顺序对每个文本块调用 callback(StringView)，返回 false 时停止；用于写入文件或渲染，不复制数据
+    /// </summary>
+    template<class Callback>
+    void ForEachChunk(Callback&& callback) const
+    {
+        if (m_root)
+        {
+            _ForEachChunk(m_root.get(), callback);
+        }
+    }
+    /// <summary>
+    /// 获取指定位置的字符，索引无效时返回空字符
+    /// </summary>
+    Char operator[](int64 index) const;
+private:
+    /// <summary>
+    /// 树节点，叶节点保存文本块，分支节点保存左右子树的统计之和
+    /// </summary>
+    struct Node
+    {
+        // 左子树，叶节点为空
+        std::shared_ptr<const Node> Left;
+        // 右子树，叶节点为空
+        std::shared_ptr<const Node> Right;
+        // 叶节点的文本块
+        String Text;
+        // 字节数
+        int64 Size = 0;
+        // 字符数
+        int64 Count = 0;
+        // 换行符数量
+        int64 Lines = 0;
+        // 高度，叶节点为 0
+        int32 Height = 0;
+
+        bool IsLeaf() const
+        {
+            return Left == nullptr;
+        }
+    };
+
+    using NodePtr = std::shared_ptr<const Node>;
+private:
+    /// <summary>
+    /// 以文本构造叶节点，文本为空时返回空指针
+    /// </summary>
+    static NodePtr _MakeLeaf(String text);
+    /// <summary>
+    /// 以两棵非空子树构造分支节点
+    /// </summary>
+    static NodePtr _MakeBranch(NodePtr left, NodePtr right);
+    /// <summary>
+    /// 将文本切分为块并构造平衡的子树
+    /// </summary>
+    static NodePtr _Build(StringView str);
+    /// <summary>
+    /// 以 [first, last) 范围的叶节点构造平衡的子树
+    /// </summary>
+    static NodePtr _Build(const Array<NodePtr>& leaves, int64 first, int64 last);
+    /// <summary>
+    /// 连接高度差不超过 2 的两棵子树，必要时旋转
+    /// </summary>
+    static NodePtr _Balance(NodePtr left, NodePtr right);
+    /// <summary>
+    /// 连接任意两棵子树，较小的叶节点与相邻的叶节点合并
+    /// </summary>
+    static NodePtr _Join(NodePtr left, NodePtr right);
+    /// <summary>
+    /// 返回在 index 位置插入文本后的子树
+    /// </summary>
+    static NodePtr _Insert(const NodePtr& node, int64 index, StringView str);
+    /// <summary>
+    /// 返回移除 [start, end) 字符后的子树
+    /// </summary>
+    static NodePtr _Remove(const NodePtr& node, int64 start, int64 end);
+    /// <summary>
+    /// 将 [start, end) 字符追加到 result
+    /// </summary>
+    static void _Collect(const Node* node, int64 start, int64 end, String& result);
+    /// <summary>
+    /// 查找包含 index 位置字符的叶节点，index 改为叶节点内的位置
+    /// </summary>
+    const Node* _FindLeaf(int64& index) const;
+
+    template<class Callback>
+    static bool _ForEachChunk(const Node* node, Callback& callback)
+    {
+        if (node->IsLeaf())
+        {
+            return callback(node->Text.View());
+        }
+        return _ForEachChunk(node->Left.get(), callback) && _ForEachChunk(node->Right.get(), callback);
+    }
+private:
+    // 根节点，文本为空时为空指针
+    NodePtr m_root;
+};
@@ -1,8 +1,151 @@
 #include "pch.h"
 
 #include "String.h"
+#include "Utf8.h"
+#include "Regex.h"
+#include "StringSearch.h"
 
-#include <regex>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <limits>
+
+namespace
+{
+    // 堆存储块头，位于字符数据之前
+    struct HeapBlockHeader
+    {
+        // 延迟构建的字符索引，首项为检查点数量
+        std::atomic<int64*> CharIndex;
+    };
+
+    inline HeapBlockHeader* HeaderOf(const char* data)
+    {
+        return reinterpret_cast<HeapBlockHeader*>(const_cast<char*>(data) - sizeof(HeapBlockHeader));
+    }
+
+    // 以 std::string_view 访问字符串的字节数据
+    inline std::string_view ViewOf(const String& str)
+    {
+        return std::string_view(str.Data(), static_cast<size_t>(str.Size()));
+    }
+
+    inline bool IsSpace(char ch)
+    {
+        return ch == ' ' || (ch >= '\t' && ch <= '\r');
+    }
+
+    inline bool IsHexDigit(char ch)
+    {
+        return (ch >= '0' && ch <= '9') || (ch >= 'a' && ch <= 'f') || (ch >= 'A' && ch <= 'F');
+    }
+
+    // 与 strtol 的约定一致：跳过前导空白与一个 '+' 或 '-'，base 为 0 或 16 时识别 "0x" 前缀，base 为 0 时以 "0" 开头按八进制，
+    // 解析尽可能长的数字前缀并忽略其后的字符；基于 std::from_chars，与区域设置无关且不设置 errno
+    // 无符号类型的负数(-0 除外)超出范围
+    template<class Type>
+    Type ParseInteger(const char* data, int64 size, int base)
+    {
+        const char* end = data + size;
+        while (data < end && IsSpace(*data))
+        {
+            data++;
+        }
+
+        bool negative = data < end && *data == '-';
+        const char* digits = data + ((negative || (data < end && *data == '+')) ? 1 : 0);
+        // from_chars 对有符号类型接受 '-'，符号之后不能再有符号
+        if (digits < end && (*digits == '+' || *digits == '-'))
+        {
+            throw std::invalid_argument("No digits were found");
+        }
+        // 与 strtol 相同，"0x" 之后没有十六进制数字时只解析 "0"
+        bool hexPrefix = end - digits > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X') && IsHexDigit(digits[2]);
+        if (base == 0)
+        {
+            base = hexPrefix ? 16 : (end - digits > 1 && digits[0] == '0' ? 8 : 10);
+        }
+        if (base == 16 && hexPrefix)
+        {
+            digits += 2;
+        }
+
+        Type result{};
+        std::from_chars_result parsed;
+        if (negative && std::is_unsigned_v<Type>)
+        {
+            parsed = std::from_chars(digits, end, result, base);
+            if (parsed.ec == std::errc() && result != 0)
+            {
+                parsed.ec = std::errc::result_out_of_range;
+            }
+        }
+        else if (negative)
+        {
+            // from_chars 只接受紧邻数字的 '-'，去掉前缀后需自行取负
+            std::make_unsigned_t<Type> magnitude{};
+            parsed = std::from_chars(digits, end, magnitude, base);
+            constexpr auto limit = static_cast<std::make_unsigned_t<Type>>(std::numeric_limits<Type>::max()) + 1u;
+            if (parsed.ec == std::errc() && magnitude > limit)
+            {
+                parsed.ec = std::errc::result_out_of_range;
+            }
+            result = static_cast<Type>(0 - magnitude);
+        }
+        else
+        {
+            parsed = std::from_chars(digits, end, result, base);
+        }
+
+        if (parsed.ec == std::errc::invalid_argument)
+        {
+            throw std::invalid_argument("No digits were found");
+        }
+        if (parsed.ec == std::errc::result_out_of_range)
+        {
+            throw std::out_of_range("Integer conversion out of range");
+        }
+        return result;
+    }
+
+    // 与 strtod 的约定一致：跳过前导空白与一个 '+' 或 '-'，接受十进制、科学计数法、"0x" 开头的十六进制以及 inf/nan，
+    // 但其后不能有多余的字符；超出类型范围(上溢或下溢)时抛出 std::out_of_range
+    template<class Type>
+    Type ParseFloat(const char* data, int64 size)
+    {
+        const char* end = data + size;
+        while (data < end && IsSpace(*data))
+        {
+            data++;
+        }
+
+        bool negative = data < end && *data == '-';
+        const char* digits = data + ((negative || (data < end && *data == '+')) ? 1 : 0);
+        std::chars_format format = std::chars_format::general;
+        if (end - digits > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X') && (IsHexDigit(digits[2]) || digits[2] == '.'))
+        {
+            format = std::chars_format::hex;
+            digits += 2;
+        }
+
+        Type magnitude{};
+        std::from_chars_result parsed{ digits, std::errc::invalid_argument };
+        // 符号已经去掉，from_chars 接受的 '-' 在这里无效
+        if (digits < end && *digits != '-' && *digits != '+')
+        {
+            parsed = std::from_chars(digits, end, magnitude, format);
+        }
+        if (parsed.ec == std::errc::invalid_argument || parsed.ptr != end)
+        {
+            throw std::invalid_argument("Invalid float conversion");
+        }
+        if (parsed.ec == std::errc::result_out_of_range)
+        {
+            throw std::out_of_range("Floating-point conversion out of range");
+        }
+        return negative ? -magnitude : magnitude;
+    }
+}
 
 /* static */
 String String::FromStdString(const std::string& str)
@@ -15,90 +158,81 @@ String String::FromCString(const char* str)
     return String(str);
 }
 
+String String::FromUtf16(const char16* data, int64 size)
+{
+    String result;
+    char* buffer = result._Allocate(Utf8::LengthFromUtf16(data, size));
+    int64 written = Utf8::FromUtf16(data, size, buffer);
+    if (written < 0)
+    {
+        throw std::invalid_argument("Unpaired UTF-16 surrogate");
+    }
+    // 每个码点对应一个或一对单元，单元数等于字节数时全部为 ASCII
+    int64 count = Utf8::CountChars(buffer, written);
+    result._SetCount(count, count == written);
+    return result;
+}
+
+String String::FromUtf32(const char32* data, int64 size)
+{
+    String result;
+    char* buffer = result._Allocate(Utf8::LengthFromUtf32(data, size));
+    if (Utf8::FromUtf32(data, size, buffer) < 0)
+    {
+        throw std::invalid_argument("Invalid UTF-32 code point");
+    }
+    result._SetCount(size, result.Size() == size);
+    return result;
+}
+
 String String::FromInt8(int8 value)
 {
-    return String(std::to_string(static_cast<int>(value)));
+    return _FromNumber(value);
 }
 
 String String::FromInt16(int16 value)
 {
-    return String(std::to_string(static_cast<int>(value)));
+    return _FromNumber(value);
 }
 
 String String::FromInt32(int32 value)
 {
-    return String(std::to_string(value));
+    return _FromNumber(value);
 }
 
 String String::FromInt64(int64 value)
 {
-    return String(std::to_string(value));
+    return _FromNumber(value);
 }
 
 String String::FromUInt8(uint8 value)
 {
-    return String(std::to_string(static_cast<unsigned int>(value)));
+    return _FromNumber(value);
 }
 
 String String::FromUInt16(uint16 value)
 {
-    return String(std::to_string(static_cast<unsigned int>(value)));
+    return _FromNumber(value);
 }
 
 String String::FromUInt32(uint32 value)
 {
-    return String(std::to_string(value));
+    return _FromNumber(value);
 }
 
 String String::FromUInt64(uint64 value)
 {
-    return String(std::to_string(value));
+    return _FromNumber(value);
 }
 
 String String::FromFloat(float value)
 {
-    std::string str = std::to_string(value);
-    // 移除尾随零
-    size_t dotPos = str.find('.');
-    if (dotPos != std::string::npos)
-    {
-        size_t lastNonZero = str.find_last_not_of('0');
-        if (lastNonZero != std::string::npos)
-        {
-            if (str[lastNonZero] == '.')
-            {
-                str.erase(lastNonZero);
-            }
-            else
-            {
-                str.erase(lastNonZero + 1);
-            }
-        }
-    }
-    return String(str);
+    return _FromNumber(value);
 }
 
 String String::FromDouble(double value)
 {
-    std::string str = std::to_string(value);
-    // 移除尾随零
-    size_t dotPos = str.find('.');
-    if (dotPos != std::string::npos)
-    {
-        size_t lastNonZero = str.find_last_not_of('0');
-        if (lastNonZero != std::string::npos)
-        {
-            if (str[lastNonZero] == '.')
-            {
-                str.erase(lastNonZero);
-            }
-            else
-            {
-                str.erase(lastNonZero + 1);
-            }
-        }
-    }
-    return String(str);
+    return _FromNumber(value);
 }
 
 String String::FromBool(bool value)
@@ -106,12 +240,28 @@ String String::FromBool(bool value)
     return String(value ? "true" : "false");
 }
 
+
 /* member */
-String::String(const String& other)
-    : m_data(other.m_data)
-    , m_count(other.m_count)
+String::String() noexcept
+    : m_header(FLAG_ASCII)
+{
+    m_inline[0] = '\0';
+}
+
+String::~String()
 {
+    if (_IsHeap())
+    {
+        _FreeHeap(m_heap.Data, m_heap.Capacity);
+    }
+}
 
+String::String(const String& other)
+    : String()
+{
+    char* buffer = _Allocate(other.Size());
+    std::memcpy(buffer, other._Data(), other.Size());
+    _SetCount(other.Count(), other.IsASCII());
 }
 
 String& String::operator=(const String& other)
@@ -121,256 +271,305 @@ String& String::operator=(const String& other)
         return *this;
     }
 
-    m_data = other.m_data;
-    m_count = other.m_count;
+    // 容量足够时复用现有存储
+    char* buffer = _Allocate(other.Size());
+    std::memcpy(buffer, other._Data(), other.Size());
+    _SetCount(other.Count(), other.IsASCII());
     return *this;
 }
 
-String::String(String&& other)
-    : m_data(std::move(other.m_data))
-    , m_count(other.m_count)
+String::String(String&& other) noexcept
+    : m_header(other.m_header)
 {
-    other.m_count = 0;
+    // 按字节整体搬移，堆指针随之转移
+    std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+    other.m_header = FLAG_ASCII;
+    other.m_inline[0] = '\0';
 }
 
-String& String::operator=(String&& other)
+String& String::operator=(String&& other) noexcept
 {
     if (this == &other) [[unlikely]]
     {
         return *this;
     }
 
-    m_data = std::move(other.m_data);
-    m_count = other.m_count;
-
-    other.m_count = 0;
+    _Release();
+    m_header = other.m_header;
+    std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+    other.m_header = FLAG_ASCII;
+    other.m_inline[0] = '\0';
     return *this;
 }
 
 String::String(const char* str)
-    : m_data(str)
+    : String()
 {
-    m_count = _CalcCharCount(str);
+    if (str)
+    {
+        _Assign(str, static_cast<int64>(std::strlen(str)));
+    }
 }
 
 String& String::operator=(const char* str)
 {
-    m_data = str;
-    m_count = _CalcCharCount(str);
+    _Assign(str, str ? static_cast<int64>(std::strlen(str)) : 0);
     return *this;
 }
 
+String::String(const char* str, int64 size)
+    : String()
+{
+    if (str && size > 0)
+    {
+        _Assign(str, size);
+    }
+}
+
 String::String(const std::string& str)
-    : m_data(str)
+    : String()
 {
-    m_count = _CalcCharCount(str.c_str());
+    _Assign(str.data(), static_cast<int64>(str.size()));
 }
 
 String& String::operator=(const std::string& str)
 {
-    m_data = str;
-    m_count = _CalcCharCount(str.c_str());
+    _Assign(str.data(), static_cast<int64>(str.size()));
     return *this;
 }
 
 String::String(const ByteArray& buffer)
+    : String()
 {
-    m_data.clear();
-
-    for (int64 i = 0; i < buffer.Size(); ++i)
-    {
-        if (buffer[i] == '\0') break;
-        m_data.push_back(buffer[i]);
-    }
+    *this = buffer;
 }
 
 String& String::operator=(const ByteArray& buffer)
 {
-    m_data.clear();
+    // 遇到 '\0' 截止
+    const char* data = reinterpret_cast<const char*>(buffer.Data());
+    const void* end = buffer.Size() > 0 ? std::memchr(data, 0, buffer.Size()) : nullptr;
+    int64 size = end ? static_cast<const char*>(end) - data : buffer.Size();
+    _Assign(data, size);
+    return *this;
+}
 
-    for (int64 i = 0; i < buffer.Size(); ++i)
+String::String(StringView str)
+    : String()
+{
+    if (str.Size() > 0)
     {
-        if (buffer[i] == '\0') break;
-        m_data.push_back(buffer[i]);
+        _Assign(str.Data(), str.Size());
     }
-    return *this;
+}
+
+String::operator StringView() const noexcept
+{
+    return StringView(_Data(), Size());
 }
 
 String::operator std::filesystem::path() const
 {
-    return std::filesystem::path(m_data);
+    return std::filesystem::path(ToStdString());
 }
 
 String::operator const std::string() const
 {
-    return m_data;
+    return ToStdString();
 }
 
 String::operator bool() const
 {
-    return !m_data.empty();
+    return Size() != 0;
 }
 
-String& String::Append(const String& str)
+String& String::Append(StringView str)
 {
-    m_data.append(str.m_data);
-    m_count += _CalcCharCount(str.m_data);
+    bool ascii;
+    int64 count = _Scan(str.Data(), str.Size(), ascii);
+    _Append(str.Data(), str.Size(), count, ascii);
     return *this;
 }
 
 String& String::Append(const Char& ch)
 {
-    m_data.append(ch.m_data);
-    m_count += 1;
+    char bytes[4];
+    int64 appendSize = ch.Encode(bytes);
+    if (appendSize == 0)
+    {
+        return *this;
+    }
+
+    int64 size = Size();
+    _Grow(size + appendSize);
+    std::memcpy(_Data() + size, bytes, appendSize);
+    _SetSize(size + appendSize);
+    _SetCount(Count() + 1, IsASCII() && ch.IsASCII());
     return *this;
 }
 
-String& String::Prepend(const String& str)
+String& String::Prepend(StringView str)
 {
-    m_data.insert(0, str.m_data);
-    m_count += _CalcCharCount(str.m_data);  // 修复：没有更新m_count
+    bool ascii;
+    int64 count = _Scan(str.Data(), str.Size(), ascii);
+    ascii = ascii && IsASCII();
+    count += Count();
+    _Splice(0, 0, str.Data(), str.Size());
+    _SetCount(count, ascii);
+    _JoinCount(str.Size(), Size());
     return *this;
 }
 
 String& String::Prepend(const Char& ch)
 {
-    m_data.insert(0, ch.m_data);
-    m_count += 1;
+    char bytes[4];
+    int64 size = ch.Encode(bytes);
+    if (size == 0)
+    {
+        return *this;
+    }
+
+    _Splice(0, 0, bytes, size);
+    _SetCount(Count() + 1, IsASCII() && ch.IsASCII());
     return *this;
 }
 
-int64 String::Compare(const String& str) const
+int64 String::Compare(StringView str) const
 {
-    return m_data.compare(str.m_data);
+    return ViewOf(*this).compare(std::string_view(str));
 }
 
-bool String::Contains(const String& str) const
+bool String::Contains(StringView str) const
 {
-    return m_data.contains(str.m_data);
+    return StringSearch::Find(_Data(), Size(), str.Data(), str.Size()) >= 0;
 }
 
 bool String::Contains(const Char& ch) const
 {
-    return m_data.contains(ch.m_data);
+    char bytes[4];
+    int32 size = ch.Encode(bytes);
+    return size > 0 && StringSearch::Find(_Data(), Size(), bytes, size) >= 0;
 }
 
-int64 String::IndexOf(const String& str) const
+int64 String::IndexOf(StringView str) const
 {
-    // �ж������ַ����Ƿ�Ϊ��
-    if (!str)
+    // 判断查找字符串是否为空
+    if (str.IsEmpty())
     {
         return -1;
     }
-    // �����Ӵ����ֽ�λ��
-    int64 pos = m_data.find(str.m_data);
-    if (pos == std::string::npos)
+    // 查找子串的字节位置
+    int64 pos = StringSearch::Find(_Data(), Size(), str.Data(), str.Size());
+    if (pos < 0)
     {
         return -1;
     }
-    // ����ӿ�ʼ�����ֽ�λ�õ��ַ���
-    return _CalcCharCount(m_data, pos);
+    // 计算从开始到该字节位置的字符数
+    return _CalcCharCount(pos);
 }
 
 int64 String::IndexOf(const Char& ch) const
 {
-    // �ж������ַ����Ƿ�Ϊ��
-    if (!ch)
+    // 判断查找字符是否为空
+    char bytes[4];
+    int32 size = ch.Encode(bytes);
+    if (size == 0)
     {
         return -1;
     }
-    // �����Ӵ����ֽ�λ��
-    int64 pos = m_data.find(ch.m_data);
-    if (pos == std::string::npos)
+    // 查找字符的字节位置
+    int64 pos = StringSearch::Find(_Data(), Size(), bytes, size);
+    if (pos < 0)
     {
         return -1;
     }
-    // ����ӿ�ʼ�����ֽ�λ�õ��ַ���
-    return _CalcCharCount(m_data, pos);
+    // 计算从开始到该字节位置的字符数
+    return _CalcCharCount(pos);
 }
 
-int64 String::LastIndexOf(const String& str) const
+int64 String::LastIndexOf(StringView str) const
 {
-    // �ж������ַ����Ƿ�Ϊ��
-    if (!str)
+    // 判断查找字符串是否为空
+    if (str.IsEmpty())
     {
         return -1;
     }
-    // �����Ӵ����ֽ�λ��
-    int64 pos = m_data.rfind(str.m_data);
-    if (pos == std::string::npos)
+    // 查找子串的字节位置
+    int64 pos = StringSearch::FindLast(_Data(), Size(), str.Data(), str.Size());
+    if (pos < 0)
     {
         return -1;
     }
-    // ����ӿ�ʼ�����ֽ�λ�õ��ַ���
-    return _CalcCharCount(m_data, pos);
+    // 计算从开始到该字节位置的字符数
+    return _CalcCharCount(pos);
 }
 
 int64 String::LastIndexOf(const Char& ch) const
 {
-    // �ж������ַ����Ƿ�Ϊ��
-    if (!ch)
+    // 判断查找字符是否为空
+    char bytes[4];
+    int32 size = ch.Encode(bytes);
+    if (size == 0)
     {
         return -1;
     }
-    // �����Ӵ����ֽ�λ��
-    int64 pos = m_data.rfind(ch.m_data);
-    if (pos == std::string::npos)
+    // 查找字符的字节位置
+    int64 pos = StringSearch::FindLast(_Data(), Size(), bytes, size);
+    if (pos < 0)
     {
         return -1;
     }
-    // ����ӿ�ʼ�����ֽ�λ�õ��ַ���
-    return _CalcCharCount(m_data, pos);
+    // 计算从开始到该字节位置的字符数
+    return _CalcCharCount(pos);
 }
 
-bool String::StartWith(const String& str) const
+bool String::StartWith(StringView str) const
 {
-    return m_data.starts_with(str.m_data);
+    return ViewOf(*this).starts_with(std::string_view(str));
 }
 
-bool String::EndWith(const String& str) const
+bool String::EndWith(StringView str) const
 {
-    return m_data.ends_with(str.m_data);
+    return ViewOf(*this).ends_with(std::string_view(str));
 }
 
 String& String::RemoveLeft(int64 count)
 {
     if (count <= 0) return *this;
 
-    // ���ɾ���ַ��������ڵ����ַ������ַ���������ַ���
-    if (count >= m_count)
+    // 如果删除字符数大于等于总字符数，清空字符串
+    if (count >= Count())
     {
         Clear();
-        m_count = 0;
         return *this;
     }
 
-    int64 pos = _IndexToPos(m_data, count);
-    if (pos > 0)
-    {
-        m_data.erase(0, pos);
-        m_count -= count;
-    }
-
+    int64 pos = _IndexToPos(count);
+    _Splice(0, pos, nullptr, 0);
+    _SetCount(Count() - count, IsASCII());
+    _RefreshASCII();
     return *this;
 }
 
 String& String::RemoveMid(int64 index, int64 count)
 {
-    if (count <= 0 || index >= m_count) return *this;
+    if (count <= 0 || index < 0 || index >= Count()) return *this;
 
-    // ����ɾ��������ֹԽ��
-    if (index + count > m_count)
+    // 调整删除数量防止越界
+    if (index + count > Count())
     {
-        count = m_count - index;
+        count = Count() - index;
     }
 
-    int64 start = _IndexToPos(m_data, index);
-    int64 end = _IndexToPos(m_data, index + count);
+    int64 start = _IndexToPos(index);
+    int64 end = _IndexToPos(index + count);
 
-    if (start >= 0 && end > start)
+    if (end > start)
     {
-        m_data.erase(start, end - start);
-        m_count -= count;
+        _Splice(start, end - start, nullptr, 0);
+        _SetCount(Count() - count, IsASCII());
+        _RefreshASCII();
+        _JoinCount(start, Size());
     }
     return *this;
 }
@@ -379,21 +578,17 @@ String& String::RemoveRight(int64 count)
 {
     if (count <= 0) return *this;
 
-    if (count >= m_count)
+    if (count >= Count())
     {
-        m_data.clear();
-        m_count = 0;
+        Clear();
         return *this;
     }
 
-    int64 keepCounts = m_count - count;
-    int64 pos = _IndexToPos(m_data, keepCounts);
-
-    if (pos >= 0)
-    {
-        m_data.erase(pos);
-        m_count = keepCounts;
-    }
+    int64 keepCount = Count() - count;
+    int64 pos = _IndexToPos(keepCount);
+    _SetSize(pos);
+    _SetCount(keepCount, IsASCII());
+    _RefreshASCII();
     return *this;
 }
 
@@ -401,48 +596,36 @@ String& String::RemianLeft(int64 count)
 {
     if (count <= 0)
     {
-        m_data.clear();
-        m_count = 0;
+        Clear();
     }
-    else if (count < m_count)
+    else if (count < Count())
     {
-        int64 pos = _IndexToPos(m_data, count);
-        if (pos > 0)
-        {
-            m_data.erase(pos);
-            m_count = count;
-        }
+        RemoveRight(Count() - count);
     }
     return *this;
 }
 
 String& String::RemianMid(int64 index, int64 count)
 {
-    if (count <= 0 || index >= m_count)
+    if (count <= 0 || index < 0 || index >= Count())
     {
-        m_data.clear();
-        m_count = 0;
+        Clear();
         return *this;
     }
 
-    if (index + count > m_count)
+    if (index + count > Count())
     {
-        count = m_count - index;
+        count = Count() - index;
     }
 
-    int64 start = _IndexToPos(m_data, index);
-    int64 end = _IndexToPos(m_data, index + count);
+    int64 start = _IndexToPos(index);
+    int64 end = _IndexToPos(index + count);
 
-    if (start >= 0 && end > start)
-    {
-        m_data = m_data.substr(start, end - start);
-        m_count = count;
-    }
-    else
-    {
-        m_data.clear();
-        m_count = 0;
-    }
+    // 保留部分前移，不重新分配
+    std::memmove(_Data(), _Data() + start, end - start);
+    _SetSize(end - start);
+    _SetCount(count, IsASCII());
+    _RefreshASCII();
     return *this;
 }
 
@@ -450,82 +633,58 @@ String& String::RemianRight(int64 count)
 {
     if (count <= 0)
     {
-        m_data.clear();
-        m_count = 0;
+        Clear();
     }
-    else if (count < m_count)
+    else if (count < Count())
     {
-        int64 start = _IndexToPos(m_data, m_count - count);
-        if (start >= 0)
-        {
-            m_data = m_data.substr(start);
-            m_count = count;
-        }
+        RemoveLeft(Count() - count);
     }
     return *this;
 }
 
 String String::LeftStr(int64 count)
 {
-    if (count <= 0) return String("");
-    if (count >= m_count) return *this;
+    if (count <= 0) return String();
+    if (count >= Count()) return *this;
 
-    int64 pos = _IndexToPos(m_data, count);
-    if (pos > 0)
-    {
-        return String(m_data.substr(0, pos).c_str());
-    }
-    return String("");
+    return String(_Data(), _IndexToPos(count));
 }
 
 String String::MidStr(int64 index, int64 count)
 {
-    if (index < 0 || count <= 0 || index >= m_count) {
-        return String("");
+    if (index < 0 || count <= 0 || index >= Count()) {
+        return String();
     }
 
-    if (index + count > m_count) {
-        count = m_count - index;
+    if (index + count > Count()) {
+        count = Count() - index;
     }
 
-    int64 start = _IndexToPos(m_data, index);
-    int64 end = _IndexToPos(m_data, index + count);
-
-    if (start >= 0 && end > start)
-    {
-        return String(m_data.substr(start, end - start).c_str());
-    }
-    return String("");
+    int64 start = _IndexToPos(index);
+    int64 end = _IndexToPos(index + count);
+    return String(_Data() + start, end - start);
 }
 
 String String::SubStr(int64 start, int64 end)
 {
-    if (start < 0 || end < start || start >= m_count) {
-        return String("");
+    if (start < 0 || end < start || start >= Count()) {
+        return String();
     }
 
-    if (end > m_count) end = m_count;
-
-    int64 startPos = _IndexToPos(m_data, start);
-    int64 endPos = _IndexToPos(m_data, end);
+    if (end > Count()) end = Count();
 
-    if (startPos >= 0 && endPos > startPos) {
-        return String(m_data.substr(startPos, endPos - startPos).c_str());
-    }
-    return String("");
+    int64 startPos = _IndexToPos(start);
+    int64 endPos = _IndexToPos(end);
+    return String(_Data() + startPos, endPos - startPos);
 }
 
 String String::RightStr(int64 count)
 {
-    if (count <= 0) return String("");
-    if (count >= m_count) return *this;
+    if (count <= 0) return String();
+    if (count >= Count()) return *this;
 
-    int64 startPos = _IndexToPos(m_data, m_count - count);
-    if (startPos >= 0)
-    {
-        return String(m_data.substr(startPos).c_str());
-    }
-    return String("");
+    int64 startPos = _IndexToPos(Count() - count);
+    return String(_Data() + startPos, Size() - startPos);
 }
 
 String& String::Trim()
@@ -538,60 +697,26 @@ String& String::Trim()
 String& String::TrimLeft()
 {
     // 使用UTF-8安全的空白字符判断
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(m_data.data());
-    size_t len = m_data.size();
-    size_t start = 0;
+    int64 size = Size();
+    int64 start = 0;
+    int64 removed = 0;
 
-    while (start < len)
+    while (start < size)
     {
-        unsigned char ch = ptr[start];
-
-        // 检查是否为空白字符（ASCII和Unicode）
-        bool isSpace = false;
-
-        // ASCII空白字符
-        if (ch == 0x20 || ch == 0x09 || ch == 0x0A || ch == 0x0D || ch == 0x0C || ch == 0x0B)
-        {
-            isSpace = true;
-            start += 1;
-        }
-        // UTF-8多字节空白字符（如不换行空格）
-        else if ((ch & 0xE0) == 0xC0 && len - start >= 2)
-        {
-            uint32 code = ((ptr[start] & 0x1F) << 6) | (ptr[start + 1] & 0x3F);
-            if (code == 0x00A0)  // 不换行空格
-            {
-                isSpace = true;
-                start += 2;
-            }
-        }
-        else if ((ch & 0xF0) == 0xE0 && len - start >= 3)
-        {
-            uint32 code = ((ptr[start] & 0x0F) << 12) |
-                ((ptr[start + 1] & 0x3F) << 6) |
-                (ptr[start + 2] & 0x3F);
-            if (code == 0x3000 ||  // 表意空格
-                code == 0x2000 || code == 0x2001 || code == 0x2002 ||
-                code == 0x2003 || code == 0x2004 || code == 0x2005 ||
-                code == 0x2006 || code == 0x2007 || code == 0x2008 ||
-                code == 0x2009 || code == 0x200A || code == 0x202F ||
-                code == 0x205F)
-            {
-                isSpace = true;
-                start += 3;
-            }
-        }
-
-        if (!isSpace)
+        int32 length = Utf8::SpaceLength(_Data() + start, size - start);
+        if (length == 0)
         {
             break;
         }
+        start += length;
+        ++removed;
     }
 
     if (start > 0)
     {
-        m_data.erase(0, start);
-        m_count = _CalcCharCount(m_data);
+        _Splice(0, start, nullptr, 0);
+        _SetCount(Count() - removed, IsASCII());
+        _RefreshASCII();
     }
 
     return *this;
@@ -599,131 +724,164 @@ String& String::TrimLeft()
 
 String& String::TrimRight()
 {
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(m_data.data());
-    size_t len = m_data.size();
-    size_t end = len;
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(_Data());
+    int64 end = Size();
+    int64 removed = 0;
 
     while (end > 0)
     {
         // 找到字符起始位置
-        size_t charStart = end - 1;
+        int64 charStart = end - 1;
         while (charStart > 0 && (ptr[charStart] & 0xC0) == 0x80)
         {
             charStart--;
         }
 
-        unsigned char ch = ptr[charStart];
-        size_t charLen = end - charStart;
-        bool isSpace = false;
-
-        // ASCII空白字符
-        if (ch == 0x20 || ch == 0x09 || ch == 0x0A || ch == 0x0D || ch == 0x0C || ch == 0x0B)
-        {
-            isSpace = true;
-        }
-        // UTF-8多字节空白字符
-        else if ((ch & 0xE0) == 0xC0 && charLen >= 2)
-        {
-            uint32 code = ((ptr[charStart] & 0x1F) << 6) | (ptr[charStart + 1] & 0x3F);
-            if (code == 0x00A0) isSpace = true;
-        }
-        else if ((ch & 0xF0) == 0xE0 && charLen >= 3)
-        {
-            uint32 code = ((ptr[charStart] & 0x0F) << 12) |
-                ((ptr[charStart + 1] & 0x3F) << 6) |
-                (ptr[charStart + 2] & 0x3F);
-            if (code == 0x3000 || (code >= 0x2000 && code <= 0x200A) ||
-                code == 0x202F || code == 0x205F)
-            {
-                isSpace = true;
-            }
-        }
-
-        if (!isSpace)
+        int32 length = Utf8::SpaceLength(_Data() + charStart, end - charStart);
+        if (length == 0 || charStart + length != end)
         {
             break;
         }
 
         end = charStart;
+        ++removed;
     }
 
-    if (end < len)
+    if (end < Size())
     {
-        m_data.erase(end);
-        m_count = _CalcCharCount(m_data);
+        _SetSize(end);
+        _SetCount(Count() - removed, IsASCII());
+        _RefreshASCII();
     }
 
     return *this;
 }
 
+String String::ToLower() const
+{
+    return _MapCase(Char::CaseMapping::Lower);
+}
+
+String String::ToUpper() const
+{
+    return _MapCase(Char::CaseMapping::Upper);
+}
+
+String String::CaseFold() const
+{
+    return _MapCase(Char::CaseMapping::Fold);
+}
+
 StringList String::Split(char sep) const
 {
+    // 与 std::getline 语义一致：末尾分隔符之后不产生空串
+    // 先统计分隔符数量一次预留，避免逐个添加时反复移动已生成的 String
     StringList result;
-    std::stringstream ss(m_data);
-    std::string str;
-
-    while (std::getline(ss, str, sep))
+    result.Reserve(std::count(_Data(), _Data() + Size(), sep) + 1);
+    for (StringView part : SplitView(sep))
     {
-        result.Push(str);
+        result.Push(String(part));
     }
-
     return result;
 }
 
-String String::Match(const String& regex)
+SplitRange String::SplitView(char sep) const
 {
-    try
-    {
-        std::regex pattern(regex.m_data);
-        std::smatch match;
+    return SplitRange(View(), sep);
+}
 
-        if (std::regex_search(m_data, match, pattern))
-        {
-            return String(match[0].str());
-        }
+SplitRange String::SplitView(StringView sep) const
+{
+    return SplitRange(View(), sep);
+}
+
+int64 String::Tokenize(StringView delimiters, Array<StringView>& tokens) const
+{
+    return View().Tokenize(delimiters, tokens);
+}
+
+StringView String::View() const noexcept
+{
+    return StringView(_Data(), Size());
+}
+
+StringView String::SubView(int64 index, int64 count) const
+{
+    if (index < 0 || count <= 0 || index >= Count())
+    {
+        return StringView();
     }
-    catch (const std::regex_error&)
+
+    if (index + count > Count())
     {
-        // 正则表达式无效，返回空字符串
+        count = Count() - index;
     }
 
+    int64 start = _IndexToPos(index);
+    int64 end = _IndexToPos(index + count);
+    return StringView(_Data() + start, end - start);
+}
+
+CharRange String::Chars() const
+{
+    return CharRange(View());
+}
+
+String String::Match(StringView regex)
+{
+    // 编译结果来自进程级缓存，无效的模式不会抛出异常
+    StringView match;
+    if (Regex(regex).Search(View(), match))
+    {
+        return String(match);
+    }
     return String();
 }
 
-String& String::Insert(int64 index, const String& str)
+String& String::Insert(int64 index, StringView str)
 {
-    if (index < 0 || index > m_count) {
+    if (index < 0 || index > Count()) {
         return *this;
     }
 
-    int64 pos = _IndexToPos(m_data, index);
-    if (pos >= 0)
-    {
-        m_data.insert(pos, str.m_data);
-        m_count += str.m_count;
-    }
+    bool ascii;
+    int64 count = Count() + _Scan(str.Data(), str.Size(), ascii);
+    ascii = ascii && IsASCII();
+    int64 pos = _IndexToPos(index);
+    _Splice(pos, 0, str.Data(), str.Size());
+    _SetCount(count, ascii);
+    _JoinCount(pos, pos + str.Size());
+    _JoinCount(pos + str.Size(), Size());
     return *this;
 }
 
-String& String::Replace(int64 index, int64 count, const String& str)
+String& String::Replace(int64 index, int64 count, StringView str)
 {
-    if (index < 0 || count < 0 || index >= m_count)
+    if (index < 0 || count < 0 || index >= Count())
     {
         return *this;
     }
 
-    if (index + count > m_count)
+    if (index + count > Count())
     {
-        count = m_count - index;
+        count = Count() - index;
     }
 
-    int64 startPos = _IndexToPos(m_data, index);
-    int64 endPos = _IndexToPos(m_data, index + count);
+    int64 startPos = _IndexToPos(index);
+    int64 endPos = _IndexToPos(index + count);
 
-    if (startPos >= 0 && endPos > startPos)
+    if (endPos > startPos)
     {
-        m_data.replace(startPos, endPos - startPos, str.m_data);
-        m_count = m_count - count + str.m_count;
+        bool strASCII;
+        int64 newCount = Count() - count + _Scan(str.Data(), str.Size(), strASCII);
+        _Splice(startPos, endPos - startPos, str.Data(), str.Size());
+        _SetCount(newCount, IsASCII() && strASCII);
+        _JoinCount(startPos, startPos + str.Size());
+        _JoinCount(startPos + str.Size(), Size());
+        if (strASCII)
+        {
+            _RefreshASCII();
+        }
     }
     return *this;
 }
@@ -732,68 +890,110 @@ String& String::Repeat(int64 count)
 {
     if (count <= 0)
     {
-        m_data.clear();
-        m_count = 0;
+        Clear();
     }
     else if (count > 1)
     {
-        std::string original = m_data;
-        for (int64 i = 1; i < count; ++i)
+        // 一次分配到位，再按倍增方式复制
+        int64 size = Size();
+        int64 total = size * count;
+        _Grow(total);
+        char* data = _Data();
+        int64 filled = size;
+        while (filled < total)
         {
-            m_data += original;
+            int64 copy = std::min(filled, total - filled);
+            std::memcpy(data + filled, data, copy);
+            filled += copy;
+        }
+        _SetSize(total);
+        _SetCount(Count() * count, IsASCII());
+        for (int64 pos = size; !IsASCII() && pos < total; pos += size)
+        {
+            _JoinCount(pos, pos + size);
         }
-        m_count = _CalcCharCount(m_data.c_str());
     }
     return *this;
 }
 
 void String::Clear()
 {
-    m_data.clear();
-    m_count = 0;
+    _SetSize(0);
+    _SetCount(0, true);
 }
 
 int64 String::Capacity() const
 {
-    return m_data.capacity();
+    return _IsHeap() ? m_heap.Capacity : INLINE_CAPACITY;
 }
 
 int64 String::Size() const
 {
-    return m_data.size();
+    return _IsHeap() ? m_heap.Size : static_cast<int64>((m_header >> INLINE_SIZE_SHIFT) & 0xFF);
 }
 
 int64 String::Count() const
 {
-    return m_count;
+    return static_cast<int64>(m_header >> COUNT_SHIFT);
 }
 
 void String::Reserve(int64 size)
 {
-    m_data.reserve(size);
+    if (size > Capacity())
+    {
+        // 按请求的大小精确分配
+        HeapBuffer buffer{ _AllocateHeap(size), Size(), size };
+        std::memcpy(buffer.Data, _Data(), Size() + 1);
+        if (_IsHeap())
+        {
+            _FreeHeap(m_heap.Data, m_heap.Capacity);
+        }
+        m_heap = buffer;
+        m_header = (m_header & ~(uint64(0xFF) << INLINE_SIZE_SHIFT)) | FLAG_HEAP;
+    }
 }
 
 void String::Shrink()
 {
-    m_data.shrink_to_fit();
+    if (!_IsHeap() || m_heap.Capacity == m_heap.Size)
+    {
+        return;
+    }
+
+    HeapBuffer old = m_heap;
+    if (old.Size <= INLINE_CAPACITY)
+    {
+        // 能放下时回到内联存储
+        std::memcpy(m_inline, old.Data, old.Size + 1);
+        m_header = (m_header & ~FLAG_HEAP) | (static_cast<uint64>(old.Size) << INLINE_SIZE_SHIFT);
+    }
+    else
+    {
+        m_heap.Data = _AllocateHeap(old.Size);
+        m_heap.Capacity = old.Size;
+        std::memcpy(m_heap.Data, old.Data, old.Size + 1);
+    }
+    _FreeHeap(old.Data, old.Capacity);
 }
 
 bool String::IsEmpty() const
 {
-    return m_data.empty();
+    return Size() == 0;
 }
 
 bool String::IsNumeric() const
 {
-    if (m_data.empty()) return false;
+    if (IsEmpty()) return false;
 
+    const char* data = _Data();
+    int64 size = Size();
     bool hasDigit = false;
     bool hasDot = false;
     bool hasE = false;
 
-    for (int64 i = 0; i < m_data.size(); ++i)
+    for (int64 i = 0; i < size; ++i)
     {
-        char c = m_data[i];
+        char c = data[i];
 
         if (c >= '0' && c <= '9')
         {
@@ -808,7 +1008,7 @@ bool String::IsNumeric() const
             hasE = true;
             hasDigit = false;
         }
-        else if ((c == '+' || c == '-') && (i == 0 || m_data[i - 1] == 'e' || m_data[i - 1] == 'E'))
+        else if ((c == '+' || c == '-') && (i == 0 || data[i - 1] == 'e' || data[i - 1] == 'E'))
         {
 
         }
@@ -820,26 +1020,34 @@ bool String::IsNumeric() const
     return hasDigit;
 }
 
+bool String::IsASCII() const
+{
+    return (m_header & FLAG_ASCII) != 0;
+}
+
 bool String::IsValid(int64 index) const
 {
     if (index < 0) return false;
 
-    return index < m_count ? true : false;
+    return index < Count() ? true : false;
 }
 
 void String::Swap(String& other)
 {
-    std::swap(m_data, other.m_data);
-    std::swap(m_count, other.m_count);
+    char storage[sizeof(m_inline)];
+    std::memcpy(storage, m_inline, sizeof(m_inline));
+    std::memcpy(m_inline, other.m_inline, sizeof(m_inline));
+    std::memcpy(other.m_inline, storage, sizeof(m_inline));
+    std::swap(m_header, other.m_header);
 }
 
 bool String::ToBool() const
 {
-    if (m_data == "true" || m_data == "True")
+    if (*this == "true" || *this == "True")
     {
         return true;
     }
-    else if (m_data == "false" || m_data == "False")
+    else if (*this == "false" || *this == "False")
     {
         return false;
     }
@@ -851,557 +1059,736 @@ bool String::ToBool() const
 
 int8 String::ToInt8(int base) const
 {
-    int8 result;
-    char* endptr;
-
-    result = static_cast<int8>(std::strtol(m_data.c_str(), &endptr, base));
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    return result;
+    return ParseInteger<int8>(_Data(), Size(), base);
 }
 
 int16 String::ToInt16(int base) const
 {
-    int16 result;
-    char* endptr;
-
-    result = static_cast<int16>(std::strtol(m_data.c_str(), &endptr, base));
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    return result;
+    return ParseInteger<int16>(_Data(), Size(), base);
 }
 
 int32 String::ToInt32(int base) const
 {
-    int32 result;
-    char* endptr;
-
-    result = static_cast<int32>(std::strtol(m_data.c_str(), &endptr, base));
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    return result;
+    return ParseInteger<int32>(_Data(), Size(), base);
 }
 
 int64 String::ToInt64(int base) const
 {
-    if (m_data.empty())
-    {
-        throw std::invalid_argument("Cannot convert empty string to integer");
-    }
-
-    char* endptr;
-    errno = 0;
-    int64 result = std::strtoll(m_data.c_str(), &endptr, base);
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    if (errno == ERANGE)
-    {
-        throw std::out_of_range("Integer conversion out of range");
-    }
-
-    return result;
+    return ParseInteger<int64>(_Data(), Size(), base);
 }
 
 uint8 String::ToUInt8(int base) const
 {
-    uint8 result;
-    char* endptr;
-
-    result = static_cast<uint8>(std::strtoul(m_data.c_str(), &endptr, base));
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    return result;
+    return ParseInteger<uint8>(_Data(), Size(), base);
 }
 
 uint16 String::ToUInt16(int base) const
 {
-    uint16 result;
-    char* endptr;
-
-    result = static_cast<uint16>(std::strtoul(m_data.c_str(), &endptr, base));
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    return result;
+    return ParseInteger<uint16>(_Data(), Size(), base);
 }
 
 uint32 String::ToUInt32(int base) const
 {
-    uint32 result;
-    char* endptr;
-
-    result = static_cast<uint32>(std::strtoul(m_data.c_str(), &endptr, base));
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    return result;
+    return ParseInteger<uint32>(_Data(), Size(), base);
 }
 
 uint64 String::ToUInt64(int base) const
 {
-    if (m_data.empty())
-    {
-        throw std::invalid_argument("Cannot convert empty string to unsigned integer");
-    }
-
-    char* endptr;
-    errno = 0;
-    uint64 result = std::strtoull(m_data.c_str(), &endptr, base);
-
-    if (endptr == m_data.c_str())
-    {
-        throw std::invalid_argument("No digits were found");
-    }
-
-    if (errno == ERANGE)
-    {
-        throw std::out_of_range("Unsigned integer conversion out of range");
-    }
-
-    return result;
+    return ParseInteger<uint64>(_Data(), Size(), base);
 }
 
 float String::ToFloat() const
 {
-    char* endptr;
-    float result = std::strtof(m_data.c_str(), &endptr);
+    return ParseFloat<float>(_Data(), Size());
+}
 
-    if (endptr == m_data.c_str() || *endptr != '\0')
-    {
-        throw std::invalid_argument("Invalid float conversion");
-    }
+double String::ToDouble() const
+{
+    return ParseFloat<double>(_Data(), Size());
+}
 
-    return result;
+std::string String::ToStdString() const
+{
+    return std::string(_Data(), Size());
 }
 
-double String::ToDouble() const
+const char* String::ToCString() const
 {
-    char* endptr;
-    double result = std::strtod(m_data.c_str(), &endptr);
+    return _Data();
+}
 
-    if (endptr == m_data.c_str() || *endptr != '\0')
+Array<char16> String::ToUtf16() const
+{
+    Array<char16> result;
+    result.Resize(IsASCII() ? Size() : Utf8::Utf16Length(_Data(), Size()));
+    if (Utf8::ToUtf16(_Data(), Size(), result.Data()) < 0)
     {
-        throw std::invalid_argument("Invalid float conversion");
+        throw std::invalid_argument("String is not valid UTF-8");
     }
-
     return result;
 }
 
-std::string String::ToStdString() const
+Array<char32> String::ToUtf32() const
 {
-    return m_data;
+    Array<char32> result;
+    result.Resize(Count());
+    if (Utf8::ToUtf32(_Data(), Size(), result.Data()) < 0)
+    {
+        throw std::invalid_argument("String is not valid UTF-8");
+    }
+    return result;
 }
 
-const char* String::ToCString() const
+const char* String::Data() const
 {
-    return m_data.c_str();
+    return _Data();
 }
 
-Char String::operator[](int64 index)
+Char String::operator[](int64 index) const
 {
     if (!IsValid(index))
     {
         return Char();  // 返回空字符
     }
 
-    int64 bytePos = _IndexToPos(m_data, index);
-    return Char(_GetCharAtBytePos(m_data, bytePos));
+    // 在原位置解码，无效序列返回空字符
+    int64 bytePos = _IndexToPos(index);
+    uint32 code = 0;
+    return Utf8::Decode(_Data() + bytePos, Size() - bytePos, code) > 0 ? Char(code) : Char();
 }
 
 String& String::operator+=(const String& str)
 {
-    m_data += str.m_data;
-    m_count += str.m_count;  // 修复：没有更新m_count
+    _Append(str._Data(), str.Size(), str.Count(), str.IsASCII());
     return *this;
 }
 
+String& String::operator+=(StringView str)
+{
+    return Append(str);
+}
+
+String& String::operator+=(const char* str)
+{
+    return Append(StringView(str));
+}
+
 String& String::operator+=(char ch)
 {
-    m_data += ch;
-    m_count += 1;  // 修复：没有更新m_count
+    // 逐字节追加多字节字符时，由 _Append 把后续字节并入前面的字符
+    _Append(&ch, 1, 1, static_cast<unsigned char>(ch) < 0x80);
     return *this;
 }
 
 String operator+(const String& left, const String& right)
 {
-    String str(left);
-    str.Reserve(left.Size() + right.Size() + 1);
-    str += right;
+    String str;
+    str.Reserve(left.Size() + right.Size());
+    str._Append(left._Data(), left.Size(), left.Count(), left.IsASCII());
+    str._Append(right._Data(), right.Size(), right.Count(), right.IsASCII());
+    return str;
+}
+
+String operator+(const String& left, StringView right)
+{
+    String str;
+    str.Reserve(left.Size() + right.Size());
+    str._Append(left._Data(), left.Size(), left.Count(), left.IsASCII());
+    str.Append(right);
+    return str;
+}
+
+String operator+(StringView left, const String& right)
+{
+    String str;
+    str.Reserve(left.Size() + right.Size());
+    str.Append(left);
+    str._Append(right._Data(), right.Size(), right.Count(), right.IsASCII());
     return str;
 }
 
 String operator+(const String& left, const char* right)
 {
-    return String(left.m_data + right);
+    return left + StringView(right);
 }
 
 String operator+(const char* left, const String& right)
 {
-    return String(left + right.m_data);
+    return StringView(left) + right;
+}
+
+String operator+(String&& left, const String& right)
+{
+    left += right;
+    return std::move(left);
+}
+
+String operator+(String&& left, StringView right)
+{
+    left.Append(right);
+    return std::move(left);
+}
+
+String operator+(String&& left, const char* right)
+{
+    left.Append(StringView(right));
+    return std::move(left);
 }
 
 bool operator==(const String& left, const String& right)
 {
-    return left.m_data == right.m_data;
+    // 只比较字节，与按字节计算的 std::hash 保持一致
+    return ViewOf(left) == ViewOf(right);
 }
 
 bool operator==(const String& left, const char* right)
 {
-    return left.m_data == right;
+    return ViewOf(left) == right;
 }
 
 bool operator==(const char* left, const String& right)
 {
-    return left == right.m_data;
+    return left == ViewOf(right);
 }
 
 bool operator!=(const String& left, const String& right)
 {
-    return left.m_data != right.m_data;
+    return !(left == right);
 }
 
 bool operator!=(const String& left, const char* right)
 {
-    return left.m_data != right;
+    return ViewOf(left) != right;
 }
 
 bool operator!=(const char* left, const String& right)
 {
-    return left != right.m_data;
+    return left != ViewOf(right);
 }
 
 bool operator>(const String& left, const String& right)
 {
-    return left.m_data > right.m_data;
+    return ViewOf(left) > ViewOf(right);
 }
 
 bool operator>(const String& left, const char* right)
 {
-    return left.m_data > right;
+    return ViewOf(left) > right;
 }
 
 bool operator>(const char* left, const String& right)
 {
-    return left > right.m_data;
+    return left > ViewOf(right);
 }
 
 bool operator>=(const String& left, const String& right)
 {
-    return left.m_data >= right.m_data;
+    return ViewOf(left) >= ViewOf(right);
 }
 
 bool operator>=(const String& left, const char* right)
 {
-    return left.m_data >= right;
+    return ViewOf(left) >= right;
 }
 
 bool operator>=(const char* left, const String& right)
 {
-    return left >= right.m_data;
+    return left >= ViewOf(right);
 }
 
 bool operator<(const String& left, const String& right)
 {
-    return left.m_data < right.m_data;
+    return ViewOf(left) < ViewOf(right);
 }
 
 bool operator<(const String& left, const char* right)
 {
-    return left.m_data < right;
+    return ViewOf(left) < right;
 }
 
 bool operator<(const char* left, const String& right)
 {
-    return left < right.m_data;
+    return left < ViewOf(right);
 }
 
 bool operator<=(const String& left, const String& right)
 {
-    return left.m_data <= right.m_data;
+    return ViewOf(left) <= ViewOf(right);
 }
 
 bool operator<=(const String& left, const char* right)
 {
-    return left.m_data < right;
+    return ViewOf(left) <= right;
 }
 
 bool operator<=(const char* left, const String& right)
 {
-    return left < right.m_data;
+    return left <= ViewOf(right);
 }
 
 std::ostream& operator<<(std::ostream& os, const String& str)
 {
-    return os << str.ToStdString();
+    return os.write(str._Data(), str.Size());
 }
 
 
 
 /* private */
-int32 String::_GetCharLength(unsigned char firstByte) const
+char* String::_Data()
 {
-    if ((firstByte & 0x80) == 0) return 1;      // 0xxxxxxx
-    if ((firstByte & 0xE0) == 0xC0) return 2;   // 110xxxxx
-    if ((firstByte & 0xF0) == 0xE0) return 3;   // 1110xxxx
-    if ((firstByte & 0xF8) == 0xF0) return 4;   // 11110xxx
-    return 1;                                   // 无效编码，按单字节处理
+    return _IsHeap() ? m_heap.Data : m_inline;
 }
 
-bool String::_IsValidTrailByte(unsigned char byte) const
+const char* String::_Data() const
 {
-    return (byte & 0xC0) == 0x80;  // 10xxxxxx
+    return _IsHeap() ? m_heap.Data : m_inline;
 }
 
-int64 String::_CalcCharCount(const char* str) const
+bool String::_IsHeap() const
 {
-    if (!str) return 0;
-
-    int64 count = 0;
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str);
+    return (m_header & FLAG_HEAP) != 0;
+}
 
-    while (*ptr)
+void String::_SetSize(int64 size)
+{
+    if (_IsHeap())
+    {
+        m_heap.Size = size;
+        m_heap.Data[size] = '\0';
+    }
+    else
     {
-        int32 len = _GetCharLength(*ptr);
+        m_header = (m_header & ~(uint64(0xFF) << INLINE_SIZE_SHIFT)) | (static_cast<uint64>(size) << INLINE_SIZE_SHIFT);
+        m_inline[size] = '\0';
+    }
+}
 
-        // 验证多字节字符的后续字节
-        if (len > 1)
-        {
-            bool valid = true;
-            for (int32 i = 1; i < len; ++i)
-            {
-                if (ptr[i] == '\0' || !_IsValidTrailByte(ptr[i]))
-                {
-                    valid = false;
-                    break;
-                }
-            }
-            if (!valid) len = 1;  // 无效序列，按单字节处理
-        }
+void String::_SetCount(int64 count, bool ascii)
+{
+    // 所有修改内容的操作最终都会更新字符数，在此统一丢弃过期的索引
+    _ResetCharIndex();
+    uint64 flags = (m_header & FLAG_HEAP) | (ascii ? FLAG_ASCII : 0);
+    uint64 inlineSize = m_header & (uint64(0xFF) << INLINE_SIZE_SHIFT);
+    m_header = (static_cast<uint64>(count) << COUNT_SHIFT) | inlineSize | flags;
+}
 
-        ptr += len;
-        count++;
+void String::_Grow(int64 capacity)
+{
+    int64 oldCapacity = Capacity();
+    if (capacity <= oldCapacity)
+    {
+        return;
     }
 
-    return count;
+    // 按倍数扩容，摊还追加的复制开销
+    Reserve(std::max(capacity, oldCapacity * 2));
 }
 
-int64 String::_CalcCharCount(const std::string& str) const
+void String::_Release()
 {
-    return _CalcCharCount(str.c_str());
+    if (_IsHeap())
+    {
+        _FreeHeap(m_heap.Data, m_heap.Capacity);
+    }
+    m_header = FLAG_ASCII;
+    m_inline[0] = '\0';
 }
 
-int64 String::_CalcCharCount(const char* str, int64 bytePos) const
+char* String::_AllocateHeap(int64 capacity)
 {
-    if (!str || bytePos <= 0) return 0;
+    char* block = Allocator().Allocate<char>(sizeof(HeapBlockHeader) + capacity + 1);
+    new (block) HeapBlockHeader{ nullptr };
+    return block + sizeof(HeapBlockHeader);
+}
 
-    int64 count = 0;
-    int64 currentPos = 0;
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str);
+void String::_FreeHeap(char* data, int64 capacity)
+{
+    HeapBlockHeader* header = HeaderOf(data);
+    if (int64* index = header->CharIndex.load(std::memory_order_relaxed))
+    {
+        Allocator().Deallocate(index, index[0] + 1);
+    }
+    header->~HeapBlockHeader();
+    Allocator().Deallocate(reinterpret_cast<char*>(header), sizeof(HeapBlockHeader) + capacity + 1);
+}
 
-    while (currentPos < bytePos && *ptr)
+const int64* String::_GetCharIndex() const
+{
+    // 短字符串直接遍历即可，纯单字节时字节位置即字符索引
+    if (Count() < CHAR_INDEX_STRIDE * 2 || Size() == Count())
     {
-        int32 len = _GetCharLength(*ptr);
+        return nullptr;
+    }
 
-        // 确保不超出目标字节位置
-        if (currentPos + len > bytePos)
-        {
-            break;
-        }
+    HeapBlockHeader* header = HeaderOf(m_heap.Data);
+    if (int64* index = header->CharIndex.load(std::memory_order_acquire))
+    {
+        return index + 1;
+    }
 
-        // 验证多字节字符
-        if (len > 1)
+    // 一次遍历记录每 CHAR_INDEX_STRIDE 个字符的字节位置
+    int64 entries = Count() / CHAR_INDEX_STRIDE + 1;
+    int64* index = Allocator().Allocate<int64>(entries + 1);
+    index[0] = entries;
+
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(m_heap.Data);
+    int64 size = m_heap.Size;
+    int64 bytePos = 0;
+    for (int64 i = 0; i < entries; ++i)
+    {
+        index[i + 1] = bytePos;
+        for (int64 k = 0; k < CHAR_INDEX_STRIDE && bytePos < size; ++k)
         {
-            bool valid = true;
-            for (int32 i = 1; i < len; ++i)
-            {
-                if (ptr[i] == '\0' || !_IsValidTrailByte(ptr[i]))
-                {
-                    valid = false;
-                    break;
-                }
-            }
-            if (!valid) len = 1;
+            bytePos += _CharLengthAt(ptr + bytePos, size - bytePos);
         }
+    }
 
-        ptr += len;
-        currentPos += len;
-        count++;
+    // 其他线程已先构建完成时使用已有的索引
+    int64* expected = nullptr;
+    if (!header->CharIndex.compare_exchange_strong(expected, index, std::memory_order_acq_rel))
+    {
+        Allocator().Deallocate(index, entries + 1);
+        return expected + 1;
     }
+    return index + 1;
+}
 
-    return count;
+void String::_ResetCharIndex()
+{
+    if (!_IsHeap())
+    {
+        return;
+    }
+
+    HeapBlockHeader* header = HeaderOf(m_heap.Data);
+    if (int64* index = header->CharIndex.exchange(nullptr, std::memory_order_relaxed))
+    {
+        Allocator().Deallocate(index, index[0] + 1);
+    }
 }
 
-int64 String::_CalcCharCount(const std::string& str, int64 bytePos) const
+char* String::_Allocate(int64 size)
 {
-    if (bytePos > static_cast<int64>(str.size()))
+    if (size > Capacity())
     {
-        bytePos = static_cast<int64>(str.size());
+        _Release();
+        Reserve(size);
     }
-    return _CalcCharCount(str.c_str(), bytePos);
+    _SetSize(size);
+    return _Data();
 }
 
-int64 String::_IndexToPos(const std::string& str, int64 index) const
+void String::_Assign(const char* data, int64 size)
 {
-    // 边界检查
-    if (index < 0) return 0;
-    if (index >= m_count) return static_cast<int64>(str.size());
-    if (index == 0) return 0;
+    if (size > 0 && data >= _Data() && data < _Data() + Size())
+    {
+        // 源数据位于自身内部时先复制出来
+        String copy(data, size);
+        Swap(copy);
+        return;
+    }
 
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str.data());
-    int64 bytePos = 0;
-    int64 charCount = 0;
-    size_t strLen = str.size();
+    char* buffer = _Allocate(size);
+    if (size > 0)
+    {
+        std::memcpy(buffer, data, size);
+    }
+    bool ascii;
+    int64 count = _Scan(buffer, size, ascii);
+    _SetCount(count, ascii);
+}
+
+void String::_Append(const char* data, int64 size, int64 count, bool ascii)
+{
+    int64 oldSize = Size();
+    if (size <= 0)
+    {
+        return;
+    }
+
+    // 数据可能来自自身，扩容前记下偏移
+    int64 selfOffset = (data >= _Data() && data < _Data() + oldSize) ? data - _Data() : -1;
+    _Grow(oldSize + size);
+    if (selfOffset >= 0)
+    {
+        data = _Data() + selfOffset;
+    }
+    std::memcpy(_Data() + oldSize, data, size);
+    _SetSize(oldSize + size);
+    _SetCount(Count() + count, IsASCII() && ascii);
+    _JoinCount(oldSize, oldSize + size);
+}
 
-    while (charCount < index && bytePos < static_cast<int64>(strLen))
+void String::_JoinCount(int64 pos, int64 end)
+{
+    // 后一段不以后续字节开头时，前一段末尾的字符不会延伸过来
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(_Data());
+    if (pos <= 0 || pos >= end || !_IsValidTrailByte(ptr[pos]))
     {
-        int32 len = _GetCharLength(ptr[bytePos]);
+        return;
+    }
 
-        // 验证多字节字符
-        if (len > 1)
+    // 非后续字节一定是字符的起点，向前找到至多 3 个字节内的起点；找不到时前面的字符已经完整
+    int64 start = pos;
+    for (int64 i = pos - 1; i >= 0 && i >= pos - 3; --i)
+    {
+        if (!_IsValidTrailByte(ptr[i]))
         {
-            bool valid = true;
-            for (int32 i = 1; i < len; ++i)
-            {
-                if (bytePos + i >= static_cast<int64>(strLen) ||
-                    !_IsValidTrailByte(ptr[bytePos + i]))
-                {
-                    valid = false;
-                    break;
-                }
-            }
-            if (!valid) len = 1;
+            start = i;
+            break;
         }
+    }
+    if (start == pos)
+    {
+        return;
+    }
 
-        bytePos += len;
-        charCount++;
+    // 后一段开头的后续字节单独统计时各算一个字符，至多 3 个可能并入前面的字符
+    int64 stop = pos;
+    while (stop < end && stop < pos + 3 && _IsValidTrailByte(ptr[stop]))
+    {
+        stop++;
     }
+    bool ascii;
+    int64 separate = _Scan(_Data() + start, pos - start, ascii) + (stop - pos);
+    int64 joined = _Scan(_Data() + start, stop - start, ascii);
+    _SetCount(Count() - separate + joined, IsASCII());
+}
 
-    return bytePos;
+void String::_Splice(int64 pos, int64 length, const char* data, int64 size)
+{
+    int64 oldSize = Size();
+    int64 newSize = oldSize - length + size;
+    char* buffer = _Data();
+
+    if (size > 0 && data >= buffer && data < buffer + oldSize)
+    {
+        // 插入的内容来自自身时先复制出来
+        std::string copy(data, size);
+        _Splice(pos, length, copy.data(), size);
+        return;
+    }
+
+    if (newSize > Capacity())
+    {
+        _Grow(newSize);
+        buffer = _Data();
+    }
+    std::memmove(buffer + pos + size, buffer + pos + length, oldSize - pos - length);
+    if (size > 0)
+    {
+        std::memcpy(buffer + pos, data, size);
+    }
+    _SetSize(newSize);
 }
 
-std::string String::_GetCharAtBytePos(const std::string& str, int64 bytePos) const
+void String::_RefreshASCII()
 {
-    if (bytePos < 0 || bytePos >= static_cast<int64>(str.size()))
+    if (IsASCII())
     {
-        return std::string();
+        return;
     }
 
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str.data()) + bytePos;
-    int32 len = _GetCharLength(*ptr);
+    if (Utf8::IsASCII(_Data(), Size()))
+    {
+        m_header |= FLAG_ASCII;
+    }
+}
 
-    // 验证完整字符
-    if (bytePos + len > static_cast<int64>(str.size()))
+int64 String::_Scan(const char* data, int64 size, bool& ascii)
+{
+    // 有效的 UTF-8 按向量批量校验并统计
+    int64 validCount = Utf8::ValidateAndCount(data, size, ascii);
+    if (validCount >= 0)
     {
-        len = static_cast<int32>(str.size() - bytePos);
+        return validCount;
     }
-    else if (len > 1)
+
+    // 含无效序列时逐字符遍历，无效字节各按一个字符计
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(data);
+    int64 count = 0;
+    int64 pos = 0;
+    ascii = true;
+
+    while (pos < size)
     {
-        for (int32 i = 1; i < len; ++i)
+        // ASCII 快速路径：每次检查 8 个字节
+        if (pos + 8 <= size)
         {
-            if (!_IsValidTrailByte(ptr[i]))
+            uint64 word;
+            std::memcpy(&word, ptr + pos, sizeof(word));
+            if ((word & 0x8080808080808080ull) == 0)
             {
-                len = 1;  // 无效序列，只取首字节
-                break;
+                pos += 8;
+                count += 8;
+                continue;
             }
         }
+
+        if (ptr[pos] >= 0x80)
+        {
+            ascii = false;
+        }
+        pos += _CharLengthAt(ptr + pos, size - pos);
+        count++;
     }
 
-    return str.substr(bytePos, len);
+    return count;
+}
+
+String String::_MapCase(Char::CaseMapping mapping) const
+{
+    String result;
+    int64 size = Size();
+    char* buffer = result._Allocate(size);
+    Char::_MapCase(_Data(), buffer, size, mapping);
+    result._SetCount(Count(), IsASCII());
+    return result;
 }
 
-bool String::_IsValidUTF8String(const std::string& str) const
+template<class Type>
+String String::_FromNumber(Type value)
 {
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str.data());
-    size_t len = str.size();
-    size_t pos = 0;
+    // 64 位整数最多 20 位，float/double 的最短表示最多 15/24 个字符
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    int64 size = result.ptr - buffer;
+    String str;
+    std::memcpy(str._Allocate(size), buffer, size);
+    str._SetCount(size, true);
+    return str;
+}
 
-    while (pos < len)
+int32 String::_CharLengthAt(const unsigned char* ptr, int64 available)
+{
+    int32 length = _GetCharLength(ptr[0]);
+    if (length == 1)
     {
-        int32 charLen = _GetCharLength(ptr[pos]);
-
-        // 检查长度是否超出字符串
-        if (pos + charLen > len)
+        return 1;
+    }
+    // 验证多字节字符的后续字节
+    if (length > available)
+    {
+        return 1;
+    }
+    for (int32 i = 1; i < length; ++i)
+    {
+        if (!_IsValidTrailByte(ptr[i]))
         {
-            return false;
+            return 1;  // 无效序列，按单字节处理
         }
+    }
+    return length;
+}
 
-        // 验证多字节字符
-        if (charLen > 1)
+int32 String::_GetCharLength(unsigned char firstByte)
+{
+    if ((firstByte & 0x80) == 0) return 1;      // 0xxxxxxx
+    if ((firstByte & 0xE0) == 0xC0) return 2;   // 110xxxxx
+    if ((firstByte & 0xF0) == 0xE0) return 3;   // 1110xxxx
+    if ((firstByte & 0xF8) == 0xF0) return 4;   // 11110xxx
+    return 1;                                   // 无效编码，按单字节处理
+}
+
+bool String::_IsValidTrailByte(unsigned char byte)
+{
+    return (byte & 0xC0) == 0x80;  // 10xxxxxx
+}
+
+int64 String::_CalcCharCount(int64 bytePos) const
+{
+    if (bytePos <= 0) return 0;
+    if (bytePos > Size()) bytePos = Size();
+    // 每个字符都是单字节时字节位置即字符数
+    if (Size() == Count()) return bytePos;
+
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(_Data());
+    int64 size = Size();
+    int64 count = 0;
+    int64 currentPos = 0;
+
+    // 二分查找不超过目标位置的最后一个检查点，从那里开始遍历
+    if (const int64* index = _GetCharIndex())
+    {
+        const int64* end = index + (Count() / CHAR_INDEX_STRIDE + 1);
+        const int64* checkpoint = std::upper_bound(index, end, bytePos) - 1;
+        count = (checkpoint - index) * CHAR_INDEX_STRIDE;
+        currentPos = *checkpoint;
+    }
+
+    while (currentPos < bytePos)
+    {
+        int32 len = _CharLengthAt(ptr + currentPos, size - currentPos);
+
+        // 确保不超出目标字节位置
+        if (currentPos + len > bytePos)
         {
-            // 检查首字节是否有效
-            if (charLen == 2 && (ptr[pos] & 0xFE) == 0xC0)  // 过长的C0和C1
-                return false;
-            if (charLen == 3 && ptr[pos] == 0xE0 && ptr[pos + 1] < 0xA0)  // 过长的3字节
-                return false;
-            if (charLen == 4 && ptr[pos] == 0xF0 && ptr[pos + 1] < 0x90)  // 过长的4字节
-                return false;
-            if (charLen == 4 && ptr[pos] == 0xF4 && ptr[pos + 1] > 0x8F)  // 超出U+10FFFF
-                return false;
-
-            // 验证后续字节
-            for (int32 i = 1; i < charLen; ++i)
-            {
-                if (!_IsValidTrailByte(ptr[pos + i]))
-                {
-                    return false;
-                }
-            }
+            break;
         }
 
-        pos += charLen;
+        currentPos += len;
+        count++;
+    }
+
+    return count;
+}
+
+int64 String::_IndexToPos(int64 index) const
+{
+    // 边界检查
+    if (index <= 0) return 0;
+    if (index >= Count()) return Size();
+    // 每个字符都是单字节时直接返回
+    if (Size() == Count()) return index;
+
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(_Data());
+    int64 size = Size();
+    int64 bytePos = 0;
+    int64 charCount = 0;
+
+    // 从最近的检查点开始，最多遍历 CHAR_INDEX_STRIDE - 1 个字符
+    if (const int64* checkpoints = _GetCharIndex())
+    {
+        charCount = index - index % CHAR_INDEX_STRIDE;
+        bytePos = checkpoints[index / CHAR_INDEX_STRIDE];
+    }
+
+    while (charCount < index && bytePos < size)
+    {
+        bytePos += _CharLengthAt(ptr + bytePos, size - bytePos);
+        charCount++;
     }
 
-    return true;
+    return bytePos;
+}
+
+bool String::_IsValidUTF8String() const
+{
+    return Utf8::IsValid(_Data(), Size());
 }
 
-int64 String::_NextCharPos(const std::string& str, int64 currentPos) const
+int64 String::_NextCharPos(int64 currentPos) const
 {
-    if (currentPos < 0 || currentPos >= static_cast<int64>(str.size()))
+    if (currentPos < 0 || currentPos >= Size())
     {
         return -1;
     }
 
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str.data());
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(_Data());
     int32 len = _GetCharLength(ptr[currentPos]);
 
-    return currentPos + len;
+    return std::min(currentPos + len, Size());
 }
 
-int64 String::_PrevCharPos(const std::string& str, int64 currentPos) const
+int64 String::_PrevCharPos(int64 currentPos) const
 {
-    if (currentPos <= 0 || currentPos > static_cast<int64>(str.size()))
+    if (currentPos <= 0 || currentPos > Size())
     {
         return -1;
     }
 
     int64 pos = currentPos - 1;
-    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(str.data());
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(_Data());
 
     // 向后找到字符的首字节
     while (pos > 0 && (ptr[pos] & 0xC0) == 0x80)
@@ -1410,4 +1797,4 @@ int64 String::_PrevCharPos(const std::string& str, int64 currentPos) const
     }
 
     return pos;
-}
\ No newline at end of file
+}
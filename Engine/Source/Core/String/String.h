@@ -3,20 +3,26 @@
 #include "Core.h"
 #include "Container/Array.h"
 #include "String/Char.h"
+#include "String/StringView.h"
 #include "Memory/ByteArray.h"
 
+class String;
+
 using StringList = Array<String>;
 
 class String
 {
 public:
     friend class Char;
+    friend class Base64;
+    friend class Hex;
+    friend class StringBuilder;
 public:
     // 默认构造函数
-    String() = default;
+    String() noexcept;
 
     // 析构函数
-    ~String() = default;
+    ~String();
 
     // 拷贝构造函数
     String(const String& other);
@@ -25,10 +31,10 @@ public:
     String& operator=(const String& other);
 
     // 移动构造函数
-    String(String&& other);
+    String(String&& other) noexcept;
 
     // 移动赋值
-    String& operator=(String&& other);
+    String& operator=(String&& other) noexcept;
 
     // 从 C 风格字符串构造
     String(const char* str);
@@ -36,6 +42,9 @@ public:
     // 从 C 风格字符串赋值
     String& operator=(const char* str);
 
+    // 从指定长度的 UTF-8 字节序列构造
+    String(const char* str, int64 size);
+
     // 从 C++ 字符串构造
     String(const std::string& str);
 
@@ -48,6 +57,12 @@ public:
     // 从字节数组赋值
     String& operator=(const ByteArray& buffer);
 
+    // 从字符串视图构造(复制数据)
+    explicit String(StringView str);
+
+    // 隐式转换为字符串视图
+    operator StringView() const noexcept;
+
     operator std::filesystem::path() const;
 
     // 隐式转化为 const std::string
@@ -57,43 +72,43 @@ public:
     operator bool() const;
 public:
     // 将字符串附加到末尾
-    String& Append(const String& str);
+    String& Append(StringView str);
 
     // 将字符附加到末尾
     String& Append(const Char& ch);
 
     // 将字符串添加到开头
-    String& Prepend(const String& str);
+    String& Prepend(StringView str);
 
     // 将字符添加到开头
     String& Prepend(const Char& ch);
 
     // 比较两个字符串
-    int64 Compare(const String& str) const;
+    int64 Compare(StringView str) const;
 
     // 判断字符串是否包含有给定的子串 
-    bool Contains(const String& str) const;
+    bool Contains(StringView str) const;
 
     // 判断字符串是否包含有给定的字符
     bool Contains(const Char& ch) const;
 
     // 返回给定子串在字符串中首次出现的索引位置
-    int64 IndexOf(const String& str) const;
+    int64 IndexOf(StringView str) const;
 
     // 返回给定子串在字符串中首次出现的索引位置
     int64 IndexOf(const Char& ch) const;
 
     // 返回给定字符在字符串中最后出现的索引位置
-    int64 LastIndexOf(const String& str) const;
+    int64 LastIndexOf(StringView str) const;
 
     // 返回给定字符在字符串中最后出现的索引位置
     int64 LastIndexOf(const Char& ch) const;
 
     // 判断字符串是否有给定前缀
-    bool StartWith(const String& str) const;
+    bool StartWith(StringView str) const;
 
     // 判断字符串是否有给定后缀
-    bool EndWith(const String& str) const;
+    bool EndWith(StringView str) const;
 
     // 从字符串起始移除 count 个字符
     String& RemoveLeft(int64 count);
@@ -134,17 +149,44 @@ public:
     // 移除字符串右侧的空白字符
     String& TrimRight();
 
+    // 返回转换为小写的副本(ASCII 部分按向量批量转换，其余字符查表转换)
+    String ToLower() const;
+
+    // 返回转换为大写的副本
+    String ToUpper() const;
+
+    // 返回大小写折叠后的副本，折叠结果相同的字符串不区分大小写时相等
+    String CaseFold() const;
+
     // 返回以 sep 分割符分割的字符串中的所有部分
     StringList Split(char sep) const;
 
+    // 按分隔符惰性切分，逐段返回子视图，不复制数据
+    SplitRange SplitView(char sep) const;
+
+    // 按分隔字符串惰性切分，逐段返回子视图，不复制数据
+    SplitRange SplitView(StringView sep) const;
+
+    // 以 delimiters 中的任一字节切分并跳过空段，结果写入 tokens(先清空)
+    int64 Tokenize(StringView delimiters, Array<StringView>& tokens) const;
+
+    // 返回整个字符串的视图
+    StringView View() const noexcept;
+
+    // 返回从 index 位置开始的 count 个字符的视图
+    StringView SubView(int64 index, int64 count) const;
+
+    // 按码点遍历(支持 rbegin/rend 反向遍历)，就地解码，不分配内存
+    CharRange Chars() const;
+
     // 用于将正则表达式 regexp 与字符串匹配
-    String Match(const String& regex);
+    String Match(StringView regex);
 
     // 向指定位置插入字符串
-    String& Insert(int64 index, const String& str);
+    String& Insert(int64 index, StringView str);
 
     // 替换字符串的指定部分
-    String& Replace(int64 index, int64 count, const String& str);
+    String& Replace(int64 index, int64 count, StringView str);
 
     // 使当前字符串重复 n 次
     String& Repeat(int64 count);
@@ -173,6 +215,9 @@ public:
     // 判断字符串是否仅包含数字字符
     bool IsNumeric() const;
 
+    // 判断字符串是否仅包含 ASCII 字符
+    bool IsASCII() const;
+
     // 判断索引是否为有效值
     bool IsValid(int64 index) const;
 
@@ -212,24 +257,68 @@ public:
     // 将字符串转换为 double 类型的值
     double ToDouble() const;
 
+    // 尝试将字符串转换为整数，格式无效、有多余字符或超出范围时返回 false(不抛出异常)
+    template<class Type> requires std::is_integral_v<Type> && (!std::is_same_v<Type, bool>)
+    bool TryParse(Type& value, int base = 10) const noexcept
+    {
+        return View().TryParse(value, base);
+    }
+
+    // 尝试将字符串转换为浮点数(与区域设置无关)，失败时返回 false
+    template<class Type> requires std::is_floating_point_v<Type>
+    bool TryParse(Type& value) const noexcept
+    {
+        return View().TryParse(value);
+    }
+
+    // 尝试将字符串转换为布尔值，失败时返回 false
+    bool TryParse(bool& value) const noexcept
+    {
+        return View().TryParse(value);
+    }
+
     // 将字符串转换为 C++ 类型的字符串
     std::string ToStdString() const;
 
     // 将字符串转换为 C 类型的字符串
     const char* ToCString() const;
+
+    // 转换为 UTF-16(不含结尾的 0)，按预先计算的长度一次分配，ASCII 部分按向量批量转换；不是有效的 UTF-8 时抛出 std::invalid_argument
+    Array<char16> ToUtf16() const;
+
+    // 转换为 UTF-32，长度即字符数；不是有效的 UTF-8 时抛出 std::invalid_argument
+    Array<char32> ToUtf32() const;
+
+    // 返回 UTF-8 字节数据(以 '\0' 结尾)
+    const char* Data() const;
 public:
-    Char operator[](int64 index);
+    Char operator[](int64 index) const;
 
     String& operator+=(const String& str);
 
+    String& operator+=(StringView str);
+
+    String& operator+=(const char* str);
+
     String& operator+=(char ch);
 
     friend String operator+(const String& left, const String& right);
 
+    friend String operator+(const String& left, StringView right);
+
+    friend String operator+(StringView left, const String& right);
+
     friend String operator+(const String& left, const char* right);
 
     friend String operator+(const char* left, const String& right);
 
+    // 左侧为临时字符串时原地追加并移出，a + b + c + d 沿用第一次拼接的结果，不产生中间字符串
+    friend String operator+(String&& left, const String& right);
+
+    friend String operator+(String&& left, StringView right);
+
+    friend String operator+(String&& left, const char* right);
+
     friend bool operator==(const String& left, const String& right);
 
     friend bool operator==(const String& left, const char* right);
@@ -272,6 +361,12 @@ public:
 
     static String FromCString(const char* str);
 
+    // 从 UTF-16 构造，含未配对的代理项时抛出 std::invalid_argument
+    static String FromUtf16(const char16* data, int64 size);
+
+    // 从 UTF-32 构造，含无效码点时抛出 std::invalid_argument
+    static String FromUtf32(const char32* data, int64 size);
+
     static String FromInt8(int8 value);
 
     static String FromInt16(int16 value);
@@ -298,52 +393,173 @@ public:
     inline static const char* Empty = "";
 private:
     /// <summary>
-    /// 获取UTF-8字符的字节长度（从首字节判断）
+    /// 内联存储可容纳的最大字节数(不含结尾的 '\0')
     /// </summary>
-    int32 _GetCharLength(unsigned char firstByte) const;
+    static constexpr int64 INLINE_CAPACITY = 23;
     /// <summary>
-    /// 验证是否为有效的UTF-8连续字节
+    /// 头部标志：数据存放在堆上
+    /// </summary>
+    static constexpr uint64 FLAG_HEAP = 1;
+    /// <summary>
+    /// 头部标志：全部为 ASCII 字符
     /// </summary>
-    bool _IsValidTrailByte(unsigned char byte) const;
+    static constexpr uint64 FLAG_ASCII = 2;
     /// <summary>
-    /// 计算 UTF-8 字符串的字符数量
+    /// 头部中内联字节数的偏移
     /// </summary>
-    int64 _CalcCharCount(const char* str) const;
+    static constexpr int32 INLINE_SIZE_SHIFT = 8;
     /// <summary>
-    /// 计算 UTF-8 字符串的字符数量（std::string版本）
+    /// 头部中字符数的偏移
     /// </summary>
-    int64 _CalcCharCount(const std::string& str) const;
+    static constexpr int32 COUNT_SHIFT = 16;
     /// <summary>
-    /// 计算从开始到指定字节位置的字符数
+    /// 字符索引中相邻检查点间隔的字符数
     /// </summary>
-    int64 _CalcCharCount(const char* str, int64 bytePos) const;
+    static constexpr int64 CHAR_INDEX_STRIDE = 64;
     /// <summary>
-    /// 计算从开始到指定字节位置的字符数
+    /// 长字符串的堆存储
     /// </summary>
-    int64 _CalcCharCount(const std::string& str, int64 bytePos) const;
+    struct HeapBuffer
+    {
+        // 数据指针
+        char* Data;
+        // 字节数
+        int64 Size;
+        // 容量(不含结尾的 '\0')
+        int64 Capacity;
+    };
+private:
+    /// <summary>
+    /// 获取数据指针
+    /// </summary>
+    char* _Data();
+    /// <summary>
+    /// 获取数据指针
+    /// </summary>
+    const char* _Data() const;
     /// <summary>
-    /// 将字符索引转换为字节位置（优化版）
+    /// 是否使用堆存储
     /// </summary>
-    int64 _IndexToPos(const std::string& str, int64 index) const;
+    bool _IsHeap() const;
     /// <summary>
-    /// 从字节位置获取完整的UTF-8字符（新功能）
+    /// 设置字节数并写入结尾的 '\0'
     /// </summary>
-    std::string _GetCharAtBytePos(const std::string& str, int64 bytePos) const;
+    void _SetSize(int64 size);
     /// <summary>
-    /// 验证整个字符串是否为有效的UTF-8编码（新功能）
+    /// 设置字符数和 ASCII 标志
     /// </summary>
-    bool _IsValidUTF8String(const std::string& str) const;
+    void _SetCount(int64 count, bool ascii);
     /// <summary>
-    /// 获取下一个字符的起始位置（新功能）
+    /// 确保容量至少为 capacity 字节，保留原有内容
     /// </summary>
-    int64 _NextCharPos(const std::string& str, int64 currentPos) const;
+    void _Grow(int64 capacity);
     /// <summary>
-    /// 获取上一个字符的起始位置（新功能）
+    /// 释放堆存储并恢复为空的内联存储
     /// </summary>
-    int64 _PrevCharPos(const std::string& str, int64 currentPos) const;
+    void _Release();
+    /// <summary>
+    /// 分配可容纳 capacity 字节的堆存储，数据前预留存放字符索引的块头
+    /// </summary>
+    static char* _AllocateHeap(int64 capacity);
+    /// <summary>
+    /// 释放堆存储及其字符索引
+    /// </summary>
+    static void _FreeHeap(char* data, int64 capacity);
+    /// <summary>
+    /// 获取字符索引，首次使用时构建(多线程同时读取是安全的)
+    /// <para>第 i 项为第 i * CHAR_INDEX_STRIDE 个字符的字节位置，字符数较少或纯单字节时返回空</para>
+    /// </summary>
+    const int64* _GetCharIndex() const;
+    /// <summary>
+    /// 内容修改后丢弃字符索引
+    /// </summary>
+    void _ResetCharIndex();
+    /// <summary>
+    /// 丢弃原有内容并准备 size 字节的未初始化空间，供调用者直接写入
+    /// <para>写入完成后需调用 _SetCount 设置字符数</para>
+    /// </summary>
+    char* _Allocate(int64 size);
+    /// <summary>
+    /// 以字节序列替换全部内容并统计字符数
+    /// </summary>
+    void _Assign(const char* data, int64 size);
+    /// <summary>
+    /// 在末尾追加已知字符数的字节序列(可以指向自身)
+    /// </summary>
+    void _Append(const char* data, int64 size, int64 count, bool ascii);
+    /// <summary>
+    /// [0, pos) 与 [pos, end) 分别统计字符数后拼接在一起时，修正接缝处的字符数
+    /// <para>前一段末尾不完整的多字节序列可能与后一段开头的后续字节组成一个字符，只需重新统计接缝两侧至多 3 个字节</para>
+    /// </summary>
+    void _JoinCount(int64 pos, int64 end);
+    /// <summary>
+    /// 替换 [pos, pos + length) 范围内的字节，不更新字符数
+    /// </summary>
+    void _Splice(int64 pos, int64 length, const char* data, int64 size);
+    /// <summary>
+    /// 重新扫描内容以更新 ASCII 标志(删除非 ASCII 字符后调用)
+    /// </summary>
+    void _RefreshASCII();
+    /// <summary>
+    /// 一次遍历同时统计字符数并检查是否全部为 ASCII
+    /// </summary>
+    static int64 _Scan(const char* data, int64 size, bool& ascii);
+    /// <summary>
+    /// 以 std::to_chars 将数值直接写入栈上缓冲区后构造(浮点数为最短的可往返表示)
+    /// </summary>
+    template<class Type>
+    static String _FromNumber(Type value);
+    /// <summary>
+    /// 按指定方式转换大小写，结果与原字符串字节数、字符数相同
+    /// </summary>
+    String _MapCase(Char::CaseMapping mapping) const;
+    /// <summary>
+    /// 获取 ptr 处字符的字节长度，后续字节不足或无效时按单字节处理
+    /// </summary>
+    static int32 _CharLengthAt(const unsigned char* ptr, int64 available);
+    /// <summary>
+    /// 获取UTF-8字符的字节长度（从首字节判断）
+    /// </summary>
+    static int32 _GetCharLength(unsigned char firstByte);
+    /// <summary>
+    /// 验证是否为有效的UTF-8连续字节
+    /// </summary>
+    static bool _IsValidTrailByte(unsigned char byte);
+    /// <summary>
+    /// 计算当前字符串从开始到指定字节位置的字符数
+    /// </summary>
+    int64 _CalcCharCount(int64 bytePos) const;
+    /// <summary>
+    /// 将字符索引转换为字节位置
+    /// </summary>
+    int64 _IndexToPos(int64 index) const;
+    /// <summary>
+    /// 验证整个字符串是否为有效的UTF-8编码
+    /// </summary>
+    bool _IsValidUTF8String() const;
+    /// <summary>
+    /// 获取下一个字符的起始位置
+    /// </summary>
+    int64 _NextCharPos(int64 currentPos) const;
+    /// <summary>
+    /// 获取上一个字符的起始位置
+    /// </summary>
+    int64 _PrevCharPos(int64 currentPos) const;
 private:
-    // UTF-8 字符串
-    std::string m_data;
-    // Unicode 字符数量
-    int64 m_count;
-};
\ No newline at end of file
+    // 短字符串直接存放在对象内，长字符串存放在堆上
+    union
+    {
+        HeapBuffer m_heap;
+        char m_inline[INLINE_CAPACITY + 1];
+    };
+    // 低 8 位为标志，8-15 位为内联字节数，其余为 Unicode 字符数量
+    uint64 m_header;
+};
+template<>
+struct std::hash<String>
+{
+    size_t operator()(const String& str) const noexcept
+    {
+        return std::hash<std::string_view>()(std::string_view(str.Data(), static_cast<size_t>(str.Size())));
+    }
+};
@@ -0,0 +1,254 @@
+#include "pch.h"
+
+#include "StringBuilder.h"
+#include "Utf8.h"
+
+#include <cstring>
+
+StringBuilder::StringBuilder(MemoryResource* resource)
+{
+    m_allocator.m_resource = resource;
+}
+
+StringBuilder::~StringBuilder()
+{
+    _FreeChunks();
+}
+
+StringBuilder::StringBuilder(StringBuilder&& other) noexcept
+    : m_head(std::exchange(other.m_head, nullptr))
+    , m_tail(std::exchange(other.m_tail, nullptr))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_count(std::exchange(other.m_count, 0))
+    , m_ascii(std::exchange(other.m_ascii, true))
+    , m_valid(std::exchange(other.m_valid, true))
+    , m_allocator(other.m_allocator)
+{
+
+}
+
+StringBuilder& StringBuilder::operator=(StringBuilder&& other) noexcept
+{
+    if (this != &other)
+    {
+        _FreeChunks();
+        m_head = std::exchange(other.m_head, nullptr);
+        m_tail = std::exchange(other.m_tail, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_count = std::exchange(other.m_count, 0);
+        m_ascii = std::exchange(other.m_ascii, true);
+        m_valid = std::exchange(other.m_valid, true);
+        m_allocator = other.m_allocator;
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::Append(StringView str)
+{
+    bool ascii = false;
+    int64 count = Utf8::ValidateAndCount(str.Data(), str.Size(), ascii);
+    if (count < 0)
+    {
+        m_valid = false;
+        ascii = false;
+        count = 0;
+    }
+    _Append(str.Data(), str.Size(), count, ascii);
+    return *this;
+}
+
+StringBuilder& StringBuilder::Append(const String& str)
+{
+    _Append(str.Data(), str.Size(), str.Count(), str.IsASCII());
+    return *this;
+}
+
+StringBuilder& StringBuilder::Append(const char* str)
+{
+    return Append(StringView(str));
+}
+
+StringBuilder& StringBuilder::Append(char ch)
+{
+    // 单个非 ASCII 字节只是多字节字符的一部分，生成时再统一统计
+    if (static_cast<unsigned char>(ch) >= 0x80)
+    {
+        m_valid = false;
+        m_ascii = false;
+    }
+    else
+    {
+        m_count++;
+    }
+
+    if (m_tail && m_tail->Size < m_tail->Capacity)
+    {
+        m_tail->Data()[m_tail->Size++] = ch;
+        m_size++;
+    }
+    else
+    {
+        _Write(&ch, 1);
+    }
+    return *this;
+}
+
+StringBuilder& StringBuilder::AppendLine(StringView str)
+{
+    Append(str);
+    return Append('\n');
+}
+
+void StringBuilder::Reserve(int64 size)
+{
+    int64 available = m_tail ? m_tail->Capacity - m_tail->Size : 0;
+    if (size <= available)
+    {
+        return;
+    }
+
+    // 在当前块之后插入足够大的新块，写满当前块后直接进入新块
+    size -= available;
+    int64 units = 1 + (size + static_cast<int64>(sizeof(Chunk)) - 1) / static_cast<int64>(sizeof(Chunk));
+    Chunk* chunk = m_allocator.Allocate<Chunk>(units);
+    chunk->Next = m_tail ? m_tail->Next : nullptr;
+    chunk->Size = 0;
+    chunk->Capacity = (units - 1) * static_cast<int64>(sizeof(Chunk));
+    if (m_tail)
+    {
+        m_tail->Next = chunk;
+    }
+    else
+    {
+        m_head = m_tail = chunk;
+    }
+}
+
+void StringBuilder::Clear()
+{
+    for (Chunk* chunk = m_head; chunk; chunk = chunk->Next)
+    {
+        chunk->Size = 0;
+    }
+    m_tail = m_head;
+    m_size = 0;
+    m_count = 0;
+    m_ascii = true;
+    m_valid = true;
+}
+
+int64 StringBuilder::Size() const
+{
+    return m_size;
+}
+
+int64 StringBuilder::Count() const
+{
+    if (m_valid)
+    {
+        return m_count;
+    }
+    return ToString().Count();
+}
+
+bool StringBuilder::IsEmpty() const
+{
+    return m_size == 0;
+}
+
+String StringBuilder::ToString() const
+{
+    String str;
+    char* buffer = str._Allocate(m_size);
+    _CopyTo(buffer);
+    if (m_valid)
+    {
+        str._SetCount(m_count, m_ascii);
+    }
+    else
+    {
+        // 逐字节追加或含无效序列时，按拼接后的完整内容统计
+        bool ascii = false;
+        int64 count = String::_Scan(buffer, m_size, ascii);
+        str._SetCount(count, ascii);
+    }
+    return str;
+}
+
+void StringBuilder::_Append(const char* data, int64 size, int64 count, bool ascii)
+{
+    if (size <= 0)
+    {
+        return;
+    }
+    _Write(data, size);
+    m_count += count;
+    m_ascii = m_ascii && ascii;
+}
+
+void StringBuilder::_Write(const char* data, int64 size)
+{
+    while (size > 0)
+    {
+        if (!m_tail || m_tail->Size == m_tail->Capacity)
+        {
+            _NextChunk(size);
+        }
+        int64 length = std::min(size, m_tail->Capacity - m_tail->Size);
+        std::memcpy(m_tail->Data() + m_tail->Size, data, length);
+        m_tail->Size += length;
+        m_size += length;
+        data += length;
+        size -= length;
+    }
+}
+
+void StringBuilder::_NextChunk(int64 size)
+{
+    // Clear 之后重复使用已有的块
+    if (m_tail && m_tail->Next)
+    {
+        m_tail = m_tail->Next;
+        return;
+    }
+
+    // 块容量随已写入的总量增长，单次追加的内容不拆分到多个新块
+    int64 capacity = std::max(size, std::clamp(m_size, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE));
+    int64 units = 1 + (capacity + static_cast<int64>(sizeof(Chunk)) - 1) / static_cast<int64>(sizeof(Chunk));
+    Chunk* chunk = m_allocator.Allocate<Chunk>(units);
+    chunk->Next = nullptr;
+    chunk->Size = 0;
+    chunk->Capacity = (units - 1) * static_cast<int64>(sizeof(Chunk));
+    if (m_tail)
+    {
+        m_tail->Next = chunk;
+    }
+    else
+    {
+        m_head = chunk;
+    }
+    m_tail = chunk;
+}
+
+void StringBuilder::_FreeChunks()
+{
+    Chunk* chunk = m_head;
+    while (chunk)
+    {
+        Chunk* next = chunk->Next;
+        int64 units = 1 + chunk->Capacity / static_cast<int64>(sizeof(Chunk));
+        m_allocator.Deallocate(chunk, units);
+        chunk = next;
+    }
+    m_head = nullptr;
+    m_tail = nullptr;
+}
+
+void StringBuilder::_CopyTo(char* buffer) const
+{
+    for (Chunk* chunk = m_head; chunk && chunk->Size > 0; chunk = chunk->Next)
+    {
+        std::memcpy(buffer, chunk->Data(), chunk->Size);
+        buffer += chunk->Size;
+    }
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Core.h"
+#include "String/String.h"
+#include "String/StringView.h"
+#include "Container/Allocator/Allocator.h"
+
+#include <charconv>
+#include <format>
+#include <string>
+#include <utility>
+#include <type_traits>
+
+/// <summary>
+/// 字符串构建器
+/// <para>内容追加到按块分配的缓冲区中，缓冲区满时链接新块而不搬移已写入的数据；追加时同步累计字符数</para>
+/// <para>ToString 按总长度一次分配并复制各块，得到的 String 无需重新统计字符数</para>
+/// <para>可指定内存资源，块从内存资源中分配(如帧内临时分配器)；Clear 保留已分配的块以便重复使用</para>
+/// </summary>
+class StringBuilder
+{
+public:
+    /// <summary>
+    /// 默认构造函数，首次追加时才分配内存
+    /// </summary>
+    StringBuilder() = default;
+    /// <summary>
+    /// 从指定的内存资源分配缓冲块
+    /// </summary>
+    /// <param name="resource">内存资源，必须比构建器存活更久</param>
+    explicit StringBuilder(MemoryResource* resource);
+    /// <summary>
+    /// 析构函数
+    /// </summary>
+    ~StringBuilder();
+    /// <summary>
+    /// 禁止拷贝构造
+    /// </summary>
+    StringBuilder(const StringBuilder& other) = delete;
+    /// <summary>
+    /// 禁止拷贝赋值
+    /// </summary>
+    StringBuilder& operator=(const StringBuilder& other) = delete;
+    /// <summary>
+    /// 移动构造函数
+    /// </summary>
+    StringBuilder(StringBuilder&& other) noexcept;
+    /// <summary>
+    /// 移动赋值函数
+    /// </summary>
+    StringBuilder& operator=(StringBuilder&& other) noexcept;
+public:
+    /// <summary>
+    /// 追加字符串视图(校验并统计其字符数)
+    /// </summary>
+    StringBuilder& Append(StringView str);
+    /// <summary>
+    /// 追加字符串(直接使用其已知的字符数)
+    /// </summary>
+    StringBuilder& Append(const String& str);
+    /// <summary>
+    /// 追加 C 风格字符串
+    /// </summary>
+    StringBuilder& Append(const char* str);
+    /// <summary>
+    /// 追加单个字节
+    /// </summary>
+    StringBuilder& Append(char ch);
+    /// <summary>
+    /// 追加字符串视图与换行符
+    /// </summary>
+    StringBuilder& AppendLine(StringView str = StringView());
+    /// <summary>
+    /// 按 std::format 格式追加，较短的结果先写入栈上缓冲区，不产生临时字符串
+    /// </summary>
+    template<class... Args>
+    StringBuilder& AppendFormat(std::format_string<Args...> fmt, Args&&... args)
+    {
+        char buffer[FORMAT_BUFFER_SIZE];
+        auto result = std::format_to_n(buffer, FORMAT_BUFFER_SIZE, fmt, std::forward<Args>(args)...);
+        if (result.size <= FORMAT_BUFFER_SIZE)
+        {
+            return Append(StringView(buffer, static_cast<int64>(result.size)));
+        }
+        std::string text = std::format(fmt, std::forward<Args>(args)...);
+        return Append(StringView(text));
+    }
+    /// <summary>
+    /// 以 std::to_chars 追加数值(浮点数为最短的可往返表示)，不产生临时字符串
+    /// </summary>
+    template<class Type> requires std::is_arithmetic_v<Type> && (!std::is_same_v<Type, bool>) && (!std::is_same_v<Type, char>)
+    StringBuilder& AppendNumber(Type value)
+    {
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        int64 size = result.ptr - buffer;
+        _Append(buffer, size, size, true);
+        return *this;
+    }
+    /// <summary>
+    /// 确保再追加 size 个字节时不再分配内存
+    /// </summary>
+    void Reserve(int64 size);
+    /// <summary>
+    /// 清空内容，保留已分配的缓冲块
+    /// </summary>
+    void Clear();
+    /// <summary>
+    /// 获取已追加的字节数
+    /// </summary>
+    int64 Size() const;
+    /// <summary>
+    /// 获取已追加的字符数
+    /// </summary>
+    int64 Count() const;
+    /// <summary>
+    /// 判断是否为空
+    /// </summary>
+    bool IsEmpty() const;
+    /// <summary>
+    /// 生成字符串(一次分配)
+    /// </summary>
+    String ToString() const;
+private:
+    /// <summary>
+    /// 缓冲块，数据紧跟在块头之后
+    /// </summary>
+    struct Chunk
+    {
+        // 下一个块
+        Chunk* Next;
+        // 已写入的字节数
+        int64 Size;
+        // 容量
+        int64 Capacity;
+
+        char* Data()
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+private:
+    /// <summary>
+    /// 写入字节并累计字符数
+    /// </summary>
+    void _Append(const char* data, int64 size, int64 count, bool ascii);
+    /// <summary>
+    /// 写入字节，不更新字符数
+    /// </summary>
+    void _Write(const char* data, int64 size);
+    /// <summary>
+    /// 切换到下一个可写的块，没有时分配至少能容纳 size 字节的新块
+    /// </summary>
+    void _NextChunk(int64 size);
+    /// <summary>
+    /// 释放全部缓冲块
+    /// </summary>
+    void _FreeChunks();
+    /// <summary>
+    /// 将全部内容复制到 buffer
+    /// </summary>
+    void _CopyTo(char* buffer) const;
+private:
+    /// <summary>
+    /// 新块的最小容量
+    /// </summary>
+    static constexpr int64 MIN_CHUNK_SIZE = 256;
+    /// <summary>
+    /// 新块的最大容量(单次追加更长时按实际长度分配)
+    /// </summary>
+    static constexpr int64 MAX_CHUNK_SIZE = 64 * 1024;
+    /// <summary>
+    /// AppendFormat 的栈上缓冲区大小
+    /// </summary>
+    static constexpr int64 FORMAT_BUFFER_SIZE = 256;
+private:
+    // 第一个块
+    Chunk* m_head = nullptr;
+    // 当前写入的块
+    Chunk* m_tail = nullptr;
+    // 已追加的字节数
+    int64 m_size = 0;
+    // 已追加的字符数
+    int64 m_count = 0;
+    // 是否全部为 ASCII 字符
+    bool m_ascii = true;
+    // 追加的内容是否都是有效的 UTF-8(否则字符数需在生成时重新统计)
+    bool m_valid = true;
+    // 块分配器
+    Allocator m_allocator;
+};
@@ -0,0 +1,285 @@
+#include "pch.h"
+
+#include "StringSearch.h"
+#include "CpuFeatures.h"
+
+#include <bit>
+#include <cstring>
+#include <string_view>
+
+#if defined(CPU_ARCH_X64)
+    #include <immintrin.h>
+#elif defined(CPU_ARCH_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+    /*
+     * 首尾字节过滤(W. Muła, "SIMD-friendly algorithms for substring searching")：
+     * 将模式的首字节与尾字节分别广播(单字节模式两者相同)，与文本中从 i 与 i + m - 1 开始的两个向量比较，两者按位与后的每一位对应一个候选起点；
+     * 只有首尾字节都相等的候选才比较中间的 m - 2 个字节。
+     * 正向内核返回找到的位置，否则通过 scanned 返回已排除的候选起点数；反向内核通过 remaining 返回尚未检查的候选起点数
+     */
+
+    using FindKernel = int64(*)(const char*, int64, const char*, int64, int64&);
+
+    inline bool MatchMiddle(const char* candidate, const char* pattern, int64 patternSize)
+    {
+        return patternSize <= 2 || std::memcmp(candidate + 1, pattern + 1, static_cast<size_t>(patternSize - 2)) == 0;
+    }
+
+#if defined(CPU_ARCH_X64)
+    CPU_TARGET_SSE42 int64 FindSse(const char* text, int64 size, const char* pattern, int64 patternSize, int64& scanned)
+    {
+        const __m128i first = _mm_set1_epi8(pattern[0]);
+        const __m128i last = _mm_set1_epi8(pattern[patternSize - 1]);
+        int64 pos = 0;
+        for (; pos + patternSize - 1 + 16 <= size; pos += 16)
+        {
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + pos + patternSize - 1));
+            uint32 mask = static_cast<uint32>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+            while (mask != 0)
+            {
+                int32 bit = std::countr_zero(mask);
+                if (MatchMiddle(text + pos + bit, pattern, patternSize))
+                {
+                    return pos + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+        scanned = pos;
+        return -1;
+    }
+
+    CPU_TARGET_SSE42 int64 FindLastSse(const char* text, int64 size, const char* pattern, int64 patternSize, int64& remaining)
+    {
+        const __m128i first = _mm_set1_epi8(pattern[0]);
+        const __m128i last = _mm_set1_epi8(pattern[patternSize - 1]);
+        int64 end = size - patternSize + 1;
+        for (; end >= 16; end -= 16)
+        {
+            int64 base = end - 16;
+            __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + base));
+            __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + base + patternSize - 1));
+            uint32 mask = static_cast<uint32>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last))));
+            while (mask != 0)
+            {
+                int32 bit = 31 - std::countl_zero(mask);
+                if (MatchMiddle(text + base + bit, pattern, patternSize))
+                {
+                    return base + bit;
+                }
+                mask &= ~(1u << bit);
+            }
+        }
+        remaining = end;
+        return -1;
+    }
+
+    CPU_TARGET_AVX2 int64 FindAvx2(const char* text, int64 size, const char* pattern, int64 patternSize, int64& scanned)
+    {
+        const __m256i first = _mm256_set1_epi8(pattern[0]);
+        const __m256i last = _mm256_set1_epi8(pattern[patternSize - 1]);
+        int64 pos = 0;
+        for (; pos + patternSize - 1 + 32 <= size; pos += 32)
+        {
+            __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos));
+            __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + pos + patternSize - 1));
+            uint32 mask = static_cast<uint32>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+            while (mask != 0)
+            {
+                int32 bit = std::countr_zero(mask);
+                if (MatchMiddle(text + pos + bit, pattern, patternSize))
+                {
+                    return pos + bit;
+                }
+                mask &= mask - 1;
+            }
+        }
+        scanned = pos;
+        return -1;
+    }
+
+    CPU_TARGET_AVX2 int64 FindLastAvx2(const char* text, int64 size, const char* pattern, int64 patternSize, int64& remaining)
+    {
+        const __m256i first = _mm256_set1_epi8(pattern[0]);
+        const __m256i last = _mm256_set1_epi8(pattern[patternSize - 1]);
+        int64 end = size - patternSize + 1;
+        for (; end >= 32; end -= 32)
+        {
+            int64 base = end - 32;
+            __m256i blockFirst = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + base));
+            __m256i blockLast = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + base + patternSize - 1));
+            uint32 mask = static_cast<uint32>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last))));
+            while (mask != 0)
+            {
+                int32 bit = 31 - std::countl_zero(mask);
+                if (MatchMiddle(text + base + bit, pattern, patternSize))
+                {
+                    return base + bit;
+                }
+                mask &= ~(1u << bit);
+            }
+        }
+        remaining = end;
+        return -1;
+    }
+
+    template<class Kernel>
+    Kernel SelectKernel(Kernel sse, Kernel avx2)
+    {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.AVX2)
+        {
+            return avx2;
+        }
+        if (features.SSE42)
+        {
+            return sse;
+        }
+        return nullptr;
+    }
+#elif defined(CPU_ARCH_ARM64)
+    /* NEON 没有 movemask，将比较结果右移窄化为每个字节 4 位的 64 位掩码 */
+
+    inline uint64 CandidateMaskNeon(const char* text, int64 pos, int64 patternSize, uint8x16_t first, uint8x16_t last)
+    {
+        uint8x16_t blockFirst = vld1q_u8(reinterpret_cast<const uint8*>(text + pos));
+        uint8x16_t blockLast = vld1q_u8(reinterpret_cast<const uint8*>(text + pos + patternSize - 1));
+        uint8x16_t eq = vandq_u8(vceqq_u8(blockFirst, first), vceqq_u8(blockLast, last));
+        uint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        return mask & 0x8888888888888888ull;
+    }
+
+    int64 FindNeon(const char* text, int64 size, const char* pattern, int64 patternSize, int64& scanned)
+    {
+        const uint8x16_t first = vdupq_n_u8(static_cast<uint8>(pattern[0]));
+        const uint8x16_t last = vdupq_n_u8(static_cast<uint8>(pattern[patternSize - 1]));
+        int64 pos = 0;
+        for (; pos + patternSize - 1 + 16 <= size; pos += 16)
+        {
+            uint64 mask = CandidateMaskNeon(text, pos, patternSize, first, last);
+            while (mask != 0)
+            {
+                int32 lane = std::countr_zero(mask) >> 2;
+                if (MatchMiddle(text + pos + lane, pattern, patternSize))
+                {
+                    return pos + lane;
+                }
+                mask &= mask - 1;
+            }
+        }
+        scanned = pos;
+        return -1;
+    }
+
+    int64 FindLastNeon(const char* text, int64 size, const char* pattern, int64 patternSize, int64& remaining)
+    {
+        const uint8x16_t first = vdupq_n_u8(static_cast<uint8>(pattern[0]));
+        const uint8x16_t last = vdupq_n_u8(static_cast<uint8>(pattern[patternSize - 1]));
+        int64 end = size - patternSize + 1;
+        for (; end >= 16; end -= 16)
+        {
+            int64 base = end - 16;
+            uint64 mask = CandidateMaskNeon(text, base, patternSize, first, last);
+            while (mask != 0)
+            {
+                int32 bit = 63 - std::countl_zero(mask);
+                if (MatchMiddle(text + base + (bit >> 2), pattern, patternSize))
+                {
+                    return base + (bit >> 2);
+                }
+                mask &= ~(1ull << bit);
+            }
+        }
+        remaining = end;
+        return -1;
+    }
+#endif
+
+    FindKernel GetFindKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const FindKernel kernel = SelectKernel<FindKernel>(&FindSse, &FindAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &FindNeon;
+#else
+        return nullptr;
+#endif
+    }
+
+    FindKernel GetFindLastKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const FindKernel kernel = SelectKernel<FindKernel>(&FindLastSse, &FindLastAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &FindLastNeon;
+#else
+        return nullptr;
+#endif
+    }
+}
+
+int64 StringSearch::Find(const char* text, int64 size, const char* pattern, int64 patternSize)
+{
+    if (patternSize == 0)
+    {
+        return 0;
+    }
+    if (patternSize > size)
+    {
+        return -1;
+    }
+    if (patternSize == 1)
+    {
+        const void* ptr = std::memchr(text, pattern[0], static_cast<size_t>(size));
+        return ptr ? static_cast<const char*>(ptr) - text : -1;
+    }
+
+    int64 scanned = 0;
+    if (FindKernel kernel = GetFindKernel())
+    {
+        int64 pos = kernel(text, size, pattern, patternSize, scanned);
+        if (pos >= 0)
+        {
+            return pos;
+        }
+    }
+
+    // 剩余不足一个向量的候选起点
+    std::string_view rest(text + scanned, static_cast<size_t>(size - scanned));
+    size_t pos = rest.find(std::string_view(pattern, static_cast<size_t>(patternSize)));
+    return pos == std::string_view::npos ? -1 : scanned + static_cast<int64>(pos);
+}
+
+int64 StringSearch::FindLast(const char* text, int64 size, const char* pattern, int64 patternSize)
+{
+    if (patternSize == 0)
+    {
+        return size;
+    }
+    if (patternSize > size)
+    {
+        return -1;
+    }
+
+    int64 remaining = size - patternSize + 1;
+    if (FindKernel kernel = GetFindLastKernel())
+    {
+        int64 pos = kernel(text, size, pattern, patternSize, remaining);
+        if (pos >= 0)
+        {
+            return pos;
+        }
+    }
+
+    // 剩余的候选起点为 [0, remaining)
+    std::string_view rest(text, static_cast<size_t>(remaining + patternSize - 1));
+    size_t pos = rest.rfind(std::string_view(pattern, static_cast<size_t>(patternSize)));
+    return pos == std::string_view::npos ? -1 : static_cast<int64>(pos);
+}
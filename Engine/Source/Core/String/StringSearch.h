@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// 子串查找
+/// <para>支持 AVX2/SSE4.2/NEON 时使用首尾字节过滤：一次比较 32/16 个候选位置的首字节与尾字节，只对两者都相等的位置比较中间部分，
+/// 常见文本中绝大多数候选位置在向量比较阶段即被排除；首次调用时按 CPU 特性选择实现</para>
+/// <para>结果与 std::string_view::find/rfind 相同，空模式在起始(正向)或末尾(反向)位置匹配</para>
+/// </summary>
+class StringSearch
+{
+public:
+    /// <summary>
+    /// 查找模式第一次出现的位置
+    /// </summary>
+    /// <param name="text">文本</param>
+    /// <param name="size">文本字节数</param>
+    /// <param name="pattern">模式</param>
+    /// <param name="patternSize">模式字节数</param>
+    /// <returns>字节位置，未找到返回 -1</returns>
+    static int64 Find(const char* text, int64 size, const char* pattern, int64 patternSize);
+    /// <summary>
+    /// 查找模式最后一次出现的位置
+    /// </summary>
+    /// <param name="text">文本</param>
+    /// <param name="size">文本字节数</param>
+    /// <param name="pattern">模式</param>
+    /// <param name="patternSize">模式字节数</param>
+    /// <returns>字节位置，未找到返回 -1</returns>
+    static int64 FindLast(const char* text, int64 size, const char* pattern, int64 patternSize);
+};
@@ -0,0 +1,183 @@
+#include "pch.h"
+
+#include "StringView.h"
+#include "Utf8.h"
+
+/* StringView */
+int64 StringView::Count() const
+{
+    return Utf8::CountChars(m_data, m_size);
+}
+
+bool StringView::IsASCII() const
+{
+    return Utf8::IsASCII(m_data, m_size);
+}
+
+bool StringView::IsValid() const
+{
+    return Utf8::IsValid(m_data, m_size);
+}
+
+StringView StringView::Trim() const
+{
+    return TrimLeft().TrimRight();
+}
+
+StringView StringView::TrimLeft() const
+{
+    int64 start = 0;
+    while (start < m_size)
+    {
+        int32 length = Utf8::SpaceLength(m_data + start, m_size - start);
+        if (length == 0)
+        {
+            break;
+        }
+        start += length;
+    }
+    return StringView(m_data + start, m_size - start);
+}
+
+StringView StringView::TrimRight() const
+{
+    const unsigned char* ptr = reinterpret_cast<const unsigned char*>(m_data);
+    int64 end = m_size;
+    while (end > 0)
+    {
+        // 找到最后一个字符的起始位置
+        int64 charStart = end - 1;
+        while (charStart > 0 && (ptr[charStart] & 0xC0) == 0x80)
+        {
+            charStart--;
+        }
+
+        int32 length = Utf8::SpaceLength(m_data + charStart, end - charStart);
+        if (length == 0 || charStart + length != end)
+        {
+            break;
+        }
+        end = charStart;
+    }
+    return StringView(m_data, end);
+}
+
+SplitRange StringView::Split(char sep) const
+{
+    return SplitRange(*this, sep);
+}
+
+SplitRange StringView::Split(StringView sep) const
+{
+    return SplitRange(*this, sep);
+}
+
+int64 StringView::Tokenize(StringView delimiters, Array<StringView>& tokens) const
+{
+    tokens.Clear();
+
+    // 256 位的分隔字节集合
+    uint64 isDelimiter[4] = {};
+    for (char ch : delimiters)
+    {
+        uint8 value = static_cast<uint8>(ch);
+        isDelimiter[value >> 6] |= uint64(1) << (value & 63);
+    }
+
+    int64 start = -1;
+    for (int64 i = 0; i < m_size; ++i)
+    {
+        uint8 value = static_cast<uint8>(m_data[i]);
+        bool delimiter = (isDelimiter[value >> 6] >> (value & 63)) & 1;
+        if (delimiter && start >= 0)
+        {
+            tokens.Push(StringView(m_data + start, i - start));
+            start = -1;
+        }
+        else if (!delimiter && start < 0)
+        {
+            start = i;
+        }
+    }
+    if (start >= 0)
+    {
+        tokens.Push(StringView(m_data + start, m_size - start));
+    }
+    return tokens.Size();
+}
+
+CharRange StringView::Chars() const
+{
+    return CharRange(*this);
+}
+
+/* SplitRange */
+SplitRange::Iterator::Iterator(StringView text, StringView sep, char sepChar, bool byChar)
+    : m_rest(text)
+    , m_sep(sep)
+    , m_sepChar(sepChar)
+    , m_byChar(byChar)
+    , m_hasRest(!text.IsEmpty())
+    , m_done(false)
+{
+    _Advance();
+}
+
+void SplitRange::Iterator::_Advance()
+{
+    if (!m_hasRest)
+    {
+        m_done = true;
+        return;
+    }
+
+    int64 sepSize = m_byChar ? 1 : m_sep.Size();
+    int64 pos = m_byChar ? m_rest.IndexOf(m_sepChar) : (sepSize > 0 ? m_rest.IndexOf(m_sep) : -1);
+    if (pos < 0)
+    {
+        m_current = m_rest;
+        m_hasRest = false;
+        return;
+    }
+
+    m_current = m_rest.Left(pos);
+    m_rest = StringView(m_rest.Data() + pos + sepSize, m_rest.Size() - pos - sepSize);
+    // 末尾分隔符之后不再产生空段
+    m_hasRest = !m_rest.IsEmpty();
+}
+
+int64 SplitRange::CollectTo(Array<StringView>& parts) const
+{
+    int64 count = 0;
+    for (StringView part : *this)
+    {
+        parts.Push(part);
+        ++count;
+    }
+    return count;
+}
+
+/* CharRange */
+void CharRange::Iterator::_Retreat()
+{
+    if (m_pos <= m_begin)
+    {
+        return;
+    }
+
+    // 向前跳过至多 3 个连续字节找到首字节，只有从首字节解码恰好到达当前位置时才是一个完整字符，否则上一个字符是单个无效字节
+    const char* lead = m_pos - 1;
+    while (lead > m_begin && m_pos - lead < 4 && (static_cast<uint8>(*lead) & 0xC0) == 0x80)
+    {
+        lead--;
+    }
+    uint32 code = 0;
+    if (Utf8::Decode(lead, m_end - lead, code) == m_pos - lead)
+    {
+        m_pos = lead;
+    }
+    else
+    {
+        m_pos--;
+    }
+}
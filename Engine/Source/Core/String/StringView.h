@@ -0,0 +1,566 @@
+#pragma once
+
+#include "Core.h"
+#include "Container/Array.h"
+#include "String/Char.h"
+#include "String/Utf8.h"
+#include "String/StringSearch.h"
+
+#include <cstring>
+#include <string_view>
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <type_traits>
+
+class SplitRange;
+class CharRange;
+
+/// <summary>
+/// 不持有数据的 UTF-8 字符串视图
+/// <para>只保存指针和字节数，拷贝、截取、查找、切分均不分配内存；被引用的数据必须在视图使用期间保持有效</para>
+/// <para>与 String 的字符索引不同，视图上的位置和长度均以字节计，Count 统计码点数量</para>
+/// </summary>
+class StringView
+{
+public:
+    /// <summary>
+    /// 默认构造函数，构造空视图
+    /// </summary>
+    constexpr StringView() noexcept = default;
+    /// <summary>
+    /// 引用指定长度的字节序列
+    /// </summary>
+    /// <param name="data">数据指针</param>
+    /// <param name="size">字节数</param>
+    constexpr StringView(const char* data, int64 size) noexcept
+        : m_data(data)
+        , m_size(size)
+    {
+
+    }
+    /// <summary>
+    /// 引用以 '\0' 结尾的 C 风格字符串
+    /// </summary>
+    /// <param name="str">C 风格字符串，可为空指针</param>
+    constexpr StringView(const char* str) noexcept
+        : m_data(str)
+        , m_size(str ? static_cast<int64>(std::char_traits<char>::length(str)) : 0)
+    {
+
+    }
+    /// <summary>
+    /// 引用标准库字符串视图(std::string 也可经由它转换)
+    /// </summary>
+    constexpr StringView(std::string_view str) noexcept
+        : m_data(str.data())
+        , m_size(static_cast<int64>(str.size()))
+    {
+
+    }
+    /// <summary>
+    /// 转换为标准库字符串视图
+    /// </summary>
+    constexpr operator std::string_view() const noexcept
+    {
+        return std::string_view(m_data, static_cast<size_t>(m_size));
+    }
+public:
+    /// <summary>
+    /// 获取数据指针(不保证以 '\0' 结尾)
+    /// </summary>
+    constexpr const char* Data() const noexcept
+    {
+        return m_data;
+    }
+    /// <summary>
+    /// 获取字节数
+    /// </summary>
+    constexpr int64 Size() const noexcept
+    {
+        return m_size;
+    }
+    /// <summary>
+    /// 判断是否为空
+    /// </summary>
+    constexpr bool IsEmpty() const noexcept
+    {
+        return m_size == 0;
+    }
+    /// <summary>
+    /// 统计码点数量(对无效的 UTF-8 按非连续字节计)
+    /// </summary>
+    int64 Count() const;
+    /// <summary>
+    /// 判断是否全部为 ASCII 字符
+    /// </summary>
+    bool IsASCII() const;
+    /// <summary>
+    /// 判断是否为有效的 UTF-8
+    /// </summary>
+    bool IsValid() const;
+    /// <summary>
+    /// 返回子视图
+    /// </summary>
+    /// <param name="offset">起始字节偏移，超出范围时返回空视图</param>
+    /// <param name="length">字节数，-1 或超出末尾时截取到末尾</param>
+    /// <returns>子视图</returns>
+    constexpr StringView Slice(int64 offset, int64 length = -1) const noexcept
+    {
+        if (offset < 0 || offset >= m_size)
+        {
+            return StringView();
+        }
+        if (length < 0 || length > m_size - offset)
+        {
+            length = m_size - offset;
+        }
+        return StringView(m_data + offset, length);
+    }
+    /// <summary>
+    /// 返回最左侧的 count 个字节
+    /// </summary>
+    constexpr StringView Left(int64 count) const noexcept
+    {
+        return StringView(m_data, std::clamp<int64>(count, 0, m_size));
+    }
+    /// <summary>
+    /// 返回最右侧的 count 个字节
+    /// </summary>
+    constexpr StringView Right(int64 count) const noexcept
+    {
+        count = std::clamp<int64>(count, 0, m_size);
+        return StringView(m_data + m_size - count, count);
+    }
+    /// <summary>
+    /// 查找子串第一次出现的字节位置(首尾字节过滤的向量查找)
+    /// </summary>
+    /// <param name="str">要查找的子串</param>
+    /// <param name="start">起始搜索位置</param>
+    /// <returns>字节位置，未找到返回 -1</returns>
+    int64 IndexOf(StringView str, int64 start = 0) const noexcept
+    {
+        if (start < 0 || start > m_size)
+        {
+            return -1;
+        }
+        int64 pos = StringSearch::Find(m_data + start, m_size - start, str.m_data, str.m_size);
+        return pos < 0 ? -1 : start + pos;
+    }
+    /// <summary>
+    /// 查找字节第一次出现的位置
+    /// </summary>
+    int64 IndexOf(char ch, int64 start = 0) const noexcept
+    {
+        if (start < 0 || start >= m_size)
+        {
+            return -1;
+        }
+        const void* ptr = std::memchr(m_data + start, ch, static_cast<size_t>(m_size - start));
+        return ptr ? static_cast<const char*>(ptr) - m_data : -1;
+    }
+    /// <summary>
+    /// 查找子串最后一次出现的字节位置
+    /// </summary>
+    /// <returns>字节位置，未找到返回 -1</returns>
+    int64 LastIndexOf(StringView str) const noexcept
+    {
+        return StringSearch::FindLast(m_data, m_size, str.m_data, str.m_size);
+    }
+    /// <summary>
+    /// 判断是否包含子串
+    /// </summary>
+    bool Contains(StringView str) const noexcept
+    {
+        return IndexOf(str) != -1;
+    }
+    /// <summary>
+    /// 判断是否有给定前缀
+    /// </summary>
+    constexpr bool StartWith(StringView str) const noexcept
+    {
+        return std::string_view(*this).starts_with(std::string_view(str));
+    }
+    /// <summary>
+    /// 判断是否有给定后缀
+    /// </summary>
+    constexpr bool EndWith(StringView str) const noexcept
+    {
+        return std::string_view(*this).ends_with(std::string_view(str));
+    }
+    /// <summary>
+    /// 按字节比较
+    /// </summary>
+    /// <returns>小于 0 表示当前视图较小，等于 0 表示相等，大于 0 表示当前视图较大</returns>
+    constexpr int64 Compare(StringView str) const noexcept
+    {
+        return std::string_view(*this).compare(std::string_view(str));
+    }
+    /// <summary>
+    /// 返回去掉两侧空白字符(含 Unicode 空白)后的视图
+    /// </summary>
+    StringView Trim() const;
+    /// <summary>
+    /// 返回去掉左侧空白字符后的视图
+    /// </summary>
+    StringView TrimLeft() const;
+    /// <summary>
+    /// 返回去掉右侧空白字符后的视图
+    /// </summary>
+    StringView TrimRight() const;
+    /// <summary>
+    /// 按分隔符惰性切分，遍历时逐段返回子视图
+    /// <para>与 std::getline 语义一致：末尾分隔符之后不产生空段，空视图不产生任何段</para>
+    /// </summary>
+    SplitRange Split(char sep) const;
+    /// <summary>
+    /// 按分隔字符串惰性切分
+    /// </summary>
+    SplitRange Split(StringView sep) const;
+    /// <summary>
+    /// 以 delimiters 中的任一字节为分隔符切分，跳过空段
+    /// <para>结果写入调用者提供的数组(先清空)，重复使用同一数组时不再分配内存</para>
+    /// </summary>
+    /// <param name="delimiters">分隔字节集合</param>
+    /// <param name="tokens">输出的子视图</param>
+    /// <returns>子视图数量</returns>
+    int64 Tokenize(StringView delimiters, Array<StringView>& tokens) const;
+    /// <summary>
+    /// 按码点遍历，迭代器在原数据上就地解码，不分配内存
+    /// <para>支持双向遍历，rbegin/rend 从末尾向前遍历；无效字节逐个作为无效字符(Size 为 0)返回</para>
+    /// </summary>
+    CharRange Chars() const;
+    /// <summary>
+    /// 尝试解析整数，不抛出异常、不分配内存、与区域设置无关
+    /// <para>允许一个前导 '+'，整个视图都必须是数字；不接受空白和 "0x" 前缀</para>
+    /// </summary>
+    /// <param name="value">解析结果，失败时不修改</param>
+    /// <param name="base">进制(2-36)</param>
+    /// <returns>格式无效或超出类型范围时返回 false</returns>
+    template<class Type> requires std::is_integral_v<Type> && (!std::is_same_v<Type, bool>)
+    bool TryParse(Type& value, int base = 10) const noexcept
+    {
+        StringView digits = _SkipPlus();
+        Type result{};
+        auto [ptr, ec] = std::from_chars(digits.begin(), digits.end(), result, base);
+        if (ec != std::errc() || ptr != digits.end() || digits.IsEmpty())
+        {
+            return false;
+        }
+        value = result;
+        return true;
+    }
+    /// <summary>
+    /// 尝试解析浮点数(十进制或科学计数法，以及 inf/nan)，结果为最接近的可表示值
+    /// </summary>
+    /// <param name="value">解析结果，失败时不修改</param>
+    /// <returns>格式无效或超出类型范围时返回 false</returns>
+    template<class Type> requires std::is_floating_point_v<Type>
+    bool TryParse(Type& value) const noexcept
+    {
+        StringView digits = _SkipPlus();
+        Type result{};
+        auto [ptr, ec] = std::from_chars(digits.begin(), digits.end(), result);
+        if (ec != std::errc() || ptr != digits.end() || digits.IsEmpty())
+        {
+            return false;
+        }
+        value = result;
+        return true;
+    }
+    /// <summary>
+    /// 尝试解析布尔值("true"/"True"/"false"/"False")
+    /// </summary>
+    bool TryParse(bool& value) const noexcept
+    {
+        if (*this == "true" || *this == "True")
+        {
+            value = true;
+            return true;
+        }
+        if (*this == "false" || *this == "False")
+        {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+public:
+    constexpr const char* begin() const noexcept
+    {
+        return m_data;
+    }
+
+    constexpr const char* end() const noexcept
+    {
+        return m_data + m_size;
+    }
+
+    friend constexpr bool operator==(StringView left, StringView right) noexcept
+    {
+        return std::string_view(left) == std::string_view(right);
+    }
+
+    friend constexpr auto operator<=>(StringView left, StringView right) noexcept
+    {
+        return std::string_view(left) <=> std::string_view(right);
+    }
+private:
+    /// <summary>
+    /// 跳过数值前的 '+'(std::from_chars 不接受)，"+-1" 之类的形式仍然无效
+    /// </summary>
+    constexpr StringView _SkipPlus() const noexcept
+    {
+        if (m_size > 1 && m_data[0] == '+' && m_data[1] != '-' && m_data[1] != '+')
+        {
+            return StringView(m_data + 1, m_size - 1);
+        }
+        return *this;
+    }
+private:
+    // 数据指针
+    const char* m_data = nullptr;
+    // 字节数
+    int64 m_size = 0;
+};
+
+/// <summary>
+/// StringView 的惰性切分结果，可用于范围 for 循环
+/// <para>迭代器只保存剩余部分的视图，切分过程不分配内存</para>
+/// </summary>
+class SplitRange
+{
+public:
+    class Iterator
+    {
+    public:
+        using value_type = StringView;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+    public:
+        Iterator() = default;
+
+        Iterator(StringView text, StringView sep, char sepChar, bool byChar);
+
+        const StringView& operator*() const
+        {
+            return m_current;
+        }
+
+        const StringView* operator->() const
+        {
+            return &m_current;
+        }
+
+        Iterator& operator++()
+        {
+            _Advance();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            _Advance();
+            return old;
+        }
+
+        friend bool operator==(const Iterator& left, const Iterator& right)
+        {
+            if (left.m_done || right.m_done)
+            {
+                return left.m_done == right.m_done;
+            }
+            return left.m_current.Data() == right.m_current.Data() && left.m_hasRest == right.m_hasRest;
+        }
+    private:
+        /// <summary>
+        /// 取出下一段
+        /// </summary>
+        void _Advance();
+    private:
+        // 尚未切分的部分
+        StringView m_rest;
+        // 当前段
+        StringView m_current;
+        // 分隔字符串
+        StringView m_sep;
+        // 单字节分隔符
+        char m_sepChar = 0;
+        // 是否按单字节分隔符切分
+        bool m_byChar = false;
+        // 是否还有未切分的部分
+        bool m_hasRest = false;
+        // 是否已到末尾
+        bool m_done = true;
+    };
+public:
+    /// <summary>
+    /// 以单字节分隔符切分
+    /// </summary>
+    SplitRange(StringView text, char sep)
+        : m_text(text)
+        , m_sepChar(sep)
+        , m_byChar(true)
+    {
+
+    }
+    /// <summary>
+    /// 以分隔字符串切分(分隔字符串为空时整体作为一段)
+    /// </summary>
+    SplitRange(StringView text, StringView sep)
+        : m_text(text)
+        , m_sep(sep)
+    {
+
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(m_text, m_sep, m_sepChar, m_byChar);
+    }
+
+    Iterator end() const
+    {
+        return Iterator();
+    }
+    /// <summary>
+    /// 将全部段依次追加到数组中
+    /// </summary>
+    /// <returns>段数</returns>
+    int64 CollectTo(Array<StringView>& parts) const;
+private:
+    // 被切分的文本
+    StringView m_text;
+    // 分隔字符串
+    StringView m_sep;
+    // 单字节分隔符
+    char m_sepChar = 0;
+    // 是否按单字节分隔符切分
+    bool m_byChar = false;
+};
+
+/// <summary>
+/// StringView 的逐码点遍历范围，可用于范围 for 循环
+/// <para>迭代器只保存数据指针，解引用时就地解码当前码点，遍历过程不分配内存</para>
+/// </summary>
+class CharRange
+{
+public:
+    class Iterator
+    {
+    public:
+        using value_type = Char;
+        using reference = Char;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::bidirectional_iterator_tag;
+    public:
+        Iterator() = default;
+
+        Iterator(const char* begin, const char* end, const char* pos)
+            : m_begin(begin)
+            , m_end(end)
+            , m_pos(pos)
+        {
+
+        }
+
+        Char operator*() const
+        {
+            uint32 code = 0;
+            return Utf8::Decode(m_pos, m_end - m_pos, code) > 0 ? Char(code) : Char();
+        }
+
+        Iterator& operator++()
+        {
+            uint32 code = 0;
+            int32 length = Utf8::Decode(m_pos, m_end - m_pos, code);
+            m_pos += length > 0 ? length : 1;
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        Iterator& operator--()
+        {
+            _Retreat();
+            return *this;
+        }
+
+        Iterator operator--(int)
+        {
+            Iterator old = *this;
+            _Retreat();
+            return old;
+        }
+        /// <summary>
+        /// 获取当前字符在视图中的字节偏移
+        /// </summary>
+        int64 Offset() const
+        {
+            return m_pos - m_begin;
+        }
+        /// <summary>
+        /// 获取当前字符的 UTF-8 字节(无效字节为 1 字节)
+        /// </summary>
+        StringView Bytes() const
+        {
+            uint32 code = 0;
+            int32 length = Utf8::Decode(m_pos, m_end - m_pos, code);
+            return StringView(m_pos, length > 0 ? length : 1);
+        }
+
+        friend bool operator==(const Iterator& left, const Iterator& right)
+        {
+            return left.m_pos == right.m_pos;
+        }
+    private:
+        /// <summary>
+        /// 退回上一个字符的起始位置，与正向遍历的划分一致
+        /// </summary>
+        void _Retreat();
+    private:
+        // 数据起始
+        const char* m_begin = nullptr;
+        // 数据末尾
+        const char* m_end = nullptr;
+        // 当前字符的起始位置
+        const char* m_pos = nullptr;
+    };
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+public:
+    explicit CharRange(StringView text)
+        : m_text(text)
+    {
+
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(m_text.begin(), m_text.end(), m_text.begin());
+    }
+
+    Iterator end() const
+    {
+        return Iterator(m_text.begin(), m_text.end(), m_text.end());
+    }
+
+    ReverseIterator rbegin() const
+    {
+        return ReverseIterator(end());
+    }
+
+    ReverseIterator rend() const
+    {
+        return ReverseIterator(begin());
+    }
+private:
+    // 被遍历的文本
+    StringView m_text;
+};
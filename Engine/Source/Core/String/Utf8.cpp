@@ -0,0 +1,1272 @@
+#include "pch.h"
+
+#include "Utf8.h"
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(CPU_ARCH_X64)
+    #include <immintrin.h>
+#elif defined(CPU_ARCH_ARM64)
+    #include <arm_neon.h>
+#endif
+
+namespace
+{
+    /*
+     * 向量校验使用查表法(Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte")：
+     * 以前一字节的高/低 4 位和当前字节的高 4 位查三张表，三者按位与后非零即为非法的相邻字节组合；
+     * 三、四字节序列中第 3、4 个字节是否必须为连续字节由前 2、3 个字节的首字节推出，与查表结果的最高位异或检查
+     */
+
+    constexpr uint8 TOO_SHORT = 1 << 0;      // 11______ 0_______ 或 11______ 11______
+    constexpr uint8 TOO_LONG = 1 << 1;       // 0_______ 10______
+    constexpr uint8 OVERLONG_3 = 1 << 2;     // 11100000 100_____
+    constexpr uint8 TOO_LARGE = 1 << 3;      // 11110100 1001____ 或 11110100 101_____ 或 11110101+ 1___
+    constexpr uint8 SURROGATE = 1 << 4;      // 11101101 101_____
+    constexpr uint8 OVERLONG_2 = 1 << 5;     // 1100000_ 10______
+    constexpr uint8 TOO_LARGE_1000 = 1 << 6; // 11110101+ 1000____
+    constexpr uint8 OVERLONG_4 = 1 << 6;     // 11110000 1000____
+    constexpr uint8 TWO_CONTS = 1 << 7;      // 10______ 10______
+    constexpr uint8 CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    // 按前一字节的高 4 位查表
+    alignas(16) constexpr uint8 BYTE1_HIGH_TABLE[16] = {
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+    };
+
+    // 按前一字节的低 4 位查表
+    alignas(16) constexpr uint8 BYTE1_LOW_TABLE[16] = {
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000
+    };
+
+    // 按当前字节的高 4 位查表
+    alignas(16) constexpr uint8 BYTE2_HIGH_TABLE[16] = {
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+    };
+
+    // 块末尾 3 个字节超过这些值时说明序列延续到下一块
+    alignas(16) constexpr uint8 INCOMPLETE_LIMIT[16] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+    };
+
+    /// <summary>
+    /// 判断是否为连续字节(10xxxxxx)
+    /// </summary>
+    inline bool IsContinuation(uint8 byte)
+    {
+        return (byte & 0xC0) == 0x80;
+    }
+
+    /// <summary>
+    /// 8 字节一组的 ASCII 检查
+    /// </summary>
+    inline bool IsASCIIWord(const uint8* data)
+    {
+        uint64 word;
+        std::memcpy(&word, data, sizeof(word));
+        return (word & 0x8080808080808080ull) == 0;
+    }
+
+    int64 ValidateAndCountScalar(const uint8* data, int64 size, bool& ascii)
+    {
+        int64 count = 0;
+        int64 pos = 0;
+        ascii = true;
+
+        while (pos < size)
+        {
+            if (pos + 8 <= size && IsASCIIWord(data + pos))
+            {
+                pos += 8;
+                count += 8;
+                continue;
+            }
+
+            uint8 lead = data[pos];
+            if (lead < 0x80)
+            {
+                ++pos;
+                ++count;
+                continue;
+            }
+            ascii = false;
+
+            // 第二个字节的取值范围随首字节收窄，以排除过长编码、代理项和超出范围的码点
+            int32 length;
+            uint8 low = 0x80;
+            uint8 high = 0xBF;
+            if (lead >= 0xC2 && lead <= 0xDF)
+            {
+                length = 2;
+            }
+            else if (lead >= 0xE0 && lead <= 0xEF)
+            {
+                length = 3;
+                if (lead == 0xE0) low = 0xA0;
+                if (lead == 0xED) high = 0x9F;
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4)
+            {
+                length = 4;
+                if (lead == 0xF0) low = 0x90;
+                if (lead == 0xF4) high = 0x8F;
+            }
+            else
+            {
+                return -1;
+            }
+
+            if (pos + length > size || data[pos + 1] < low || data[pos + 1] > high)
+            {
+                return -1;
+            }
+            for (int32 i = 2; i < length; ++i)
+            {
+                if (!IsContinuation(data[pos + i]))
+                {
+                    return -1;
+                }
+            }
+            pos += length;
+            ++count;
+        }
+
+        return count;
+    }
+
+    int64 CountCharsScalar(const uint8* data, int64 size)
+    {
+        int64 count = 0;
+        for (int64 i = 0; i < size; ++i)
+        {
+            count += IsContinuation(data[i]) ? 0 : 1;
+        }
+        return count;
+    }
+
+    inline bool IsSurrogate(uint32 code)
+    {
+        return (code & 0xFFFFF800u) == 0xD800;
+    }
+
+    // 校验内核处理全部数据；统计和 ASCII 内核返回已处理的字节数，剩余部分由标量代码完成
+    using ValidateKernel = int64(*)(const uint8*, int64, bool&);
+    using CountKernel = int64(*)(const uint8*, int64, int64&);
+    using ASCIIKernel = int64(*)(const uint8*, int64);
+    // 转换内核只转换连续的 ASCII 块(输入与输出单元数相同)，遇到非 ASCII 的块时返回已转换的单元数
+    using ToUtf16Kernel = int64(*)(const uint8*, int64, char16*);
+    using ToUtf32Kernel = int64(*)(const uint8*, int64, char32*);
+    using FromUtf16Kernel = int64(*)(const char16*, int64, uint8*);
+    using FromUtf32Kernel = int64(*)(const char32*, int64, uint8*);
+    using Utf16CountKernel = int64(*)(const char16*, int64, int64&);
+    using Utf32CountKernel = int64(*)(const char32*, int64, int64&);
+
+#if defined(CPU_ARCH_X64)
+    /* SSE4.2：每次 16 字节 */
+
+    // 当前块与前一块拼接后右移，得到每个字节之前第 N 个字节
+    template<int N>
+    CPU_TARGET_SSE42 inline __m128i PrevSse(__m128i input, __m128i prevInput)
+    {
+        return _mm_alignr_epi8(input, prevInput, 16 - N);
+    }
+
+    struct ValidateStateSse
+    {
+        __m128i Error;
+        __m128i PrevInput;
+        __m128i PrevIncomplete;
+        __m128i NonASCII;
+        int64 Count;
+    };
+
+    CPU_TARGET_SSE42 inline void ValidateBlockSse(__m128i input, ValidateStateSse& state)
+    {
+        if (_mm_movemask_epi8(input) == 0)
+        {
+            // 纯 ASCII 块只需确认上一块没有未完成的序列
+            state.Error = _mm_or_si128(state.Error, state.PrevIncomplete);
+            state.PrevIncomplete = _mm_setzero_si128();
+            state.Count += 16;
+        }
+        else
+        {
+            const __m128i lowNibble = _mm_set1_epi8(0x0F);
+            __m128i prev1 = PrevSse<1>(input, state.PrevInput);
+            __m128i byte1High = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(BYTE1_HIGH_TABLE)),
+                _mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibble));
+            __m128i byte1Low = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(BYTE1_LOW_TABLE)),
+                _mm_and_si128(prev1, lowNibble));
+            __m128i byte2High = _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(BYTE2_HIGH_TABLE)),
+                _mm_and_si128(_mm_srli_epi16(input, 4), lowNibble));
+            __m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+            __m128i isThird = _mm_subs_epu8(PrevSse<2>(input, state.PrevInput), _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            __m128i isFourth = _mm_subs_epu8(PrevSse<3>(input, state.PrevInput), _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            __m128i mustContinue = _mm_and_si128(_mm_or_si128(isThird, isFourth), _mm_set1_epi8(static_cast<char>(0x80)));
+
+            state.Error = _mm_or_si128(state.Error, _mm_xor_si128(mustContinue, special));
+            state.PrevIncomplete = _mm_subs_epu8(input, _mm_load_si128(reinterpret_cast<const __m128i*>(INCOMPLETE_LIMIT)));
+            state.NonASCII = _mm_or_si128(state.NonASCII, input);
+
+            // 有符号比较：大于 0xBF(-65) 的字节即 ASCII 或首字节
+            __m128i leads = _mm_cmpgt_epi8(input, _mm_set1_epi8(-65));
+            state.Count += std::popcount(static_cast<uint32>(_mm_movemask_epi8(leads)));
+        }
+        state.PrevInput = input;
+    }
+
+    CPU_TARGET_SSE42 int64 ValidateAndCountSse(const uint8* data, int64 size, bool& ascii)
+    {
+        ValidateStateSse state{ _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128(), 0 };
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            ValidateBlockSse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)), state);
+        }
+        if (pos < size)
+        {
+            // 尾部补零按整块处理，补上的零按 ASCII 计数后减去
+            alignas(16) uint8 buffer[16] = {};
+            std::memcpy(buffer, data + pos, size - pos);
+            ValidateBlockSse(_mm_load_si128(reinterpret_cast<const __m128i*>(buffer)), state);
+            state.Count -= 16 - (size - pos);
+        }
+        state.Error = _mm_or_si128(state.Error, state.PrevIncomplete);
+        if (!_mm_testz_si128(state.Error, state.Error))
+        {
+            return -1;
+        }
+        ascii = _mm_movemask_epi8(state.NonASCII) == 0;
+        return state.Count;
+    }
+
+    CPU_TARGET_SSE42 int64 CountCharsSse(const uint8* data, int64 size, int64& count)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i leads = _mm_cmpgt_epi8(input, _mm_set1_epi8(-65));
+            count += std::popcount(static_cast<uint32>(_mm_movemask_epi8(leads)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 ASCIIPrefixSse(const uint8* data, int64 size)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos))) != 0)
+            {
+                break;
+            }
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 Utf16LengthSse(const uint8* data, int64 size, int64& length)
+    {
+        // 非连续字节各占一个单元，四字节序列的首字节(0xF0 及以上)再多占一个
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i leads = _mm_cmpgt_epi8(input, _mm_set1_epi8(-65));
+            __m128i fours = _mm_cmpeq_epi8(_mm_max_epu8(input, _mm_set1_epi8(static_cast<char>(0xF0))), input);
+            length += std::popcount(static_cast<uint32>(_mm_movemask_epi8(leads)));
+            length += std::popcount(static_cast<uint32>(_mm_movemask_epi8(fours)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 ToUtf16Sse(const uint8* data, int64 size, char16* output)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            if (_mm_movemask_epi8(input) != 0)
+            {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos), _mm_cvtepu8_epi16(input));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos + 8), _mm_cvtepu8_epi16(_mm_srli_si128(input, 8)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 ToUtf32Sse(const uint8* data, int64 size, char32* output)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            if (_mm_movemask_epi8(input) != 0)
+            {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos), _mm_cvtepu8_epi32(input));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos + 4), _mm_cvtepu8_epi32(_mm_srli_si128(input, 4)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos + 8), _mm_cvtepu8_epi32(_mm_srli_si128(input, 8)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos + 12), _mm_cvtepu8_epi32(_mm_srli_si128(input, 12)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 FromUtf16Sse(const char16* data, int64 size, uint8* output)
+    {
+        const __m128i nonASCII = _mm_set1_epi16(static_cast<short>(0xFF80));
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 8));
+            if (!_mm_testz_si128(_mm_or_si128(low, high), nonASCII))
+            {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos), _mm_packus_epi16(low, high));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 FromUtf32Sse(const char32* data, int64 size, uint8* output)
+    {
+        const __m128i nonASCII = _mm_set1_epi32(static_cast<int>(0xFFFFFF80));
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 4));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 8));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + 12));
+            if (!_mm_testz_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), nonASCII))
+            {
+                break;
+            }
+            __m128i packed = _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + pos), packed);
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 LengthFromUtf16Sse(const char16* data, int64 size, int64& length)
+    {
+        // 每个单元至少 1 字节，不小于 0x80、0x800 时各加 1 字节，代理项(成对时共 4 字节)各减 1 字节；比较掩码每个单元占 2 位
+        int64 pos = 0;
+        for (; pos + 8 <= size; pos += 8)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i two = _mm_cmpeq_epi16(_mm_min_epu16(input, _mm_set1_epi16(0x80)), _mm_set1_epi16(0x80));
+            __m128i three = _mm_cmpeq_epi16(_mm_min_epu16(input, _mm_set1_epi16(0x800)), _mm_set1_epi16(0x800));
+            __m128i surrogate = _mm_cmpeq_epi16(_mm_and_si128(input, _mm_set1_epi16(static_cast<short>(0xF800))), _mm_set1_epi16(static_cast<short>(0xD800)));
+            int32 extra = std::popcount(static_cast<uint32>(_mm_movemask_epi8(two))) + std::popcount(static_cast<uint32>(_mm_movemask_epi8(three)))
+                - std::popcount(static_cast<uint32>(_mm_movemask_epi8(surrogate)));
+            length += 8 + extra / 2;
+        }
+        return pos;
+    }
+
+    CPU_TARGET_SSE42 int64 LengthFromUtf32Sse(const char32* data, int64 size, int64& length)
+    {
+        // 比较掩码每个码点占 4 位
+        int64 pos = 0;
+        for (; pos + 4 <= size; pos += 4)
+        {
+            __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+            __m128i two = _mm_cmpeq_epi32(_mm_min_epu32(input, _mm_set1_epi32(0x80)), _mm_set1_epi32(0x80));
+            __m128i three = _mm_cmpeq_epi32(_mm_min_epu32(input, _mm_set1_epi32(0x800)), _mm_set1_epi32(0x800));
+            __m128i four = _mm_cmpeq_epi32(_mm_min_epu32(input, _mm_set1_epi32(0x10000)), _mm_set1_epi32(0x10000));
+            int32 extra = std::popcount(static_cast<uint32>(_mm_movemask_epi8(two))) + std::popcount(static_cast<uint32>(_mm_movemask_epi8(three)))
+                + std::popcount(static_cast<uint32>(_mm_movemask_epi8(four)));
+            length += 4 + extra / 4;
+        }
+        return pos;
+    }
+
+    /* AVX2：每次 32 字节 */
+
+    template<int N>
+    CPU_TARGET_AVX2 inline __m256i PrevAvx2(__m256i input, __m256i prevInput)
+    {
+        // 跨 128 位通道拼接：低通道取前一块的高半部分
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prevInput, input, 0x21), 16 - N);
+    }
+
+    CPU_TARGET_AVX2 inline __m256i LoadTableAvx2(const uint8* table)
+    {
+        return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+    }
+
+    struct ValidateStateAvx2
+    {
+        __m256i Error;
+        __m256i PrevInput;
+        __m256i PrevIncomplete;
+        __m256i NonASCII;
+        int64 Count;
+    };
+
+    CPU_TARGET_AVX2 inline void ValidateBlockAvx2(__m256i input, ValidateStateAvx2& state)
+    {
+        if (_mm256_movemask_epi8(input) == 0)
+        {
+            state.Error = _mm256_or_si256(state.Error, state.PrevIncomplete);
+            state.PrevIncomplete = _mm256_setzero_si256();
+            state.Count += 32;
+        }
+        else
+        {
+            const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+            __m256i prev1 = PrevAvx2<1>(input, state.PrevInput);
+            __m256i byte1High = _mm256_shuffle_epi8(LoadTableAvx2(BYTE1_HIGH_TABLE),
+                _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibble));
+            __m256i byte1Low = _mm256_shuffle_epi8(LoadTableAvx2(BYTE1_LOW_TABLE),
+                _mm256_and_si256(prev1, lowNibble));
+            __m256i byte2High = _mm256_shuffle_epi8(LoadTableAvx2(BYTE2_HIGH_TABLE),
+                _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibble));
+            __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+            __m256i isThird = _mm256_subs_epu8(PrevAvx2<2>(input, state.PrevInput), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            __m256i isFourth = _mm256_subs_epu8(PrevAvx2<3>(input, state.PrevInput), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            __m256i mustContinue = _mm256_and_si256(_mm256_or_si256(isThird, isFourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+            state.Error = _mm256_or_si256(state.Error, _mm256_xor_si256(mustContinue, special));
+            __m256i limit = _mm256_inserti128_si256(_mm256_set1_epi8(static_cast<char>(0xFF)),
+                _mm_load_si128(reinterpret_cast<const __m128i*>(INCOMPLETE_LIMIT)), 1);
+            state.PrevIncomplete = _mm256_subs_epu8(input, limit);
+            state.NonASCII = _mm256_or_si256(state.NonASCII, input);
+
+            __m256i leads = _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65));
+            state.Count += std::popcount(static_cast<uint32>(_mm256_movemask_epi8(leads)));
+        }
+        state.PrevInput = input;
+    }
+
+    CPU_TARGET_AVX2 int64 ValidateAndCountAvx2(const uint8* data, int64 size, bool& ascii)
+    {
+        ValidateStateAvx2 state{ _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), 0 };
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            ValidateBlockAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos)), state);
+        }
+        if (pos < size)
+        {
+            alignas(32) uint8 buffer[32] = {};
+            std::memcpy(buffer, data + pos, size - pos);
+            ValidateBlockAvx2(_mm256_load_si256(reinterpret_cast<const __m256i*>(buffer)), state);
+            state.Count -= 32 - (size - pos);
+        }
+        state.Error = _mm256_or_si256(state.Error, state.PrevIncomplete);
+        if (!_mm256_testz_si256(state.Error, state.Error))
+        {
+            return -1;
+        }
+        ascii = _mm256_movemask_epi8(state.NonASCII) == 0;
+        return state.Count;
+    }
+
+    CPU_TARGET_AVX2 int64 CountCharsAvx2(const uint8* data, int64 size, int64& count)
+    {
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i leads = _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65));
+            count += std::popcount(static_cast<uint32>(_mm256_movemask_epi8(leads)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 ASCIIPrefixAvx2(const uint8* data, int64 size)
+    {
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos))) != 0)
+            {
+                break;
+            }
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 Utf16LengthAvx2(const uint8* data, int64 size, int64& length)
+    {
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i leads = _mm256_cmpgt_epi8(input, _mm256_set1_epi8(-65));
+            __m256i fours = _mm256_cmpeq_epi8(_mm256_max_epu8(input, _mm256_set1_epi8(static_cast<char>(0xF0))), input);
+            length += std::popcount(static_cast<uint32>(_mm256_movemask_epi8(leads)));
+            length += std::popcount(static_cast<uint32>(_mm256_movemask_epi8(fours)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 ToUtf16Avx2(const uint8* data, int64 size, char16* output)
+    {
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            if (_mm256_movemask_epi8(input) != 0)
+            {
+                break;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(input)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(input, 1)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 ToUtf32Avx2(const uint8* data, int64 size, char32* output)
+    {
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            if (_mm256_movemask_epi8(input) != 0)
+            {
+                break;
+            }
+            __m128i low = _mm256_castsi256_si128(input);
+            __m128i high = _mm256_extracti128_si256(input, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos), _mm256_cvtepu8_epi32(low));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos + 8), _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos + 16), _mm256_cvtepu8_epi32(high));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos + 24), _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 FromUtf16Avx2(const char16* data, int64 size, uint8* output)
+    {
+        const __m256i nonASCII = _mm256_set1_epi16(static_cast<short>(0xFF80));
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 16));
+            if (!_mm256_testz_si256(_mm256_or_si256(low, high), nonASCII))
+            {
+                break;
+            }
+            // packus 在 128 位通道内交错，按 64 位重排回原顺序
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos), packed);
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 FromUtf32Avx2(const char32* data, int64 size, uint8* output)
+    {
+        const __m256i nonASCII = _mm256_set1_epi32(static_cast<int>(0xFFFFFF80));
+        int64 pos = 0;
+        for (; pos + 32 <= size; pos += 32)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 8));
+            __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 16));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 24));
+            if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)), nonASCII))
+            {
+                break;
+            }
+            // 两次 packus 后每个 32 位元素为 4 个连续码点，按 a/b/c/d 的低、高两半重排回原顺序
+            __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+            packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + pos), packed);
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 LengthFromUtf16Avx2(const char16* data, int64 size, int64& length)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i two = _mm256_cmpeq_epi16(_mm256_min_epu16(input, _mm256_set1_epi16(0x80)), _mm256_set1_epi16(0x80));
+            __m256i three = _mm256_cmpeq_epi16(_mm256_min_epu16(input, _mm256_set1_epi16(0x800)), _mm256_set1_epi16(0x800));
+            __m256i surrogate = _mm256_cmpeq_epi16(_mm256_and_si256(input, _mm256_set1_epi16(static_cast<short>(0xF800))), _mm256_set1_epi16(static_cast<short>(0xD800)));
+            int32 extra = std::popcount(static_cast<uint32>(_mm256_movemask_epi8(two))) + std::popcount(static_cast<uint32>(_mm256_movemask_epi8(three)))
+                - std::popcount(static_cast<uint32>(_mm256_movemask_epi8(surrogate)));
+            length += 16 + extra / 2;
+        }
+        return pos;
+    }
+
+    CPU_TARGET_AVX2 int64 LengthFromUtf32Avx2(const char32* data, int64 size, int64& length)
+    {
+        int64 pos = 0;
+        for (; pos + 8 <= size; pos += 8)
+        {
+            __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+            __m256i two = _mm256_cmpeq_epi32(_mm256_min_epu32(input, _mm256_set1_epi32(0x80)), _mm256_set1_epi32(0x80));
+            __m256i three = _mm256_cmpeq_epi32(_mm256_min_epu32(input, _mm256_set1_epi32(0x800)), _mm256_set1_epi32(0x800));
+            __m256i four = _mm256_cmpeq_epi32(_mm256_min_epu32(input, _mm256_set1_epi32(0x10000)), _mm256_set1_epi32(0x10000));
+            int32 extra = std::popcount(static_cast<uint32>(_mm256_movemask_epi8(two))) + std::popcount(static_cast<uint32>(_mm256_movemask_epi8(three)))
+                + std::popcount(static_cast<uint32>(_mm256_movemask_epi8(four)));
+            length += 8 + extra / 4;
+        }
+        return pos;
+    }
+
+    template<class Kernel>
+    Kernel SelectKernel(Kernel sse, Kernel avx2)
+    {
+        const CpuFeatures& features = CpuFeatures::Get();
+        if (features.AVX2)
+        {
+            return avx2;
+        }
+        if (features.SSE42)
+        {
+            return sse;
+        }
+        return nullptr;
+    }
+#elif defined(CPU_ARCH_ARM64)
+    /* NEON：每次 16 字节 */
+
+    template<int N>
+    inline uint8x16_t PrevNeon(uint8x16_t input, uint8x16_t prevInput)
+    {
+        return vextq_u8(prevInput, input, 16 - N);
+    }
+
+    struct ValidateStateNeon
+    {
+        uint8x16_t Error;
+        uint8x16_t PrevInput;
+        uint8x16_t PrevIncomplete;
+        uint8x16_t NonASCII;
+        int64 Count;
+    };
+
+    inline void ValidateBlockNeon(uint8x16_t input, ValidateStateNeon& state)
+    {
+        if (vmaxvq_u8(input) < 0x80)
+        {
+            state.Error = vorrq_u8(state.Error, state.PrevIncomplete);
+            state.PrevIncomplete = vdupq_n_u8(0);
+            state.Count += 16;
+        }
+        else
+        {
+            const uint8x16_t lowNibble = vdupq_n_u8(0x0F);
+            uint8x16_t prev1 = PrevNeon<1>(input, state.PrevInput);
+            uint8x16_t byte1High = vqtbl1q_u8(vld1q_u8(BYTE1_HIGH_TABLE), vshrq_n_u8(prev1, 4));
+            uint8x16_t byte1Low = vqtbl1q_u8(vld1q_u8(BYTE1_LOW_TABLE), vandq_u8(prev1, lowNibble));
+            uint8x16_t byte2High = vqtbl1q_u8(vld1q_u8(BYTE2_HIGH_TABLE), vshrq_n_u8(input, 4));
+            uint8x16_t special = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+
+            uint8x16_t isThird = vqsubq_u8(PrevNeon<2>(input, state.PrevInput), vdupq_n_u8(0xE0 - 0x80));
+            uint8x16_t isFourth = vqsubq_u8(PrevNeon<3>(input, state.PrevInput), vdupq_n_u8(0xF0 - 0x80));
+            uint8x16_t mustContinue = vandq_u8(vorrq_u8(isThird, isFourth), vdupq_n_u8(0x80));
+
+            state.Error = vorrq_u8(state.Error, veorq_u8(mustContinue, special));
+            state.PrevIncomplete = vqsubq_u8(input, vld1q_u8(INCOMPLETE_LIMIT));
+            state.NonASCII = vorrq_u8(state.NonASCII, input);
+
+            uint8x16_t leads = vcgtq_s8(vreinterpretq_s8_u8(input), vdupq_n_s8(-65));
+            state.Count += vaddvq_u8(vshrq_n_u8(leads, 7));
+        }
+        state.PrevInput = input;
+    }
+
+    int64 ValidateAndCountNeon(const uint8* data, int64 size, bool& ascii)
+    {
+        ValidateStateNeon state{ vdupq_n_u8(0), vdupq_n_u8(0), vdupq_n_u8(0), vdupq_n_u8(0), 0 };
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            ValidateBlockNeon(vld1q_u8(data + pos), state);
+        }
+        if (pos < size)
+        {
+            alignas(16) uint8 buffer[16] = {};
+            std::memcpy(buffer, data + pos, size - pos);
+            ValidateBlockNeon(vld1q_u8(buffer), state);
+            state.Count -= 16 - (size - pos);
+        }
+        state.Error = vorrq_u8(state.Error, state.PrevIncomplete);
+        if (vmaxvq_u8(state.Error) != 0)
+        {
+            return -1;
+        }
+        ascii = vmaxvq_u8(state.NonASCII) < 0x80;
+        return state.Count;
+    }
+
+    int64 CountCharsNeon(const uint8* data, int64 size, int64& count)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint8x16_t leads = vcgtq_s8(vld1q_s8(reinterpret_cast<const int8*>(data + pos)), vdupq_n_s8(-65));
+            count += vaddvq_u8(vshrq_n_u8(leads, 7));
+        }
+        return pos;
+    }
+
+    int64 ASCIIPrefixNeon(const uint8* data, int64 size)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            if (vmaxvq_u8(vld1q_u8(data + pos)) >= 0x80)
+            {
+                break;
+            }
+        }
+        return pos;
+    }
+
+    int64 Utf16LengthNeon(const uint8* data, int64 size, int64& length)
+    {
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint8x16_t input = vld1q_u8(data + pos);
+            uint8x16_t leads = vcgtq_s8(vreinterpretq_s8_u8(input), vdupq_n_s8(-65));
+            uint8x16_t fours = vcgeq_u8(input, vdupq_n_u8(0xF0));
+            length += vaddvq_u8(vshrq_n_u8(leads, 7)) + vaddvq_u8(vshrq_n_u8(fours, 7));
+        }
+        return pos;
+    }
+
+    int64 ToUtf16Neon(const uint8* data, int64 size, char16* output)
+    {
+        uint16* out = reinterpret_cast<uint16*>(output);
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint8x16_t input = vld1q_u8(data + pos);
+            if (vmaxvq_u8(input) >= 0x80)
+            {
+                break;
+            }
+            vst1q_u16(out + pos, vmovl_u8(vget_low_u8(input)));
+            vst1q_u16(out + pos + 8, vmovl_u8(vget_high_u8(input)));
+        }
+        return pos;
+    }
+
+    int64 ToUtf32Neon(const uint8* data, int64 size, char32* output)
+    {
+        uint32* out = reinterpret_cast<uint32*>(output);
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint8x16_t input = vld1q_u8(data + pos);
+            if (vmaxvq_u8(input) >= 0x80)
+            {
+                break;
+            }
+            uint16x8_t low = vmovl_u8(vget_low_u8(input));
+            uint16x8_t high = vmovl_u8(vget_high_u8(input));
+            vst1q_u32(out + pos, vmovl_u16(vget_low_u16(low)));
+            vst1q_u32(out + pos + 4, vmovl_u16(vget_high_u16(low)));
+            vst1q_u32(out + pos + 8, vmovl_u16(vget_low_u16(high)));
+            vst1q_u32(out + pos + 12, vmovl_u16(vget_high_u16(high)));
+        }
+        return pos;
+    }
+
+    int64 FromUtf16Neon(const char16* data, int64 size, uint8* output)
+    {
+        const uint16* in = reinterpret_cast<const uint16*>(data);
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint16x8_t low = vld1q_u16(in + pos);
+            uint16x8_t high = vld1q_u16(in + pos + 8);
+            if (vmaxvq_u16(vorrq_u16(low, high)) >= 0x80)
+            {
+                break;
+            }
+            vst1q_u8(output + pos, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+        }
+        return pos;
+    }
+
+    int64 FromUtf32Neon(const char32* data, int64 size, uint8* output)
+    {
+        const uint32* in = reinterpret_cast<const uint32*>(data);
+        int64 pos = 0;
+        for (; pos + 16 <= size; pos += 16)
+        {
+            uint32x4_t a = vld1q_u32(in + pos);
+            uint32x4_t b = vld1q_u32(in + pos + 4);
+            uint32x4_t c = vld1q_u32(in + pos + 8);
+            uint32x4_t d = vld1q_u32(in + pos + 12);
+            if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80)
+            {
+                break;
+            }
+            uint16x8_t low = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+            uint16x8_t high = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+            vst1q_u8(output + pos, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+        }
+        return pos;
+    }
+
+    int64 LengthFromUtf16Neon(const char16* data, int64 size, int64& length)
+    {
+        const uint16* in = reinterpret_cast<const uint16*>(data);
+        int64 pos = 0;
+        for (; pos + 8 <= size; pos += 8)
+        {
+            uint16x8_t input = vld1q_u16(in + pos);
+            uint16x8_t two = vshrq_n_u16(vcgeq_u16(input, vdupq_n_u16(0x80)), 15);
+            uint16x8_t three = vshrq_n_u16(vcgeq_u16(input, vdupq_n_u16(0x800)), 15);
+            uint16x8_t surrogate = vshrq_n_u16(vceqq_u16(vandq_u16(input, vdupq_n_u16(0xF800)), vdupq_n_u16(0xD800)), 15);
+            length += 8 + static_cast<int64>(vaddvq_u16(vaddq_u16(two, three))) - vaddvq_u16(surrogate);
+        }
+        return pos;
+    }
+
+    int64 LengthFromUtf32Neon(const char32* data, int64 size, int64& length)
+    {
+        const uint32* in = reinterpret_cast<const uint32*>(data);
+        int64 pos = 0;
+        for (; pos + 4 <= size; pos += 4)
+        {
+            uint32x4_t input = vld1q_u32(in + pos);
+            uint32x4_t two = vshrq_n_u32(vcgeq_u32(input, vdupq_n_u32(0x80)), 31);
+            uint32x4_t three = vshrq_n_u32(vcgeq_u32(input, vdupq_n_u32(0x800)), 31);
+            uint32x4_t four = vshrq_n_u32(vcgeq_u32(input, vdupq_n_u32(0x10000)), 31);
+            length += 4 + vaddvq_u32(vaddq_u32(vaddq_u32(two, three), four));
+        }
+        return pos;
+    }
+#endif
+
+    ValidateKernel GetValidateKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const ValidateKernel kernel = SelectKernel<ValidateKernel>(&ValidateAndCountSse, &ValidateAndCountAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &ValidateAndCountNeon;
+#else
+        return nullptr;
+#endif
+    }
+
+    CountKernel GetCountKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const CountKernel kernel = SelectKernel<CountKernel>(&CountCharsSse, &CountCharsAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &CountCharsNeon;
+#else
+        return nullptr;
+#endif
+    }
+
+    ASCIIKernel GetASCIIKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const ASCIIKernel kernel = SelectKernel<ASCIIKernel>(&ASCIIPrefixSse, &ASCIIPrefixAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &ASCIIPrefixNeon;
+#else
+        return nullptr;
+#endif
+    }
+
+    CountKernel GetUtf16LengthKernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const CountKernel kernel = SelectKernel<CountKernel>(&Utf16LengthSse, &Utf16LengthAvx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &Utf16LengthNeon;
+#else
+        return nullptr;
+#endif
+    }
+
+    ToUtf16Kernel GetToUtf16Kernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const ToUtf16Kernel kernel = SelectKernel<ToUtf16Kernel>(&ToUtf16Sse, &ToUtf16Avx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &ToUtf16Neon;
+#else
+        return nullptr;
+#endif
+    }
+
+    ToUtf32Kernel GetToUtf32Kernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const ToUtf32Kernel kernel = SelectKernel<ToUtf32Kernel>(&ToUtf32Sse, &ToUtf32Avx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &ToUtf32Neon;
+#else
+        return nullptr;
+#endif
+    }
+
+    FromUtf16Kernel GetFromUtf16Kernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const FromUtf16Kernel kernel = SelectKernel<FromUtf16Kernel>(&FromUtf16Sse, &FromUtf16Avx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &FromUtf16Neon;
+#else
+        return nullptr;
+#endif
+    }
+
+    FromUtf32Kernel GetFromUtf32Kernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const FromUtf32Kernel kernel = SelectKernel<FromUtf32Kernel>(&FromUtf32Sse, &FromUtf32Avx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &FromUtf32Neon;
+#else
+        return nullptr;
+#endif
+    }
+
+    Utf16CountKernel GetLengthFromUtf16Kernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const Utf16CountKernel kernel = SelectKernel<Utf16CountKernel>(&LengthFromUtf16Sse, &LengthFromUtf16Avx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &LengthFromUtf16Neon;
+#else
+        return nullptr;
+#endif
+    }
+
+    Utf32CountKernel GetLengthFromUtf32Kernel()
+    {
+#if defined(CPU_ARCH_X64)
+        static const Utf32CountKernel kernel = SelectKernel<Utf32CountKernel>(&LengthFromUtf32Sse, &LengthFromUtf32Avx2);
+        return kernel;
+#elif defined(CPU_ARCH_ARM64)
+        return &LengthFromUtf32Neon;
+#else
+        return nullptr;
+#endif
+    }
+}
+
+bool Utf8::IsValid(const char* data, int64 size)
+{
+    bool ascii;
+    return ValidateAndCount(data, size, ascii) >= 0;
+}
+
+bool Utf8::IsASCII(const char* data, int64 size)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    int64 pos = 0;
+    if (ASCIIKernel kernel = GetASCIIKernel())
+    {
+        pos = kernel(bytes, size);
+    }
+    for (; pos + 8 <= size; pos += 8)
+    {
+        if (!IsASCIIWord(bytes + pos))
+        {
+            return false;
+        }
+    }
+    for (; pos < size; ++pos)
+    {
+        if (bytes[pos] >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int64 Utf8::CountChars(const char* data, int64 size)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    int64 count = 0;
+    int64 pos = 0;
+    if (CountKernel kernel = GetCountKernel())
+    {
+        pos = kernel(bytes, size, count);
+    }
+    return count + CountCharsScalar(bytes + pos, size - pos);
+}
+
+int64 Utf8::ValidateAndCount(const char* data, int64 size, bool& ascii)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    if (size <= 0)
+    {
+        ascii = true;
+        return 0;
+    }
+    // 短于一个向量时标量实现更快
+    ValidateKernel kernel = GetValidateKernel();
+    if (kernel && size >= 16)
+    {
+        return kernel(bytes, size, ascii);
+    }
+    return ValidateAndCountScalar(bytes, size, ascii);
+}
+
+int32 Utf8::SpaceLength(const char* data, int64 size)
+{
+    const uint8* ptr = reinterpret_cast<const uint8*>(data);
+    uint8 ch = ptr[0];
+    // ASCII空白字符
+    if (ch == 0x20 || ch == 0x09 || ch == 0x0A || ch == 0x0D || ch == 0x0C || ch == 0x0B)
+    {
+        return 1;
+    }
+    // UTF-8多字节空白字符（如不换行空格）
+    if ((ch & 0xE0) == 0xC0 && size >= 2)
+    {
+        uint32 code = ((ptr[0] & 0x1F) << 6) | (ptr[1] & 0x3F);
+        return code == 0x00A0 ? 2 : 0;
+    }
+    if ((ch & 0xF0) == 0xE0 && size >= 3)
+    {
+        uint32 code = ((ptr[0] & 0x0F) << 12) | ((ptr[1] & 0x3F) << 6) | (ptr[2] & 0x3F);
+        if (code == 0x3000 || (code >= 0x2000 && code <= 0x200A) || code == 0x202F || code == 0x205F)
+        {
+            return 3;
+        }
+    }
+    return 0;
+}
+
+int64 Utf8::Utf16Length(const char* data, int64 size)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    int64 length = 0;
+    int64 pos = 0;
+    if (CountKernel kernel = GetUtf16LengthKernel())
+    {
+        pos = kernel(bytes, size, length);
+    }
+    for (; pos < size; ++pos)
+    {
+        length += (IsContinuation(bytes[pos]) ? 0 : 1) + (bytes[pos] >= 0xF0 ? 1 : 0);
+    }
+    return length;
+}
+
+int64 Utf8::ToUtf16(const char* data, int64 size, char16* output)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    ToUtf16Kernel kernel = GetToUtf16Kernel();
+    int64 pos = 0;
+    int64 written = 0;
+    while (pos < size)
+    {
+        // 向量内核转换连续的 ASCII 块，之后逐字符转换一个向量宽度再交回内核
+        int64 end = size;
+        if (kernel)
+        {
+            int64 converted = kernel(bytes + pos, size - pos, output + written);
+            pos += converted;
+            written += converted;
+            end = std::min(size, pos + 32);
+        }
+
+        while (pos < end)
+        {
+            uint32 code = 0;
+            int32 length = Decode(data + pos, size - pos, code);
+            if (length == 0)
+            {
+                return -1;
+            }
+            if (code < 0x10000)
+            {
+                output[written++] = static_cast<char16>(code);
+            }
+            else
+            {
+                code -= 0x10000;
+                output[written++] = static_cast<char16>(0xD800 | (code >> 10));
+                output[written++] = static_cast<char16>(0xDC00 | (code & 0x3FF));
+            }
+            pos += length;
+        }
+    }
+    return written;
+}
+
+int64 Utf8::ToUtf32(const char* data, int64 size, char32* output)
+{
+    const uint8* bytes = reinterpret_cast<const uint8*>(data);
+    ToUtf32Kernel kernel = GetToUtf32Kernel();
+    int64 pos = 0;
+    int64 written = 0;
+    while (pos < size)
+    {
+        int64 end = size;
+        if (kernel)
+        {
+            int64 converted = kernel(bytes + pos, size - pos, output + written);
+            pos += converted;
+            written += converted;
+            end = std::min(size, pos + 32);
+        }
+
+        while (pos < end)
+        {
+            uint32 code = 0;
+            int32 length = Decode(data + pos, size - pos, code);
+            if (length == 0)
+            {
+                return -1;
+            }
+            output[written++] = static_cast<char32>(code);
+            pos += length;
+        }
+    }
+    return written;
+}
+
+int64 Utf8::LengthFromUtf16(const char16* data, int64 size)
+{
+    int64 length = 0;
+    int64 pos = 0;
+    if (Utf16CountKernel kernel = GetLengthFromUtf16Kernel())
+    {
+        pos = kernel(data, size, length);
+    }
+    for (; pos < size; ++pos)
+    {
+        uint32 unit = data[pos];
+        length += unit < 0x80 ? 1 : unit < 0x800 || IsSurrogate(unit) ? 2 : 3;
+    }
+    return length;
+}
+
+int64 Utf8::FromUtf16(const char16* data, int64 size, char* output)
+{
+    FromUtf16Kernel kernel = GetFromUtf16Kernel();
+    uint8* bytes = reinterpret_cast<uint8*>(output);
+    int64 pos = 0;
+    int64 written = 0;
+    while (pos < size)
+    {
+        int64 end = size;
+        if (kernel)
+        {
+            int64 converted = kernel(data + pos, size - pos, bytes + written);
+            pos += converted;
+            written += converted;
+            end = std::min(size, pos + 32);
+        }
+
+        while (pos < end)
+        {
+            uint32 code = data[pos++];
+            if (IsSurrogate(code))
+            {
+                // 高代理项后必须紧跟低代理项
+                if (code >= 0xDC00 || pos >= size || (data[pos] & 0xFC00) != 0xDC00)
+                {
+                    return -1;
+                }
+                code = 0x10000 + ((code - 0xD800) << 10) + (data[pos++] - 0xDC00);
+            }
+            written += Encode(code, output + written);
+        }
+    }
+    return written;
+}
+
+int64 Utf8::LengthFromUtf32(const char32* data, int64 size)
+{
+    int64 length = 0;
+    int64 pos = 0;
+    if (Utf32CountKernel kernel = GetLengthFromUtf32Kernel())
+    {
+        pos = kernel(data, size, length);
+    }
+    for (; pos < size; ++pos)
+    {
+        uint32 code = data[pos];
+        length += code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+    }
+    return length;
+}
+
+int64 Utf8::FromUtf32(const char32* data, int64 size, char* output)
+{
+    FromUtf32Kernel kernel = GetFromUtf32Kernel();
+    uint8* bytes = reinterpret_cast<uint8*>(output);
+    int64 pos = 0;
+    int64 written = 0;
+    while (pos < size)
+    {
+        int64 end = size;
+        if (kernel)
+        {
+            int64 converted = kernel(data + pos, size - pos, bytes + written);
+            pos += converted;
+            written += converted;
+            end = std::min(size, pos + 32);
+        }
+
+        for (; pos < end; ++pos)
+        {
+            uint32 code = data[pos];
+            if (code > 0x10FFFF || IsSurrogate(code))
+            {
+                return -1;
+            }
+            written += Encode(code, output + written);
+        }
+    }
+    return written;
+}
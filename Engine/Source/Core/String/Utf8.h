@@ -0,0 +1,190 @@
+#pragma once
+
+#include "Core.h"
+
+/// <summary>
+/// UTF-8 校验、字符统计、编解码以及与 UTF-16/UTF-32 的相互转换
+/// <para>支持 AVX2/SSE4.2/NEON 时按向量批量处理(查表法校验，每次 32/16 字节)，首次调用时按 CPU 特性选择实现</para>
+/// <para>校验遵循 RFC 3629：拒绝过长编码、代理项、超出 U+10FFFF 的码点以及截断的序列</para>
+/// <para>转换时先用 Utf16Length/LengthFromUtf16 等计算输出长度，一次分配后直接写入目标缓冲区，不经过中间容器</para>
+/// </summary>
+class Utf8
+{
+public:
+    /// <summary>
+    /// 判断字节序列是否为有效的 UTF-8
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <returns>是否有效</returns>
+    static bool IsValid(const char* data, int64 size);
+    /// <summary>
+    /// 判断字节序列是否全部为 ASCII 字符
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <returns>是否全部小于 0x80</returns>
+    static bool IsASCII(const char* data, int64 size);
+    /// <summary>
+    /// 统计码点数量(即非连续字节的数量)
+    /// <para>不做校验，仅对有效的 UTF-8 结果准确</para>
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <returns>码点数量</returns>
+    static int64 CountChars(const char* data, int64 size);
+    /// <summary>
+    /// 一次遍历同时校验、统计码点数量并判断是否全部为 ASCII
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <param name="ascii">是否全部为 ASCII 字符，无效时不确定</param>
+    /// <returns>码点数量，不是有效的 UTF-8 时返回 -1</returns>
+    static int64 ValidateAndCount(const char* data, int64 size, bool& ascii);
+    /// <summary>
+    /// 判断开头是否为空白字符(ASCII 空白、U+00A0、U+2000-U+200A、U+202F、U+205F、U+3000)
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">可读取的字节数，至少为 1</param>
+    /// <returns>空白字符的字节长度，不是空白时返回 0</returns>
+    static int32 SpaceLength(const char* data, int64 size);
+    /// <summary>
+    /// 统计转换为 UTF-16 所需的代码单元数(码点数加四字节序列数)
+    /// <para>不做校验，仅对有效的 UTF-8 结果准确；对无效的输入也不小于 ToUtf16 实际写入的单元数</para>
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <returns>UTF-16 代码单元数</returns>
+    static int64 Utf16Length(const char* data, int64 size);
+    /// <summary>
+    /// 校验并转换为 UTF-16，连续的 ASCII 块按向量批量扩展
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <param name="output">输出缓冲区，至少 Utf16Length 个单元</param>
+    /// <returns>写入的单元数，不是有效的 UTF-8 时返回 -1</returns>
+    static int64 ToUtf16(const char* data, int64 size, char16* output);
+    /// <summary>
+    /// 校验并转换为 UTF-32，连续的 ASCII 块按向量批量扩展
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">字节数</param>
+    /// <param name="output">输出缓冲区，至少 CountChars 个单元</param>
+    /// <returns>写入的单元数，不是有效的 UTF-8 时返回 -1</returns>
+    static int64 ToUtf32(const char* data, int64 size, char32* output);
+    /// <summary>
+    /// 统计 UTF-16 转换为 UTF-8 所需的字节数
+    /// <para>不做校验，对含未配对代理项的输入也不小于 FromUtf16 实际写入的字节数</para>
+    /// </summary>
+    /// <param name="data">UTF-16 代码单元</param>
+    /// <param name="size">单元数</param>
+    /// <returns>UTF-8 字节数</returns>
+    static int64 LengthFromUtf16(const char16* data, int64 size);
+    /// <summary>
+    /// 将 UTF-16 转换为 UTF-8，连续的 ASCII 块按向量批量收窄
+    /// </summary>
+    /// <param name="data">UTF-16 代码单元</param>
+    /// <param name="size">单元数</param>
+    /// <param name="output">输出缓冲区，至少 LengthFromUtf16 个字节</param>
+    /// <returns>写入的字节数，含未配对的代理项时返回 -1</returns>
+    static int64 FromUtf16(const char16* data, int64 size, char* output);
+    /// <summary>
+    /// 统计 UTF-32 转换为 UTF-8 所需的字节数(不做校验)
+    /// </summary>
+    /// <param name="data">码点</param>
+    /// <param name="size">码点数</param>
+    /// <returns>UTF-8 字节数</returns>
+    static int64 LengthFromUtf32(const char32* data, int64 size);
+    /// <summary>
+    /// 将 UTF-32 转换为 UTF-8，连续的 ASCII 块按向量批量收窄
+    /// </summary>
+    /// <param name="data">码点</param>
+    /// <param name="size">码点数</param>
+    /// <param name="output">输出缓冲区，至少 LengthFromUtf32 个字节</param>
+    /// <returns>写入的字节数，含代理项或超出 U+10FFFF 的值时返回 -1</returns>
+    static int64 FromUtf32(const char32* data, int64 size, char* output);
+    /// <summary>
+    /// 就地解码开头的一个码点(按 RFC 3629 校验)
+    /// </summary>
+    /// <param name="data">字节序列</param>
+    /// <param name="size">可读取的字节数，至少为 1</param>
+    /// <param name="code">解码得到的码点</param>
+    /// <returns>序列的字节数，无效或被截断时返回 0</returns>
+    static int32 Decode(const char* data, int64 size, uint32& code)
+    {
+        const uint8* ptr = reinterpret_cast<const uint8*>(data);
+        uint8 lead = ptr[0];
+        if (lead < 0x80)
+        {
+            code = lead;
+            return 1;
+        }
+        if (lead >= 0xC2 && lead <= 0xDF)
+        {
+            if (size < 2 || (ptr[1] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            code = ((lead & 0x1Fu) << 6) | (ptr[1] & 0x3Fu);
+            return 2;
+        }
+        if (lead >= 0xE0 && lead <= 0xEF)
+        {
+            // 排除过长编码与代理项
+            uint8 low = lead == 0xE0 ? 0xA0 : 0x80;
+            uint8 high = lead == 0xED ? 0x9F : 0xBF;
+            if (size < 3 || ptr[1] < low || ptr[1] > high || (ptr[2] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            code = ((lead & 0x0Fu) << 12) | ((ptr[1] & 0x3Fu) << 6) | (ptr[2] & 0x3Fu);
+            return 3;
+        }
+        if (lead >= 0xF0 && lead <= 0xF4)
+        {
+            // 排除过长编码与超出 U+10FFFF 的码点
+            uint8 low = lead == 0xF0 ? 0x90 : 0x80;
+            uint8 high = lead == 0xF4 ? 0x8F : 0xBF;
+            if (size < 4 || ptr[1] < low || ptr[1] > high || (ptr[2] & 0xC0) != 0x80 || (ptr[3] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+            code = ((lead & 0x07u) << 18) | ((ptr[1] & 0x3Fu) << 12) | ((ptr[2] & 0x3Fu) << 6) | (ptr[3] & 0x3Fu);
+            return 4;
+        }
+        return 0;
+    }
+    /// <summary>
+    /// 将码点编码为 UTF-8
+    /// </summary>
+    /// <param name="code">有效的码点(不检查)</param>
+    /// <param name="buffer">至少 4 字节的缓冲区</param>
+    /// <returns>写入的字节数</returns>
+    static int32 Encode(uint32 code, char* buffer)
+    {
+        uint8* out = reinterpret_cast<uint8*>(buffer);
+        if (code < 0x80)
+        {
+            out[0] = static_cast<uint8>(code);
+            return 1;
+        }
+        if (code < 0x800)
+        {
+            out[0] = static_cast<uint8>(0xC0 | (code >> 6));
+            out[1] = static_cast<uint8>(0x80 | (code & 0x3F));
+            return 2;
+        }
+        if (code < 0x10000)
+        {
+            out[0] = static_cast<uint8>(0xE0 | (code >> 12));
+            out[1] = static_cast<uint8>(0x80 | ((code >> 6) & 0x3F));
+            out[2] = static_cast<uint8>(0x80 | (code & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<uint8>(0xF0 | (code >> 18));
+        out[1] = static_cast<uint8>(0x80 | ((code >> 12) & 0x3F));
+        out[2] = static_cast<uint8>(0x80 | ((code >> 6) & 0x3F));
+        out[3] = static_cast<uint8>(0x80 | (code & 0x3F));
+        return 4;
+    }
+};
@@ -0,0 +1,90 @@
+#include "pch.h"
+
+#include "CpuFeatures.h"
+
+#if defined(CPU_ARCH_X64)
+    #if defined(COMPILER_MSVC)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#elif defined(CPU_ARCH_ARM64)
+    #if defined(PLATFORM_WINDOWS)
+        #include "Windows/WindowsPlatform.h"
+    #elif defined(PLATFORM_LINUX) || defined(PLATFORM_ANDROID)
+        #include <sys/auxv.h>
+        #include <asm/hwcap.h>
+    #endif
+#endif
+
+namespace
+{
+#if defined(CPU_ARCH_X64)
+    void CpuId(int32 leaf, int32 subLeaf, uint32 registers[4])
+    {
+#if defined(COMPILER_MSVC)
+        int info[4];
+        __cpuidex(info, leaf, subLeaf);
+        for (int32 i = 0; i < 4; ++i)
+        {
+            registers[i] = static_cast<uint32>(info[i]);
+        }
+#else
+        __cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    }
+
+    uint64 ReadXCR0()
+    {
+#if defined(COMPILER_MSVC)
+        return _xgetbv(0);
+#else
+        uint32 low, high;
+        __asm__ volatile("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+        return (static_cast<uint64>(high) << 32) | low;
+#endif
+    }
+#endif
+
+    CpuFeatures Detect()
+    {
+        CpuFeatures features;
+#if defined(CPU_ARCH_X64)
+        uint32 regs[4];
+        CpuId(0, 0, regs);
+        uint32 maxLeaf = regs[0];
+
+        CpuId(1, 0, regs);
+        features.SSE42 = (regs[2] & (1u << 20)) != 0;
+        features.PCLMUL = (regs[2] & (1u << 1)) != 0;
+        bool osxsave = (regs[2] & (1u << 27)) != 0;
+        bool avx = (regs[2] & (1u << 28)) != 0;
+        // 操作系统须在上下文切换时保存 XMM/YMM 状态
+        bool ymmEnabled = osxsave && avx && (ReadXCR0() & 0x6) == 0x6;
+
+        if (maxLeaf >= 7)
+        {
+            CpuId(7, 0, regs);
+            features.AVX2 = ymmEnabled && (regs[1] & (1u << 5)) != 0;
+            features.BMI2 = (regs[1] & (1u << 3)) != 0 && (regs[1] & (1u << 8)) != 0;
+        }
+#elif defined(CPU_ARCH_ARM64)
+        features.NEON = true;
+    #if defined(PLATFORM_WINDOWS)
+        features.CRC32 = IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != 0;
+    #elif defined(PLATFORM_LINUX) || defined(PLATFORM_ANDROID)
+        features.CRC32 = (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+    #else
+        // Apple 芯片均支持 CRC32
+        features.CRC32 = true;
+    #endif
+#endif
+        return features;
+    }
+}
+
+const CpuFeatures& CpuFeatures::Get()
+{
+    static const CpuFeatures features = Detect();
+    return features;
+}
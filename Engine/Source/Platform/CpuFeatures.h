@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Platform.h"
+
+// ==================== 指令集目标属性 ====================
+// GCC/Clang 需要为使用特定指令集的函数单独开启目标，MSVC 无需开启即可使用全部内建函数
+#if defined(COMPILER_MSVC)
+    #define CPU_TARGET(name)
+#else
+    #define CPU_TARGET(name) __attribute__((target(name)))
+#endif
+
+#if defined(CPU_ARCH_X64)
+    #define CPU_TARGET_SSE42 CPU_TARGET("sse4.2")
+    #define CPU_TARGET_AVX2 CPU_TARGET("avx2,bmi,bmi2,popcnt")
+#elif defined(CPU_ARCH_ARM64)
+    #if defined(COMPILER_GCC)
+        #define CPU_TARGET_CRC CPU_TARGET("+crc")
+    #else
+        #define CPU_TARGET_CRC CPU_TARGET("crc")
+    #endif
+#endif
+
+/// <summary>
+/// 运行时检测到的 CPU 指令集特性
+/// <para>SIMD 代码按这里的结果在首次调用时选择实现，不依赖编译选项</para>
+/// </summary>
+struct CpuFeatures
+{
+    // SSE4.2(含 CRC32 指令)
+    bool SSE42 = false;
+    // PCLMULQDQ 无进位乘法
+    bool PCLMUL = false;
+    // AVX2(同时要求操作系统保存 YMM 寄存器)
+    bool AVX2 = false;
+    // BMI1/BMI2 位操作指令
+    bool BMI2 = false;
+    // ARM NEON(ARM64 上总是可用)
+    bool NEON = false;
+    // ARMv8 CRC32 指令
+    bool CRC32 = false;
+
+    /// <summary>
+    /// 获取当前 CPU 的特性(首次调用时检测)
+    /// </summary>
+    static const CpuFeatures& Get();
+};
@@ -52,6 +52,10 @@
     #error "The engine requires a 64-bit CPU architecture"
 #endif
 
+// ==================== 缓存行大小 ====================
+// 用于并发数据结构隔离读写热点，避免伪共享
+#define PLATFORM_CACHE_LINE_SIZE 64
+
 // ==================== DLL 导入导出指令定义 ====================
 #ifdef PLATFORM_WINDOWS
     #define DLLEXPORT __declspec(dllexport)
@@ -88,7 +92,11 @@
 #endif
 
 // ==================== 字节序检测 ====================
-// @ 实现
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    #define PLATFORM_BIG_ENDIAN 1
+#else
+    #define PLATFORM_LITTLE_ENDIAN 1
+#endif
 
 // ==================== 平台扩展支持 ====================​​
 #ifdef PLATFORM_WINDOWS